@@ -0,0 +1,165 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "DeletionQueue.hpp"
+#include <cassert>
+#include <cstring>
+
+DeletionQueue::DeletionQueue(void)
+    : device_(VK_NULL_HANDLE), allocator_(nullptr), destroyedCount_(0) {}
+
+void DeletionQueue::Create(VkDevice device, MemoryAllocator* allocator) {
+  assert(pending_.empty());
+  device_ = device;
+  allocator_ = allocator;
+  destroyedCount_ = 0;
+}
+
+void DeletionQueue::Destroy(void) {
+  while (!pending_.empty()) {
+    Release(&pending_.front());
+    pending_.pop_front();
+  }
+}
+
+void DeletionQueue::DeferBuffer(VkBuffer buffer, uint64_t retireValue) {
+  if (buffer == VK_NULL_HANDLE) return;
+  Entry entry;
+  entry.kind = kBuffer;
+  entry.retireValue = retireValue;
+  entry.buffer = buffer;
+  Push(entry);
+}
+
+void DeletionQueue::DeferImage(VkImage image, uint64_t retireValue) {
+  if (image == VK_NULL_HANDLE) return;
+  Entry entry;
+  entry.kind = kImage;
+  entry.retireValue = retireValue;
+  entry.image = image;
+  Push(entry);
+}
+
+void DeletionQueue::DeferImageView(VkImageView view, uint64_t retireValue) {
+  if (view == VK_NULL_HANDLE) return;
+  Entry entry;
+  entry.kind = kImageView;
+  entry.retireValue = retireValue;
+  entry.view = view;
+  Push(entry);
+}
+
+void DeletionQueue::DeferSampler(VkSampler sampler, uint64_t retireValue) {
+  if (sampler == VK_NULL_HANDLE) return;
+  Entry entry;
+  entry.kind = kSampler;
+  entry.retireValue = retireValue;
+  entry.sampler = sampler;
+  Push(entry);
+}
+
+void DeletionQueue::DeferFramebuffer(VkFramebuffer framebuffer,
+                                     uint64_t retireValue) {
+  if (framebuffer == VK_NULL_HANDLE) return;
+  Entry entry;
+  entry.kind = kFramebuffer;
+  entry.retireValue = retireValue;
+  entry.framebuffer = framebuffer;
+  Push(entry);
+}
+
+void DeletionQueue::DeferCommandPool(VkCommandPool pool,
+                                     uint64_t retireValue) {
+  if (pool == VK_NULL_HANDLE) return;
+  Entry entry;
+  entry.kind = kCommandPool;
+  entry.retireValue = retireValue;
+  entry.pool = pool;
+  Push(entry);
+}
+
+void DeletionQueue::DeferSemaphore(VkSemaphore semaphore,
+                                   uint64_t retireValue) {
+  if (semaphore == VK_NULL_HANDLE) return;
+  Entry entry;
+  entry.kind = kSemaphore;
+  entry.retireValue = retireValue;
+  entry.semaphore = semaphore;
+  Push(entry);
+}
+
+void DeletionQueue::DeferFence(VkFence fence, uint64_t retireValue) {
+  if (fence == VK_NULL_HANDLE) return;
+  Entry entry;
+  entry.kind = kFence;
+  entry.retireValue = retireValue;
+  entry.fence = fence;
+  Push(entry);
+}
+
+void DeletionQueue::DeferMemory(MemoryAllocation* allocation,
+                                uint64_t retireValue) {
+  if (allocation->memory == VK_NULL_HANDLE) return;
+  Entry entry;
+  entry.kind = kMemory;
+  entry.retireValue = retireValue;
+  entry.memory = *allocation;
+  Push(entry);
+  memset(allocation, 0, sizeof(*allocation));
+}
+
+void DeletionQueue::Collect(uint64_t completedValue) {
+  while (!pending_.empty() && pending_.front().retireValue <= completedValue) {
+    Release(&pending_.front());
+    pending_.pop_front();
+  }
+}
+
+void DeletionQueue::Push(const Entry& entry) {
+  assert(device_ != VK_NULL_HANDLE);
+  pending_.push_back(entry);
+}
+
+void DeletionQueue::Release(Entry* entry) {
+  switch (entry->kind) {
+    case kBuffer:
+      vkDestroyBuffer(device_, entry->buffer, nullptr);
+      break;
+    case kImage:
+      vkDestroyImage(device_, entry->image, nullptr);
+      break;
+    case kImageView:
+      vkDestroyImageView(device_, entry->view, nullptr);
+      break;
+    case kSampler:
+      vkDestroySampler(device_, entry->sampler, nullptr);
+      break;
+    case kFramebuffer:
+      vkDestroyFramebuffer(device_, entry->framebuffer, nullptr);
+      break;
+    case kCommandPool:
+      vkDestroyCommandPool(device_, entry->pool, nullptr);
+      break;
+    case kSemaphore:
+      vkDestroySemaphore(device_, entry->semaphore, nullptr);
+      break;
+    case kFence:
+      vkDestroyFence(device_, entry->fence, nullptr);
+      break;
+    case kMemory:
+      allocator_->Free(&entry->memory);
+      break;
+  }
+  destroyedCount_++;
+}
@@ -0,0 +1,98 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DELETION_QUEUE_HPP
+#define DELETION_QUEUE_HPP
+
+#include <vulkan_wrapper.h>
+#include <deque>
+#include "MemoryAllocator.hpp"
+
+// Objects the GPU may still be using, destroyed once it is done with them
+// rather than after waiting for it. Each is deferred with a retire value:
+// a frame number, or a timeline semaphore value, that the app knows has
+// completed once the GPU is past every use of the object. Collect() is
+// then given the latest completed value, say after the wait for a frame's
+// fence, and destroys what it retires.
+//
+// Objects are destroyed in the order they were deferred; one deferred with
+// a lower value than an earlier one waits for it. Not thread safe.
+class DeletionQueue {
+ public:
+  DeletionQueue(void);
+
+  // Objects are destroyed on |device|, and memory freed to |allocator|
+  void Create(VkDevice device, MemoryAllocator* allocator);
+  // Destroys every pending object: wait for the device to be idle first
+  void Destroy(void);
+
+  // Each takes VK_NULL_HANDLE, and a zeroed allocation, as a no-op. The
+  // names differ as non-dispatchable handles share a type on 32-bit builds.
+  void DeferBuffer(VkBuffer buffer, uint64_t retireValue);
+  void DeferImage(VkImage image, uint64_t retireValue);
+  void DeferImageView(VkImageView view, uint64_t retireValue);
+  void DeferSampler(VkSampler sampler, uint64_t retireValue);
+  void DeferFramebuffer(VkFramebuffer framebuffer, uint64_t retireValue);
+  void DeferCommandPool(VkCommandPool pool, uint64_t retireValue);
+  void DeferSemaphore(VkSemaphore semaphore, uint64_t retireValue);
+  void DeferFence(VkFence fence, uint64_t retireValue);
+  // Clears |allocation|, as MemoryAllocator::Free() does
+  void DeferMemory(MemoryAllocation* allocation, uint64_t retireValue);
+
+  // Destroys what was deferred with a value up to |completedValue|
+  void Collect(uint64_t completedValue);
+
+  uint32_t PendingCount(void) const {
+    return static_cast<uint32_t>(pending_.size());
+  }
+  uint64_t DestroyedCount(void) const { return destroyedCount_; }
+
+ private:
+  enum Kind {
+    kBuffer,
+    kImage,
+    kImageView,
+    kSampler,
+    kFramebuffer,
+    kCommandPool,
+    kSemaphore,
+    kFence,
+    kMemory,
+  };
+  struct Entry {
+    Kind kind;
+    uint64_t retireValue;
+    union {
+      VkBuffer buffer;
+      VkImage image;
+      VkImageView view;
+      VkSampler sampler;
+      VkFramebuffer framebuffer;
+      VkCommandPool pool;
+      VkSemaphore semaphore;
+      VkFence fence;
+      MemoryAllocation memory;
+    };
+  };
+
+  void Push(const Entry& entry);
+  void Release(Entry* entry);
+
+  VkDevice device_;
+  MemoryAllocator* allocator_;
+  std::deque<Entry> pending_;
+  uint64_t destroyedCount_;
+};
+
+#endif  // DELETION_QUEUE_HPP
@@ -0,0 +1,166 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "DepthBuffer.hpp"
+#include <cstring>
+
+namespace {
+
+// Best first. Every device renders to D16_UNORM and to one of the 24 and
+// 32-bit formats of each list.
+const uint32_t kFormatCount = 3;
+const VkFormat kDepthFormats[kFormatCount] = {
+    VK_FORMAT_X8_D24_UNORM_PACK32,
+    VK_FORMAT_D32_SFLOAT,
+    VK_FORMAT_D16_UNORM,
+};
+const VkFormat kDepthStencilFormats[kFormatCount] = {
+    VK_FORMAT_D24_UNORM_S8_UINT,
+    VK_FORMAT_D32_SFLOAT_S8_UINT,
+    VK_FORMAT_D16_UNORM_S8_UINT,
+};
+
+}  // namespace
+
+VkFormat ChooseDepthFormat(VkPhysicalDevice gpu, bool stencil) {
+  const VkFormat* formats = stencil ? kDepthStencilFormats : kDepthFormats;
+  for (uint32_t i = 0; i < kFormatCount; i++) {
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(gpu, formats[i], &properties);
+    if (properties.optimalTilingFeatures &
+        VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+      return formats[i];
+    }
+  }
+  return VK_FORMAT_UNDEFINED;
+}
+
+bool CreateDepthBuffer(VkPhysicalDevice gpu, VkDevice device,
+                       const MemoryTypeSelector& memoryTypes,
+                       VkExtent2D extent, bool stencil, DepthBuffer* depth,
+                       MemoryBudget* budget) {
+  memset(depth, 0, sizeof(*depth));
+  depth->format = ChooseDepthFormat(gpu, stencil);
+  if (depth->format == VK_FORMAT_UNDEFINED) return false;
+  depth->aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+  if (stencil) depth->aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+
+  // TRANSIENT: nothing but the render pass ever reads or writes it, which
+  // is what lets lazily allocated memory back it
+  VkImageCreateInfo imageInfo{
+      .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .imageType = VK_IMAGE_TYPE_2D,
+      .format = depth->format,
+      .extent = {extent.width, extent.height, 1},
+      .mipLevels = 1,
+      .arrayLayers = 1,
+      .samples = VK_SAMPLE_COUNT_1_BIT,
+      .tiling = VK_IMAGE_TILING_OPTIMAL,
+      .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+               VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+      .queueFamilyIndexCount = 0,
+      .pQueueFamilyIndices = nullptr,
+      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+  };
+  if (vkCreateImage(device, &imageInfo, nullptr, &depth->image) !=
+      VK_SUCCESS) {
+    return false;
+  }
+
+  VkMemoryRequirements requirements;
+  vkGetImageMemoryRequirements(device, depth->image, &requirements);
+  uint32_t typeIndex = memoryTypes.Select(kMemoryUsageTransient,
+                                          requirements.memoryTypeBits);
+  depth->lazilyAllocated =
+      (typeIndex != MemoryTypeSelector::kNoType) &&
+      (memoryTypes.Flags(typeIndex) & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+  VkMemoryAllocateInfo allocateInfo{
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .pNext = nullptr,
+      .allocationSize = requirements.size,
+      .memoryTypeIndex = typeIndex,
+  };
+  if (typeIndex == MemoryTypeSelector::kNoType ||
+      vkAllocateMemory(device, &allocateInfo, nullptr, &depth->memory) !=
+          VK_SUCCESS) {
+    DestroyDepthBuffer(device, depth);
+    return false;
+  }
+  depth->allocationSize = requirements.size;
+  depth->memoryType = typeIndex;
+  if (budget) {
+    budget->RecordMemory(typeIndex, requirements.size);
+    budget->RecordAllocation(typeIndex, requirements.size);
+    depth->budget_ = budget;
+  }
+  if (vkBindImageMemory(device, depth->image, depth->memory, 0) !=
+      VK_SUCCESS) {
+    DestroyDepthBuffer(device, depth);
+    return false;
+  }
+
+  VkImageViewCreateInfo viewInfo{
+      .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .image = depth->image,
+      .viewType = VK_IMAGE_VIEW_TYPE_2D,
+      .format = depth->format,
+      .components =
+          {
+              .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+              .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+              .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+              .a = VK_COMPONENT_SWIZZLE_IDENTITY,
+          },
+      .subresourceRange =
+          {
+              .aspectMask = depth->aspect,
+              .baseMipLevel = 0,
+              .levelCount = 1,
+              .baseArrayLayer = 0,
+              .layerCount = 1,
+          },
+  };
+  if (vkCreateImageView(device, &viewInfo, nullptr, &depth->view) !=
+      VK_SUCCESS) {
+    DestroyDepthBuffer(device, depth);
+    return false;
+  }
+  return true;
+}
+
+void DestroyDepthBuffer(VkDevice device, DepthBuffer* depth) {
+  // All three take VK_NULL_HANDLE
+  vkDestroyImageView(device, depth->view, nullptr);
+  vkDestroyImage(device, depth->image, nullptr);
+  vkFreeMemory(device, depth->memory, nullptr);
+  if (depth->budget_) {
+    depth->budget_->ReleaseAllocation(depth->memoryType,
+                                      depth->allocationSize);
+    depth->budget_->ReleaseMemory(depth->memoryType, depth->allocationSize);
+  }
+  memset(depth, 0, sizeof(*depth));
+}
+
+VkDeviceSize DepthBufferCommitment(VkDevice device, const DepthBuffer& depth) {
+  // Only valid on lazily allocated memory; the rest is committed up front
+  if (!depth.lazilyAllocated) return depth.allocationSize;
+  VkDeviceSize committed = 0;
+  vkGetDeviceMemoryCommitment(device, depth.memory, &committed);
+  return committed;
+}
@@ -0,0 +1,58 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DEPTH_BUFFER_HPP
+#define DEPTH_BUFFER_HPP
+
+#include <vulkan_wrapper.h>
+#include "MemoryBudget.hpp"
+#include "MemoryTypeSelector.hpp"
+
+// A depth (and stencil) attachment that only lives through a render pass:
+// cleared on load, DONT_CARE on store. It is a TRANSIENT_ATTACHMENT image
+// in LAZILY_ALLOCATED memory where the device has such a memory type, which
+// a tiler backs with on-chip tile memory only, so depth never reaches DRAM.
+struct DepthBuffer {
+  VkFormat format;
+  VkImageAspectFlags aspect;  // depth, plus stencil for a stencil format
+  VkImage image;
+  VkDeviceMemory memory;
+  VkImageView view;
+  VkDeviceSize allocationSize;
+  uint32_t memoryType;
+  bool lazilyAllocated;
+
+  MemoryBudget* budget_;  // what the memory is recorded in, if anything
+};
+
+// The first depth format |gpu| renders to, with a stencil component if
+// |stencil|; VK_FORMAT_UNDEFINED if there is none
+VkFormat ChooseDepthFormat(VkPhysicalDevice gpu, bool stencil);
+
+// Creates a |extent| sized depth buffer on |device|, in the memory type
+// |memoryTypes| picks for kMemoryUsageTransient, recorded in |budget| if
+// not nullptr; returns false if it has no depth format or memory for one
+bool CreateDepthBuffer(VkPhysicalDevice gpu, VkDevice device,
+                       const MemoryTypeSelector& memoryTypes,
+                       VkExtent2D extent, bool stencil, DepthBuffer* depth,
+                       MemoryBudget* budget = nullptr);
+
+void DestroyDepthBuffer(VkDevice device, DepthBuffer* depth);
+
+// Bytes of |depth|'s memory the device actually committed, from
+// vkGetDeviceMemoryCommitment(); all of it unless lazily allocated. Only
+// meaningful once rendering has used the attachment.
+VkDeviceSize DepthBufferCommitment(VkDevice device, const DepthBuffer& depth);
+
+#endif  // DEPTH_BUFFER_HPP
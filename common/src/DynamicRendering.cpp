@@ -0,0 +1,95 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "DynamicRendering.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool HasExtension(const std::vector<VkExtensionProperties>& extensions,
+                  const char* name) {
+  for (const VkExtensionProperties& extension : extensions) {
+    if (!strcmp(extension.extensionName, name)) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+uint32_t ChooseInstanceApiVersion(uint32_t maxVersion) {
+  // Through vkGetInstanceProcAddr(), which returns nullptr where the
+  // loader has no such function
+  PFN_vkEnumerateInstanceVersion enumerateInstanceVersion =
+      reinterpret_cast<PFN_vkEnumerateInstanceVersion>(
+          vkGetInstanceProcAddr(VK_NULL_HANDLE, "vkEnumerateInstanceVersion"));
+  uint32_t version = VK_API_VERSION_1_0;
+  if (enumerateInstanceVersion &&
+      enumerateInstanceVersion(&version) != VK_SUCCESS) {
+    version = VK_API_VERSION_1_0;
+  }
+  // Patch versions do not matter to the API
+  version = VK_MAKE_VERSION(VK_VERSION_MAJOR(version),
+                            VK_VERSION_MINOR(version), 0);
+  return std::min(version, maxVersion);
+}
+
+void QueryDynamicRendering(VkInstance instance, VkPhysicalDevice gpu,
+                           uint32_t instanceVersion,
+                           std::vector<const char*>* extensions,
+                           DynamicRenderingSupport* support) {
+  memset(support, 0, sizeof(*support));
+  support->features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+  // What the app may use is what both the instance and the device do
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(gpu, &properties);
+  uint32_t version = std::min(properties.apiVersion, instanceVersion);
+  if (version < VK_API_VERSION_1_1) return;
+
+  std::vector<const char*> required;
+  if (version < VK_API_VERSION_1_3) {
+    required.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+    if (version < VK_API_VERSION_1_2) {
+      required.push_back(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME);
+      required.push_back(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME);
+    }
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount,
+                                         nullptr);
+    std::vector<VkExtensionProperties> deviceExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount,
+                                         deviceExtensions.data());
+    for (const char* name : required) {
+      if (!HasExtension(deviceExtensions, name)) return;
+    }
+  }
+
+  PFN_vkGetPhysicalDeviceFeatures2 getPhysicalDeviceFeatures2 =
+      reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2>(
+          vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2"));
+  if (!getPhysicalDeviceFeatures2) return;
+  VkPhysicalDeviceFeatures2 features2{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+      .pNext = &support->features,
+  };
+  getPhysicalDeviceFeatures2(gpu, &features2);
+  support->features.pNext = nullptr;
+  if (!support->features.dynamicRendering) return;
+
+  extensions->insert(extensions->end(), required.begin(), required.end());
+  support->core = (version >= VK_API_VERSION_1_3);
+  support->supported = true;
+}
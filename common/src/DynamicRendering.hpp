@@ -0,0 +1,45 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DYNAMIC_RENDERING_HPP
+#define DYNAMIC_RENDERING_HPP
+
+#include <vulkan_wrapper.h>
+#include <vector>
+
+// The Vulkan version to put in VkApplicationInfo::apiVersion: the loader's,
+// up to |maxVersion|. 1.0 loaders, which fail vkCreateInstance() for any
+// other version, do not have vkEnumerateInstanceVersion().
+uint32_t ChooseInstanceApiVersion(uint32_t maxVersion);
+
+// Dynamic rendering draws straight to image views, between
+// vkCmdBeginRendering() and vkCmdEndRendering(), with no VkRenderPass or
+// VkFramebuffer to create, or to recreate with the swapchain.
+struct DynamicRenderingSupport {
+  bool supported;
+  // Vulkan 1.3, where it is core; else VK_KHR_dynamic_rendering
+  bool core;
+  // Chain into VkDeviceCreateInfo::pNext when |supported|
+  VkPhysicalDeviceDynamicRenderingFeaturesKHR features;
+};
+
+// Fills |support| for |gpu| on an instance created for |instanceVersion|,
+// and adds what to enable to |extensions|. Short of Vulkan 1.3, it takes a
+// 1.1 device and instance, which the extensions build on.
+void QueryDynamicRendering(VkInstance instance, VkPhysicalDevice gpu,
+                           uint32_t instanceVersion,
+                           std::vector<const char*>* extensions,
+                           DynamicRenderingSupport* support);
+
+#endif  // DYNAMIC_RENDERING_HPP
@@ -0,0 +1,129 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "FrameRing.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+const VkDeviceSize FrameRing::kMaxAlignment;
+
+namespace {
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+FrameRing::FrameRing(void)
+    : device_(VK_NULL_HANDLE),
+      allocator_(nullptr),
+      buffer_(VK_NULL_HANDLE),
+      size_(0),
+      uniformAlignment_(1),
+      head_(0),
+      tail_(0),
+      flushed_(0),
+      frame_(0),
+      peakBytes_(0) {
+  memset(&memory_, 0, sizeof(memory_));
+}
+
+bool FrameRing::Create(VkPhysicalDevice gpu, VkDevice device,
+                       MemoryAllocator* allocator, VkDeviceSize size,
+                       VkBufferUsageFlags usage, uint32_t frameCount) {
+  assert(buffer_ == VK_NULL_HANDLE && frameCount > 0);
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(gpu, &properties);
+  uniformAlignment_ =
+      std::max(properties.limits.minUniformBufferOffsetAlignment,
+               properties.limits.minStorageBufferOffsetAlignment);
+  uniformAlignment_ = std::max<VkDeviceSize>(uniformAlignment_, 1);
+  assert(uniformAlignment_ <= kMaxAlignment);
+
+  size_ = AlignUp(size, kMaxAlignment);
+  VkBufferCreateInfo bufferInfo{
+      .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .size = size_,
+      .usage = usage,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+      .queueFamilyIndexCount = 0,
+      .pQueueFamilyIndices = nullptr,
+  };
+  if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer_) != VK_SUCCESS) {
+    return false;
+  }
+  device_ = device;
+  allocator_ = allocator;
+  if (!allocator_->AllocateForBuffer(buffer_, kMemoryUsageDynamic,
+                                     &memory_) ||
+      !memory_.mapped) {
+    Destroy();
+    return false;
+  }
+  head_ = tail_ = flushed_ = 0;
+  frame_ = 0;
+  frameEnd_.assign(frameCount, 0);
+  peakBytes_ = 0;
+  return true;
+}
+
+void FrameRing::Destroy(void) {
+  if (buffer_ == VK_NULL_HANDLE) return;
+  vkDestroyBuffer(device_, buffer_, nullptr);
+  allocator_->Free(&memory_);
+  buffer_ = VK_NULL_HANDLE;
+  frameEnd_.clear();
+}
+
+void FrameRing::BeginFrame(uint32_t frame) {
+  assert(frame < frameEnd_.size());
+  frameEnd_[frame_] = head_;
+  // The slot's fence signaled, so its last frame and every one submitted
+  // before it are done
+  tail_ = std::max(tail_, frameEnd_[frame]);
+  frame_ = frame;
+}
+
+void* FrameRing::Allocate(VkDeviceSize size, VkDeviceSize alignment,
+                          VkDeviceSize* offset) {
+  if (!alignment) alignment = uniformAlignment_;
+  assert(!(alignment & (alignment - 1)) && alignment <= kMaxAlignment);
+  if (!size || size > size_) return nullptr;
+
+  // size_ is a multiple of every alignment, so aligned positions are
+  // aligned offsets. What does not fit before the end of the buffer starts
+  // over at the beginning.
+  uint64_t start = AlignUp(head_, alignment);
+  if (start % size_ + size > size_) start = (start / size_ + 1) * size_;
+  if (start + size - tail_ > size_) return nullptr;
+  head_ = start + size;
+  peakBytes_ = std::max<VkDeviceSize>(peakBytes_, head_ - tail_);
+
+  *offset = start % size_;
+  return static_cast<char*>(memory_.mapped) + *offset;
+}
+
+void FrameRing::Flush(void) {
+  // In at most two pieces: up to the end of the buffer, and from its start
+  while (flushed_ < head_) {
+    uint64_t lapEnd = (flushed_ / size_ + 1) * size_;
+    uint64_t end = std::min(head_, lapEnd);
+    allocator_->Flush(memory_, flushed_ % size_, end - flushed_);
+    flushed_ = end;
+  }
+}
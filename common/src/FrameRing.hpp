@@ -0,0 +1,84 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FRAME_RING_HPP
+#define FRAME_RING_HPP
+
+#include <vulkan_wrapper.h>
+#include <vector>
+#include "MemoryAllocator.hpp"
+
+// Data the CPU writes for one frame and the GPU reads in it: uniforms,
+// vertices, per-draw constants. It is allocated in ring order from one
+// buffer that stays mapped, so an allocation is an offset bump, with no
+// vkAllocateMemory(), vkMapMemory() or free per frame; bind it with the
+// offset, as a dynamic offset for a *_DYNAMIC descriptor.
+//
+// Each frame in flight has a slot. BeginFrame() for a slot reclaims what
+// the slot allocated last time, and everything before it: call it once the
+// slot's fence has signaled. Not thread safe.
+class FrameRing {
+ public:
+  // Every alignment Allocate() takes divides this; it is the largest
+  // minUniformBufferOffsetAlignment and minStorageBufferOffsetAlignment
+  // can be
+  static const VkDeviceSize kMaxAlignment = 256;
+
+  FrameRing(void);
+
+  // A ring of |size| bytes, rounded up to kMaxAlignment, in a buffer for
+  // |usage| in kMemoryUsageDynamic memory, for |frameCount| slots
+  bool Create(VkPhysicalDevice gpu, VkDevice device,
+              MemoryAllocator* allocator, VkDeviceSize size,
+              VkBufferUsageFlags usage, uint32_t frameCount);
+  // Wait for the frames in flight first
+  void Destroy(void);
+
+  void BeginFrame(uint32_t frame);
+
+  // |size| bytes, aligned to |alignment|, or to UniformAlignment() if 0.
+  // Returns where to write them, and their offset in Buffer() in |offset|;
+  // nullptr if the frames in flight hold too much of the ring.
+  void* Allocate(VkDeviceSize size, VkDeviceSize alignment,
+                 VkDeviceSize* offset);
+
+  // Makes what was allocated since the last Flush() visible to the device;
+  // call before submitting the commands that read it
+  void Flush(void);
+
+  VkBuffer Buffer(void) const { return buffer_; }
+  VkDeviceSize Size(void) const { return size_; }
+  // For offsets bound to uniform and storage buffer descriptors
+  VkDeviceSize UniformAlignment(void) const { return uniformAlignment_; }
+  // The most the ring has held at once, to size it with
+  VkDeviceSize PeakBytes(void) const { return peakBytes_; }
+
+ private:
+  VkDevice device_;
+  MemoryAllocator* allocator_;
+  VkBuffer buffer_;
+  MemoryAllocation memory_;
+  VkDeviceSize size_;
+  VkDeviceSize uniformAlignment_;
+  // Positions only ever grow; a position's offset in the buffer is it
+  // modulo size_
+  uint64_t head_;     // where the next allocation goes
+  uint64_t tail_;     // the oldest byte the GPU may still read
+  uint64_t flushed_;  // up to where Flush() has been
+  uint32_t frame_;    // the slot allocating now
+  std::vector<uint64_t> frameEnd_;  // head_ when each slot last ended
+  VkDeviceSize peakBytes_;
+};
+
+#endif  // FRAME_RING_HPP
@@ -0,0 +1,166 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Ktx2Texture.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const uint8_t kKtx2Identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32,
+                                     0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+// The header and index, up to the level index
+const size_t kKtx2HeaderBytes = 80;
+// ASTC block extents, from VK_FORMAT_ASTC_4x4 up, each UNORM then SRGB
+const uint8_t kAstcBlocks[][2] = {
+    {4, 4},  {5, 4},  {5, 5},  {6, 5},   {6, 6},   {8, 5},   {8, 6},
+    {8, 8},  {10, 5}, {10, 6}, {10, 8},  {10, 10}, {12, 10}, {12, 12},
+};
+
+uint32_t ReadU32(const uint8_t* data) {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+uint64_t ReadU64(const uint8_t* data) {
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+bool IsBc(VkFormat format) {
+  return format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK &&
+         format <= VK_FORMAT_BC7_SRGB_BLOCK;
+}
+
+bool IsEtc2(VkFormat format) {
+  return format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK &&
+         format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK;
+}
+
+bool IsAstc(VkFormat format) {
+  return format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK &&
+         format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
+}
+
+}  // namespace
+
+bool GetBlockFormat(VkFormat format, BlockFormat* block) {
+  if (format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB) {
+    *block = BlockFormat{1, 1, 4};
+    return true;
+  }
+  if (IsBc(format)) {
+    // BC1 and BC4 are half the size of the others
+    bool half = format <= VK_FORMAT_BC1_RGBA_SRGB_BLOCK ||
+                format == VK_FORMAT_BC4_UNORM_BLOCK ||
+                format == VK_FORMAT_BC4_SNORM_BLOCK;
+    *block = BlockFormat{4, 4, half ? 8u : 16u};
+    return true;
+  }
+  if (IsEtc2(format)) {
+    // RGB, RGB with 1 bit alpha and R11 are half the size of the others
+    bool half = format <= VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK ||
+                format == VK_FORMAT_EAC_R11_UNORM_BLOCK ||
+                format == VK_FORMAT_EAC_R11_SNORM_BLOCK;
+    *block = BlockFormat{4, 4, half ? 8u : 16u};
+    return true;
+  }
+  if (IsAstc(format)) {
+    const uint8_t* extent =
+        kAstcBlocks[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+    *block = BlockFormat{extent[0], extent[1], 16};
+    return true;
+  }
+  return false;
+}
+
+uint64_t BlockLevelBytes(const BlockFormat& block, uint32_t width,
+                         uint32_t height) {
+  uint64_t blocksWide = (width + block.blockWidth - 1) / block.blockWidth;
+  uint64_t blocksHigh = (height + block.blockHeight - 1) / block.blockHeight;
+  return blocksWide * blocksHigh * block.blockBytes;
+}
+
+void QueryTextureCompression(VkPhysicalDevice gpu,
+                             VkPhysicalDeviceFeatures* enable) {
+  VkPhysicalDeviceFeatures features;
+  vkGetPhysicalDeviceFeatures(gpu, &features);
+  enable->textureCompressionETC2 = features.textureCompressionETC2;
+  enable->textureCompressionASTC_LDR = features.textureCompressionASTC_LDR;
+  enable->textureCompressionBC = features.textureCompressionBC;
+}
+
+bool IsFormatSampled(VkPhysicalDevice gpu,
+                     const VkPhysicalDeviceFeatures& enabled,
+                     VkFormat format) {
+  // Formats of a feature not enabled cannot even be created
+  if ((IsBc(format) && !enabled.textureCompressionBC) ||
+      (IsEtc2(format) && !enabled.textureCompressionETC2) ||
+      (IsAstc(format) && !enabled.textureCompressionASTC_LDR)) {
+    return false;
+  }
+  VkFormatProperties props;
+  vkGetPhysicalDeviceFormatProperties(gpu, format, &props);
+  return (props.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+}
+
+bool IsKtx2(const void* data, size_t size) {
+  return size >= sizeof(kKtx2Identifier) &&
+         !memcmp(data, kKtx2Identifier, sizeof(kKtx2Identifier));
+}
+
+bool ParseKtx2(const void* data, size_t size, Ktx2Texture* texture) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  if (!IsKtx2(data, size) || size < kKtx2HeaderBytes) return false;
+  memset(texture, 0, sizeof(*texture));
+  texture->format = static_cast<VkFormat>(ReadU32(bytes + 12));
+  texture->width = ReadU32(bytes + 20);
+  texture->height = ReadU32(bytes + 24);
+  uint32_t depth = ReadU32(bytes + 28);
+  uint32_t layerCount = ReadU32(bytes + 32);
+  uint32_t faceCount = ReadU32(bytes + 36);
+  uint32_t levelCount = ReadU32(bytes + 40);
+  texture->supercompression = ReadU32(bytes + 44);
+  if (!texture->width || !texture->height || depth || layerCount > 1 ||
+      faceCount != 1 || levelCount > Ktx2Texture::kMaxLevels) {
+    return false;
+  }
+  // 0 asks the loader for mip levels: the one given is used alone
+  texture->mipLevels = std::max(levelCount, 1u);
+  uint32_t maxSide = std::max(texture->width, texture->height);
+  if (maxSide >> (texture->mipLevels - 1) == 0) return false;
+
+  uint64_t levelIndexEnd =
+      kKtx2HeaderBytes + texture->mipLevels * uint64_t(3 * sizeof(uint64_t));
+  if (levelIndexEnd > size) return false;
+  BlockFormat block;
+  bool knownFormat = GetBlockFormat(texture->format, &block);
+  for (uint32_t level = 0; level < texture->mipLevels; level++) {
+    const uint8_t* entry = bytes + kKtx2HeaderBytes + level * 24;
+    Ktx2Texture::Level& dst = texture->levels[level];
+    dst.offset = ReadU64(entry);
+    dst.size = ReadU64(entry + 8);
+    if (dst.offset > size || dst.size > size - dst.offset) return false;
+    if (knownFormat &&
+        texture->supercompression == Ktx2Texture::kSupercompressionNone &&
+        dst.size != BlockLevelBytes(block,
+                                    std::max(texture->width >> level, 1u),
+                                    std::max(texture->height >> level, 1u))) {
+      return false;
+    }
+  }
+  return texture->format != VK_FORMAT_UNDEFINED;
+}
@@ -0,0 +1,78 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef KTX2_TEXTURE_HPP
+#define KTX2_TEXTURE_HPP
+
+#include <vulkan_wrapper.h>
+#include <cstddef>
+#include <cstdint>
+
+// How a format's texels are stored: blocks of blockWidth x blockHeight
+// texels, blockBytes each; 1x1 for formats that are not block compressed
+struct BlockFormat {
+  uint32_t blockWidth;
+  uint32_t blockHeight;
+  uint32_t blockBytes;
+};
+
+// False for formats other than R8G8B8A8, BC, ETC2/EAC and ASTC LDR
+bool GetBlockFormat(VkFormat format, BlockFormat* block);
+// Bytes of a |width| x |height| level, in whole blocks
+uint64_t BlockLevelBytes(const BlockFormat& block, uint32_t width,
+                         uint32_t height);
+
+// Sets the textureCompression features of |enable| that |gpu| has, to
+// enable with the device; the others are cleared
+void QueryTextureCompression(VkPhysicalDevice gpu,
+                             VkPhysicalDeviceFeatures* enable);
+// Whether |format| can be sampled from optimally tiled images, on a device
+// created with |enabled|. Thread safe: physical device queries are.
+bool IsFormatSampled(VkPhysicalDevice gpu,
+                     const VkPhysicalDeviceFeatures& enabled,
+                     VkFormat format);
+
+// The texture a KTX2 file holds, parsed in place
+struct Ktx2Texture {
+  static const uint32_t kMaxLevels = 16;
+
+  enum Supercompression {
+    kSupercompressionNone = 0,
+    kSupercompressionBasisLz = 1,
+    kSupercompressionZstd = 2,
+    kSupercompressionZlib = 3,
+  };
+  struct Level {
+    uint64_t offset;  // in the file
+    uint64_t size;
+  };
+
+  VkFormat format;
+  uint32_t width;
+  uint32_t height;
+  uint32_t mipLevels;  // 1 when the file asks for them to be generated
+  uint32_t supercompression;
+  Level levels[kMaxLevels];  // level 0 first
+};
+
+// Whether |data| starts with the KTX2 identifier
+bool IsKtx2(const void* data, size_t size);
+// Parses the 2D texture in the |size| bytes at |data|, checking every
+// level is inside them and, for formats GetBlockFormat() knows that are
+// not supercompressed, the size its extent makes it. False for what is
+// not one: cube maps, arrays, 3D textures, payloads without a Vulkan format,
+// as Basis Universal ones are, and other files.
+bool ParseKtx2(const void* data, size_t size, Ktx2Texture* texture);
+
+#endif  // KTX2_TEXTURE_HPP
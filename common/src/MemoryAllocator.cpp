@@ -0,0 +1,308 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "MemoryAllocator.hpp"
+#include <algorithm>
+#include <cstring>
+
+const VkDeviceSize MemoryAllocator::kDefaultBlockSize;
+
+struct MemoryBlock {
+  MemoryBlock(uint32_t type, MemoryResourceKind resourceKind,
+              VkDeviceSize size)
+      : memory(VK_NULL_HANDLE),
+        mapped(nullptr),
+        memoryType(type),
+        kind(resourceKind),
+        heap(size) {}
+
+  VkDeviceMemory memory;
+  void* mapped;
+  uint32_t memoryType;
+  MemoryResourceKind kind;
+  TlsfHeap heap;
+};
+
+namespace {
+
+const VkDeviceSize kSmallHeapSize = 1ull << 30;
+
+#ifdef ENABLE_VULKAN_CAPTURE
+// Capture records what mapped memory holds only when it is flushed or
+// unmapped, and blocks stay mapped: coherent memory is flushed as well
+const bool kFlushCoherent = true;
+#else
+const bool kFlushCoherent = false;
+#endif
+
+// Whether Flush() calls the driver for memory of |flags|
+bool NeedsFlush(VkMemoryPropertyFlags flags) {
+  return kFlushCoherent || !(flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+}  // namespace
+
+MemoryAllocator::MemoryAllocator(VkPhysicalDevice gpu, VkDevice device,
+                                 const MemoryBudgetSupport* budgetSupport,
+                                 VkDeviceSize blockSize)
+    : device_(device), dedicatedCount_(0), dedicatedBytes_(0) {
+  vkGetPhysicalDeviceMemoryProperties(gpu, &properties_);
+  selector_ = MemoryTypeSelector(properties_);
+  budget_ = MemoryBudget(gpu, properties_, budgetSupport);
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(gpu, &properties);
+  bufferImageGranularity_ = properties.limits.bufferImageGranularity;
+  nonCoherentAtomSize_ = properties.limits.nonCoherentAtomSize;
+
+  // A block is most of a small heap, typically a mobile GPU's in a 32-bit
+  // address space; do not take it all at once
+  for (uint32_t i = 0; i < properties_.memoryHeapCount; i++) {
+    VkDeviceSize heapSize = properties_.memoryHeaps[i].size;
+    blockSize_[i] = blockSize;
+    if (heapSize < kSmallHeapSize && heapSize / 8 < blockSize) {
+      blockSize_[i] = heapSize / 8;
+    }
+  }
+  pools_.resize(properties_.memoryTypeCount * kMemoryResourceKindCount);
+}
+
+MemoryAllocator::~MemoryAllocator() {
+  // Freeing a mapped VkDeviceMemory unmaps it
+  for (Pool& pool : pools_) {
+    for (std::unique_ptr<MemoryBlock>& block : pool.blocks) {
+      vkFreeMemory(device_, block->memory, nullptr);
+    }
+  }
+}
+
+MemoryAllocator::Pool& MemoryAllocator::PoolFor(uint32_t memoryType,
+                                                MemoryResourceKind kind) {
+  // With no granularity to keep, linear and optimal resources share
+  if (bufferImageGranularity_ <= 1) kind = kMemoryLinear;
+  return pools_[memoryType * kMemoryResourceKindCount + kind];
+}
+
+void* MemoryAllocator::MapWhole(uint32_t memoryType, VkDeviceMemory memory) {
+  if (!(properties_.memoryTypes[memoryType].propertyFlags &
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+    return nullptr;
+  }
+  void* data;
+  if (vkMapMemory(device_, memory, 0, VK_WHOLE_SIZE, 0, &data) !=
+      VK_SUCCESS) {
+    return nullptr;
+  }
+  return data;
+}
+
+MemoryBlock* MemoryAllocator::NewBlock(uint32_t memoryType, Pool* pool) {
+  uint32_t heap = properties_.memoryTypes[memoryType].heapIndex;
+  MemoryResourceKind kind = static_cast<MemoryResourceKind>(
+      (pool - pools_.data()) % kMemoryResourceKindCount);
+  std::unique_ptr<MemoryBlock> block(
+      new MemoryBlock(memoryType, kind, blockSize_[heap]));
+  VkMemoryAllocateInfo allocateInfo{
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .pNext = nullptr,
+      .allocationSize = blockSize_[heap],
+      .memoryTypeIndex = memoryType,
+  };
+  if (vkAllocateMemory(device_, &allocateInfo, nullptr, &block->memory) !=
+      VK_SUCCESS) {
+    return nullptr;
+  }
+  budget_.RecordMemory(memoryType, blockSize_[heap]);
+  block->mapped = MapWhole(memoryType, block->memory);
+  pool->blocks.push_back(std::move(block));
+  return pool->blocks.back().get();
+}
+
+bool MemoryAllocator::AllocateDedicated(VkDeviceSize size,
+                                        uint32_t memoryType,
+                                        MemoryAllocation* allocation) {
+  VkMemoryAllocateInfo allocateInfo{
+      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+      .pNext = nullptr,
+      .allocationSize = size,
+      .memoryTypeIndex = memoryType,
+  };
+  if (vkAllocateMemory(device_, &allocateInfo, nullptr,
+                       &allocation->memory) != VK_SUCCESS) {
+    return false;
+  }
+  allocation->offset = 0;
+  allocation->size = size;
+  allocation->memoryType = memoryType;
+  allocation->mapped = MapWhole(memoryType, allocation->memory);
+  allocation->block_ = nullptr;
+  allocation->node_ = TlsfHeap::kNoNode;
+  dedicatedCount_++;
+  dedicatedBytes_ += size;
+  budget_.RecordMemory(memoryType, size);
+  budget_.RecordAllocation(memoryType, size);
+  return true;
+}
+
+bool MemoryAllocator::Allocate(const VkMemoryRequirements& requirements,
+                               uint32_t memoryType, MemoryResourceKind kind,
+                               MemoryAllocation* allocation) {
+  memset(allocation, 0, sizeof(*allocation));
+  if (memoryType >= properties_.memoryTypeCount) return false;
+  VkDeviceSize size = requirements.size;
+  VkDeviceSize alignment = requirements.alignment ? requirements.alignment : 1;
+
+  // Flushes and invalidates are in whole atoms, so no two allocations
+  // share one
+  VkMemoryPropertyFlags flags =
+      properties_.memoryTypes[memoryType].propertyFlags;
+  if ((flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && NeedsFlush(flags) &&
+      nonCoherentAtomSize_ > 1) {
+    if (alignment < nonCoherentAtomSize_) alignment = nonCoherentAtomSize_;
+    size = AlignUp(size, nonCoherentAtomSize_);
+  }
+
+  uint32_t heap = properties_.memoryTypes[memoryType].heapIndex;
+  if (size > blockSize_[heap] / 2) {
+    return AllocateDedicated(size, memoryType, allocation);
+  }
+
+  Pool& pool = PoolFor(memoryType, kind);
+  MemoryBlock* block = nullptr;
+  uint32_t node = TlsfHeap::kNoNode;
+  uint64_t offset = 0;
+  for (std::unique_ptr<MemoryBlock>& candidate : pool.blocks) {
+    node = candidate->heap.Allocate(size, alignment, &offset);
+    if (node != TlsfHeap::kNoNode) {
+      block = candidate.get();
+      break;
+    }
+  }
+  if (!block) {
+    block = NewBlock(memoryType, &pool);
+    if (!block) return false;
+    node = block->heap.Allocate(size, alignment, &offset);
+  }
+
+  allocation->memory = block->memory;
+  allocation->offset = offset;
+  allocation->size = size;
+  allocation->memoryType = memoryType;
+  allocation->mapped =
+      block->mapped ? static_cast<char*>(block->mapped) + offset : nullptr;
+  allocation->block_ = block;
+  allocation->node_ = node;
+  budget_.RecordAllocation(memoryType, size);
+  return true;
+}
+
+bool MemoryAllocator::AllocateForBuffer(VkBuffer buffer, MemoryUsage usage,
+                                        MemoryAllocation* allocation) {
+  VkMemoryRequirements requirements;
+  vkGetBufferMemoryRequirements(device_, buffer, &requirements);
+  uint32_t memoryType =
+      selector_.Select(usage, requirements.memoryTypeBits);
+  if (!Allocate(requirements, memoryType, kMemoryLinear, allocation)) {
+    return false;
+  }
+  if (vkBindBufferMemory(device_, buffer, allocation->memory,
+                         allocation->offset) != VK_SUCCESS) {
+    Free(allocation);
+    return false;
+  }
+  return true;
+}
+
+bool MemoryAllocator::AllocateForImage(VkImage image, VkImageTiling tiling,
+                                       MemoryUsage usage,
+                                       MemoryAllocation* allocation) {
+  VkMemoryRequirements requirements;
+  vkGetImageMemoryRequirements(device_, image, &requirements);
+  uint32_t memoryType =
+      selector_.Select(usage, requirements.memoryTypeBits);
+  MemoryResourceKind kind = (tiling == VK_IMAGE_TILING_OPTIMAL)
+                                ? kMemoryOptimal
+                                : kMemoryLinear;
+  if (!Allocate(requirements, memoryType, kind, allocation)) return false;
+  if (vkBindImageMemory(device_, image, allocation->memory,
+                        allocation->offset) != VK_SUCCESS) {
+    Free(allocation);
+    return false;
+  }
+  return true;
+}
+
+void MemoryAllocator::Free(MemoryAllocation* allocation) {
+  if (allocation->memory == VK_NULL_HANDLE) return;
+  budget_.ReleaseAllocation(allocation->memoryType, allocation->size);
+  MemoryBlock* block = allocation->block_;
+  if (!block) {
+    vkFreeMemory(device_, allocation->memory, nullptr);
+    budget_.ReleaseMemory(allocation->memoryType, allocation->size);
+    dedicatedCount_--;
+    dedicatedBytes_ -= allocation->size;
+  } else {
+    block->heap.Free(allocation->node_);
+    // Keep one block per pool around, so a pool going back and forth
+    // between empty and not does not allocate every time
+    Pool& pool = PoolFor(block->memoryType, block->kind);
+    if (!block->heap.AllocationCount() && pool.blocks.size() > 1) {
+      for (size_t i = 0; i < pool.blocks.size(); i++) {
+        if (pool.blocks[i].get() != block) continue;
+        vkFreeMemory(device_, block->memory, nullptr);
+        budget_.ReleaseMemory(block->memoryType, block->heap.Size());
+        pool.blocks.erase(pool.blocks.begin() + i);
+        break;
+      }
+    }
+  }
+  memset(allocation, 0, sizeof(*allocation));
+}
+
+void MemoryAllocator::Flush(const MemoryAllocation& allocation,
+                            VkDeviceSize offset, VkDeviceSize size) {
+  VkMemoryPropertyFlags flags =
+      properties_.memoryTypes[allocation.memoryType].propertyFlags;
+  if (!size || !NeedsFlush(flags)) return;
+  VkDeviceSize atom = nonCoherentAtomSize_ ? nonCoherentAtomSize_ : 1;
+  VkDeviceSize start = (allocation.offset + offset) & ~(atom - 1);
+  VkDeviceSize end = std::min(AlignUp(allocation.offset + offset + size, atom),
+                              allocation.offset + allocation.size);
+  VkMappedMemoryRange range{
+      .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+      .pNext = nullptr,
+      .memory = allocation.memory,
+      .offset = start,
+      .size = end - start,
+  };
+  vkFlushMappedMemoryRanges(device_, 1, &range);
+}
+
+void MemoryAllocator::GetStats(Stats* stats) const {
+  memset(stats, 0, sizeof(*stats));
+  for (const Pool& pool : pools_) {
+    for (const std::unique_ptr<MemoryBlock>& block : pool.blocks) {
+      stats->blockCount++;
+      stats->allocationCount += block->heap.AllocationCount();
+      stats->blockBytes += block->heap.Size();
+      stats->usedBytes += block->heap.Size() - block->heap.FreeBytes();
+    }
+  }
+  stats->dedicatedCount = dedicatedCount_;
+  stats->allocationCount += dedicatedCount_;
+  stats->dedicatedBytes = dedicatedBytes_;
+}
@@ -0,0 +1,126 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEMORY_ALLOCATOR_HPP
+#define MEMORY_ALLOCATOR_HPP
+
+#include <vulkan_wrapper.h>
+#include <memory>
+#include <vector>
+#include "MemoryBudget.hpp"
+#include "MemoryTypeSelector.hpp"
+#include "TlsfHeap.hpp"
+
+struct MemoryBlock;
+
+// A range of a VkDeviceMemory, bound to one buffer or image
+struct MemoryAllocation {
+  VkDeviceMemory memory;
+  VkDeviceSize offset;
+  VkDeviceSize size;
+  uint32_t memoryType;
+  // The range, mapped, if its memory type is host visible; blocks stay
+  // mapped for their lifetime, so there is nothing to unmap
+  void* mapped;
+
+  MemoryBlock* block_;  // nullptr for a dedicated allocation
+  uint32_t node_;
+};
+
+// Buffers and images bound to linear memory next to optimally tiled images
+// have to be bufferImageGranularity apart; they get pools of their own
+// where the device has such a granularity.
+enum MemoryResourceKind {
+  kMemoryLinear,   // buffers and VK_IMAGE_TILING_LINEAR images
+  kMemoryOptimal,  // VK_IMAGE_TILING_OPTIMAL images
+  kMemoryResourceKindCount,
+};
+
+// Sub-allocates buffers and images from a few large VkDeviceMemory blocks
+// per memory type, rather than a vkAllocateMemory() each: those are slow,
+// and capped at maxMemoryAllocationCount, 4096 on many devices. Ranges are
+// placed by a TlsfHeap per block; a resource larger than half a block gets
+// a dedicated allocation. Blocks and allocations are accounted for in
+// Budget(). Not thread safe.
+class MemoryAllocator {
+ public:
+  struct Stats {
+    uint32_t blockCount;
+    uint32_t dedicatedCount;  // allocations with a VkDeviceMemory each
+    uint32_t allocationCount;
+    VkDeviceSize blockBytes;  // allocated from the device, in blocks
+    VkDeviceSize usedBytes;   // in blocks, by live allocations
+    VkDeviceSize dedicatedBytes;
+  };
+
+  // Blocks are |blockSize|, or an eighth of the heap on heaps under 1 GiB.
+  // Budget() queries VK_EXT_memory_budget if |budgetSupport| has it, which
+  // may be nullptr.
+  MemoryAllocator(VkPhysicalDevice gpu, VkDevice device,
+                  const MemoryBudgetSupport* budgetSupport,
+                  VkDeviceSize blockSize = kDefaultBlockSize);
+  // Frees every block; free the allocations beforehand
+  ~MemoryAllocator();
+
+  // Picks the memory types AllocateForBuffer() and AllocateForImage() use
+  const MemoryTypeSelector& Selector(void) const { return selector_; }
+  MemoryBudget& Budget(void) { return budget_; }
+
+  bool Allocate(const VkMemoryRequirements& requirements, uint32_t memoryType,
+                MemoryResourceKind kind, MemoryAllocation* allocation);
+  // Allocate() for |buffer| or |image|, in the memory type Selector()
+  // picks for |usage|, and bind it
+  bool AllocateForBuffer(VkBuffer buffer, MemoryUsage usage,
+                         MemoryAllocation* allocation);
+  bool AllocateForImage(VkImage image, VkImageTiling tiling,
+                        MemoryUsage usage, MemoryAllocation* allocation);
+  // Takes a zeroed |allocation| too, as the handles' destroy calls take
+  // VK_NULL_HANDLE
+  void Free(MemoryAllocation* allocation);
+
+  // Makes CPU writes to |size| bytes at |offset| into |allocation| visible
+  // to the device, widened to whole nonCoherentAtomSize atoms, which
+  // Allocate() keeps to the allocation; nothing to do on coherent memory,
+  // but in ENABLE_VULKAN_CAPTURE builds, for the trace to get the writes
+  void Flush(const MemoryAllocation& allocation, VkDeviceSize offset,
+             VkDeviceSize size);
+
+  void GetStats(Stats* stats) const;
+
+  static const VkDeviceSize kDefaultBlockSize = 64ull << 20;
+
+ private:
+  struct Pool {
+    std::vector<std::unique_ptr<MemoryBlock>> blocks;
+  };
+
+  Pool& PoolFor(uint32_t memoryType, MemoryResourceKind kind);
+  bool AllocateDedicated(VkDeviceSize size, uint32_t memoryType,
+                         MemoryAllocation* allocation);
+  MemoryBlock* NewBlock(uint32_t memoryType, Pool* pool);
+  void* MapWhole(uint32_t memoryType, VkDeviceMemory memory);
+
+  VkDevice device_;
+  VkPhysicalDeviceMemoryProperties properties_;
+  MemoryTypeSelector selector_;
+  MemoryBudget budget_;
+  VkDeviceSize bufferImageGranularity_;
+  VkDeviceSize nonCoherentAtomSize_;
+  VkDeviceSize blockSize_[VK_MAX_MEMORY_HEAPS];
+  std::vector<Pool> pools_;
+  uint32_t dedicatedCount_;
+  VkDeviceSize dedicatedBytes_;
+};
+
+#endif  // MEMORY_ALLOCATOR_HPP
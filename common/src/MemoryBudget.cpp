@@ -0,0 +1,181 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "MemoryBudget.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+bool HasExtension(const std::vector<VkExtensionProperties>& extensions,
+                  const char* name) {
+  for (const VkExtensionProperties& extension : extensions) {
+    if (!strcmp(extension.extensionName, name)) return true;
+  }
+  return false;
+}
+
+// Without the extension, leave a fifth of each heap to the rest of the
+// system
+VkDeviceSize EstimatedBudget(VkDeviceSize heapSize) {
+  return heapSize / 10 * 8;
+}
+
+}  // namespace
+
+void QueryMemoryBudget(VkInstance instance, VkPhysicalDevice gpu,
+                       uint32_t instanceVersion,
+                       std::vector<const char*>* extensions,
+                       MemoryBudgetSupport* support) {
+  memset(support, 0, sizeof(*support));
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(gpu, &properties);
+  if (std::min(properties.apiVersion, instanceVersion) < VK_API_VERSION_1_1) {
+    return;
+  }
+
+  uint32_t extensionCount = 0;
+  vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount,
+                                       nullptr);
+  std::vector<VkExtensionProperties> deviceExtensions(extensionCount);
+  vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount,
+                                       deviceExtensions.data());
+  if (!HasExtension(deviceExtensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+    return;
+  }
+  support->getMemoryProperties2 =
+      reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2>(
+          vkGetInstanceProcAddr(instance,
+                                "vkGetPhysicalDeviceMemoryProperties2"));
+  if (!support->getMemoryProperties2) return;
+
+  extensions->push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+  support->supported = true;
+}
+
+MemoryBudget::MemoryBudget(void) : gpu_(VK_NULL_HANDLE) {
+  memset(&properties_, 0, sizeof(properties_));
+  memset(&support_, 0, sizeof(support_));
+}
+
+MemoryBudget::MemoryBudget(VkPhysicalDevice gpu,
+                           const VkPhysicalDeviceMemoryProperties& properties,
+                           const MemoryBudgetSupport* support)
+    : gpu_(gpu), properties_(properties) {
+  memset(&support_, 0, sizeof(support_));
+  if (support) support_ = *support;
+  heaps_.resize(properties_.memoryHeapCount);
+  allocatedAtUpdate_.assign(properties_.memoryHeapCount, 0);
+  for (uint32_t i = 0; i < properties_.memoryHeapCount; i++) {
+    HeapBudget& heap = heaps_[i];
+    memset(&heap, 0, sizeof(heap));
+    heap.size = properties_.memoryHeaps[i].size;
+    heap.flags = properties_.memoryHeaps[i].flags;
+    heap.budget = EstimatedBudget(heap.size);
+  }
+  Update();
+}
+
+void MemoryBudget::RecordMemory(uint32_t memoryType, VkDeviceSize size) {
+  HeapBudget& heap = heaps_[HeapOf(memoryType)];
+  heap.allocatedBytes += size;
+  heap.memoryCount++;
+  heap.peakBytes = std::max(heap.peakBytes, heap.allocatedBytes);
+}
+
+void MemoryBudget::ReleaseMemory(uint32_t memoryType, VkDeviceSize size) {
+  HeapBudget& heap = heaps_[HeapOf(memoryType)];
+  assert(heap.memoryCount && heap.allocatedBytes >= size);
+  heap.allocatedBytes -= size;
+  heap.memoryCount--;
+}
+
+void MemoryBudget::RecordAllocation(uint32_t memoryType, VkDeviceSize size) {
+  HeapBudget& heap = heaps_[HeapOf(memoryType)];
+  heap.boundBytes += size;
+  heap.allocationCount++;
+}
+
+void MemoryBudget::ReleaseAllocation(uint32_t memoryType, VkDeviceSize size) {
+  HeapBudget& heap = heaps_[HeapOf(memoryType)];
+  assert(heap.allocationCount && heap.boundBytes >= size);
+  heap.boundBytes -= size;
+  heap.allocationCount--;
+}
+
+void MemoryBudget::Update(void) {
+  if (!support_.supported) return;
+  VkPhysicalDeviceMemoryBudgetPropertiesEXT budget;
+  memset(&budget, 0, sizeof(budget));
+  budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+  VkPhysicalDeviceMemoryProperties2 properties{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+      .pNext = &budget,
+  };
+  support_.getMemoryProperties2(gpu_, &properties);
+  for (uint32_t i = 0; i < heaps_.size(); i++) {
+    // Drivers have reported 0 for heaps they do not track
+    heaps_[i].budget = budget.heapBudget[i]
+                           ? budget.heapBudget[i]
+                           : EstimatedBudget(heaps_[i].size);
+    heaps_[i].usage = budget.heapUsage[i];
+    allocatedAtUpdate_[i] = heaps_[i].allocatedBytes;
+  }
+}
+
+void MemoryBudget::GetHeap(uint32_t heap, HeapBudget* budget) const {
+  *budget = heaps_[heap];
+  if (!support_.supported) {
+    budget->usage = budget->allocatedBytes;
+    return;
+  }
+  // What the driver reported, give or take what was allocated since
+  VkDeviceSize allocated = budget->allocatedBytes;
+  VkDeviceSize atUpdate = allocatedAtUpdate_[heap];
+  if (allocated >= atUpdate) {
+    budget->usage += allocated - atUpdate;
+  } else {
+    budget->usage -= std::min(budget->usage, atUpdate - allocated);
+  }
+}
+
+std::string MemoryBudget::Json(void) const {
+  std::string json = support_.supported ? "{\"budgetExtension\": true"
+                                        : "{\"budgetExtension\": false";
+  json += ", \"heaps\": [";
+  for (uint32_t i = 0; i < HeapCount(); i++) {
+    HeapBudget heap;
+    GetHeap(i, &heap);
+    char entry[512];
+    snprintf(entry, sizeof(entry),
+             "%s{\"index\": %u, \"deviceLocal\": %s, \"size\": %llu, "
+             "\"budget\": %llu, \"usage\": %llu, \"allocatedBytes\": %llu, "
+             "\"peakBytes\": %llu, \"boundBytes\": %llu, "
+             "\"memoryCount\": %u, \"allocationCount\": %u}",
+             i ? ", " : "", i,
+             (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? "true" : "false",
+             static_cast<unsigned long long>(heap.size),
+             static_cast<unsigned long long>(heap.budget),
+             static_cast<unsigned long long>(heap.usage),
+             static_cast<unsigned long long>(heap.allocatedBytes),
+             static_cast<unsigned long long>(heap.peakBytes),
+             static_cast<unsigned long long>(heap.boundBytes),
+             heap.memoryCount, heap.allocationCount);
+    json += entry;
+  }
+  json += "]}";
+  return json;
+}
@@ -0,0 +1,101 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEMORY_BUDGET_HPP
+#define MEMORY_BUDGET_HPP
+
+#include <vulkan_wrapper.h>
+#include <string>
+#include <vector>
+
+// VK_EXT_memory_budget reports, per heap, how much memory the process can
+// use before the system starts evicting or killing it, and how much it
+// uses, the driver's own allocations included.
+struct MemoryBudgetSupport {
+  bool supported;
+  // To query them with, when |supported|
+  PFN_vkGetPhysicalDeviceMemoryProperties2 getMemoryProperties2;
+};
+
+// Fills |support| for |gpu| on an instance created for |instanceVersion|,
+// and adds the extension to |extensions| if the device has it. It takes a
+// 1.1 device and instance, for vkGetPhysicalDeviceMemoryProperties2().
+void QueryMemoryBudget(VkInstance instance, VkPhysicalDevice gpu,
+                       uint32_t instanceVersion,
+                       std::vector<const char*>* extensions,
+                       MemoryBudgetSupport* support);
+
+struct HeapBudget {
+  VkDeviceSize size;
+  VkMemoryHeapFlags flags;
+  // From VK_EXT_memory_budget, as of the last Update() plus what was
+  // allocated and freed here since; without it, 80% of the heap and
+  // |allocatedBytes|
+  VkDeviceSize budget;
+  VkDeviceSize usage;
+  VkDeviceSize allocatedBytes;  // in live VkDeviceMemory objects
+  VkDeviceSize peakBytes;       // the most |allocatedBytes| has been
+  VkDeviceSize boundBytes;      // of |allocatedBytes|, by live resources
+  uint32_t memoryCount;         // live VkDeviceMemory objects
+  uint32_t allocationCount;     // live resources
+};
+
+// Accounts for each VkDeviceMemory the app allocates, and the resources
+// bound to it, per heap. MemoryAllocator records its blocks and
+// allocations; what allocates around it, as CreateDepthBuffer() does, can
+// record itself. Not thread safe.
+class MemoryBudget {
+ public:
+  // Tracks no heaps until assigned one made for the device
+  MemoryBudget(void);
+  MemoryBudget(VkPhysicalDevice gpu,
+               const VkPhysicalDeviceMemoryProperties& properties,
+               const MemoryBudgetSupport* support);
+
+  // After vkAllocateMemory() and before vkFreeMemory()
+  void RecordMemory(uint32_t memoryType, VkDeviceSize size);
+  void ReleaseMemory(uint32_t memoryType, VkDeviceSize size);
+  // A resource bound to |size| bytes of memory recorded above
+  void RecordAllocation(uint32_t memoryType, VkDeviceSize size);
+  void ReleaseAllocation(uint32_t memoryType, VkDeviceSize size);
+
+  // Queries the budget and usage again. Other processes and the driver
+  // change them, but the query is not free: call it every so often, not
+  // per allocation.
+  void Update(void);
+
+  bool Queried(void) const { return support_.supported; }
+  uint32_t HeapCount(void) const {
+    return static_cast<uint32_t>(heaps_.size());
+  }
+  void GetHeap(uint32_t heap, HeapBudget* budget) const;
+
+  // {"budgetExtension": true, "heaps": [{"index": 0, "size": ..., ...}]},
+  // with each HeapBudget field
+  std::string Json(void) const;
+
+ private:
+  uint32_t HeapOf(uint32_t memoryType) const {
+    return properties_.memoryTypes[memoryType].heapIndex;
+  }
+
+  VkPhysicalDevice gpu_;
+  VkPhysicalDeviceMemoryProperties properties_;
+  MemoryBudgetSupport support_;
+  std::vector<HeapBudget> heaps_;
+  // allocatedBytes when |usage| was last queried
+  std::vector<VkDeviceSize> allocatedAtUpdate_;
+};
+
+#endif  // MEMORY_BUDGET_HPP
@@ -0,0 +1,137 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "MemoryTypeSelector.hpp"
+#include <algorithm>
+#include <cstring>
+
+const uint32_t MemoryTypeSelector::kNoType;
+const uint32_t MemoryTypeSelector::kMaxTableTypes;
+
+namespace {
+
+const uint8_t kNoTableEntry = 0xFF;
+
+struct UsageFlags {
+  VkMemoryPropertyFlags required;
+  VkMemoryPropertyFlags preferred;
+  VkMemoryPropertyFlags unwanted;
+};
+
+// Lazily allocated memory only backs transient attachments, and protected
+// memory needs the protectedMemory feature; neither is ever unwanted only
+const VkMemoryPropertyFlags kForbidden =
+    VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT | VK_MEMORY_PROPERTY_PROTECTED_BIT;
+
+const UsageFlags kUsageFlags[kMemoryUsageCount] = {
+    // kMemoryUsageGpuOnly
+    {0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT},
+    // kMemoryUsageUpload
+    {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+     VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT},
+    // kMemoryUsageDynamic
+    {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+     VK_MEMORY_PROPERTY_HOST_CACHED_BIT},
+    // kMemoryUsageReadback
+    {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+     VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+     0},
+    // kMemoryUsageTransient
+    {0,
+     VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT |
+         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+     VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT},
+};
+
+uint32_t BitCount(VkMemoryPropertyFlags flags) {
+  return __builtin_popcount(flags);
+}
+
+}  // namespace
+
+MemoryTypeSelector::MemoryTypeSelector(void) {
+  memset(&properties_, 0, sizeof(properties_));
+}
+
+MemoryTypeSelector::MemoryTypeSelector(
+    const VkPhysicalDeviceMemoryProperties& properties)
+    : properties_(properties) {
+  uint32_t typeCount = properties_.memoryTypeCount;
+  for (uint32_t usage = 0; usage < kMemoryUsageCount; usage++) {
+    const UsageFlags& flags = kUsageFlags[usage];
+    VkMemoryPropertyFlags forbidden = kForbidden & ~flags.preferred;
+    std::vector<uint8_t>& ranked = ranked_[usage];
+    for (uint32_t type = 0; type < typeCount; type++) {
+      VkMemoryPropertyFlags typeFlags = Flags(type);
+      if ((typeFlags & flags.required) != flags.required) continue;
+      if (typeFlags & forbidden) continue;
+      ranked.push_back(static_cast<uint8_t>(type));
+    }
+    MemoryUsage memoryUsage = static_cast<MemoryUsage>(usage);
+    std::stable_sort(ranked.begin(), ranked.end(),
+                     [this, memoryUsage](uint8_t type, uint8_t other) {
+                       return Better(memoryUsage, type, other);
+                     });
+    if (typeCount > kMaxTableTypes) continue;
+
+    // Each entry is the better of the lowest type and the entry for the
+    // other types, which comes earlier in the table
+    std::vector<uint8_t> rank(typeCount, kNoTableEntry);
+    for (size_t i = 0; i < ranked.size(); i++) {
+      rank[ranked[i]] = static_cast<uint8_t>(i);
+    }
+    std::vector<uint8_t>& table = table_[usage];
+    table.assign(1u << typeCount, kNoTableEntry);
+    for (uint32_t bits = 1; bits < table.size(); bits++) {
+      uint8_t best = table[bits & (bits - 1)];
+      uint8_t lowest = static_cast<uint8_t>(__builtin_ctz(bits));
+      if (rank[lowest] != kNoTableEntry &&
+          (best == kNoTableEntry || rank[lowest] < rank[best])) {
+        best = lowest;
+      }
+      table[bits] = best;
+    }
+  }
+}
+
+bool MemoryTypeSelector::Better(MemoryUsage usage, uint32_t type,
+                                uint32_t other) const {
+  const UsageFlags& flags = kUsageFlags[usage];
+  uint32_t preferred = BitCount(Flags(type) & flags.preferred);
+  uint32_t otherPreferred = BitCount(Flags(other) & flags.preferred);
+  if (preferred != otherPreferred) return preferred > otherPreferred;
+  uint32_t unwanted = BitCount(Flags(type) & flags.unwanted);
+  uint32_t otherUnwanted = BitCount(Flags(other) & flags.unwanted);
+  if (unwanted != otherUnwanted) return unwanted < otherUnwanted;
+  VkDeviceSize heap =
+      properties_.memoryHeaps[properties_.memoryTypes[type].heapIndex].size;
+  VkDeviceSize otherHeap =
+      properties_.memoryHeaps[properties_.memoryTypes[other].heapIndex].size;
+  return heap > otherHeap;
+}
+
+uint32_t MemoryTypeSelector::Select(MemoryUsage usage,
+                                    uint32_t typeBits) const {
+  const std::vector<uint8_t>& table = table_[usage];
+  if (!table.empty()) {
+    uint8_t type = table[typeBits & (table.size() - 1)];
+    return (type == kNoTableEntry) ? kNoType : type;
+  }
+  for (uint8_t type : ranked_[usage]) {
+    if (typeBits & (1u << type)) return type;
+  }
+  return kNoType;
+}
@@ -0,0 +1,71 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEMORY_TYPE_SELECTOR_HPP
+#define MEMORY_TYPE_SELECTOR_HPP
+
+#include <vulkan_wrapper.h>
+#include <vector>
+
+// What a resource's memory is for, which decides the memory type it goes in
+enum MemoryUsage {
+  kMemoryUsageGpuOnly,    // written and read by the GPU only
+  kMemoryUsageUpload,     // staging: written once by the CPU, copied from
+  kMemoryUsageDynamic,    // written by the CPU, read by shaders
+  kMemoryUsageReadback,   // written by the GPU, read by the CPU
+  kMemoryUsageTransient,  // TRANSIENT_ATTACHMENT images
+  kMemoryUsageCount,
+};
+
+// Picks the memory type for a usage out of a resource's memoryTypeBits.
+// Each usage has flags a type must have, flags it should have and flags it
+// should not: HOST_CACHED for memory the CPU only writes, DEVICE_LOCAL for
+// staging, which would take the small host visible part of a discrete
+// GPU's memory. Types are ranked by the most preferred flags, then the
+// fewest unwanted ones, then the largest heap. On a unified memory GPU,
+// where every type is device local, that leaves the uncached coherent type
+// for CPU writes and the cached one for reads.
+//
+// The ranking is done once: for up to kMaxTableTypes memory types, which
+// covers mobile GPUs, into a table indexed by memoryTypeBits, so Select()
+// is a lookup; past that, Select() walks the ranked types.
+class MemoryTypeSelector {
+ public:
+  static const uint32_t kNoType = ~0u;
+  static const uint32_t kMaxTableTypes = 10;
+
+  // Selects nothing until assigned one made from the device's properties
+  MemoryTypeSelector(void);
+  explicit MemoryTypeSelector(
+      const VkPhysicalDeviceMemoryProperties& properties);
+
+  // The best type in |typeBits| for |usage|, or kNoType if none has the
+  // flags |usage| requires
+  uint32_t Select(MemoryUsage usage, uint32_t typeBits) const;
+
+  VkMemoryPropertyFlags Flags(uint32_t type) const {
+    return properties_.memoryTypes[type].propertyFlags;
+  }
+
+ private:
+  bool Better(MemoryUsage usage, uint32_t type, uint32_t other) const;
+
+  VkPhysicalDeviceMemoryProperties properties_;
+  // Best first, types without the required flags left out
+  std::vector<uint8_t> ranked_[kMemoryUsageCount];
+  // memoryTypeBits to type, or 0xFF for none; empty past kMaxTableTypes
+  std::vector<uint8_t> table_[kMemoryUsageCount];
+};
+
+#endif  // MEMORY_TYPE_SELECTOR_HPP
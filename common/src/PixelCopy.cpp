@@ -0,0 +1,424 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "PixelCopy.hpp"
+#include <cassert>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PIXEL_COPY_X86 1
+#include <immintrin.h>
+// The SIMD rows are built for their instruction set whatever the baseline
+// is, and only picked where the CPU has it
+#define PIXEL_COPY_TARGET(isa) __attribute__((target(isa)))
+#elif defined(__ARM_NEON)
+#define PIXEL_COPY_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+// Each converts one row of |width| pixels
+typedef void (*RowFunction)(const uint8_t* src, uint8_t* dst,
+                            uint32_t width);
+
+// Averages pixels 2x and 2x + 1 of rows |top| and |bottom| into pixel x of
+// |dst|, for the |dstWidth| pixels of the row a level down
+typedef void (*DownsampleRowFunction)(const uint8_t* top,
+                                      const uint8_t* bottom, uint8_t* dst,
+                                      uint32_t dstWidth);
+
+struct RowFunctions {
+  RowFunction expand;       // RGB to opaque RGBA
+  RowFunction premultiply;  // RGBA to premultiplied RGBA
+  DownsampleRowFunction downsample;
+};
+
+// c * a / 255, rounded to nearest, exactly, without a division
+inline uint8_t MultiplyAlpha(uint32_t c, uint32_t a) {
+  uint32_t t = c * a + 128;
+  return static_cast<uint8_t>((t + (t >> 8)) >> 8);
+}
+
+void ExpandRowScalar(const uint8_t* src, uint8_t* dst, uint32_t width) {
+  for (uint32_t x = 0; x < width; x++, src += 3, dst += 4) {
+    dst[0] = src[0];
+    dst[1] = src[1];
+    dst[2] = src[2];
+    dst[3] = 0xFF;
+  }
+}
+
+void PremultiplyRowScalar(const uint8_t* src, uint8_t* dst, uint32_t width) {
+  for (uint32_t x = 0; x < width; x++, src += 4, dst += 4) {
+    uint32_t a = src[3];
+    dst[0] = MultiplyAlpha(src[0], a);
+    dst[1] = MultiplyAlpha(src[1], a);
+    dst[2] = MultiplyAlpha(src[2], a);
+    dst[3] = static_cast<uint8_t>(a);
+  }
+}
+
+void DownsampleRowScalar(const uint8_t* top, const uint8_t* bottom,
+                         uint8_t* dst, uint32_t dstWidth) {
+  for (uint32_t i = 0; i < dstWidth * 4; i++, dst++) {
+    uint32_t c = i + (i & ~3u);  // channel i % 4 of pixel 2 * (i / 4)
+    *dst = static_cast<uint8_t>(
+        (top[c] + top[c + 4] + bottom[c] + bottom[c + 4] + 2) >> 2);
+  }
+}
+
+#ifdef PIXEL_COPY_X86
+
+// Moves 4 RGB pixels to the color bytes of 4 RGBA ones; -1 zeroes alpha
+#define PIXEL_COPY_EXPAND_SHUFFLE \
+  0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+
+PIXEL_COPY_TARGET("ssse3")
+void ExpandRowSsse3(const uint8_t* src, uint8_t* dst, uint32_t width) {
+  const __m128i shuffle = _mm_setr_epi8(PIXEL_COPY_EXPAND_SHUFFLE);
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+  uint32_t x = 0;
+  // A load takes 16 bytes for the 12 used: stop 2 pixels short of the end
+  for (; x + 6 <= width; x += 4, src += 12, dst += 16) {
+    __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), rgba);
+  }
+  ExpandRowScalar(src, dst, width - x);
+}
+
+// Premultiplies the 2 pixels in each 64 bits of |pixels|, widened to 16
+// bits a channel; alpha is multiplied by 255, which keeps it
+PIXEL_COPY_TARGET("ssse3")
+inline __m128i PremultiplyWide(__m128i pixels) {
+  const __m128i colorMask = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+  const __m128i opaque = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+  __m128i alpha = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+      _MM_SHUFFLE(3, 3, 3, 3));
+  alpha = _mm_or_si128(_mm_and_si128(alpha, colorMask), opaque);
+  __m128i t = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha),
+                            _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+PIXEL_COPY_TARGET("ssse3")
+void PremultiplyRowSsse3(const uint8_t* src, uint8_t* dst, uint32_t width) {
+  const __m128i zero = _mm_setzero_si128();
+  uint32_t x = 0;
+  for (; x + 4 <= width; x += 4, src += 16, dst += 16) {
+    __m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i low = PremultiplyWide(_mm_unpacklo_epi8(rgba, zero));
+    __m128i high = PremultiplyWide(_mm_unpackhi_epi8(rgba, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_packus_epi16(low, high));
+  }
+  PremultiplyRowScalar(src, dst, width - x);
+}
+
+PIXEL_COPY_TARGET("avx2")
+void ExpandRowAvx2(const uint8_t* src, uint8_t* dst, uint32_t width) {
+  const __m256i shuffle = _mm256_setr_epi8(PIXEL_COPY_EXPAND_SHUFFLE,
+                                           PIXEL_COPY_EXPAND_SHUFFLE);
+  const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+  uint32_t x = 0;
+  // 8 pixels from 2 loads 12 bytes apart, the second reading 4 bytes past
+  // them: stop 2 pixels short of the end
+  for (; x + 10 <= width; x += 8, src += 24, dst += 32) {
+    __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    __m128i high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+    __m256i rgb = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high,
+                                          1);
+    __m256i rgba = _mm256_or_si256(_mm256_shuffle_epi8(rgb, shuffle), alpha);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), rgba);
+  }
+  ExpandRowSsse3(src, dst, width - x);
+}
+
+PIXEL_COPY_TARGET("avx2")
+inline __m256i PremultiplyWideAvx2(__m256i pixels) {
+  const __m256i colorMask = _mm256_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0,
+                                              -1, -1, -1, 0, -1, -1, -1, 0);
+  const __m256i opaque = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255,
+                                           0, 0, 0, 255, 0, 0, 0, 255);
+  __m256i alpha = _mm256_shufflehi_epi16(
+      _mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+      _MM_SHUFFLE(3, 3, 3, 3));
+  alpha = _mm256_or_si256(_mm256_and_si256(alpha, colorMask), opaque);
+  __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha),
+                               _mm256_set1_epi16(128));
+  return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+PIXEL_COPY_TARGET("avx2")
+void PremultiplyRowAvx2(const uint8_t* src, uint8_t* dst, uint32_t width) {
+  const __m256i zero = _mm256_setzero_si256();
+  uint32_t x = 0;
+  // Unpacking and packing both work within 128-bit lanes, so the pixels
+  // come back in order
+  for (; x + 8 <= width; x += 8, src += 32, dst += 32) {
+    __m256i rgba =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    __m256i low = PremultiplyWideAvx2(_mm256_unpacklo_epi8(rgba, zero));
+    __m256i high = PremultiplyWideAvx2(_mm256_unpackhi_epi8(rgba, zero));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                        _mm256_packus_epi16(low, high));
+  }
+  PremultiplyRowSsse3(src, dst, width - x);
+}
+
+// Sums 4 pixels of |top| and |bottom| in 2x2 blocks, widened to 16 bits a
+// channel, and rounds the 2 averages
+PIXEL_COPY_TARGET("ssse3")
+inline __m128i DownsampleWide(__m128i top, __m128i bottom) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(top, zero),
+                              _mm_unpacklo_epi8(bottom, zero));
+  __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, zero),
+                               _mm_unpackhi_epi8(bottom, zero));
+  // Each pixel pair, added, in the low 64 bits
+  low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+  high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+  __m128i sum = _mm_unpacklo_epi64(low, high);
+  return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(2)), 2);
+}
+
+PIXEL_COPY_TARGET("ssse3")
+void DownsampleRowSsse3(const uint8_t* top, const uint8_t* bottom,
+                        uint8_t* dst, uint32_t dstWidth) {
+  uint32_t x = 0;
+  for (; x + 4 <= dstWidth; x += 4, top += 32, bottom += 32, dst += 16) {
+    __m128i low = DownsampleWide(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(top)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom)));
+    __m128i high = DownsampleWide(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(top + 16)),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bottom + 16)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                     _mm_packus_epi16(low, high));
+  }
+  DownsampleRowScalar(top, bottom, dst, dstWidth - x);
+}
+
+PIXEL_COPY_TARGET("avx2")
+inline __m256i DownsampleWideAvx2(__m256i top, __m256i bottom) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i low = _mm256_add_epi16(_mm256_unpacklo_epi8(top, zero),
+                                 _mm256_unpacklo_epi8(bottom, zero));
+  __m256i high = _mm256_add_epi16(_mm256_unpackhi_epi8(top, zero),
+                                  _mm256_unpackhi_epi8(bottom, zero));
+  low = _mm256_add_epi16(low, _mm256_srli_si256(low, 8));
+  high = _mm256_add_epi16(high, _mm256_srli_si256(high, 8));
+  __m256i sum = _mm256_unpacklo_epi64(low, high);
+  return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(2)), 2);
+}
+
+PIXEL_COPY_TARGET("avx2")
+void DownsampleRowAvx2(const uint8_t* top, const uint8_t* bottom,
+                       uint8_t* dst, uint32_t dstWidth) {
+  uint32_t x = 0;
+  // Within each 128-bit lane, as DownsampleWide(): the 64-bit pairs of
+  // pixels come out as 0, 2, 1, 3, and are put back in order
+  for (; x + 8 <= dstWidth; x += 8, top += 64, bottom += 64, dst += 32) {
+    __m256i low = DownsampleWideAvx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom)));
+    __m256i high = DownsampleWideAvx2(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + 32)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + 32)));
+    __m256i packed = _mm256_packus_epi16(low, high);
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst),
+        _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  DownsampleRowSsse3(top, bottom, dst, dstWidth - x);
+}
+
+#undef PIXEL_COPY_EXPAND_SHUFFLE
+
+#endif  // PIXEL_COPY_X86
+
+#ifdef PIXEL_COPY_NEON
+
+void ExpandRowNeon(const uint8_t* src, uint8_t* dst, uint32_t width) {
+  uint32_t x = 0;
+  for (; x + 16 <= width; x += 16, src += 48, dst += 64) {
+    uint8x16x3_t rgb = vld3q_u8(src);
+    uint8x16x4_t rgba;
+    rgba.val[0] = rgb.val[0];
+    rgba.val[1] = rgb.val[1];
+    rgba.val[2] = rgb.val[2];
+    rgba.val[3] = vdupq_n_u8(0xFF);
+    vst4q_u8(dst, rgba);
+  }
+  ExpandRowScalar(src, dst, width - x);
+}
+
+// MultiplyAlpha() for 8 channels: (t + ((t + 128) >> 8) + 128) >> 8
+inline uint8x8_t MultiplyAlphaNeon(uint8x8_t c, uint8x8_t a) {
+  uint16x8_t t = vmull_u8(c, a);
+  return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+
+void PremultiplyRowNeon(const uint8_t* src, uint8_t* dst, uint32_t width) {
+  uint32_t x = 0;
+  for (; x + 8 <= width; x += 8, src += 32, dst += 32) {
+    uint8x8x4_t rgba = vld4_u8(src);
+    rgba.val[0] = MultiplyAlphaNeon(rgba.val[0], rgba.val[3]);
+    rgba.val[1] = MultiplyAlphaNeon(rgba.val[1], rgba.val[3]);
+    rgba.val[2] = MultiplyAlphaNeon(rgba.val[2], rgba.val[3]);
+    vst4_u8(dst, rgba);
+  }
+  PremultiplyRowScalar(src, dst, width - x);
+}
+
+// Even and odd pixels come apart as 32-bit lanes; their sums are rounded
+// as they are narrowed
+void DownsampleRowNeon(const uint8_t* top, const uint8_t* bottom,
+                       uint8_t* dst, uint32_t dstWidth) {
+  uint32_t x = 0;
+  for (; x + 4 <= dstWidth; x += 4, top += 32, bottom += 32, dst += 16) {
+    uint32x4x2_t t = vld2q_u32(reinterpret_cast<const uint32_t*>(top));
+    uint32x4x2_t b = vld2q_u32(reinterpret_cast<const uint32_t*>(bottom));
+    uint8x16_t te = vreinterpretq_u8_u32(t.val[0]);
+    uint8x16_t to = vreinterpretq_u8_u32(t.val[1]);
+    uint8x16_t be = vreinterpretq_u8_u32(b.val[0]);
+    uint8x16_t bo = vreinterpretq_u8_u32(b.val[1]);
+    uint16x8_t low =
+        vaddq_u16(vaddl_u8(vget_low_u8(te), vget_low_u8(to)),
+                  vaddl_u8(vget_low_u8(be), vget_low_u8(bo)));
+    uint16x8_t high =
+        vaddq_u16(vaddl_u8(vget_high_u8(te), vget_high_u8(to)),
+                  vaddl_u8(vget_high_u8(be), vget_high_u8(bo)));
+    vst1q_u8(dst, vcombine_u8(vrshrn_n_u16(low, 2), vrshrn_n_u16(high, 2)));
+  }
+  DownsampleRowScalar(top, bottom, dst, dstWidth - x);
+}
+
+#endif  // PIXEL_COPY_NEON
+
+const RowFunctions kRowFunctions[kPixelCopyIsaCount] = {
+    {ExpandRowScalar, PremultiplyRowScalar, DownsampleRowScalar},
+#ifdef PIXEL_COPY_X86
+    {ExpandRowSsse3, PremultiplyRowSsse3, DownsampleRowSsse3},
+    {ExpandRowAvx2, PremultiplyRowAvx2, DownsampleRowAvx2},
+#else
+    {nullptr, nullptr, nullptr},
+    {nullptr, nullptr, nullptr},
+#endif
+#ifdef PIXEL_COPY_NEON
+    {ExpandRowNeon, PremultiplyRowNeon, DownsampleRowNeon},
+#else
+    {nullptr, nullptr, nullptr},
+#endif
+};
+
+PixelCopyIsa currentIsa = kPixelCopyIsaCount;  // not picked yet
+
+}  // namespace
+
+bool PixelCopyIsaSupported(PixelCopyIsa isa) {
+  switch (isa) {
+    case kPixelCopyScalar:
+      return true;
+#ifdef PIXEL_COPY_X86
+    case kPixelCopySsse3:
+      return __builtin_cpu_supports("ssse3");
+    case kPixelCopyAvx2:
+      return __builtin_cpu_supports("avx2");
+#endif
+#ifdef PIXEL_COPY_NEON
+    case kPixelCopyNeon:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+PixelCopyIsa BestPixelCopyIsa(void) {
+  const PixelCopyIsa kPreference[] = {kPixelCopyNeon, kPixelCopyAvx2,
+                                      kPixelCopySsse3};
+  for (PixelCopyIsa isa : kPreference) {
+    if (PixelCopyIsaSupported(isa)) return isa;
+  }
+  return kPixelCopyScalar;
+}
+
+bool SetPixelCopyIsa(PixelCopyIsa isa) {
+  if (!PixelCopyIsaSupported(isa)) return false;
+  currentIsa = isa;
+  return true;
+}
+
+PixelCopyIsa GetPixelCopyIsa(void) {
+  if (currentIsa == kPixelCopyIsaCount) currentIsa = BestPixelCopyIsa();
+  return currentIsa;
+}
+
+const char* PixelCopyIsaName(PixelCopyIsa isa) {
+  const char* kNames[kPixelCopyIsaCount] = {"scalar", "ssse3", "avx2",
+                                            "neon"};
+  return isa < kPixelCopyIsaCount ? kNames[isa] : "unknown";
+}
+
+void CopyPixelsToRgba(const uint8_t* src, uint32_t srcChannels,
+                      uint32_t width, uint32_t height, uint8_t* dst,
+                      uint64_t dstRowPitch, uint32_t flags) {
+  assert(srcChannels == 3 || srcChannels == 4);
+  assert(dstRowPitch >= width * 4ull);
+  const RowFunctions& rows = kRowFunctions[GetPixelCopyIsa()];
+  // RGB comes out opaque, and opaque is premultiplied already; unchanged
+  // RGBA rows are a memcpy(), which is vectorized as it is
+  RowFunction row = nullptr;
+  if (srcChannels == 3) {
+    row = rows.expand;
+  } else if (flags & kPixelCopyPremultiply) {
+    row = rows.premultiply;
+  }
+
+  uint64_t srcRowBytes = static_cast<uint64_t>(width) * srcChannels;
+  for (uint32_t y = 0; y < height; y++, src += srcRowBytes) {
+    uint32_t dstRow = (flags & kPixelCopyFlipY) ? height - 1 - y : y;
+    uint8_t* dstPixels = dst + dstRow * dstRowPitch;
+    if (row) {
+      row(src, dstPixels, width);
+    } else {
+      memcpy(dstPixels, src, width * 4ull);
+    }
+  }
+}
+
+void DownsampleRgba(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                    uint64_t srcRowPitch, uint8_t* dst, uint64_t dstRowPitch) {
+  assert(srcWidth && srcHeight);
+  uint32_t dstWidth = srcWidth > 1 ? srcWidth / 2 : 1;
+  uint32_t dstHeight = srcHeight > 1 ? srcHeight / 2 : 1;
+  assert(srcRowPitch >= srcWidth * 4ull && dstRowPitch >= dstWidth * 4ull);
+  DownsampleRowFunction row = kRowFunctions[GetPixelCopyIsa()].downsample;
+  for (uint32_t y = 0; y < dstHeight; y++, dst += dstRowPitch) {
+    const uint8_t* top = src + 2 * y * srcRowPitch;
+    const uint8_t* bottom = srcHeight > 1 ? top + srcRowPitch : top;
+    if (srcWidth > 1) {
+      row(top, bottom, dst, dstWidth);
+      continue;
+    }
+    // A width of 1 stays 1: only rows are averaged
+    for (uint32_t c = 0; c < 4; c++) {
+      dst[c] = static_cast<uint8_t>((top[c] + bottom[c] + 1) >> 1);
+    }
+  }
+}
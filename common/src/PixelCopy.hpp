@@ -0,0 +1,63 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PIXEL_COPY_HPP
+#define PIXEL_COPY_HPP
+
+#include <cstdint>
+
+// Options for CopyPixelsToRgba()
+enum PixelCopyFlags : uint32_t {
+  kPixelCopyPremultiply = 1 << 0,  // scale color by alpha
+  kPixelCopyFlipY = 1 << 1,        // the first row copied becomes the last
+};
+
+// The instruction sets CopyPixelsToRgba() and DownsampleRgba() have rows
+// processed with
+enum PixelCopyIsa {
+  kPixelCopyScalar,
+  kPixelCopySsse3,
+  kPixelCopyAvx2,
+  kPixelCopyNeon,
+  kPixelCopyIsaCount,
+};
+
+// Copies |width| x |height| pixels of |srcChannels| bytes, 3 for RGB or 4
+// for RGBA, from rows packed one after another, as stb_image returns them,
+// to RGBA rows |dstRowPitch| bytes apart: a mapped linear image, with the
+// rowPitch of its VkSubresourceLayout, or a staging buffer. RGB gets an
+// opaque alpha. Expansion, premultiplication and flipping happen in the
+// one pass over the pixels.
+void CopyPixelsToRgba(const uint8_t* src, uint32_t srcChannels,
+                      uint32_t width, uint32_t height, uint8_t* dst,
+                      uint64_t dstRowPitch, uint32_t flags);
+
+// Averages each 2x2 block of |srcWidth| x |srcHeight| RGBA pixels, rows
+// |srcRowPitch| bytes apart, to one pixel at |dst|, rows |dstRowPitch|
+// bytes apart: the next mip level down, of half the width and height. An
+// odd last row or column is left out, and a side of 1 stays 1.
+void DownsampleRgba(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                    uint64_t srcRowPitch, uint8_t* dst, uint64_t dstRowPitch);
+
+// The fastest of them this CPU runs, which CopyPixelsToRgba() and
+// DownsampleRgba() start with
+PixelCopyIsa BestPixelCopyIsa(void);
+bool PixelCopyIsaSupported(PixelCopyIsa isa);
+// To compare them: returns false, and changes nothing, if |isa| is not
+// supported. Not thread safe with CopyPixelsToRgba() or DownsampleRgba().
+bool SetPixelCopyIsa(PixelCopyIsa isa);
+PixelCopyIsa GetPixelCopyIsa(void);
+const char* PixelCopyIsaName(PixelCopyIsa isa);
+
+#endif  // PIXEL_COPY_HPP
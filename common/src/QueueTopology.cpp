@@ -0,0 +1,212 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "QueueTopology.hpp"
+#include <cassert>
+
+namespace {
+
+const uint32_t kNoFamily = ~0u;
+
+// Every queue is created with the same priority
+const float kQueuePriorities[kQueueRoleCount] = {1.0f, 1.0f, 1.0f};
+
+// The first family with all of |required| and none of |excluded|
+uint32_t FindFamily(const std::vector<VkQueueFamilyProperties>& families,
+                    VkQueueFlags required, VkQueueFlags excluded) {
+  for (uint32_t i = 0; i < families.size(); i++) {
+    VkQueueFlags flags = families[i].queueFlags;
+    if (families[i].queueCount && (flags & required) == required &&
+        !(flags & excluded)) {
+      return i;
+    }
+  }
+  return kNoFamily;
+}
+
+}  // namespace
+
+bool DiscoverQueueTopology(VkPhysicalDevice gpu, VkSurfaceKHR surface,
+                           QueueTopology* topology) {
+  uint32_t familyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(gpu, &familyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> families(familyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(gpu, &familyCount,
+                                           families.data());
+
+  // Graphics: the first family that presents, one with compute if any.
+  // Graphics and compute families can all do transfers, whether they say
+  // so or not.
+  uint32_t graphics = kNoFamily;
+  for (uint32_t i = 0; i < familyCount; i++) {
+    if (!families[i].queueCount ||
+        !(families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+      continue;
+    }
+    if (surface != VK_NULL_HANDLE) {
+      VkBool32 present = VK_FALSE;
+      vkGetPhysicalDeviceSurfaceSupportKHR(gpu, i, surface, &present);
+      if (!present) continue;
+    }
+    if (families[i].queueFlags & VK_QUEUE_COMPUTE_BIT) {
+      graphics = i;
+      break;
+    }
+    if (graphics == kNoFamily) graphics = i;
+  }
+  if (graphics == kNoFamily) return false;
+
+  // Transfer: a DMA engine's family, else an async compute one
+  uint32_t transfer = FindFamily(families, VK_QUEUE_TRANSFER_BIT,
+                                 VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+  if (transfer == kNoFamily) {
+    transfer = FindFamily(families, VK_QUEUE_COMPUTE_BIT,
+                          VK_QUEUE_GRAPHICS_BIT);
+  }
+  if (transfer == kNoFamily) transfer = graphics;
+
+  // Compute: an async compute family, else whichever graphics one has it
+  uint32_t compute = FindFamily(families, VK_QUEUE_COMPUTE_BIT,
+                                VK_QUEUE_GRAPHICS_BIT);
+  if (compute == kNoFamily) {
+    compute = (families[graphics].queueFlags & VK_QUEUE_COMPUTE_BIT)
+                  ? graphics
+                  : FindFamily(families, VK_QUEUE_COMPUTE_BIT, 0);
+  }
+
+  topology->family[kQueueGraphics] = graphics;
+  topology->family[kQueueTransfer] = transfer;
+  topology->family[kQueueCompute] = (compute == kNoFamily) ? graphics : compute;
+
+  // Each role gets the next unused queue of its family, or shares the
+  // family's last one when they run out
+  std::vector<uint32_t> used(familyCount, 0);
+  for (uint32_t role = 0; role < kQueueRoleCount; role++) {
+    uint32_t family = topology->family[role];
+    if (used[family] < families[family].queueCount) {
+      topology->index[role] = used[family]++;
+    } else {
+      topology->index[role] = families[family].queueCount - 1;
+    }
+    topology->queue[role] = VK_NULL_HANDLE;
+  }
+  return true;
+}
+
+std::vector<VkDeviceQueueCreateInfo> QueueCreateInfos(
+    const QueueTopology& topology) {
+  std::vector<VkDeviceQueueCreateInfo> createInfos;
+  for (uint32_t role = 0; role < kQueueRoleCount; role++) {
+    uint32_t family = topology.family[role];
+    uint32_t count = topology.index[role] + 1;
+    bool found = false;
+    for (VkDeviceQueueCreateInfo& createInfo : createInfos) {
+      if (createInfo.queueFamilyIndex != family) continue;
+      if (createInfo.queueCount < count) createInfo.queueCount = count;
+      found = true;
+    }
+    if (found) continue;
+    createInfos.push_back(VkDeviceQueueCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .queueFamilyIndex = family,
+        .queueCount = count,
+        .pQueuePriorities = kQueuePriorities,
+    });
+  }
+  return createInfos;
+}
+
+void GetTopologyQueues(VkDevice device, QueueTopology* topology) {
+  for (uint32_t role = 0; role < kQueueRoleCount; role++) {
+    vkGetDeviceQueue(device, topology->family[role], topology->index[role],
+                     &topology->queue[role]);
+  }
+}
+
+void RecordOwnershipRelease(VkCommandBuffer cmdBuffer,
+                            const ImageOwnershipTransfer& transfer) {
+  RecordOwnershipReleases(cmdBuffer, &transfer, 1);
+}
+
+void RecordOwnershipAcquire(VkCommandBuffer cmdBuffer,
+                            const ImageOwnershipTransfer& transfer) {
+  RecordOwnershipAcquires(cmdBuffer, &transfer, 1);
+}
+
+void RecordOwnershipReleases(VkCommandBuffer cmdBuffer,
+                             const ImageOwnershipTransfer* transfers,
+                             uint32_t count) {
+  if (!count) return;
+  const ImageOwnershipTransfer& first = transfers[0];
+  bool sameFamily = (first.srcFamily == first.dstFamily);
+  std::vector<VkImageMemoryBarrier> barriers(count);
+  for (uint32_t i = 0; i < count; i++) {
+    const ImageOwnershipTransfer& transfer = transfers[i];
+    assert(transfer.srcFamily == first.srcFamily &&
+           transfer.dstFamily == first.dstFamily &&
+           transfer.srcStage == first.srcStage &&
+           transfer.dstStage == first.dstStage);
+    barriers[i] = VkImageMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = transfer.srcAccess,
+        .dstAccessMask = sameFamily ? transfer.dstAccess : 0,
+        .oldLayout = transfer.oldLayout,
+        .newLayout = transfer.newLayout,
+        .srcQueueFamilyIndex =
+            sameFamily ? VK_QUEUE_FAMILY_IGNORED : transfer.srcFamily,
+        .dstQueueFamilyIndex =
+            sameFamily ? VK_QUEUE_FAMILY_IGNORED : transfer.dstFamily,
+        .image = transfer.image,
+        .subresourceRange = transfer.range,
+    };
+  }
+  // The destination stages of a release are never reached on this queue
+  vkCmdPipelineBarrier(
+      cmdBuffer, first.srcStage,
+      sameFamily ? first.dstStage : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+      0, nullptr, 0, nullptr, count, barriers.data());
+}
+
+void RecordOwnershipAcquires(VkCommandBuffer cmdBuffer,
+                             const ImageOwnershipTransfer* transfers,
+                             uint32_t count) {
+  if (!count || transfers[0].srcFamily == transfers[0].dstFamily) return;
+  const ImageOwnershipTransfer& first = transfers[0];
+  std::vector<VkImageMemoryBarrier> barriers(count);
+  for (uint32_t i = 0; i < count; i++) {
+    const ImageOwnershipTransfer& transfer = transfers[i];
+    assert(transfer.srcFamily == first.srcFamily &&
+           transfer.dstFamily == first.dstFamily &&
+           transfer.dstStage == first.dstStage);
+    barriers[i] = VkImageMemoryBarrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = 0,
+        .dstAccessMask = transfer.dstAccess,
+        .oldLayout = transfer.oldLayout,
+        .newLayout = transfer.newLayout,
+        .srcQueueFamilyIndex = transfer.srcFamily,
+        .dstQueueFamilyIndex = transfer.dstFamily,
+        .image = transfer.image,
+        .subresourceRange = transfer.range,
+    };
+  }
+  // Starting at the semaphore wait's stage chains the barrier, and the
+  // layout change it repeats, after the release
+  vkCmdPipelineBarrier(cmdBuffer, first.dstStage, first.dstStage, 0, 0,
+                       nullptr, 0, nullptr, count, barriers.data());
+}
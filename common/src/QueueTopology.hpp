@@ -0,0 +1,92 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef QUEUE_TOPOLOGY_HPP
+#define QUEUE_TOPOLOGY_HPP
+
+#include <vulkan_wrapper.h>
+#include <vector>
+
+// The queues a device is created with: graphics, which also presents, and
+// transfer and compute queues that run next to it. A GPU with dedicated
+// transfer or compute families gets queues from those; otherwise they share
+// a family with graphics, as separate queues where the family has more than
+// one and as the graphics queue itself where it does not.
+enum QueueRole {
+  kQueueGraphics,
+  kQueueTransfer,
+  kQueueCompute,
+  kQueueRoleCount,
+};
+
+struct QueueTopology {
+  uint32_t family[kQueueRoleCount];
+  uint32_t index[kQueueRoleCount];  // in the family
+  VkQueue queue[kQueueRoleCount];
+
+  // Images |role|'s queue hands to graphics need no ownership transfer
+  bool SharesGraphicsFamily(QueueRole role) const {
+    return family[role] == family[kQueueGraphics];
+  }
+  // Work on |role|'s queue can overlap graphics work
+  bool HasOwnQueue(QueueRole role) const {
+    return !SharesGraphicsFamily(role) || index[role] != index[kQueueGraphics];
+  }
+};
+
+// Picks the families and queue indices for |gpu|. The graphics family must
+// be able to present to |surface|, unless it is VK_NULL_HANDLE. Returns
+// false if no family does graphics.
+bool DiscoverQueueTopology(VkPhysicalDevice gpu, VkSurfaceKHR surface,
+                           QueueTopology* topology);
+
+// What to put in VkDeviceCreateInfo::pQueueCreateInfos; one entry per family
+// used. The pointers stay valid for the life of the process.
+std::vector<VkDeviceQueueCreateInfo> QueueCreateInfos(
+    const QueueTopology& topology);
+
+// Fills topology->queue once the device exists
+void GetTopologyQueues(VkDevice device, QueueTopology* topology);
+
+// Hands an image from one queue family to another, changing its layout on
+// the way. The release is recorded on the source family's queue and the
+// acquire on the destination's, which has to wait for the release with a
+// semaphore, at dstStage. Within one family, the release is a plain barrier
+// and the acquire records nothing.
+struct ImageOwnershipTransfer {
+  VkImage image;
+  VkImageSubresourceRange range;
+  VkImageLayout oldLayout;
+  VkImageLayout newLayout;
+  uint32_t srcFamily;
+  uint32_t dstFamily;
+  VkPipelineStageFlags srcStage;
+  VkAccessFlags srcAccess;
+  VkPipelineStageFlags dstStage;
+  VkAccessFlags dstAccess;
+};
+void RecordOwnershipRelease(VkCommandBuffer cmdBuffer,
+                            const ImageOwnershipTransfer& transfer);
+void RecordOwnershipAcquire(VkCommandBuffer cmdBuffer,
+                            const ImageOwnershipTransfer& transfer);
+// The same for |count| images in one barrier each side, as uploads of
+// several textures hand them over; the images share families and stages.
+void RecordOwnershipReleases(VkCommandBuffer cmdBuffer,
+                             const ImageOwnershipTransfer* transfers,
+                             uint32_t count);
+void RecordOwnershipAcquires(VkCommandBuffer cmdBuffer,
+                             const ImageOwnershipTransfer* transfers,
+                             uint32_t count);
+
+#endif  // QUEUE_TOPOLOGY_HPP
@@ -0,0 +1,149 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "StagingRing.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+const VkDeviceSize StagingRing::kMaxAlignment;
+
+namespace {
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Limits the device may leave at 0 or 1, kept to powers of 2 that
+// kMaxAlignment is a multiple of, and to whole texels
+VkDeviceSize CopyAlignment(VkDeviceSize limit) {
+  VkDeviceSize alignment = 4;
+  while (alignment < limit && alignment < StagingRing::kMaxAlignment) {
+    alignment <<= 1;
+  }
+  return alignment;
+}
+
+}  // namespace
+
+StagingRing::StagingRing(void)
+    : device_(VK_NULL_HANDLE),
+      allocator_(nullptr),
+      buffer_(VK_NULL_HANDLE),
+      size_(0),
+      offsetAlignment_(4),
+      rowPitchAlignment_(4),
+      head_(0),
+      tail_(0),
+      flushed_(0),
+      peakBytes_(0) {
+  memset(&memory_, 0, sizeof(memory_));
+}
+
+bool StagingRing::Create(VkPhysicalDevice gpu, VkDevice device,
+                         MemoryAllocator* allocator, VkDeviceSize size) {
+  assert(buffer_ == VK_NULL_HANDLE);
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(gpu, &properties);
+  offsetAlignment_ =
+      CopyAlignment(properties.limits.optimalBufferCopyOffsetAlignment);
+  rowPitchAlignment_ =
+      CopyAlignment(properties.limits.optimalBufferCopyRowPitchAlignment);
+
+  size_ = AlignUp(size, kMaxAlignment);
+  VkBufferCreateInfo bufferInfo{
+      .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .size = size_,
+      .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+      .queueFamilyIndexCount = 0,
+      .pQueueFamilyIndices = nullptr,
+  };
+  if (vkCreateBuffer(device, &bufferInfo, nullptr, &buffer_) != VK_SUCCESS) {
+    return false;
+  }
+  device_ = device;
+  allocator_ = allocator;
+  if (!allocator_->AllocateForBuffer(buffer_, kMemoryUsageUpload,
+                                     &memory_) ||
+      !memory_.mapped) {
+    Destroy();
+    return false;
+  }
+  head_ = tail_ = flushed_ = 0;
+  retiring_.clear();
+  peakBytes_ = 0;
+  return true;
+}
+
+void StagingRing::Destroy(void) {
+  if (buffer_ == VK_NULL_HANDLE) return;
+  vkDestroyBuffer(device_, buffer_, nullptr);
+  allocator_->Free(&memory_);
+  buffer_ = VK_NULL_HANDLE;
+  retiring_.clear();
+}
+
+void* StagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment,
+                            VkDeviceSize* offset) {
+  if (!alignment) alignment = offsetAlignment_;
+  assert(!(alignment & (alignment - 1)) && alignment <= kMaxAlignment);
+  if (!size || size > size_) return nullptr;
+
+  // What does not fit before the end of the buffer starts over at the
+  // beginning, which is aligned to any alignment
+  uint64_t start = AlignUp(head_, alignment);
+  if (start % size_ + size > size_) start = (start / size_ + 1) * size_;
+  if (start + size - tail_ > size_) return nullptr;
+  head_ = start + size;
+  peakBytes_ = std::max<VkDeviceSize>(peakBytes_, head_ - tail_);
+
+  *offset = start % size_;
+  return static_cast<char*>(memory_.mapped) + *offset;
+}
+
+void StagingRing::Flush(void) {
+  // In at most two pieces: up to the end of the buffer, and from its start
+  while (flushed_ < head_) {
+    uint64_t lapEnd = (flushed_ / size_ + 1) * size_;
+    uint64_t end = std::min(head_, lapEnd);
+    allocator_->Flush(memory_, flushed_ % size_, end - flushed_);
+    flushed_ = end;
+  }
+}
+
+void StagingRing::Retire(uint64_t retireValue) {
+  uint64_t retired = retiring_.empty() ? tail_ : retiring_.back().end;
+  if (head_ == retired) return;  // nothing allocated since
+  Span span = {head_, retireValue};
+  retiring_.push_back(span);
+}
+
+void StagingRing::Collect(uint64_t completedValue) {
+  while (!retiring_.empty() &&
+         retiring_.front().retireValue <= completedValue) {
+    tail_ = retiring_.front().end;
+    retiring_.pop_front();
+  }
+}
+
+VkDeviceSize StagingRing::RowPitch(uint32_t width, uint32_t texelSize) const {
+  // Both powers of 2: the larger is a multiple of the other. Blocks of 8
+  // or 16 bytes can be larger than the device's alignment.
+  assert(!(texelSize & (texelSize - 1)));
+  return AlignUp(static_cast<uint64_t>(width) * texelSize,
+                 std::max<uint64_t>(rowPitchAlignment_, texelSize));
+}
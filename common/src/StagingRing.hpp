@@ -0,0 +1,92 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STAGING_RING_HPP
+#define STAGING_RING_HPP
+
+#include <vulkan_wrapper.h>
+#include <deque>
+#include "MemoryAllocator.hpp"
+
+// Host visible memory that uploads are written to, for vkCmdCopyBuffer()
+// and vkCmdCopyBufferToImage() to copy into device local resources. It is
+// one buffer, mapped once and reused in ring order, so an upload costs no
+// vkCreateBuffer(), allocation or mapping of its own.
+//
+// Space is reclaimed by retire value, as DeletionQueue objects are: after
+// allocating for a submit, Retire() what was allocated with the value that
+// completes once the copies have; Collect() is given the latest completed
+// value. Not thread safe.
+class StagingRing {
+ public:
+  // The most an allocation is aligned to; the ring is a multiple of it
+  static const VkDeviceSize kMaxAlignment = 256;
+
+  StagingRing(void);
+
+  // A ring of |size| bytes, rounded up to kMaxAlignment, in
+  // kMemoryUsageUpload memory
+  bool Create(VkPhysicalDevice gpu, VkDevice device,
+              MemoryAllocator* allocator, VkDeviceSize size);
+  // Wait for the copies from it first
+  void Destroy(void);
+
+  // |size| bytes, aligned to |alignment|, a power of 2, or to
+  // CopyOffsetAlignment() if 0. Returns where to write them, and their
+  // offset in Buffer() in |offset|; nullptr if the ring has too little
+  // space that is not waiting to retire.
+  void* Allocate(VkDeviceSize size, VkDeviceSize alignment,
+                 VkDeviceSize* offset);
+  // Makes what was allocated since the last Flush() visible to the device;
+  // call before submitting the copies
+  void Flush(void);
+  // What was allocated up to now is free once |retireValue| completes
+  void Retire(uint64_t retireValue);
+  void Collect(uint64_t completedValue);
+
+  // The bytes between rows of |width| texels, or compressed blocks, of
+  // |texelSize| bytes, a power of 2, for bufferRowLength, aligned as the
+  // device copies them fastest and to whole texels
+  VkDeviceSize RowPitch(uint32_t width, uint32_t texelSize) const;
+
+  VkBuffer Buffer(void) const { return buffer_; }
+  VkDeviceSize Size(void) const { return size_; }
+  // optimalBufferCopyOffsetAlignment, and at least a texel of 4 bytes
+  VkDeviceSize CopyOffsetAlignment(void) const { return offsetAlignment_; }
+  // The most the ring has held at once, to size it with
+  VkDeviceSize PeakBytes(void) const { return peakBytes_; }
+
+ private:
+  struct Span {
+    uint64_t end;  // head_ when it was retired
+    uint64_t retireValue;
+  };
+
+  VkDevice device_;
+  MemoryAllocator* allocator_;
+  VkBuffer buffer_;
+  MemoryAllocation memory_;
+  VkDeviceSize size_;
+  VkDeviceSize offsetAlignment_;
+  VkDeviceSize rowPitchAlignment_;
+  // Positions only ever grow; a position's offset in the buffer is it
+  // modulo size_
+  uint64_t head_;     // where the next allocation goes
+  uint64_t tail_;     // the oldest byte a copy may still read
+  uint64_t flushed_;  // up to where Flush() has been
+  std::deque<Span> retiring_;
+  VkDeviceSize peakBytes_;
+};
+
+#endif  // STAGING_RING_HPP
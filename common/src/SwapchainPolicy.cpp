@@ -0,0 +1,255 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SwapchainPolicy.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Frames presented but not yet seen on the display beyond this many are
+// dropped, in case the swapchain stops completing presents.
+const size_t kMaxPendingPresents = 16;
+
+bool HasPresentMode(const std::vector<VkPresentModeKHR>& modes,
+                    VkPresentModeKHR mode) {
+  return std::find(modes.begin(), modes.end(), mode) != modes.end();
+}
+
+bool HasExtension(const std::vector<VkExtensionProperties>& extensions,
+                  const char* name) {
+  for (const VkExtensionProperties& extension : extensions) {
+    if (!strcmp(extension.extensionName, name)) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+SwapchainPolicy ChooseSwapchainPolicy(
+    VkPhysicalDevice gpu, VkSurfaceKHR surface,
+    const VkSurfaceCapabilitiesKHR& capabilities, SwapchainProfile profile,
+    uint32_t imageCount) {
+  uint32_t modeCount = 0;
+  vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, surface, &modeCount, nullptr);
+  std::vector<VkPresentModeKHR> modes(modeCount);
+  vkGetPhysicalDeviceSurfacePresentModesKHR(gpu, surface, &modeCount,
+                                            modes.data());
+
+  SwapchainPolicy policy{
+      .presentMode = VK_PRESENT_MODE_FIFO_KHR,
+      .minImageCount = 3,
+  };
+  if (profile == kSwapchainLowLatency) {
+    // MAILBOX replaces a queued frame with a newer one, which takes a third
+    // image to render into while one is displayed and one waits. The FIFO
+    // modes queue frames instead, so each extra image is a frame of delay.
+    if (HasPresentMode(modes, VK_PRESENT_MODE_MAILBOX_KHR)) {
+      policy.presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    } else {
+      if (HasPresentMode(modes, VK_PRESENT_MODE_FIFO_RELAXED_KHR)) {
+        policy.presentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+      }
+      policy.minImageCount = 2;
+    }
+  }
+  if (imageCount >= 2 && imageCount <= 4) policy.minImageCount = imageCount;
+
+  policy.minImageCount =
+      std::max(policy.minImageCount, capabilities.minImageCount);
+  if (capabilities.maxImageCount) {
+    policy.minImageCount =
+        std::min(policy.minImageCount, capabilities.maxImageCount);
+  }
+  return policy;
+}
+
+const char* PresentModeName(VkPresentModeKHR mode) {
+  switch (mode) {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+      return "IMMEDIATE";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+      return "MAILBOX";
+    case VK_PRESENT_MODE_FIFO_KHR:
+      return "FIFO";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+      return "FIFO_RELAXED";
+    default:
+      return "unknown";
+  }
+}
+
+PreRotation ChoosePreRotation(const VkSurfaceCapabilitiesKHR& capabilities,
+                              VkExtent2D extent) {
+  PreRotation preRotation{
+      .transform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
+      .extent = extent,
+      .rotation = {1.0f, 0.0f, 0.0f, 1.0f},
+  };
+  int degrees;
+  switch (capabilities.currentTransform) {
+    case VK_SURFACE_TRANSFORM_ROTATE_90_BIT_KHR:
+      degrees = 90;
+      break;
+    case VK_SURFACE_TRANSFORM_ROTATE_180_BIT_KHR:
+      degrees = 180;
+      break;
+    case VK_SURFACE_TRANSFORM_ROTATE_270_BIT_KHR:
+      degrees = 270;
+      break;
+    default:
+      // Identity, or mirrored ones, which the compositor keeps doing
+      return preRotation;
+  }
+  if (!(capabilities.supportedTransforms & capabilities.currentTransform)) {
+    return preRotation;
+  }
+
+  preRotation.transform = capabilities.currentTransform;
+  if (degrees != 180) {
+    preRotation.extent.width = extent.height;
+    preRotation.extent.height = extent.width;
+  }
+  // Exact values: the sines and cosines of multiples of 90 degrees are 0
+  // and +-1, which float math would only get close to
+  float sine = (degrees == 90) ? 1.0f : (degrees == 270) ? -1.0f : 0.0f;
+  float cosine = (degrees == 180) ? -1.0f : 0.0f;
+  preRotation.rotation[0] = cosine;
+  preRotation.rotation[1] = sine;
+  preRotation.rotation[2] = -sine;
+  preRotation.rotation[3] = cosine;
+  return preRotation;
+}
+
+void QueryPresentWait(VkInstance instance, VkPhysicalDevice gpu,
+                      uint32_t instanceVersion,
+                      std::vector<const char*>* extensions,
+                      PresentWaitFeatures* features) {
+  memset(features, 0, sizeof(*features));
+  features->presentId.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+  features->presentId.pNext = &features->presentWait;
+  features->presentWait.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+
+  // The features are queried with vkGetPhysicalDeviceFeatures2, core in
+  // Vulkan 1.1 for both the instance and the device
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(gpu, &properties);
+  if (std::min(properties.apiVersion, instanceVersion) < VK_API_VERSION_1_1) {
+    return;
+  }
+
+  uint32_t extensionCount = 0;
+  vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount,
+                                       nullptr);
+  std::vector<VkExtensionProperties> deviceExtensions(extensionCount);
+  vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount,
+                                       deviceExtensions.data());
+  if (!HasExtension(deviceExtensions, VK_KHR_PRESENT_ID_EXTENSION_NAME) ||
+      !HasExtension(deviceExtensions, VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+    return;
+  }
+
+  // Having the extensions does not mean the features are there
+  PFN_vkGetPhysicalDeviceFeatures2 getPhysicalDeviceFeatures2 =
+      reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2>(
+          vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceFeatures2"));
+  if (!getPhysicalDeviceFeatures2) return;
+  VkPhysicalDeviceFeatures2 features2{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+      .pNext = &features->presentId,
+  };
+  getPhysicalDeviceFeatures2(gpu, &features2);
+  if (!features->presentId.presentId || !features->presentWait.presentWait) {
+    return;
+  }
+
+  extensions->push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+  extensions->push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+  features->supported = true;
+}
+
+PresentLatencyTracker::PresentLatencyTracker() {
+  Reset(VK_NULL_HANDLE, VK_NULL_HANDLE, nullptr);
+}
+
+void PresentLatencyTracker::Reset(VkDevice device, VkSwapchainKHR swapchain,
+                                  PFN_vkWaitForPresentKHR waitForPresent) {
+  device_ = device;
+  swapchain_ = swapchain;
+  waitForPresent_ = waitForPresent;
+  lastPresentId_ = 0;
+  presented_.clear();
+  latencies_.clear();
+}
+
+void PresentLatencyTracker::BeginFrame(void) {
+  Poll();
+  acquireTime_ = std::chrono::steady_clock::now();
+}
+
+void PresentLatencyTracker::AddPresentId(VkPresentInfoKHR* presentInfo) {
+  if (!waitForPresent_) return;
+  // Ids only have to increase; 0 means none
+  lastPresentId_++;
+  presentIdInfo_ = VkPresentIdKHR{
+      .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+      .pNext = presentInfo->pNext,
+      .swapchainCount = 1,
+      .pPresentIds = &lastPresentId_,
+  };
+  presentInfo->pNext = &presentIdInfo_;
+}
+
+void PresentLatencyTracker::EndFrame(void) {
+  Frame frame{
+      .presentId = lastPresentId_,
+      .acquireTime = acquireTime_,
+  };
+  if (!waitForPresent_) {
+    Complete(frame);
+    return;
+  }
+  if (presented_.size() == kMaxPendingPresents) presented_.pop_front();
+  presented_.push_back(frame);
+  Poll();
+}
+
+void PresentLatencyTracker::TakeLatencies(std::vector<uint64_t>* latencies) {
+  latencies->swap(latencies_);
+  latencies_.clear();
+}
+
+void PresentLatencyTracker::Complete(const Frame& frame) {
+  latencies_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() -
+                           frame.acquireTime)
+                           .count());
+}
+
+void PresentLatencyTracker::Poll(void) {
+  // Presents reach the display in order, so stop at the first one that has
+  // not. A timeout of 0 only checks.
+  while (!presented_.empty()) {
+    VkResult result = waitForPresent_(device_, swapchain_,
+                                      presented_.front().presentId, 0);
+    if (result == VK_TIMEOUT) break;
+    // An error, such as an out of date swapchain, loses the frame
+    if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+      Complete(presented_.front());
+    }
+    presented_.pop_front();
+  }
+}
@@ -0,0 +1,131 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SWAPCHAIN_POLICY_HPP
+#define SWAPCHAIN_POLICY_HPP
+
+#include <vulkan_wrapper.h>
+#include <chrono>
+#include <deque>
+#include <vector>
+
+// What a swapchain is tuned for. More images and FIFO keep the CPU and GPU
+// busy; fewer images, or a mode that does not queue, get a frame to the
+// display sooner.
+enum SwapchainProfile {
+  // MAILBOX with 3 images, else FIFO_RELAXED or FIFO with 2
+  kSwapchainLowLatency,
+  // FIFO with 3 images
+  kSwapchainHighThroughput,
+};
+
+struct SwapchainPolicy {
+  VkPresentModeKHR presentMode;
+  uint32_t minImageCount;
+};
+
+// The present mode and image count |profile| prefers, among what |surface|
+// supports; FIFO is always there. |imageCount| of 2, 3 or 4 overrides the
+// profile's count, which is then clamped to the surface's range.
+SwapchainPolicy ChooseSwapchainPolicy(
+    VkPhysicalDevice gpu, VkSurfaceKHR surface,
+    const VkSurfaceCapabilitiesKHR& capabilities, SwapchainProfile profile,
+    uint32_t imageCount = 0);
+
+const char* PresentModeName(VkPresentModeKHR mode);
+
+// Pre-rotation: a swapchain in the display's own orientation, drawn to with
+// the scene rotated to match, so the compositor has no rotation pass to do
+// every frame. Pass |transform| as preTransform and |extent| as imageExtent,
+// and multiply clip-space xy by |rotation|, a column-major 2x2 matrix.
+struct PreRotation {
+  VkSurfaceTransformFlagBitsKHR transform;
+  VkExtent2D extent;
+  float rotation[4];
+};
+
+// Adopts the surface's currentTransform when it is a plain rotation the
+// surface supports, else stays at identity; |extent| is the size of the
+// surface as the app sees it, swapped for 90 and 270 degrees.
+PreRotation ChoosePreRotation(const VkSurfaceCapabilitiesKHR& capabilities,
+                              VkExtent2D extent);
+
+// VK_KHR_present_id and VK_KHR_present_wait, which let PresentLatencyTracker
+// time frames up to the display. When |supported|, chain |presentId| into
+// VkDeviceCreateInfo::pNext; it points at |presentWait|, so the struct must
+// not move before vkCreateDevice().
+struct PresentWaitFeatures {
+  bool supported;
+  VkPhysicalDevicePresentIdFeaturesKHR presentId;
+  VkPhysicalDevicePresentWaitFeaturesKHR presentWait;
+};
+
+// Fills |features| for |gpu|, and adds both extensions to |extensions| if it
+// supports them. |instanceVersion| is the apiVersion |instance| was created
+// with: querying the features needs it and |gpu| to be Vulkan 1.1.
+void QueryPresentWait(VkInstance instance, VkPhysicalDevice gpu,
+                      uint32_t instanceVersion,
+                      std::vector<const char*>* extensions,
+                      PresentWaitFeatures* features);
+
+// Acquire-to-present latency of each frame. With present wait, a frame ends
+// when vkWaitForPresentKHR() reports its image on the display; that is polled
+// without blocking at each call below, so it can read up to a frame late.
+// Without it, a frame ends when vkQueuePresentKHR() returns, which only
+// covers the CPU side.
+class PresentLatencyTracker {
+ public:
+  PresentLatencyTracker();
+
+  // Start over on |swapchain|. |waitForPresent| is the device's
+  // vkWaitForPresentKHR, or nullptr if present wait is not enabled.
+  void Reset(VkDevice device, VkSwapchainKHR swapchain,
+             PFN_vkWaitForPresentKHR waitForPresent);
+
+  bool UsesPresentWait(void) const { return waitForPresent_ != nullptr; }
+
+  // Call right before vkAcquireNextImageKHR()
+  void BeginFrame(void);
+
+  // Call before vkQueuePresentKHR(): with present wait, chains an id for the
+  // frame into |presentInfo|, valid until the next call.
+  void AddPresentId(VkPresentInfoKHR* presentInfo);
+
+  // Call after vkQueuePresentKHR()
+  void EndFrame(void);
+
+  // Moves the latencies, in nanoseconds, of the frames that ended since the
+  // last call to |latencies|, oldest first.
+  void TakeLatencies(std::vector<uint64_t>* latencies);
+
+ private:
+  struct Frame {
+    uint64_t presentId;
+    std::chrono::steady_clock::time_point acquireTime;
+  };
+  void Complete(const Frame& frame);
+  void Poll(void);
+
+  VkDevice device_;
+  VkSwapchainKHR swapchain_;
+  PFN_vkWaitForPresentKHR waitForPresent_;
+
+  uint64_t lastPresentId_;
+  VkPresentIdKHR presentIdInfo_;
+  std::chrono::steady_clock::time_point acquireTime_;
+  std::deque<Frame> presented_;  // presents not on the display yet
+  std::vector<uint64_t> latencies_;
+};
+
+#endif  // SWAPCHAIN_POLICY_HPP
@@ -0,0 +1,188 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TextureStreamer.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+TextureStreamer::TextureStreamer(void)
+    : decode_(nullptr),
+      release_(nullptr),
+      context_(nullptr),
+      stopping_(false),
+      completed_(0),
+      completedBytes_(0) {}
+
+TextureStreamer::~TextureStreamer(void) { Stop(); }
+
+uint32_t TextureStreamer::CoreCount(void) {
+  // 0 where it cannot tell
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void TextureStreamer::Start(uint32_t workerCount, DecodeFunc decode,
+                            ReleaseFunc release, void* context) {
+  assert(workers_.empty() && workerCount);
+  decode_ = decode;
+  release_ = release;
+  context_ = context;
+  stopping_ = false;
+  entries_.clear();
+  queue_.clear();
+  decoded_.clear();
+  uploading_.clear();
+  completed_ = 0;
+  completedBytes_ = 0;
+  for (uint32_t i = 0; i < workerCount; i++) {
+    workers_.push_back(std::thread(&TextureStreamer::Work, this));
+  }
+}
+
+void TextureStreamer::Stop(void) {
+  if (workers_.empty()) return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+    queue_.clear();
+  }
+  queued_.notify_all();
+  for (std::thread& worker : workers_) worker.join();
+  workers_.clear();
+  for (uint32_t id : decoded_) release_(context_, &entries_[id].decoded);
+  decoded_.clear();
+}
+
+uint32_t TextureStreamer::Request(const char* name) {
+  uint32_t id;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id = static_cast<uint32_t>(entries_.size());
+    Entry entry;
+    entry.name = name;
+    entry.state = kQueued;
+    memset(&entry.decoded, 0, sizeof(entry.decoded));
+    entry.bytes = 0;
+    entry.retireValue = 0;
+    entries_.push_back(entry);
+    queue_.push_back(id);
+  }
+  if (!id) firstRequest_ = std::chrono::steady_clock::now();
+  queued_.notify_one();
+  return id;
+}
+
+void TextureStreamer::Work(void) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    queued_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (stopping_) return;
+    uint32_t id = queue_.front();
+    queue_.pop_front();
+    // entries_ may grow meanwhile, so the name is copied out
+    std::string name = entries_[id].name;
+    lock.unlock();
+    DecodedTexture decoded;
+    memset(&decoded, 0, sizeof(decoded));
+    bool ok = decode_(context_, name.c_str(), &decoded);
+    lock.lock();
+    if (stopping_) {
+      if (ok) release_(context_, &decoded);
+      return;
+    }
+    Entry& entry = entries_[id];
+    if (ok) {
+      entry.state = kDecoded;
+      entry.decoded = decoded;
+      decoded_.push_back(id);
+    } else {
+      entry.state = kFailed;
+    }
+  }
+}
+
+bool TextureStreamer::TakeDecoded(uint32_t* id, DecodedTexture* texture) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (decoded_.empty()) return false;
+  *id = decoded_.front();
+  decoded_.pop_front();
+  *texture = entries_[*id].decoded;
+  memset(&entries_[*id].decoded, 0, sizeof(DecodedTexture));
+  return true;
+}
+
+void TextureStreamer::Release(DecodedTexture* texture) {
+  release_(context_, texture);
+  memset(texture, 0, sizeof(*texture));
+}
+
+void TextureStreamer::Uploading(uint32_t id, uint64_t bytes,
+                                uint64_t retireValue) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Entry& entry = entries_[id];
+  assert(entry.state == kDecoded);
+  entry.state = kUploading;
+  entry.bytes = bytes;
+  entry.retireValue = retireValue;
+  uploading_.push_back(id);
+}
+
+void TextureStreamer::Failed(uint32_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[id].state = kFailed;
+}
+
+void TextureStreamer::Collect(uint64_t completedValue,
+                              std::vector<uint32_t>* resident) {
+  if (uploading_.empty()) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Uploads are submitted in retire value order
+  size_t count = 0;
+  while (count < uploading_.size() &&
+         entries_[uploading_[count]].retireValue <= completedValue) {
+    Entry& entry = entries_[uploading_[count]];
+    entry.state = kResident;
+    completed_++;
+    completedBytes_ += entry.bytes;
+    resident->push_back(uploading_[count]);
+    count++;
+  }
+  if (!count) return;
+  uploading_.erase(uploading_.begin(), uploading_.begin() + count);
+  lastCompletion_ = std::chrono::steady_clock::now();
+}
+
+TextureStreamer::State TextureStreamer::GetState(uint32_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_[id].state;
+}
+
+void TextureStreamer::GetStats(Stats* stats) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint32_t failed = 0;
+  for (const Entry& entry : entries_) failed += (entry.state == kFailed);
+  stats->workers = static_cast<uint32_t>(workers_.size());
+  stats->completed = completed_;
+  stats->failed = failed;
+  stats->inFlight =
+      static_cast<uint32_t>(entries_.size()) - completed_ - failed;
+  stats->bytes = completedBytes_;
+  stats->nanoseconds =
+      completed_ ? std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       lastCompletion_ - firstRequest_)
+                       .count()
+                 : 0;
+  stats->bytesPerSecond =
+      stats->nanoseconds ? completedBytes_ * 1e9 / stats->nanoseconds : 0.0;
+}
@@ -0,0 +1,143 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TEXTURE_STREAMER_HPP
+#define TEXTURE_STREAMER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Texels a worker decoded, as CopyPixelsToRgba() takes them, or the blocks
+// of a compressed format, uploaded as they are
+struct DecodedTexture {
+  uint32_t width;
+  uint32_t height;
+  uint32_t channels;  // 3 or 4; 0 for blocks
+  unsigned char* pixels;
+  // For blocks: a VkFormat, and the levels packed at pixels, level 0 first
+  uint32_t format;
+  uint32_t mipLevels;
+  uint64_t size;
+};
+
+// Loads textures off the thread that renders: worker threads read and
+// decode them, in the background, and the renderer takes what they
+// finished, in the order they did, to upload it at the start of a frame.
+//
+// Readiness follows the retire values DeletionQueue and StagingRing are
+// collected by: an upload submitted with retire value V makes its texture
+// resident once Collect() is given V or more. Until then, the renderer
+// draws with a placeholder.
+//
+// Request(), TakeDecoded(), Uploading(), Failed() and Collect() are for the
+// one thread that renders; decoding is the only work done elsewhere.
+class TextureStreamer {
+ public:
+  // Reads and decodes |name|, on a worker thread; false if it cannot
+  typedef bool (*DecodeFunc)(void* context, const char* name,
+                             DecodedTexture* texture);
+  // Frees what DecodeFunc returned
+  typedef void (*ReleaseFunc)(void* context, DecodedTexture* texture);
+
+  enum State {
+    kQueued,     // waiting for, or on, a worker
+    kDecoded,    // waiting for TakeDecoded()
+    kUploading,  // submitted, waiting for its retire value
+    kResident,
+    kFailed,
+  };
+
+  struct Stats {
+    uint32_t workers;
+    uint32_t inFlight;  // requested, neither resident nor failed
+    uint32_t completed;
+    uint32_t failed;
+    uint64_t bytes;  // uploaded for the completed textures
+    // From the first request to the last completion
+    uint64_t nanoseconds;
+    double bytesPerSecond;
+  };
+
+  TextureStreamer(void);
+  ~TextureStreamer(void);
+
+  // The cores the CPU has, at least 1: the workers to decode a set of
+  // textures with, each decode being a core's work
+  static uint32_t CoreCount(void);
+
+  // Starts |workerCount| threads, forgetting earlier requests
+  void Start(uint32_t workerCount, DecodeFunc decode, ReleaseFunc release,
+             void* context);
+  // Joins the workers, dropping what they have not decoded, or what was
+  // decoded and not taken
+  void Stop(void);
+
+  // Queues |name| for decoding, returning its id: requests are numbered
+  // from 0 since Start()
+  uint32_t Request(const char* name);
+
+  // The oldest decoded texture not taken yet, if any. The caller uploads
+  // and releases it, then calls Uploading() or Failed() for |id|.
+  bool TakeDecoded(uint32_t* id, DecodedTexture* texture);
+  void Release(DecodedTexture* texture);
+  // |bytes| were submitted for |id|, resident once |retireValue| completes
+  void Uploading(uint32_t id, uint64_t bytes, uint64_t retireValue);
+  void Failed(uint32_t id);
+
+  // Marks what |completedValue| retired resident, appending their ids to
+  // |resident|
+  void Collect(uint64_t completedValue, std::vector<uint32_t>* resident);
+
+  State GetState(uint32_t id);
+  void GetStats(Stats* stats);
+
+ private:
+  struct Entry {
+    std::string name;
+    State state;
+    DecodedTexture decoded;
+    uint64_t bytes;
+    uint64_t retireValue;
+  };
+
+  void Work(void);
+
+  DecodeFunc decode_;
+  ReleaseFunc release_;
+  void* context_;
+  std::vector<std::thread> workers_;
+
+  // Guards the members below, which workers share
+  std::mutex mutex_;
+  std::condition_variable queued_;
+  bool stopping_;
+  std::vector<Entry> entries_;
+  std::deque<uint32_t> queue_;    // ids to decode, in request order
+  std::deque<uint32_t> decoded_;  // ids decoded, in the order they finished
+
+  // The renderer's alone
+  std::vector<uint32_t> uploading_;
+  uint32_t completed_;
+  uint64_t completedBytes_;
+  std::chrono::steady_clock::time_point firstRequest_;
+  std::chrono::steady_clock::time_point lastCompletion_;
+};
+
+#endif  // TEXTURE_STREAMER_HPP
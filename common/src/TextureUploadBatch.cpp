@@ -0,0 +1,333 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TextureUploadBatch.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace {
+
+VkImageSubresourceRange ColorLevels(uint32_t baseLevel, uint32_t count) {
+  return VkImageSubresourceRange{VK_IMAGE_ASPECT_COLOR_BIT, baseLevel, count,
+                                 0, 1};
+}
+
+VkImageMemoryBarrier LayoutBarrier(VkImage image,
+                                   const VkImageSubresourceRange& range,
+                                   VkImageLayout oldLayout,
+                                   VkImageLayout newLayout,
+                                   VkAccessFlags srcAccess,
+                                   VkAccessFlags dstAccess) {
+  return VkImageMemoryBarrier{
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .pNext = nullptr,
+      .srcAccessMask = srcAccess,
+      .dstAccessMask = dstAccess,
+      .oldLayout = oldLayout,
+      .newLayout = newLayout,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = image,
+      .subresourceRange = range,
+  };
+}
+
+int32_t LevelSize(uint32_t size, uint32_t level) {
+  return static_cast<int32_t>(std::max(size >> level, 1u));
+}
+
+}  // namespace
+
+TextureUploadBatch::TextureUploadBatch(void)
+    : device_(VK_NULL_HANDLE), submitCount_(0) {
+  memset(&queues_, 0, sizeof(queues_));
+}
+
+void TextureUploadBatch::Begin(VkDevice device, const QueueTopology& queues) {
+  assert(copies_.empty() && linear_.empty());
+  device_ = device;
+  queues_ = queues;
+  submitCount_ = 0;
+}
+
+void TextureUploadBatch::AddCopy(VkImage image, VkBuffer source,
+                                 VkDeviceSize offset, uint32_t rowLength,
+                                 uint32_t width, uint32_t height) {
+  VkBufferImageCopy region{
+      .bufferOffset = offset,
+      .bufferRowLength = rowLength,
+      .bufferImageHeight = 0,
+      .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+      .imageOffset = {0, 0, 0},
+      .imageExtent = {width, height, 1},
+  };
+  AddCopy(image, 1, source, &region, 1);
+}
+
+void TextureUploadBatch::AddCopy(VkImage image, uint32_t mipLevels,
+                                 VkBuffer source,
+                                 const VkBufferImageCopy* regions,
+                                 uint32_t regionCount) {
+  assert(regionCount == 1 || regionCount == mipLevels);
+  assert(!regions[0].imageSubresource.mipLevel);
+  Copy copy;
+  copy.image = image;
+  copy.source = source;
+  copy.mipLevels = mipLevels;
+  copy.extent = VkExtent2D{regions[0].imageExtent.width,
+                           regions[0].imageExtent.height};
+  copy.regions.assign(regions, regions + regionCount);
+  copies_.push_back(copy);
+}
+
+void TextureUploadBatch::AddLinear(VkImage image) { linear_.push_back(image); }
+
+VkCommandBuffer TextureUploadBatch::BeginCommands(uint32_t queueFamily,
+                                                  VkCommandPool* pool) {
+  VkCommandPoolCreateInfo poolInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+      .queueFamilyIndex = queueFamily,
+  };
+  vkCreateCommandPool(device_, &poolInfo, nullptr, pool);
+  VkCommandBufferAllocateInfo allocateInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .pNext = nullptr,
+      .commandPool = *pool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+  };
+  VkCommandBuffer cmdBuffer;
+  vkAllocateCommandBuffers(device_, &allocateInfo, &cmdBuffer);
+  VkCommandBufferBeginInfo beginInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .pNext = nullptr,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+      .pInheritanceInfo = nullptr,
+  };
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+  return cmdBuffer;
+}
+
+void TextureUploadBatch::RecordBlits(
+    VkCommandBuffer cmdBuffer, const std::vector<const Copy*>& blitted) {
+  uint32_t maxLevels = 0;
+  for (const Copy* copy : blitted) {
+    maxLevels = std::max(maxLevels, copy->mipLevels);
+  }
+  // Level by level, across the images with that many: one barrier makes
+  // the level above of each a blit source, then each is blitted from it
+  std::vector<VkImageMemoryBarrier> barriers;
+  for (uint32_t level = 1; level < maxLevels; level++) {
+    barriers.clear();
+    for (const Copy* copy : blitted) {
+      if (level >= copy->mipLevels) continue;
+      barriers.push_back(LayoutBarrier(
+          copy->image, ColorLevels(level - 1, 1),
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT,
+          VK_ACCESS_TRANSFER_READ_BIT));
+    }
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, static_cast<uint32_t>(barriers.size()),
+                         barriers.data());
+    for (const Copy* copy : blitted) {
+      if (level >= copy->mipLevels) continue;
+      VkImageBlit blit{
+          .srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1},
+          .srcOffsets = {{0, 0, 0},
+                         {LevelSize(copy->extent.width, level - 1),
+                          LevelSize(copy->extent.height, level - 1), 1}},
+          .dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1},
+          .dstOffsets = {{0, 0, 0},
+                         {LevelSize(copy->extent.width, level),
+                          LevelSize(copy->extent.height, level), 1}},
+      };
+      vkCmdBlitImage(cmdBuffer, copy->image,
+                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, copy->image,
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit,
+                     VK_FILTER_LINEAR);
+    }
+  }
+
+  // Then all to the fragment shader: the levels blitted from are sources,
+  // the last is still a destination
+  barriers.clear();
+  for (const Copy* copy : blitted) {
+    uint32_t last = copy->mipLevels - 1;
+    if (last) {
+      barriers.push_back(LayoutBarrier(
+          copy->image, ColorLevels(0, last),
+          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+          VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT));
+    }
+    barriers.push_back(LayoutBarrier(
+        copy->image, ColorLevels(last, 1),
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT,
+        VK_ACCESS_SHADER_READ_BIT));
+  }
+  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr,
+                       0, nullptr, static_cast<uint32_t>(barriers.size()),
+                       barriers.data());
+}
+
+VkResult TextureUploadBatch::Submit(DeletionQueue* deletionQueue,
+                                    uint64_t retireValue) {
+  submitCount_ = 0;
+  if (!TextureCount()) return VK_SUCCESS;
+
+  // Where the transfer queue is the graphics queue, everything goes in the
+  // one command buffer
+  bool ownQueue = !copies_.empty() && queues_.HasOwnQueue(kQueueTransfer);
+  VkCommandPool gfxPool = VK_NULL_HANDLE;
+  VkCommandPool copyPool = VK_NULL_HANDLE;
+  VkCommandBuffer gfxCmd =
+      BeginCommands(queues_.family[kQueueGraphics], &gfxPool);
+  VkCommandBuffer copyCmd =
+      ownQueue ? BeginCommands(queues_.family[kQueueTransfer], &copyPool)
+               : gfxCmd;
+
+  uint32_t copyCount = static_cast<uint32_t>(copies_.size());
+  VkPipelineStageFlags copiedStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+  if (copyCount) {
+    std::vector<VkImageMemoryBarrier> toTransfer;
+    // Images copied whole go to the fragment shader; the others stay in
+    // TRANSFER_DST for their blits
+    std::vector<ImageOwnershipTransfer> sampled, blitSources;
+    std::vector<const Copy*> blitted;
+    for (const Copy& copy : copies_) {
+      VkImageSubresourceRange levels = ColorLevels(0, copy.mipLevels);
+      // Out of UNDEFINED, discarding whatever the images held
+      toTransfer.push_back(LayoutBarrier(
+          copy.image, levels, VK_IMAGE_LAYOUT_UNDEFINED,
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+          VK_ACCESS_TRANSFER_WRITE_BIT));
+      ImageOwnershipTransfer handOver{
+          .image = copy.image,
+          .range = levels,
+          .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+          .srcFamily = queues_.family[kQueueTransfer],
+          .dstFamily = queues_.family[kQueueGraphics],
+          .srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+          .srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT,
+          .dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+          .dstAccess = VK_ACCESS_SHADER_READ_BIT,
+      };
+      if (copy.regions.size() == copy.mipLevels) {
+        sampled.push_back(handOver);
+        continue;
+      }
+      handOver.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+      handOver.dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+      handOver.dstAccess =
+          VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+      blitSources.push_back(handOver);
+      blitted.push_back(&copy);
+    }
+    vkCmdPipelineBarrier(copyCmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                         nullptr, copyCount, toTransfer.data());
+    // The submit makes the host's writes to the sources visible
+    for (const Copy& copy : copies_) {
+      vkCmdCopyBufferToImage(copyCmd, copy.source, copy.image,
+                             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             static_cast<uint32_t>(copy.regions.size()),
+                             copy.regions.data());
+    }
+    if (!sampled.empty()) {
+      uint32_t count = static_cast<uint32_t>(sampled.size());
+      RecordOwnershipReleases(copyCmd, sampled.data(), count);
+      RecordOwnershipAcquires(gfxCmd, sampled.data(), count);
+    }
+    if (!blitted.empty()) {
+      uint32_t count = static_cast<uint32_t>(blitSources.size());
+      RecordOwnershipReleases(copyCmd, blitSources.data(), count);
+      RecordOwnershipAcquires(gfxCmd, blitSources.data(), count);
+      RecordBlits(gfxCmd, blitted);
+      copiedStage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    }
+  }
+
+  if (!linear_.empty()) {
+    std::vector<VkImageMemoryBarrier> toSampled;
+    for (VkImage image : linear_) {
+      toSampled.push_back(LayoutBarrier(
+          image, ColorLevels(0, 1), VK_IMAGE_LAYOUT_PREINITIALIZED,
+          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_HOST_WRITE_BIT,
+          VK_ACCESS_SHADER_READ_BIT));
+    }
+    vkCmdPipelineBarrier(gfxCmd, VK_PIPELINE_STAGE_HOST_BIT,
+                         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr,
+                         0, nullptr, static_cast<uint32_t>(toSampled.size()),
+                         toSampled.data());
+  }
+
+  // The copies on a queue of their own are ordered before the graphics
+  // submit by a semaphore
+  VkResult result = VK_SUCCESS;
+  VkSemaphore copied = VK_NULL_HANDLE;
+  if (ownQueue) {
+    vkEndCommandBuffer(copyCmd);
+    VkSemaphoreCreateInfo semaphoreInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+    };
+    vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &copied);
+    VkSubmitInfo copySubmit{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = nullptr,
+        .waitSemaphoreCount = 0,
+        .pWaitSemaphores = nullptr,
+        .pWaitDstStageMask = nullptr,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &copyCmd,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &copied,
+    };
+    result = vkQueueSubmit(queues_.queue[kQueueTransfer], 1, &copySubmit,
+                           VK_NULL_HANDLE);
+    submitCount_++;
+  }
+  vkEndCommandBuffer(gfxCmd);
+  VkSubmitInfo gfxSubmit{
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .pNext = nullptr,
+      .waitSemaphoreCount = ownQueue ? 1u : 0u,
+      .pWaitSemaphores = &copied,
+      .pWaitDstStageMask = &copiedStage,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &gfxCmd,
+      .signalSemaphoreCount = 0,
+      .pSignalSemaphores = nullptr,
+  };
+  VkResult gfxResult = vkQueueSubmit(queues_.queue[kQueueGraphics], 1,
+                                     &gfxSubmit, VK_NULL_HANDLE);
+  if (result == VK_SUCCESS) result = gfxResult;
+  submitCount_++;
+
+  deletionQueue->DeferCommandPool(gfxPool, retireValue);
+  deletionQueue->DeferCommandPool(copyPool, retireValue);
+  deletionQueue->DeferSemaphore(copied, retireValue);
+  copies_.clear();
+  linear_.clear();
+  return result;
+}
@@ -0,0 +1,90 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TEXTURE_UPLOAD_BATCH_HPP
+#define TEXTURE_UPLOAD_BATCH_HPP
+
+#include <vulkan_wrapper.h>
+#include <vector>
+#include "DeletionQueue.hpp"
+#include "QueueTopology.hpp"
+
+// Gathers the uploads of any number of textures, and submits them together:
+// one command buffer on the transfer queue copies every staged texture,
+// with one barrier into TRANSFER_DST before the copies and one handing all
+// of them to graphics after; one on the graphics queue acquires them and
+// moves host-written linear images to SHADER_READ_ONLY, in one barrier. Two
+// submits, however many textures, and nothing waited on: the command pools
+// and semaphore go to a DeletionQueue.
+//
+// Mip levels not copied are blitted on the graphics queue, each from the
+// one above, with linear filtering: the format has to have the BLIT_SRC,
+// BLIT_DST and SAMPLED_IMAGE_FILTER_LINEAR features for optimal tiling.
+// The barriers between levels cover every image with that many levels.
+//
+// The textures are ready for fragment shaders in work submitted to the
+// graphics queue after Submit(). Not thread safe.
+class TextureUploadBatch {
+ public:
+  TextureUploadBatch(void);
+
+  // Starts a batch for |device|, copying on |queues|' transfer queue
+  void Begin(VkDevice device, const QueueTopology& queues);
+
+  // Copies |width| x |height| texels at |offset| in |source|, rows
+  // |rowLength| texels apart, to mip 0 of |image|, which is optimally
+  // tiled, in UNDEFINED layout and has TRANSFER_DST usage. The source has
+  // to stay until the retire value given to Submit() completes.
+  void AddCopy(VkImage image, VkBuffer source, VkDeviceSize offset,
+               uint32_t rowLength, uint32_t width, uint32_t height);
+  // The same for an image of |mipLevels| levels, |regionCount| |regions|
+  // copying either every level, in order, or the first only, the others
+  // being blitted
+  void AddCopy(VkImage image, uint32_t mipLevels, VkBuffer source,
+               const VkBufferImageCopy* regions, uint32_t regionCount);
+  // A linear |image| the host wrote in PREINITIALIZED layout
+  void AddLinear(VkImage image);
+
+  // Records and submits the batch, returning the first submit's error.
+  // What it used is destroyed once |retireValue| completes, which it must
+  // do after the graphics submit.
+  VkResult Submit(DeletionQueue* deletionQueue, uint64_t retireValue);
+
+  uint32_t TextureCount(void) const {
+    return static_cast<uint32_t>(copies_.size() + linear_.size());
+  }
+  // Submits of the last Submit(): 0 for an empty batch, at most 2
+  uint32_t SubmitCount(void) const { return submitCount_; }
+
+ private:
+  struct Copy {
+    VkImage image;
+    VkBuffer source;
+    uint32_t mipLevels;
+    VkExtent2D extent;
+    std::vector<VkBufferImageCopy> regions;
+  };
+
+  VkCommandBuffer BeginCommands(uint32_t queueFamily, VkCommandPool* pool);
+  void RecordBlits(VkCommandBuffer cmdBuffer,
+                   const std::vector<const Copy*>& blitted);
+
+  VkDevice device_;
+  QueueTopology queues_;
+  std::vector<Copy> copies_;
+  std::vector<VkImage> linear_;
+  uint32_t submitCount_;
+};
+
+#endif  // TEXTURE_UPLOAD_BATCH_HPP
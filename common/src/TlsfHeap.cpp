@@ -0,0 +1,206 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "TlsfHeap.hpp"
+#include <cassert>
+
+const uint32_t TlsfHeap::kNoNode;
+
+namespace {
+
+uint32_t HighestBit(uint64_t value) { return 63 - __builtin_clzll(value); }
+
+}  // namespace
+
+TlsfHeap::TlsfHeap(uint64_t size)
+    : size_(size),
+      freeBytes_(0),
+      allocationCount_(0),
+      firstLevelMap_(0) {
+  assert(size > 0);
+  for (uint32_t first = 0; first < kFirstLevels; first++) {
+    secondLevelMap_[first] = 0;
+    for (uint32_t second = 0; second < kSecondLevels; second++) {
+      freeLists_[first][second] = kNoNode;
+    }
+  }
+  uint32_t node = NewNode(0, size);
+  nodes_[node].free = true;
+  freeBytes_ = size;
+  InsertFree(node);
+}
+
+// Sizes below kSecondLevels get a bin each; above, |first| is the power of
+// two and |second| the step within it, rounding down
+void TlsfHeap::Bin(uint64_t size, uint32_t* first, uint32_t* second) {
+  if (size < kSecondLevels) {
+    *first = 0;
+    *second = static_cast<uint32_t>(size);
+    return;
+  }
+  *first = HighestBit(size);
+  *second = static_cast<uint32_t>(size >> (*first - kSecondLevelLog2)) -
+            kSecondLevels;
+}
+
+uint32_t TlsfHeap::NewNode(uint64_t offset, uint64_t size) {
+  uint32_t node;
+  if (unusedNodes_.empty()) {
+    node = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back(Node());
+  } else {
+    node = unusedNodes_.back();
+    unusedNodes_.pop_back();
+  }
+  nodes_[node] = Node{
+      .offset = offset,
+      .size = size,
+      .prevRange = kNoNode,
+      .nextRange = kNoNode,
+      .prevFree = kNoNode,
+      .nextFree = kNoNode,
+      .free = false,
+  };
+  return node;
+}
+
+void TlsfHeap::InsertFree(uint32_t node) {
+  uint32_t first, second;
+  Bin(nodes_[node].size, &first, &second);
+  uint32_t& head = freeLists_[first][second];
+  nodes_[node].prevFree = kNoNode;
+  nodes_[node].nextFree = head;
+  if (head != kNoNode) nodes_[head].prevFree = node;
+  head = node;
+  firstLevelMap_ |= 1ull << first;
+  secondLevelMap_[first] |= 1u << second;
+}
+
+void TlsfHeap::RemoveFree(uint32_t node) {
+  uint32_t first, second;
+  Bin(nodes_[node].size, &first, &second);
+  uint32_t prev = nodes_[node].prevFree;
+  uint32_t next = nodes_[node].nextFree;
+  if (prev != kNoNode) nodes_[prev].nextFree = next;
+  if (next != kNoNode) nodes_[next].prevFree = prev;
+  if (freeLists_[first][second] == node) {
+    freeLists_[first][second] = next;
+    if (next == kNoNode) {
+      secondLevelMap_[first] &= ~(1u << second);
+      if (!secondLevelMap_[first]) firstLevelMap_ &= ~(1ull << first);
+    }
+  }
+}
+
+uint32_t TlsfHeap::SplitFront(uint32_t node, uint64_t size) {
+  uint32_t front = NewNode(nodes_[node].offset, size);
+  uint32_t prev = nodes_[node].prevRange;
+  nodes_[front].prevRange = prev;
+  nodes_[front].nextRange = node;
+  if (prev != kNoNode) nodes_[prev].nextRange = front;
+  nodes_[node].prevRange = front;
+  nodes_[node].offset += size;
+  nodes_[node].size -= size;
+  return front;
+}
+
+void TlsfHeap::Merge(uint32_t node, uint32_t next) {
+  nodes_[node].size += nodes_[next].size;
+  uint32_t after = nodes_[next].nextRange;
+  nodes_[node].nextRange = after;
+  if (after != kNoNode) nodes_[after].prevRange = node;
+  unusedNodes_.push_back(next);
+}
+
+uint32_t TlsfHeap::Allocate(uint64_t size, uint64_t alignment,
+                            uint64_t* offset) {
+  assert(alignment && !(alignment & (alignment - 1)));
+  if (!size) size = 1;
+
+  // Any range in the bin of the rounded up size, or a later one, holds
+  // |size| bytes at whatever alignment the range starts
+  uint64_t search = size + alignment - 1;
+  if (search >= kSecondLevels) {
+    search += (1ull << (HighestBit(search) - kSecondLevelLog2)) - 1;
+  }
+  if (search < size) return kNoNode;  // overflowed
+  uint32_t first, second;
+  Bin(search, &first, &second);
+  if (first >= kFirstLevels) return kNoNode;
+
+  uint32_t secondMap = secondLevelMap_[first] & (~0u << second);
+  if (!secondMap) {
+    uint64_t firstMap =
+        (first + 1 < kFirstLevels) ? firstLevelMap_ & (~0ull << (first + 1))
+                                   : 0;
+    if (!firstMap) return kNoNode;
+    first = __builtin_ctzll(firstMap);
+    secondMap = secondLevelMap_[first];
+  }
+  second = __builtin_ctz(secondMap);
+  uint32_t node = freeLists_[first][second];
+  RemoveFree(node);
+
+  // Alignment padding and what is left past |size| stay free
+  uint64_t start = nodes_[node].offset;
+  uint64_t padding = ((start + alignment - 1) & ~(alignment - 1)) - start;
+  if (padding) {
+    uint32_t front = SplitFront(node, padding);
+    nodes_[front].free = true;
+    InsertFree(front);
+  }
+  if (nodes_[node].size > size) {
+    uint32_t rest = node;
+    node = SplitFront(rest, size);
+    nodes_[rest].free = true;
+    InsertFree(rest);
+  }
+  nodes_[node].free = false;
+  freeBytes_ -= nodes_[node].size;
+  allocationCount_++;
+  *offset = nodes_[node].offset;
+  return node;
+}
+
+void TlsfHeap::Free(uint32_t node) {
+  assert(node < nodes_.size() && !nodes_[node].free);
+  freeBytes_ += nodes_[node].size;
+  allocationCount_--;
+  nodes_[node].free = true;
+
+  uint32_t prev = nodes_[node].prevRange;
+  if (prev != kNoNode && nodes_[prev].free) {
+    RemoveFree(prev);
+    Merge(prev, node);
+    node = prev;
+  }
+  uint32_t next = nodes_[node].nextRange;
+  if (next != kNoNode && nodes_[next].free) {
+    RemoveFree(next);
+    Merge(node, next);
+  }
+  InsertFree(node);
+}
+
+uint64_t TlsfHeap::LargestFreeRange(void) const {
+  if (!firstLevelMap_) return 0;
+  uint32_t first = HighestBit(firstLevelMap_);
+  uint32_t second = 31 - __builtin_clz(secondLevelMap_[first]);
+  uint64_t largest = 0;
+  for (uint32_t node = freeLists_[first][second]; node != kNoNode;
+       node = nodes_[node].nextFree) {
+    if (nodes_[node].size > largest) largest = nodes_[node].size;
+  }
+  return largest;
+}
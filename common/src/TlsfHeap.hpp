@@ -0,0 +1,82 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TLSF_HEAP_HPP
+#define TLSF_HEAP_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Hands out aligned ranges of [0, size) with a two-level segregated fit
+// (TLSF): free ranges are binned by the power of two of their size, and
+// each power of two into kSecondLevels linear steps, with a bitmap per
+// level. Allocate() and Free() are O(1) and adjacent free ranges merge, so
+// a heap serves mixed sizes for long without fragmenting much. It only
+// does the bookkeeping: the memory is wherever the offsets point.
+class TlsfHeap {
+ public:
+  static const uint32_t kNoNode = ~0u;
+
+  explicit TlsfHeap(uint64_t size);
+
+  // A range of |size| bytes at an |alignment| (a power of two) multiple;
+  // returns the node to Free() it by, or kNoNode if no free range fits
+  uint32_t Allocate(uint64_t size, uint64_t alignment, uint64_t* offset);
+  void Free(uint32_t node);
+
+  uint64_t Size(void) const { return size_; }
+  uint64_t FreeBytes(void) const { return freeBytes_; }
+  uint32_t AllocationCount(void) const { return allocationCount_; }
+  // The largest allocation that could succeed; with FreeBytes(), how
+  // fragmented the heap is
+  uint64_t LargestFreeRange(void) const;
+
+ private:
+  static const uint32_t kSecondLevelLog2 = 4;
+  static const uint32_t kSecondLevels = 1u << kSecondLevelLog2;
+  static const uint32_t kFirstLevels = 64;
+
+  // A range of the heap, free or not, linked to its neighbours in address
+  // order and, when free, into its bin's list
+  struct Node {
+    uint64_t offset;
+    uint64_t size;
+    uint32_t prevRange;
+    uint32_t nextRange;
+    uint32_t prevFree;
+    uint32_t nextFree;
+    bool free;
+  };
+
+  static void Bin(uint64_t size, uint32_t* first, uint32_t* second);
+  uint32_t NewNode(uint64_t offset, uint64_t size);
+  void InsertFree(uint32_t node);
+  void RemoveFree(uint32_t node);
+  // Splits the first |size| bytes of |node| off into a node of their own,
+  // and returns it; |node| keeps the rest
+  uint32_t SplitFront(uint32_t node, uint64_t size);
+  // Appends |next| to |node|, which must be its neighbour
+  void Merge(uint32_t node, uint32_t next);
+
+  uint64_t size_;
+  uint64_t freeBytes_;
+  uint32_t allocationCount_;
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> unusedNodes_;
+  uint64_t firstLevelMap_;
+  uint32_t secondLevelMap_[kFirstLevels];
+  uint32_t freeLists_[kFirstLevels][kSecondLevels];
+};
+
+#endif  // TLSF_HEAP_HPP
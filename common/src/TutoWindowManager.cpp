@@ -16,35 +16,36 @@
 #include "TutoWindowManager.hpp"
 #include "TutorialUtils.hpp"
 
-// --------------------------------------------------------------
-// Global variables
-VkInstance tutorialInstance;
-VkPhysicalDevice tutorialGpu;
-VkDevice tutorialDevice;
-VkQueue tutorialGraphicsQueue;
-VkPhysicalDeviceMemoryProperties tutorialMemoryProperties;
-
-VkSurfaceKHR tutorialSurface;
-VkSwapchainKHR tutorialSwapchain;
-VkExtent2D tutorialDisplaySize;
-VkFormat tutorialDisplayFormat;
-uint32_t tutorialSwapchainLength;
-
-VkFramebuffer* tutorialFramebuffer;
-
-VkImageView* displayViews;
-
-void tutorialInitWindow(ANativeWindow* platformWindow,
+VulkanContext::VulkanContext()
+    : instance(VK_NULL_HANDLE),
+      gpu(VK_NULL_HANDLE),
+      device(VK_NULL_HANDLE),
+      queues(),
+      graphicsQueue(VK_NULL_HANDLE),
+      memoryProperties(),
+      memoryTypes(),
+      assetManager(nullptr),
+      surface(VK_NULL_HANDLE),
+      swapchain(VK_NULL_HANDLE),
+      displaySize(),
+      displayFormat(VK_FORMAT_UNDEFINED),
+      swapchainLength(0),
+      preRotation(),
+      depth() {}
+
+void tutorialInitWindow(VulkanContext* context, ANativeWindow* platformWindow,
                         VkApplicationInfo* appInfo) {
   LOGI("->TutoInitWindow()");
 
   std::vector<const char *> instance_extensions;
   std::vector<const char *> device_extensions;
 
-  instance_extensions.push_back("VK_KHR_surface");
-  instance_extensions.push_back("VK_KHR_android_surface");
+  if (platformWindow) {
+    instance_extensions.push_back("VK_KHR_surface");
+    instance_extensions.push_back("VK_KHR_android_surface");
 
-  device_extensions.push_back("VK_KHR_swapchain");
+    device_extensions.push_back("VK_KHR_swapchain");
+  }
 
   // **********************************************************
   // Create the Vulkan instance
@@ -57,16 +58,18 @@ void tutorialInitWindow(ANativeWindow* platformWindow,
       .enabledLayerCount = 0,
       .ppEnabledLayerNames = nullptr,
   };
-  CALL_VK(vkCreateInstance(&instanceCreateInfo, nullptr, &tutorialInstance));
-  VkAndroidSurfaceCreateInfoKHR createInfo{
-      .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
-      .pNext = nullptr,
-      .flags = 0,
-      .window = platformWindow};
+  CALL_VK(vkCreateInstance(&instanceCreateInfo, nullptr, &context->instance));
+  if (platformWindow) {
+    VkAndroidSurfaceCreateInfoKHR createInfo{
+        .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
+        .pNext = nullptr,
+        .flags = 0,
+        .window = platformWindow};
 
-  CALL_VK(vkCreateAndroidSurfaceKHR(tutorialInstance, &createInfo, nullptr,
-                                     &tutorialSurface));
-  LOGI("->TutoInitWindow() CreateAndroidSurfaceKHR");
+    CALL_VK(vkCreateAndroidSurfaceKHR(context->instance, &createInfo, nullptr,
+                                       &context->surface));
+    LOGI("->TutoInitWindow() CreateAndroidSurfaceKHR");
+  }
 
   // **********************************************************
   // We will choose the right physical device to run our app
@@ -78,62 +81,33 @@ void tutorialInitWindow(ANativeWindow* platformWindow,
   uint32_t gpuCount = 0;
 
   // First get the amount of GPU (nullptr as last argument and gpuCount == 0)
-  CALL_VK(vkEnumeratePhysicalDevices(tutorialInstance, &gpuCount, nullptr));
+  CALL_VK(vkEnumeratePhysicalDevices(context->instance, &gpuCount, nullptr));
 
   // Then get the list of physical devices
   VkPhysicalDevice tmpGpus[gpuCount];
-  CALL_VK(vkEnumeratePhysicalDevices(tutorialInstance, &gpuCount, tmpGpus));
-
-  // On Android, every device supports present; every queue supports graphics
-  // operations. we loop to confirm it does support both graphics and compute
-  bool gpuFound = false;
-  for (uint32_t idx = 0; idx < gpuCount && !gpuFound; idx++) {
-    uint32_t count = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(tmpGpus[idx], &count, nullptr);
-    VkQueueFamilyProperties queueProps[count];
-    vkGetPhysicalDeviceQueueFamilyProperties(tmpGpus[idx], &count, queueProps);
-    for (uint32_t family = 0; family < count; family++) {
-      if ((queueProps[family].queueFlags & VK_QUEUE_GRAPHICS_BIT) &&
-          (queueProps[family].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
-        // Got a queue supports both graphics and compute
-        VkBool32 supPresent;
-        CALL_VK(vkGetPhysicalDeviceSurfaceSupportKHR(
-                tmpGpus[idx],
-                family,
-                tutorialSurface,
-                &supPresent));
-        // on Android queue need to support present
-        assert(supPresent);
-        tutorialGpu = tmpGpus[idx];
-        // It should be the 1st queue family. the rest of the tutorial will
-        // use 0 as family throughout [Android Only feature]
-        assert(0 == family);
-        gpuFound = true;
-      }
-    }
-  }
-
-  // confirm that it is the first gpu and the first queue family
-  assert(gpuFound);
-  assert(tutorialGpu == tmpGpus[0]);
+  CALL_VK(vkEnumeratePhysicalDevices(context->instance, &gpuCount, tmpGpus));
+
+  // Use the first GPU. Besides its graphics family, which has to present,
+  // look for families that transfer or compute next to it; without them,
+  // those queues share the graphics family
+  context->gpu = tmpGpus[0];
+  bool queuesFound = DiscoverQueueTopology(context->gpu, context->surface,
+                                           &context->queues);
+  assert(queuesFound);
+  vkGetPhysicalDeviceMemoryProperties(context->gpu,
+                                      &context->memoryProperties);
+  context->memoryTypes = MemoryTypeSelector(context->memoryProperties);
 
   // **********************************************************
-  // Create a logical device (
-  float priorities[] = { 1.0f, };
-  VkDeviceQueueCreateInfo queueCreateInfo{
-      .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-      .pNext = nullptr,
-      .flags = 0,
-      .queueCount = 1,
-      .queueFamilyIndex = 0,
-      .pQueuePriorities = priorities,
-  };
+  // Create a logical device, with a queue for each role
+  std::vector<VkDeviceQueueCreateInfo> queueCreateInfos =
+      QueueCreateInfos(context->queues);
 
   VkDeviceCreateInfo deviceCreateInfo{
       .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
       .pNext = nullptr,
-      .queueCreateInfoCount = 1,
-      .pQueueCreateInfos = &queueCreateInfo,
+      .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
+      .pQueueCreateInfos = queueCreateInfos.data(),
       .enabledLayerCount = 0,
       .ppEnabledLayerNames = nullptr,
       .enabledExtensionCount = static_cast<uint32_t>(device_extensions.size()),
@@ -141,16 +115,22 @@ void tutorialInitWindow(ANativeWindow* platformWindow,
       .pEnabledFeatures = nullptr,
   };
 
-  CALL_VK(vkCreateDevice(tutorialGpu, &deviceCreateInfo, nullptr,
-                       &tutorialDevice));
+  CALL_VK(vkCreateDevice(context->gpu, &deviceCreateInfo, nullptr,
+                       &context->device));
   // **********************************************************
-  // Get the graphic queue (used later to submit command buffer)
-  vkGetDeviceQueue(tutorialDevice, 0, 0, &tutorialGraphicsQueue);
+  // Get the queues (the graphic one is used later to submit command buffer)
+  GetTopologyQueues(context->device, &context->queues);
+  context->graphicsQueue = context->queues.queue[kQueueGraphics];
+  LOGI("Queue families: graphics %u, transfer %u, compute %u",
+       context->queues.family[kQueueGraphics],
+       context->queues.family[kQueueTransfer],
+       context->queues.family[kQueueCompute]);
 
   LOGI("<-TutoInitWindow");
 }
 
-void tutorialCreateSwapChain() {
+void tutorialCreateSwapChain(VulkanContext* context, SwapchainProfile profile,
+                             uint32_t imageCount) {
   LOGI("->tutorialCreateSwapChain");
 
   // **********************************************************
@@ -159,7 +139,7 @@ void tutorialCreateSwapChain() {
   //   - It's necessary to query the supported surface format (R8G8B8A8 for
   //   instance ...)
   VkSurfaceCapabilitiesKHR surfaceCapabilities;
-  vkGetPhysicalDeviceSurfaceCapabilitiesKHR(tutorialGpu, tutorialSurface,
+  vkGetPhysicalDeviceSurfaceCapabilitiesKHR(context->gpu, context->surface,
                                             &surfaceCapabilities);
 
   LOGI("Capabilities:\n");
@@ -181,11 +161,11 @@ void tutorialCreateSwapChain() {
   // **********************************************************
   // Query the list of supported surface format and choose one we like
   uint32_t formatCount = 0;
-  vkGetPhysicalDeviceSurfaceFormatsKHR(tutorialGpu, tutorialSurface, &formatCount,
-                            nullptr);
+  vkGetPhysicalDeviceSurfaceFormatsKHR(context->gpu, context->surface,
+                                       &formatCount, nullptr);
   VkSurfaceFormatKHR *formats = new VkSurfaceFormatKHR [formatCount];
-  vkGetPhysicalDeviceSurfaceFormatsKHR(tutorialGpu, tutorialSurface, &formatCount,
-                            formats);
+  vkGetPhysicalDeviceSurfaceFormatsKHR(context->gpu, context->surface,
+                                       &formatCount, formats);
   LOGI("Got %d formats", formatCount);
 
   uint32_t chosenFormat;
@@ -196,71 +176,89 @@ void tutorialCreateSwapChain() {
   }
   assert(chosenFormat < formatCount);
 
+  SwapchainPolicy policy =
+      ChooseSwapchainPolicy(context->gpu, context->surface,
+                            surfaceCapabilities, profile, imageCount);
+  LOGI("Swapchain: %s, %u images", PresentModeName(policy.presentMode),
+       policy.minImageCount);
+  // Adopt the display's orientation, so the compositor does not have to
+  // rotate each frame
+  context->preRotation = ChoosePreRotation(surfaceCapabilities,
+                                           surfaceCapabilities.currentExtent);
+
   // **********************************************************
-  // Create a swap chain (here we choose the minimum available number of surface
-  // in the chain)
-  uint32_t queueFamily = 0;
+  // Create a swap chain with the present mode and length of the policy
+  uint32_t queueFamily = context->queues.family[kQueueGraphics];
   VkSwapchainCreateInfoKHR swapchainCreate{
       .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
       .pNext = nullptr,
-      .surface = tutorialSurface,
-      .minImageCount = surfaceCapabilities.minImageCount,
+      .surface = context->surface,
+      .minImageCount = policy.minImageCount,
       .imageFormat = formats[chosenFormat].format,
       .imageColorSpace = formats[chosenFormat].colorSpace,
-      .imageExtent = surfaceCapabilities.currentExtent,
+      .imageExtent = context->preRotation.extent,
       .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-      .preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
+      .preTransform = context->preRotation.transform,
       .imageArrayLayers = 1,
       .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
       .queueFamilyIndexCount = 1,
       .pQueueFamilyIndices = &queueFamily,
-      .presentMode = VK_PRESENT_MODE_FIFO_KHR,
+      .presentMode = policy.presentMode,
       .oldSwapchain = VK_NULL_HANDLE,
       .clipped = VK_FALSE,
   };
 
-  tutorialDisplaySize = surfaceCapabilities.currentExtent;
-  tutorialDisplayFormat = formats[chosenFormat].format;
+  context->displaySize = context->preRotation.extent;
+  context->displayFormat = formats[chosenFormat].format;
 
-  CALL_VK(vkCreateSwapchainKHR(tutorialDevice, &swapchainCreate, nullptr,
-                                &tutorialSwapchain));
+  CALL_VK(vkCreateSwapchainKHR(context->device, &swapchainCreate, nullptr,
+                                &context->swapchain));
   // **********************************************************
   // Get the length of the created swap chain
   uint32_t displaySwapchainLength;
-  CALL_VK(vkGetSwapchainImagesKHR(tutorialDevice, tutorialSwapchain,
+  CALL_VK(vkGetSwapchainImagesKHR(context->device, context->swapchain,
                                    &displaySwapchainLength,
                                    nullptr));
 
   LOGI("Swapchain length: %u\n", displaySwapchainLength);
-  tutorialSwapchainLength = displaySwapchainLength;
-  // **********************************************************
-
-  // Get Memory information and properties
-  vkGetPhysicalDeviceMemoryProperties(tutorialGpu, &tutorialMemoryProperties);
+  context->swapchainLength = displaySwapchainLength;
   delete [] formats;
 }
 
-void tutorialCreateFrameBuffers(VkRenderPass& renderPass,
+void tutorialCreateDepthBuffer(VulkanContext* context, bool stencil) {
+  bool created = CreateDepthBuffer(context->gpu, context->device,
+                                   context->memoryTypes,
+                                   context->displaySize, stencil,
+                                   &context->depth);
+  assert(created);
+  LOGI("Depth buffer: format %d, %llu bytes, %s\n", context->depth.format,
+       static_cast<unsigned long long>(context->depth.allocationSize),
+       context->depth.lazilyAllocated ? "lazily allocated"
+                                      : "committed up front");
+}
+
+void tutorialCreateFrameBuffers(VulkanContext* context,
+                                VkRenderPass& renderPass,
                                 VkImageView depthView) {
 
   uint32_t SwapchainImagesCount = 0;
-  CALL_VK(vkGetSwapchainImagesKHR(tutorialDevice, tutorialSwapchain,
+  CALL_VK(vkGetSwapchainImagesKHR(context->device, context->swapchain,
                                    &SwapchainImagesCount,
                                    nullptr));
 
   VkImage* displayImages = new VkImage[SwapchainImagesCount];
-  CALL_VK(vkGetSwapchainImagesKHR(tutorialDevice, tutorialSwapchain,
+  CALL_VK(vkGetSwapchainImagesKHR(context->device, context->swapchain,
                                    &SwapchainImagesCount,
                                    displayImages));
 
-  displayViews = new VkImageView[SwapchainImagesCount];
+  context->displayViews.resize(SwapchainImagesCount);
   for (uint32_t i = 0; i < SwapchainImagesCount; i++) {
     VkImageViewCreateInfo viewCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
         .pNext = nullptr,
         .image = displayImages[i],
         .viewType = VK_IMAGE_VIEW_TYPE_2D,
-        .format = tutorialDisplayFormat,
+        .format = context->displayFormat,
         .components =
             {
                 .r = VK_COMPONENT_SWIZZLE_R,
@@ -280,17 +278,17 @@ void tutorialCreateFrameBuffers(VkRenderPass& renderPass,
 
     };
 
-    CALL_VK(vkCreateImageView(tutorialDevice, &viewCreateInfo, nullptr,
-                            &displayViews[i]));
+    CALL_VK(vkCreateImageView(context->device, &viewCreateInfo, nullptr,
+                            &context->displayViews[i]));
   }
 
   delete[] displayImages;
 
-  tutorialFramebuffer = new VkFramebuffer[tutorialSwapchainLength];
+  context->framebuffers.resize(context->swapchainLength);
 
-  for (uint32_t i = 0; i < tutorialSwapchainLength; i++) {
+  for (uint32_t i = 0; i < context->swapchainLength; i++) {
     VkImageView attachments[2] = {
-        displayViews[i], depthView,
+        context->displayViews[i], depthView,
     };
     VkFramebufferCreateInfo fbCreateInfo{
         .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
@@ -299,23 +297,37 @@ void tutorialCreateFrameBuffers(VkRenderPass& renderPass,
         .layers = 1,
         .attachmentCount = 1,  // 2 if using depth
         .pAttachments = attachments,
-        .width = static_cast<uint32_t>(tutorialDisplaySize.width),
-        .height = static_cast<uint32_t>(tutorialDisplaySize.height),
+        .width = static_cast<uint32_t>(context->displaySize.width),
+        .height = static_cast<uint32_t>(context->displaySize.height),
     };
     fbCreateInfo.attachmentCount = (depthView == VK_NULL_HANDLE ? 1 : 2);
 
-    CALL_VK(vkCreateFramebuffer(tutorialDevice, &fbCreateInfo, nullptr,
-                              &tutorialFramebuffer[i]));
+    CALL_VK(vkCreateFramebuffer(context->device, &fbCreateInfo, nullptr,
+                              &context->framebuffers[i]));
   }
 }
 
-void tutorialCleanup() {
-  for (int i = 0; i < tutorialSwapchainLength; i++) {
-    vkDestroyFramebuffer(tutorialDevice, tutorialFramebuffer[i], nullptr);
-    vkDestroyImageView(tutorialDevice, displayViews[i], nullptr);
+void tutorialCleanup(VulkanContext* context) {
+  for (VkFramebuffer framebuffer : context->framebuffers) {
+    vkDestroyFramebuffer(context->device, framebuffer, nullptr);
+  }
+  for (VkImageView view : context->displayViews) {
+    vkDestroyImageView(context->device, view, nullptr);
   }
-  delete[] displayViews;
-  delete[] tutorialFramebuffer;
+  context->framebuffers.clear();
+  context->displayViews.clear();
+  DestroyDepthBuffer(context->device, &context->depth);
 
-  vkDestroySwapchainKHR(tutorialDevice, tutorialSwapchain, nullptr);
+  vkDestroySwapchainKHR(context->device, context->swapchain, nullptr);
+  context->swapchain = VK_NULL_HANDLE;
+}
+
+void tutorialDestroyContext(VulkanContext* context) {
+  if (context->swapchain != VK_NULL_HANDLE) tutorialCleanup(context);
+  vkDestroyDevice(context->device, nullptr);
+  if (context->surface != VK_NULL_HANDLE) {
+    vkDestroySurfaceKHR(context->instance, context->surface, nullptr);
+  }
+  vkDestroyInstance(context->instance, nullptr);
+  *context = VulkanContext();
 }
@@ -18,26 +18,26 @@
 #include <vulkan_wrapper.h>
 #include <stdexcept>
 #include <android/native_window.h>
+#include "VulkanContext.hpp"
 
-extern VkInstance tutorialInstance;
-extern VkPhysicalDevice tutorialGpu;
-extern VkDevice tutorialDevice;
-extern VkQueue tutorialGraphicsQueue;
-extern VkPhysicalDeviceMemoryProperties tutorialMemoryProperties;
-
-extern VkSurfaceKHR tutorialSurface;
-extern VkSwapchainKHR tutorialSwapchain;
-extern VkExtent2D tutorialDisplaySize;
-extern VkFormat tutorialDisplayFormat;
-extern uint32_t tutorialSwapchainLength;
-
-extern VkFramebuffer *tutorialFramebuffer;
-
-void tutorialInitWindow(ANativeWindow *platformWindow,
+// Creates |context|'s instance and device, and a surface for
+// |platformWindow|; with no window, the context renders offscreen
+void tutorialInitWindow(VulkanContext *context, ANativeWindow *platformWindow,
                         VkApplicationInfo *appInfo);
-void tutorialCreateSwapChain();
-void tutorialCreateFrameBuffers(VkRenderPass &renderPass,
+void tutorialCreateSwapChain(
+    VulkanContext *context,
+    SwapchainProfile profile = kSwapchainHighThroughput,
+    uint32_t imageCount = 0);
+// A transient, lazily allocated where it can be, displaySize depth buffer
+// in context->depth: pass its view to tutorialCreateFrameBuffers(), and
+// attach it with DONT_CARE store ops so it stays in tile memory
+void tutorialCreateDepthBuffer(VulkanContext *context, bool stencil = false);
+void tutorialCreateFrameBuffers(VulkanContext *context,
+                                VkRenderPass &renderPass,
                                 VkImageView depthView = VK_NULL_HANDLE);
-void tutorialCleanup();
+// Destroys the swapchain, framebuffers and depth buffer
+void tutorialCleanup(VulkanContext *context);
+// Destroys the rest: device, surface and instance
+void tutorialDestroyContext(VulkanContext *context);
 
 #endif  // TUTO_WINDOW_MANAGER_HPP
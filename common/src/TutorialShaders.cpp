@@ -13,14 +13,11 @@
 // limitations under the License.
 #include "TutorialShaders.hpp"
 
-extern VkDevice tutorialDevice;
-extern AAssetManager* tutorialAssetManager;
-
-VkResult loadShaderFromFile(const char* filePath, VkShaderModule* shaderOut,
-                            ShaderType type) {
+VkResult loadShaderFromFile(const VulkanContext& context, const char* filePath,
+                            VkShaderModule* shaderOut, ShaderType type) {
   // Read the file:
   AAsset* file =
-      AAssetManager_open(tutorialAssetManager, filePath, AASSET_MODE_BUFFER);
+      AAssetManager_open(context.assetManager, filePath, AASSET_MODE_BUFFER);
   size_t fileLength = AAsset_getLength(file);
 
   char* fileContent = new char[fileLength];
@@ -35,7 +32,7 @@ VkResult loadShaderFromFile(const char* filePath, VkShaderModule* shaderOut,
       .flags = 0,
   };
   VkResult result = vkCreateShaderModule(
-      tutorialDevice, &shaderModuleCreateInfo, nullptr, shaderOut);
+      context.device, &shaderModuleCreateInfo, nullptr, shaderOut);
 
   delete[] fileContent;
 
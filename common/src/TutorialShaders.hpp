@@ -17,9 +17,11 @@
 
 #include <android/asset_manager.h>
 #include <vulkan_wrapper.h>
+#include "VulkanContext.hpp"
 enum ShaderType { VERTEX_SHADER, FRAGMENT_SHADER };
 
-VkResult loadShaderFromFile(const char* filePath, VkShaderModule* shaderOut,
-                            ShaderType type);
+// Creates the module on |context|'s device, from its assets
+VkResult loadShaderFromFile(const VulkanContext& context, const char* filePath,
+                            VkShaderModule* shaderOut, ShaderType type);
 
 #endif  // TUTORIAL_SHADERS_HPP
\ No newline at end of file
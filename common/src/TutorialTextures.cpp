@@ -17,22 +17,72 @@
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_ONLY_PNG
 #include "stb_image.h"
+#include "PixelCopy.hpp"
 #include "TutoWindowManager.hpp"
 #include "TutorialUtils.hpp"
 
 #include <stdexcept>
 
-extern VkDevice tutorialDevice;
-extern AAssetManager* tutorialAssetManager;
-extern VkPhysicalDeviceMemoryProperties tutorialMemoryProperties;
-extern VkCommandPool cmdPool;
-extern VkPhysicalDevice tutorialGpu;
+// Begins a one-time command buffer from a new pool on |queueFamily|
+static VkCommandBuffer beginUploadCommands(const VulkanContext& context,
+                                           uint32_t queueFamily,
+                                           VkCommandPool* pool) {
+  VkCommandPoolCreateInfo poolInfo = {
+          .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+          .pNext = nullptr,
+          .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+          .queueFamilyIndex = queueFamily,
+  };
+  CALL_VK(vkCreateCommandPool(context.device, &poolInfo, nullptr, pool));
+
+  VkCommandBuffer cmdBuffer;
+  const VkCommandBufferAllocateInfo cmd = {
+          .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+          .pNext = nullptr,
+          .commandPool = *pool,
+          .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+          .commandBufferCount = 1,
+  };
+  CALL_VK(vkAllocateCommandBuffers(context.device, &cmd, &cmdBuffer));
+
+  VkCommandBufferBeginInfo cmd_buf_info = {
+          .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+          .pNext = nullptr,
+          .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+          .pInheritanceInfo = nullptr};
+  CALL_VK(vkBeginCommandBuffer(cmdBuffer, &cmd_buf_info));
+  return cmdBuffer;
+}
+
+// Moves |image| into |newLayout| for the copy
+static void transitionForCopy(VkCommandBuffer cmdBuffer, VkImage image,
+                              VkImageLayout oldLayout, VkImageLayout newLayout,
+                              VkAccessFlags srcAccess,
+                              VkAccessFlags dstAccess) {
+  VkImageMemoryBarrier barrier = {
+          .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+          .pNext = nullptr,
+          .srcAccessMask = srcAccess,
+          .dstAccessMask = dstAccess,
+          .oldLayout = oldLayout,
+          .newLayout = newLayout,
+          .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+          .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+          .image = image,
+          .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+  };
+  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_HOST_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0,
+                       nullptr, 1, &barrier);
+}
 
 // Open texture file from asset, load it into the created texture
 // The supported texture format is in kTexFmt
-//     Skipping memory barriers the next draw command is far out
-//     by then, the blit will way complete ahead
-VkResult tutorialLoadTextureFromFile(const char* filePath,
+//     The staging copy runs on the transfer queue, which hands the
+//     texture over to the graphics queue, so uploads do not wait behind
+//     rendering
+VkResult tutorialLoadTextureFromFile(const VulkanContext& context,
+                                     const char* filePath,
                                      struct texture_object* tex_obj,
                                      VkImageUsageFlags usage,
                                      VkFlags required_props) {
@@ -45,7 +95,7 @@ VkResult tutorialLoadTextureFromFile(const char* filePath,
   // Check for linear supportability
   VkFormatProperties props;
   bool  needBlit = true;
-  vkGetPhysicalDeviceFormatProperties(tutorialGpu, kTexFmt, &props);
+  vkGetPhysicalDeviceFormatProperties(context.gpu, kTexFmt, &props);
   assert((props.linearTilingFeatures | props.optimalTilingFeatures) &
           VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
 
@@ -55,21 +105,31 @@ VkResult tutorialLoadTextureFromFile(const char* filePath,
   }
 
     // Read the file:
-  AAsset* file = AAssetManager_open(tutorialAssetManager, filePath,
+  AAsset* file = AAssetManager_open(context.assetManager, filePath,
                                     AASSET_MODE_BUFFER);
   size_t fileLength = AAsset_getLength(file);
   stbi_uc* fileContent = new unsigned char[fileLength];
   AAsset_read(file, fileContent, fileLength);
 
+  // RGB and RGBA are decoded as they are, and made RGBA as they are copied
+  // to the texture; grey is expanded by stb_image
   uint32_t imgWidth, imgHeight, n;
+  stbi_info_from_memory(fileContent, fileLength,
+                        reinterpret_cast<int*>(&imgWidth),
+                        reinterpret_cast<int*>(&imgHeight),
+                        reinterpret_cast<int*>(&n));
+  int channels = (n == 3 || n == 4) ? 0 : 4;
   unsigned char* imageData = stbi_load_from_memory(
           fileContent, fileLength, reinterpret_cast<int*>(&imgWidth),
-          reinterpret_cast<int*>(&imgHeight), reinterpret_cast<int*>(&n), 0);
+          reinterpret_cast<int*>(&imgHeight), reinterpret_cast<int*>(&n),
+          channels);
+  if (channels) n = channels;
 
   tex_obj->tex_width = imgWidth;
   tex_obj->tex_height = imgHeight;
 
-  // Allocate the linear texture so texture could be copied over
+  // Sampled as it is in a linear image where the device can, else copied
+  // from a staging buffer into an optimally tiled one
   VkImageCreateInfo image_create_info = {
           .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
           .pNext = nullptr,
@@ -80,11 +140,14 @@ VkResult tutorialLoadTextureFromFile(const char* filePath,
           .mipLevels = 1,
           .arrayLayers = 1,
           .samples = VK_SAMPLE_COUNT_1_BIT,
-          .tiling = VK_IMAGE_TILING_LINEAR,
-          .usage = (needBlit ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT :
-                               VK_IMAGE_USAGE_SAMPLED_BIT),
+          .tiling = (needBlit ? VK_IMAGE_TILING_OPTIMAL :
+                                VK_IMAGE_TILING_LINEAR),
+          .usage = (needBlit ? VK_IMAGE_USAGE_TRANSFER_DST_BIT : 0u) |
+                   VK_IMAGE_USAGE_SAMPLED_BIT,
           .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
           .queueFamilyIndexCount = 0,
+          .initialLayout = (needBlit ? VK_IMAGE_LAYOUT_UNDEFINED :
+                                       VK_IMAGE_LAYOUT_PREINITIALIZED),
           .flags = 0,
   };
   VkMemoryAllocateInfo mem_alloc = {
@@ -95,114 +158,135 @@ VkResult tutorialLoadTextureFromFile(const char* filePath,
   };
 
   VkMemoryRequirements mem_reqs;
-  CALL_VK(vkCreateImage(tutorialDevice, &image_create_info,
+  CALL_VK(vkCreateImage(context.device, &image_create_info,
                       nullptr, &tex_obj->image));
-  vkGetImageMemoryRequirements(tutorialDevice, tex_obj->image, &mem_reqs);
+  vkGetImageMemoryRequirements(context.device, tex_obj->image, &mem_reqs);
   mem_alloc.allocationSize = mem_reqs.size;
-  VK_CHECK(memory_type_from_properties(mem_reqs.memoryTypeBits,
-                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                              &mem_alloc.memoryTypeIndex));
-  CALL_VK(vkAllocateMemory(tutorialDevice, &mem_alloc, nullptr, &tex_obj->mem));
-  CALL_VK(vkBindImageMemory(tutorialDevice, tex_obj->image, tex_obj->mem, 0));
-
-  if (required_props & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-    const VkImageSubresource subres = {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .mipLevel = 0,
-            .arrayLayer = 0,
-    };
-    VkSubresourceLayout layout;
-    void* data;
-
-    vkGetImageSubresourceLayout(tutorialDevice, tex_obj->image, &subres,
-                                &layout);
-    CALL_VK(vkMapMemory(tutorialDevice, tex_obj->mem, 0, mem_alloc.allocationSize,
-                      0, &data));
-
-    for (int32_t y = 0; y < imgHeight; y++) {
-      unsigned char* row = (unsigned char*)((char*)data + layout.rowPitch * y);
-      for (int32_t x = 0; x < imgWidth; x++) {
-        row[x * 4] = imageData[(x + y * imgWidth) * 4];
-        row[x * 4 + 1] = imageData[(x + y * imgWidth) * 4 + 1];
-        row[x * 4 + 2] = imageData[(x + y * imgWidth) * 4 + 2];
-        row[x * 4 + 3] = imageData[(x + y * imgWidth) * 4 + 3];
-      }
-    }
-
-    vkUnmapMemory(tutorialDevice, tex_obj->mem);
-    delete[] imageData;
-  }
-  delete [] fileContent;
+  VK_CHECK(memory_type_from_properties(
+      context, mem_reqs.memoryTypeBits,
+      needBlit ? kMemoryUsageGpuOnly : kMemoryUsageDynamic,
+      &mem_alloc.memoryTypeIndex));
+  CALL_VK(vkAllocateMemory(context.device, &mem_alloc, nullptr, &tex_obj->mem));
+  CALL_VK(vkBindImageMemory(context.device, tex_obj->image, tex_obj->mem, 0));
 
   tex_obj->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
- 
-  // If linear is supported, we are done
+
+  // If linear is supported, we are done once the pixels are in
   if (!needBlit) {
-    return VK_SUCCESS;
-  }
+    if (required_props & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+      const VkImageSubresource subres = {
+              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+              .mipLevel = 0,
+              .arrayLayer = 0,
+      };
+      VkSubresourceLayout layout;
+      void* data;
+
+      vkGetImageSubresourceLayout(context.device, tex_obj->image, &subres,
+                                  &layout);
+      CALL_VK(vkMapMemory(context.device, tex_obj->mem, 0,
+                          mem_alloc.allocationSize, 0, &data));
 
-  // save current image and mem as staging image and memory
-  VkImage stageImage = tex_obj->image;
-  VkDeviceMemory stageMem = tex_obj->mem;
-  tex_obj->image = VK_NULL_HANDLE;
-  tex_obj->mem   = VK_NULL_HANDLE;
+      CopyPixelsToRgba(imageData, n, imgWidth, imgHeight,
+                       static_cast<uint8_t*>(data) + layout.offset,
+                       layout.rowPitch, 0);
 
-  // Create a tile texture to blit into
-  image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
-  image_create_info.usage  = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-                             VK_IMAGE_USAGE_SAMPLED_BIT;
-  CALL_VK(vkCreateImage(tutorialDevice, &image_create_info,
-                                    nullptr, &tex_obj->image));
-  vkGetImageMemoryRequirements(tutorialDevice, tex_obj->image, &mem_reqs);
+      vkUnmapMemory(context.device, tex_obj->mem);
+    }
+    stbi_image_free(imageData);
+    delete [] fileContent;
+    return VK_SUCCESS;
+  }
 
+  // Stage the pixels in rows as far apart as the device copies them
+  // fastest; a power of 2 of at least 4 is a whole number of texels
+  VkPhysicalDeviceProperties gpuProperties;
+  vkGetPhysicalDeviceProperties(context.gpu, &gpuProperties);
+  VkDeviceSize pitchAlignment = 4;
+  while (pitchAlignment <
+         gpuProperties.limits.optimalBufferCopyRowPitchAlignment) {
+    pitchAlignment <<= 1;
+  }
+  VkDeviceSize rowPitch = (imgWidth * 4ull + pitchAlignment - 1) &
+                          ~(pitchAlignment - 1);
+  VkBufferCreateInfo stageInfo = {
+          .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+          .pNext = nullptr,
+          .flags = 0,
+          .size = rowPitch * imgHeight,
+          .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+          .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+          .queueFamilyIndexCount = 0,
+          .pQueueFamilyIndices = nullptr,
+  };
+  VkBuffer stageBuffer;
+  VkDeviceMemory stageMem;
+  CALL_VK(vkCreateBuffer(context.device, &stageInfo, nullptr, &stageBuffer));
+  vkGetBufferMemoryRequirements(context.device, stageBuffer, &mem_reqs);
   mem_alloc.allocationSize = mem_reqs.size;
-  VK_CHECK(memory_type_from_properties(mem_reqs.memoryTypeBits,
-                                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-                                     &mem_alloc.memoryTypeIndex));
-  CALL_VK(vkAllocateMemory(tutorialDevice, &mem_alloc, nullptr, &tex_obj->mem));
-  CALL_VK(vkBindImageMemory(tutorialDevice, tex_obj->image, tex_obj->mem, 0));
+  VK_CHECK(memory_type_from_properties(context, mem_reqs.memoryTypeBits,
+                                       kMemoryUsageUpload,
+                                       &mem_alloc.memoryTypeIndex));
+  CALL_VK(vkAllocateMemory(context.device, &mem_alloc, nullptr, &stageMem));
+  CALL_VK(vkBindBufferMemory(context.device, stageBuffer, stageMem, 0));
 
-  VkCommandBuffer gfxCmd;
-  const VkCommandBufferAllocateInfo cmd = {
-          .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+  void* data;
+  CALL_VK(vkMapMemory(context.device, stageMem, 0, VK_WHOLE_SIZE, 0, &data));
+  CopyPixelsToRgba(imageData, n, imgWidth, imgHeight,
+                   static_cast<uint8_t*>(data), rowPitch, 0);
+  // For upload memory that is not coherent
+  VkMappedMemoryRange written = {
+          .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
           .pNext = nullptr,
-          .commandPool = cmdPool,
-          .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-          .commandBufferCount = 1,
+          .memory = stageMem,
+          .offset = 0,
+          .size = VK_WHOLE_SIZE,
   };
+  CALL_VK(vkFlushMappedMemoryRanges(context.device, 1, &written));
+  vkUnmapMemory(context.device, stageMem);
+  stbi_image_free(imageData);
+  delete [] fileContent;
 
-  CALL_VK(vkAllocateCommandBuffers(tutorialDevice, &cmd, &gfxCmd));
+  VkCommandPool transferPool, gfxPool;
+  VkCommandBuffer transferCmd = beginUploadCommands(
+      context, context.queues.family[kQueueTransfer], &transferPool);
+  VkCommandBuffer gfxCmd = beginUploadCommands(
+      context, context.queues.family[kQueueGraphics], &gfxPool);
 
-  VkCommandBufferBeginInfo cmd_buf_info = {
-          .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-          .pNext = nullptr,
-          .flags = 0,
-          .pInheritanceInfo = nullptr};
-  CALL_VK(vkBeginCommandBuffer(gfxCmd, &cmd_buf_info));
-
-  VkImageCopy bltInfo = {
-    .srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-    .srcSubresource.mipLevel = 0,
-    .srcSubresource.baseArrayLayer = 0,
-    .srcSubresource.layerCount = 1,
-    .srcOffset.x = 0,
-    .srcOffset.y = 0,
-    .srcOffset.z = 0,
-    .dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-    .dstSubresource.mipLevel = 0,
-    .dstSubresource.baseArrayLayer = 0,
-    .dstSubresource.layerCount = 1,
-    .dstOffset.x = 0,
-    .dstOffset.y = 0,
-    .dstOffset.z = 0,
-    .extent.width = imgWidth,
-    .extent.height = imgHeight,
-    .extent.depth = 1,
+  // The submit makes the staging writes visible; the image only has to
+  // leave UNDEFINED
+  transitionForCopy(transferCmd, tex_obj->image, VK_IMAGE_LAYOUT_UNDEFINED,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 0,
+                    VK_ACCESS_TRANSFER_WRITE_BIT);
+  VkBufferImageCopy copyRegion = {
+    .bufferOffset = 0,
+    .bufferRowLength = static_cast<uint32_t>(rowPitch / 4),  // in texels
+    .bufferImageHeight = 0,
+    .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1},
+    .imageOffset = {0, 0, 0},
+    .imageExtent = {imgWidth, imgHeight, 1},
   };
-  vkCmdCopyImage(gfxCmd, stageImage,
-                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, tex_obj->image,
-                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bltInfo);
+  vkCmdCopyBufferToImage(transferCmd, stageBuffer, tex_obj->image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
+                         &copyRegion);
 
+  // Hand the texture to the graphics queue, ready for fragment shaders
+  ImageOwnershipTransfer handOver = {
+    .image = tex_obj->image,
+    .range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
+    .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+    .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    .srcFamily = context.queues.family[kQueueTransfer],
+    .dstFamily = context.queues.family[kQueueGraphics],
+    .srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+    .srcAccess = VK_ACCESS_TRANSFER_WRITE_BIT,
+    .dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+    .dstAccess = VK_ACCESS_SHADER_READ_BIT,
+  };
+  RecordOwnershipRelease(transferCmd, handOver);
+  RecordOwnershipAcquire(gfxCmd, handOver);
+
+  CALL_VK(vkEndCommandBuffer(transferCmd));
   CALL_VK(vkEndCommandBuffer(gfxCmd));
   VkFenceCreateInfo fenceInfo = {
      .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
@@ -210,25 +294,55 @@ VkResult tutorialLoadTextureFromFile(const char* filePath,
      .flags = 0,
   };
   VkFence  fence;
-  CALL_VK(vkCreateFence(tutorialDevice, &fenceInfo, nullptr, &fence));
+  CALL_VK(vkCreateFence(context.device, &fenceInfo, nullptr, &fence));
 
-  VkSubmitInfo submitInfo = {
+  // The graphics submit waits for the copy; on the same queue, submission
+  // order already takes care of that
+  bool ownQueue = context.queues.HasOwnQueue(kQueueTransfer);
+  VkSemaphore copied = VK_NULL_HANDLE;
+  if (ownQueue) {
+    VkSemaphoreCreateInfo semaphoreInfo = {
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+    };
+    CALL_VK(vkCreateSemaphore(context.device, &semaphoreInfo, nullptr,
+                              &copied));
+  }
+  VkPipelineStageFlags copiedStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+  VkSubmitInfo transferSubmit = {
     .pNext = nullptr,
     .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
     .waitSemaphoreCount = 0,
     .pWaitSemaphores = nullptr,
     .pWaitDstStageMask = nullptr,
     .commandBufferCount = 1,
+    .pCommandBuffers = &transferCmd,
+    .signalSemaphoreCount = ownQueue ? 1u : 0u,
+    .pSignalSemaphores = &copied,
+  };
+  CALL_VK(vkQueueSubmit(context.queues.queue[kQueueTransfer], 1,
+                        &transferSubmit, VK_NULL_HANDLE));
+  VkSubmitInfo submitInfo = {
+    .pNext = nullptr,
+    .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+    .waitSemaphoreCount = ownQueue ? 1u : 0u,
+    .pWaitSemaphores = &copied,
+    .pWaitDstStageMask = &copiedStage,
+    .commandBufferCount = 1,
     .pCommandBuffers = &gfxCmd,
     .signalSemaphoreCount = 0,
     .pSignalSemaphores = nullptr,
   };
-  CALL_VK(vkQueueSubmit(tutorialGraphicsQueue, 1, &submitInfo, fence) != VK_SUCCESS);
-  CALL_VK(vkWaitForFences(tutorialDevice, 1, &fence, VK_TRUE, 100000000) !=VK_SUCCESS);
-  vkDestroyFence(tutorialDevice, fence, nullptr);
+  CALL_VK(vkQueueSubmit(context.graphicsQueue, 1, &submitInfo, fence));
+  CALL_VK(vkWaitForFences(context.device, 1, &fence, VK_TRUE, 100000000));
+  vkDestroyFence(context.device, fence, nullptr);
 
-  vkFreeCommandBuffers(tutorialDevice, cmdPool, 1, &gfxCmd);
-  vkDestroyImage(tutorialDevice, stageImage, nullptr);
-  vkFreeMemory(tutorialDevice, stageMem, nullptr);
+  vkDestroySemaphore(context.device, copied, nullptr);
+  vkDestroyCommandPool(context.device, transferPool, nullptr);
+  vkDestroyCommandPool(context.device, gfxPool, nullptr);
+  vkDestroyBuffer(context.device, stageBuffer, nullptr);
+  vkFreeMemory(context.device, stageMem, nullptr);
   return VK_SUCCESS;
 }
@@ -17,6 +17,7 @@
 
 #include <android/asset_manager.h>
 #include <vulkan_wrapper.h>
+#include "VulkanContext.hpp"
 
 typedef struct texture_object {
   VkSampler sampler;
@@ -27,7 +28,9 @@ typedef struct texture_object {
   int32_t tex_width, tex_height;
 } texture_object;
 
-VkResult tutorialLoadTextureFromFile(const char* filePath,
+// Loads |filePath| from |context|'s assets into a texture on its device
+VkResult tutorialLoadTextureFromFile(const VulkanContext& context,
+                                     const char* filePath,
                                      struct texture_object* tex_obj,
                                      VkImageUsageFlags usage,
                                      VkFlags required_props);
@@ -14,23 +14,14 @@
 
 #include "TutorialUtils.hpp"
 
-
-extern VkPhysicalDeviceMemoryProperties tutorialMemoryProperties;
-
-VkResult memory_type_from_properties(uint32_t typeBits, VkFlags requirements_mask,
-                                 uint32_t *typeIndex) {
-  // Search memtypes to find first index with those properties
-  for (uint32_t i = 0; i < 32; i++) {
-    if ((typeBits & 1) == 1) {
-      // Type is available, does it match user properties?
-      if ((tutorialMemoryProperties.memoryTypes[i].propertyFlags &
-           requirements_mask) == requirements_mask) {
-        *typeIndex = i;
-        return VK_SUCCESS;
-      }
-    }
-    typeBits >>= 1;
+VkResult memory_type_from_properties(const VulkanContext &context,
+                                     uint32_t typeBits, MemoryUsage usage,
+                                     uint32_t *typeIndex) {
+  uint32_t type = context.memoryTypes.Select(usage, typeBits);
+  if (type == MemoryTypeSelector::kNoType) {
+    // No memory types matched, return failure
+    return VK_ERROR_MEMORY_MAP_FAILED;
   }
-  // No memory types matched, return failure
-  return VK_ERROR_MEMORY_MAP_FAILED;
+  *typeIndex = type;
+  return VK_SUCCESS;
 }
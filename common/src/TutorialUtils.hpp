@@ -18,9 +18,13 @@
 #include <android/asset_manager.h>
 #include <vulkan_wrapper.h>
 #include <cassert>
+#include "VulkanContext.hpp"
 
-VkResult memory_type_from_properties(uint32_t typeBits, VkFlags requirements_mask,
-                                 uint32_t *typeIndex);
+// The best of |context|'s memory types in |typeBits| for |usage|, see
+// MemoryTypeSelector
+VkResult memory_type_from_properties(const VulkanContext &context,
+                                     uint32_t typeBits, MemoryUsage usage,
+                                     uint32_t *typeIndex);
 
 // A set of debugging functions
 static const char* TAG = "Vulkan-Tutorial";
@@ -0,0 +1,63 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef VULKAN_CONTEXT_HPP
+#define VULKAN_CONTEXT_HPP
+
+#include <android/asset_manager.h>
+#include <vulkan_wrapper.h>
+#include <vector>
+#include "DepthBuffer.hpp"
+#include "MemoryTypeSelector.hpp"
+#include "QueueTopology.hpp"
+#include "SwapchainPolicy.hpp"
+
+// Everything the tutorial helpers work on: an instance and device, and for
+// a window, its surface and swapchain. Contexts share nothing, so each can
+// live on a thread of its own, rendering offscreen when it has no window.
+// The one shared step is InitVulkan(), which loads the entry points for
+// the whole process; call it before starting the threads.
+struct VulkanContext {
+  VulkanContext();
+
+  VkInstance instance;
+  VkPhysicalDevice gpu;
+  VkDevice device;
+  // Graphics, plus the transfer and compute queues uploads and compute work
+  // go to, so they can overlap rendering
+  QueueTopology queues;
+  VkQueue graphicsQueue;
+  VkPhysicalDeviceMemoryProperties memoryProperties;
+  // Ranks memoryProperties' types for each MemoryUsage
+  MemoryTypeSelector memoryTypes;
+  // Where shaders and textures load from
+  AAssetManager* assetManager;
+
+  // VK_NULL_HANDLE for an offscreen context
+  VkSurfaceKHR surface;
+  VkSwapchainKHR swapchain;
+  // In the display's orientation: draw with preRotation.rotation applied
+  // to clip-space positions
+  VkExtent2D displaySize;
+  VkFormat displayFormat;
+  uint32_t swapchainLength;
+  PreRotation preRotation;
+
+  std::vector<VkImageView> displayViews;
+  std::vector<VkFramebuffer> framebuffers;
+  // From tutorialCreateDepthBuffer(), for tutorialCreateFrameBuffers()
+  DepthBuffer depth;
+};
+
+#endif  // VULKAN_CONTEXT_HPP
@@ -0,0 +1,562 @@
+#!/usr/bin/env python3
+# Copyright 2016 Google Inc. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates vulkan_wrapper.h and vulkan_wrapper.cpp from the Vulkan registry.
+
+Usage:
+    gen_vulkan_wrapper.py <path/to/vk.xml> [output directory]
+
+vk.xml ships with the Vulkan-Headers project (registry/vk.xml); use the copy
+matching the vulkan_core.h the tutorials build against. The output directory
+defaults to the directory of this script.
+
+Every command of the groups listed below is emitted, wrapped in a guard on
+the group's own macro (VK_VERSION_1_x, or the extension name), so the output
+still compiles against older NDK headers that lack a group:
+  - EXPORTED_GROUPS are the entry points libvulkan.so exports. They become
+    the global function pointer variables bound by InitVulkan() /
+    InitVulkanLazy(), and are also added to the dispatch tables.
+  - TABLE_GROUPS are reachable only through the per-instance and per-device
+    dispatch tables, which query them at runtime; vkGet*ProcAddr() returns
+    NULL for a version the instance/device does not support and for an
+    extension that is not enabled, so a NULL member is the runtime gate.
+    Global-level commands of these groups (vkEnumerateInstanceVersion) are
+    emitted as global variables, since no table can hold them.
+Extensions that add only structures and enums (VK_EXT_memory_budget,
+VK_EXT_pipeline_creation_feedback, VK_KHR_present_id,
+VK_KHR_dedicated_allocation, ...) need nothing from the wrapper.
+"""
+
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+EXPORTED_GROUPS = [
+    'VK_VERSION_1_0',
+    'VK_KHR_surface',
+    'VK_KHR_swapchain',
+    'VK_KHR_display',
+    'VK_KHR_display_swapchain',
+    'VK_KHR_xlib_surface',
+    'VK_KHR_xcb_surface',
+    'VK_KHR_wayland_surface',
+    'VK_KHR_android_surface',
+    'VK_KHR_win32_surface',
+    'VK_EXT_debug_report',
+]
+
+TABLE_GROUPS = [
+    'VK_VERSION_1_1',
+    'VK_VERSION_1_2',
+    'VK_VERSION_1_3',
+    'VK_KHR_get_physical_device_properties2',
+    'VK_KHR_get_memory_requirements2',
+    'VK_KHR_timeline_semaphore',
+    'VK_KHR_synchronization2',
+    'VK_KHR_dynamic_rendering',
+    'VK_KHR_push_descriptor',
+    'VK_EXT_host_image_copy',
+    'VK_KHR_present_wait',
+    'VK_EXT_headless_surface',
+]
+
+# Groups whose guard is not their own macro. The debug report entry points
+# have always been opt-in here, and pull in the SDK platform header.
+GUARD_OVERRIDES = {
+    'VK_VERSION_1_0': None,
+    'VK_KHR_surface': None,
+    'VK_KHR_swapchain': None,
+    'VK_KHR_display': None,
+    'VK_KHR_display_swapchain': None,
+    'VK_EXT_debug_report': 'USE_DEBUG_EXTENTIONS',
+}
+GROUP_INCLUDES = {
+    'VK_EXT_debug_report': '<vulkan/vk_sdk_platform.h>',
+}
+
+# vkGetInstanceProcAddr fills the instance table and so cannot live in it;
+# vkGetDeviceProcAddr takes a VkDevice but is queried per instance.
+GLOBAL_ONLY = {'vkGetInstanceProcAddr'}
+INSTANCE_LEVEL = {'vkGetDeviceProcAddr'}
+
+INSTANCE_HANDLES = {'VkInstance', 'VkPhysicalDevice'}
+DEVICE_HANDLES = {'VkDevice', 'VkQueue', 'VkCommandBuffer'}
+
+COPYRIGHT = """\
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// This file is generated by gen_vulkan_wrapper.py from vk.xml, do not edit.
+"""
+
+HEADER_PROLOGUE = """\
+#ifndef VULKAN_WRAPPER_H
+#define VULKAN_WRAPPER_H
+
+#define VK_NO_PROTOTYPES 1
+#include <vulkan/vulkan.h>
+
+/* Initialize the Vulkan function pointer variables declared in this header.
+ * Returns 0 if vulkan is not available, non-zero if it is available.
+ */
+int InitVulkan(void);
+
+/* Lazy-binding variant of InitVulkan(): only opens libvulkan.so and points
+ * every function pointer variable at a resolver thunk, which dlsym()s the
+ * real entry point and replaces itself on its first call. Startup cost then
+ * scales with the entry points the app actually calls. All variables are
+ * non-NULL afterwards, so they cannot be used to probe for a symbol; calling
+ * one libvulkan.so does not export aborts.
+ * Returns 0 if vulkan is not available, non-zero if it is available.
+ */
+int InitVulkanLazy(void);
+
+/* Cold-start counters of the wrapper, cumulative since process start. */
+typedef struct VulkanWrapperStats {
+    uint32_t boundSymbols;     // entry points resolved through dlsym()
+    uint64_t loadNanoseconds;  // time spent in dlopen("libvulkan.so")
+    uint64_t bindNanoseconds;  // time spent in dlsym(), eager and lazy
+} VulkanWrapperStats;
+
+void GetVulkanWrapperStats(VulkanWrapperStats* stats);
+
+"""
+
+TABLES_COMMENT = """\
+// Per-instance and per-device dispatch tables.
+// The global function pointers above come from libvulkan.so and are loader
+// trampolines: each call first looks up the real entry point behind the
+// dispatchable handle. Tables filled through vkGetInstanceProcAddr() and
+// vkGetDeviceProcAddr() hold the driver entry points for one instance or
+// device, so calls made through them (vkCmd* in particular) skip that hop.
+// They also carry every Vulkan 1.1-1.3 and extension entry point the wrapper
+// knows about; members the instance or device does not support stay NULL.
+"""
+
+HEADER_EPILOGUE = """\
+/* Fill |table| with the entry points of |instance|, which must be created
+ * with the global vkCreateInstance(). Entry points the instance does not
+ * expose (extensions not enabled, for example) are left NULL.
+ * Returns 0 if InitVulkan() has not succeeded, non-zero otherwise.
+ */
+int InitVulkanInstanceDispatchTable(VkInstance instance,
+                                    VkInstanceDispatchTable* table);
+
+/* Fill |table| with the entry points of |device|, straight from the driver.
+ * Entry points the device does not expose (a core version above the one the
+ * device supports, extensions not enabled) are left NULL.
+ * Returns 0 if InitVulkan() has not succeeded, non-zero otherwise.
+ */
+int InitVulkanDeviceDispatchTable(VkDevice device,
+                                  VkDeviceDispatchTable* table);
+
+
+#endif // VULKAN_WRAPPER_H
+"""
+
+SOURCE_PROLOGUE = """\
+#include "vulkan_wrapper.h"
+#include <dlfcn.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+namespace {
+
+std::atomic<uint32_t> boundSymbolCount(0);
+std::atomic<uint64_t> bindNanoseconds(0);
+uint64_t loadNanoseconds = 0;
+
+uint64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start).count();
+}
+
+// libvulkan.so is opened once and kept for the lifetime of the process; the
+// lazy thunks below may need it at any time.
+void* OpenLibVulkan() {
+    static void* libvulkan = [] {
+        auto start = std::chrono::steady_clock::now();
+        void* library = dlopen("libvulkan.so", RTLD_NOW | RTLD_LOCAL);
+        // Desktop Linux only installs the versioned loader without the
+        // development package, e.g. where host tools replay traces.
+        if (!library)
+            library = dlopen("libvulkan.so.1", RTLD_NOW | RTLD_LOCAL);
+        loadNanoseconds = ElapsedNanoseconds(start);
+        return library;
+    }();
+    return libvulkan;
+}
+
+void* BindSymbol(void* libvulkan, const char* symbol) {
+    auto start = std::chrono::steady_clock::now();
+    void* entryPoint = dlsym(libvulkan, symbol);
+    bindNanoseconds += ElapsedNanoseconds(start);
+    if (entryPoint)
+        boundSymbolCount++;
+    return entryPoint;
+}
+
+// Resolver thunk for one entry point: the first call dlsym()s the real
+// symbol, stores it into the entry point variable (|Slot|) so later calls go
+// straight to libvulkan.so, then forwards the call. Two threads racing on the
+// first call both store the same address.
+template <typename PFN>
+struct LazyEntryPoint;
+
+template <typename R, typename... Args>
+struct LazyEntryPoint<R (VKAPI_PTR*)(Args...)> {
+    typedef R (VKAPI_PTR* Pfn)(Args...);
+
+    template <Pfn* Slot>
+    static const char*& Symbol() {
+        static const char* symbol = nullptr;
+        return symbol;
+    }
+
+    template <Pfn* Slot>
+    static VKAPI_ATTR R VKAPI_CALL Thunk(Args... args) {
+        Pfn entryPoint = reinterpret_cast<Pfn>(
+            BindSymbol(OpenLibVulkan(), Symbol<Slot>()));
+        // Same contract as InitVulkan(): calling an entry point libvulkan.so
+        // does not export is a bug in the caller; fail here rather than jump
+        // through a NULL pointer.
+        if (!entryPoint)
+            abort();
+        *Slot = entryPoint;
+        return entryPoint(args...);
+    }
+
+    template <Pfn* Slot>
+    static void Install(const char* symbol) {
+        Symbol<Slot>() = symbol;
+        *Slot = &Thunk<Slot>;
+    }
+};
+
+}  // namespace
+
+#define LAZY_ENTRY_POINT(name) \\
+    LazyEntryPoint<PFN_##name>::Install<&name>(#name)
+
+"""
+
+
+class Command(object):
+    def __init__(self, name, level, guard):
+        self.name = name
+        self.level = level  # 'global', 'instance' or 'device'
+        self.guard = guard  # extra preprocessor condition, or None
+
+
+class Group(object):
+    def __init__(self, name, guard, include, commands):
+        self.name = name
+        self.guard = guard
+        self.include = include
+        self.commands = commands
+
+
+def api_matches(element):
+    api = element.get('api')
+    return api is None or 'vulkan' in api.split(',')
+
+
+def tokenize(expression):
+    return re.findall(r'[A-Za-z0-9_]+|[,+()]', expression)
+
+
+def parse_depends(tokens):
+    """Parses a vk.xml 'depends' expression into a nested tuple tree.
+
+    ',' is a logical or and '+' a logical and; the registry parenthesizes
+    mixed expressions, '+' binds tighter here for the rest.
+    """
+    def parse_or(pos):
+        node, pos = parse_and(pos)
+        while pos < len(tokens) and tokens[pos] == ',':
+            rhs, pos = parse_and(pos + 1)
+            node = ('or', node, rhs)
+        return node, pos
+
+    def parse_and(pos):
+        node, pos = parse_term(pos)
+        while pos < len(tokens) and tokens[pos] == '+':
+            rhs, pos = parse_term(pos + 1)
+            node = ('and', node, rhs)
+        return node, pos
+
+    def parse_term(pos):
+        if tokens[pos] == '(':
+            node, pos = parse_or(pos + 1)
+            return node, pos + 1
+        return ('name', tokens[pos]), pos + 1
+
+    return parse_or(0)[0]
+
+
+def evaluate(node, selected):
+    if node[0] == 'name':
+        return node[1] in selected
+    if node[0] == 'or':
+        return evaluate(node[1], selected) or evaluate(node[2], selected)
+    return evaluate(node[1], selected) and evaluate(node[2], selected)
+
+
+def to_preprocessor(node, outer=None):
+    if node[0] == 'name':
+        return 'defined(%s)' % node[1]
+    op = '||' if node[0] == 'or' else '&&'
+    text = '%s %s %s' % (to_preprocessor(node[1], node[0]), op,
+                         to_preprocessor(node[2], node[0]))
+    return text if outer in (None, node[0]) else '(%s)' % text
+
+
+def require_depends(require):
+    """The condition of a <require> block, old or new registry syntax."""
+    depends = require.get('depends')
+    if depends:
+        return depends
+    terms = [require.get(key) for key in ('feature', 'extension')
+             if require.get(key)]
+    return '+'.join(terms) or None
+
+
+def load_commands(root):
+    """Maps every command name to the type of its first parameter."""
+    first_params = {}
+    aliases = {}
+    for command in root.iterfind('commands/command'):
+        if not api_matches(command):
+            continue
+        if command.get('alias'):
+            aliases[command.get('name')] = command.get('alias')
+            continue
+        name = command.findtext('proto/name')
+        first_params[name] = command.findtext('param/type')
+    for name, target in aliases.items():
+        while target in aliases:
+            target = aliases[target]
+        first_params[name] = first_params[target]
+    return first_params
+
+
+def command_level(name, first_param):
+    if name in GLOBAL_ONLY:
+        return 'global'
+    if name in INSTANCE_LEVEL or first_param in INSTANCE_HANDLES:
+        return 'instance'
+    if first_param in DEVICE_HANDLES:
+        return 'device'
+    return 'global'
+
+
+def load_groups(root):
+    first_params = load_commands(root)
+    elements = {}
+    for feature in root.iterfind('feature'):
+        if api_matches(feature):
+            elements[feature.get('name')] = (feature, None)
+    for extension in root.iterfind('extensions/extension'):
+        if 'vulkan' in extension.get('supported', '').split(','):
+            # Older registries carry 'protect' on the extension itself;
+            # newer ones only reference a <platform> element.
+            protect = extension.get('protect')
+            for platform in root.iterfind('platforms/platform'):
+                if platform.get('name') == extension.get('platform'):
+                    protect = platform.get('protect')
+            elements[extension.get('name')] = (extension, protect)
+
+    selected = set(EXPORTED_GROUPS + TABLE_GROUPS)
+    missing = sorted(name for name in selected if name not in elements)
+    if missing:
+        sys.exit('vk.xml does not define: ' + ', '.join(missing))
+
+    seen = set()
+    groups = []
+    for name in EXPORTED_GROUPS + TABLE_GROUPS:
+        element, protect = elements[name]
+        guard = GUARD_OVERRIDES.get(name, protect or name)
+        commands = []
+        for require in element.iterfind('require'):
+            if not api_matches(require):
+                continue
+            depends = require_depends(require)
+            subguard = None
+            if depends:
+                tree = parse_depends(tokenize(depends))
+                if not evaluate(tree, selected):
+                    continue
+                subguard = to_preprocessor(tree)
+            for command in require.iterfind('command'):
+                command_name = command.get('name')
+                if command_name in seen:
+                    continue
+                seen.add(command_name)
+                level = command_level(command_name,
+                                      first_params[command_name])
+                commands.append(Command(command_name, level, subguard))
+        groups.append(Group(name, guard, GROUP_INCLUDES.get(name), commands))
+    return groups
+
+
+def open_guard(condition):
+    if re.match(r'^defined\((\w+)\)$', condition):
+        return '#ifdef %s' % condition[len('defined('):-1]
+    if re.match(r'^\w+$', condition):
+        return '#ifdef %s' % condition
+    return '#if %s' % condition
+
+
+def emit(groups, select, line, comment=None, blank_lines=False,
+         includes=False):
+    """Emits |line(command)| for the commands picked by |select|, inside the
+    guards of their group and require block. |comment| is the indentation of
+    the group name comments, None to leave them out."""
+    out = []
+    for group in groups:
+        commands = [command for command in group.commands if select(group,
+                                                                    command)]
+        if not commands:
+            continue
+        if group.guard:
+            out.append(open_guard(group.guard))
+        if includes and group.include:
+            out.append('#include %s' % group.include)
+        if comment is not None:
+            out.append('%s// %s' % (comment, group.name))
+        subguard = None
+        for command in commands:
+            if command.guard != subguard:
+                if subguard:
+                    out.append('#endif')
+                if command.guard:
+                    out.append(open_guard(command.guard))
+                subguard = command.guard
+            out.append(line(command))
+        if subguard:
+            out.append('#endif')
+        if group.guard:
+            out.append('#endif')
+        if blank_lines:
+            out.append('')
+    return out
+
+
+def is_global(group, command):
+    return group.name in EXPORTED_GROUPS or command.level == 'global'
+
+
+def in_table(level):
+    def select(group, command):
+        return command.level == level and command.name not in GLOBAL_ONLY
+    return select
+
+
+def generate_header(groups):
+    out = [COPYRIGHT + HEADER_PROLOGUE.rstrip('\n'), '']
+    out += emit(groups, is_global,
+                lambda c: 'extern PFN_%s %s;' % (c.name, c.name), '', True,
+                True)
+    out.append(TABLES_COMMENT.rstrip('\n'))
+    for table, level in (('VkInstanceDispatchTable', 'instance'),
+                         ('VkDeviceDispatchTable', 'device')):
+        out.append('typedef struct %s {' % table)
+        out += emit(groups, in_table(level),
+                    lambda c: '  PFN_%s %s;' % (c.name, c.name), '  ')
+        out.append('} %s;' % table)
+        out.append('')
+    out.append(HEADER_EPILOGUE.rstrip('\n'))
+    return '\n'.join(out) + '\n'
+
+
+def generate_source(groups):
+    out = [COPYRIGHT + SOURCE_PROLOGUE.rstrip('\n'), '']
+
+    out += ['int InitVulkan(void) {',
+            '    void* libvulkan = OpenLibVulkan();',
+            '    if (!libvulkan)',
+            '        return 0;',
+            '',
+            '    // Vulkan supported, set function addresses']
+    out += emit(groups, is_global,
+                lambda c: ('    %s = reinterpret_cast<PFN_%s>'
+                           '(BindSymbol(libvulkan, "%s"));'
+                           % (c.name, c.name, c.name)))
+    out += ['    return 1;', '}', '']
+
+    out += ['int InitVulkanLazy(void) {',
+            '    if (!OpenLibVulkan())',
+            '        return 0;',
+            '',
+            '    // Vulkan supported, bind every entry point on its first call']
+    out += emit(groups, is_global,
+                lambda c: '    LAZY_ENTRY_POINT(%s);' % c.name)
+    out += ['    return 1;', '}', '']
+
+    out += ['void GetVulkanWrapperStats(VulkanWrapperStats* stats) {',
+            '    stats->boundSymbols = boundSymbolCount;',
+            '    stats->loadNanoseconds = loadNanoseconds;',
+            '    stats->bindNanoseconds = bindNanoseconds;',
+            '}', '']
+
+    for level, handle, proc_addr in (
+            ('instance', 'VkInstance', 'vkGetInstanceProcAddr'),
+            ('device', 'VkDevice', 'vkGetDeviceProcAddr')):
+        table = 'Vk%sDispatchTable' % level.capitalize()
+        signature = 'int InitVulkan%sDispatchTable(' % level.capitalize()
+        out += ['%s%s %s,' % (signature, handle, level),
+                '%s%s* table) {' % (' ' * len(signature), table),
+                '    if (!%s)' % proc_addr,
+                '        return 0;',
+                '']
+        out += emit(groups, in_table(level),
+                    lambda c, p=proc_addr, l=level: (
+                        '    table->%s = reinterpret_cast<PFN_%s>'
+                        '(%s(%s, "%s"));' % (c.name, c.name, p, l, c.name)))
+        out += ['    return 1;', '}', '']
+
+    out.append('// No Vulkan support, do not set function addresses')
+    out += emit(groups, is_global,
+                lambda c: 'PFN_%s %s;' % (c.name, c.name), '', True)
+    return '\n'.join(out).rstrip('\n') + '\n'
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.exit(__doc__)
+    output_dir = argv[2] if len(argv) == 3 else os.path.dirname(
+        os.path.abspath(__file__))
+    groups = load_groups(ET.parse(argv[1]).getroot())
+    for filename, generate in (('vulkan_wrapper.h', generate_header),
+                               ('vulkan_wrapper.cpp', generate_source)):
+        with open(os.path.join(output_dir, filename), 'w') as output:
+            output.write(generate(groups))
+
+
+if __name__ == '__main__':
+    main(sys.argv)
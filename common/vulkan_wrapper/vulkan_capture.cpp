@@ -0,0 +1,1262 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "vulkan_capture.h"
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+#include "vulkan_trace.h"
+
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+#define VK_CAPTURE_SURFACE(X) X(vkCreateAndroidSurfaceKHR)
+#else
+#define VK_CAPTURE_SURFACE(X)
+#endif
+
+// Every global function pointer capture replaces; the create and destroy
+// functions are the ones of VK_TRACE_DEVICE_OBJECTS.
+#define VK_CAPTURE_ENTRY_POINTS(X)               \
+    X(vkGetInstanceProcAddr)                     \
+    X(vkGetDeviceProcAddr)                       \
+    X(vkCreateInstance)                          \
+    X(vkDestroyInstance)                         \
+    X(vkEnumeratePhysicalDevices)                \
+    X(vkGetPhysicalDeviceProperties)             \
+    X(vkGetPhysicalDeviceMemoryProperties)       \
+    X(vkGetPhysicalDeviceQueueFamilyProperties)  \
+    X(vkGetPhysicalDeviceFormatProperties)       \
+    VK_CAPTURE_SURFACE(X)                        \
+    X(vkDestroySurfaceKHR)                       \
+    X(vkGetPhysicalDeviceSurfaceSupportKHR)      \
+    X(vkGetPhysicalDeviceSurfaceCapabilitiesKHR) \
+    X(vkGetPhysicalDeviceSurfaceFormatsKHR)      \
+    X(vkGetPhysicalDeviceSurfacePresentModesKHR) \
+    X(vkCreateDevice)                            \
+    X(vkDestroyDevice)                           \
+    X(vkGetDeviceQueue)                          \
+    X(vkDeviceWaitIdle)                          \
+    X(vkQueueWaitIdle)                           \
+    X(vkCreateSwapchainKHR)                      \
+    X(vkDestroySwapchainKHR)                     \
+    X(vkGetSwapchainImagesKHR)                   \
+    X(vkAcquireNextImageKHR)                     \
+    X(vkQueuePresentKHR)                         \
+    X(vkQueueSubmit)                             \
+    X(vkAllocateMemory)                          \
+    X(vkFreeMemory)                              \
+    X(vkMapMemory)                               \
+    X(vkUnmapMemory)                             \
+    X(vkFlushMappedMemoryRanges)                 \
+    X(vkBindBufferMemory)                        \
+    X(vkBindImageMemory)                         \
+    X(vkGetBufferMemoryRequirements)             \
+    X(vkGetImageMemoryRequirements)              \
+    X(vkGetImageSubresourceLayout)               \
+    X(vkCreateGraphicsPipelines)                 \
+    X(vkDestroyPipeline)                         \
+    X(vkAllocateDescriptorSets)                  \
+    X(vkFreeDescriptorSets)                      \
+    X(vkUpdateDescriptorSets)                    \
+    X(vkAllocateCommandBuffers)                  \
+    X(vkFreeCommandBuffers)                      \
+    X(vkResetCommandBuffer)                      \
+    X(vkBeginCommandBuffer)                      \
+    X(vkEndCommandBuffer)                        \
+    X(vkResetFences)                             \
+    X(vkWaitForFences)                           \
+    X(vkGetFenceStatus)                          \
+    X(vkCmdBeginRenderPass)                      \
+    X(vkCmdEndRenderPass)                        \
+    X(vkCmdBindPipeline)                         \
+    X(vkCmdBindDescriptorSets)                   \
+    X(vkCmdBindVertexBuffers)                    \
+    X(vkCmdBindIndexBuffer)                      \
+    X(vkCmdSetViewport)                          \
+    X(vkCmdSetScissor)                           \
+    X(vkCmdPushConstants)                        \
+    X(vkCmdDraw)                                 \
+    X(vkCmdDrawIndexed)                          \
+    X(vkCmdPipelineBarrier)                      \
+    X(vkCmdCopyBuffer)                           \
+    X(vkCmdCopyImage)                            \
+    X(vkCmdCopyBufferToImage)                    \
+    X(vkCmdBlitImage)                            \
+    X(vkCreateBuffer)                            \
+    X(vkDestroyBuffer)                           \
+    X(vkCreateImage)                             \
+    X(vkDestroyImage)                            \
+    X(vkCreateImageView)                         \
+    X(vkDestroyImageView)                        \
+    X(vkCreateSampler)                           \
+    X(vkDestroySampler)                          \
+    X(vkCreateShaderModule)                      \
+    X(vkDestroyShaderModule)                     \
+    X(vkCreatePipelineCache)                     \
+    X(vkDestroyPipelineCache)                    \
+    X(vkCreatePipelineLayout)                    \
+    X(vkDestroyPipelineLayout)                   \
+    X(vkCreateDescriptorSetLayout)               \
+    X(vkDestroyDescriptorSetLayout)              \
+    X(vkCreateDescriptorPool)                    \
+    X(vkDestroyDescriptorPool)                   \
+    X(vkCreateRenderPass)                        \
+    X(vkDestroyRenderPass)                       \
+    X(vkCreateFramebuffer)                       \
+    X(vkDestroyFramebuffer)                      \
+    X(vkCreateCommandPool)                       \
+    X(vkDestroyCommandPool)                      \
+    X(vkCreateFence)                             \
+    X(vkDestroyFence)                            \
+    X(vkCreateSemaphore)                         \
+    X(vkDestroySemaphore)
+
+namespace {
+
+// A live vkMapMemory() mapping, written to the trace when the app unmaps or
+// flushes it.
+struct Mapping {
+    VkDeviceSize allocationSize;
+    uint8_t* data;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+};
+
+struct CaptureState {
+    std::mutex mutex;
+    TraceWriter writer;
+    std::unordered_map<uint64_t, Mapping> memory;
+#define VK_CAPTURE_NEXT(name) PFN_##name name;
+    // The driver entry points the recording versions forward to.
+    struct {
+        VK_CAPTURE_ENTRY_POINTS(VK_CAPTURE_NEXT)
+    } next;
+#undef VK_CAPTURE_NEXT
+};
+
+CaptureState& State() {
+    static CaptureState* state = new CaptureState;
+    return *state;
+}
+
+// One recorded call. Holds the capture lock for the whole call so the trace
+// sees calls in the order the driver did, and so that a handle is always
+// recorded as created before another thread can use it.
+class Record {
+  public:
+    explicit Record(TraceCommand command)
+        : lock_(State().mutex), start_(std::chrono::steady_clock::now()),
+          nanoseconds_(0) {
+        writer().Begin(command);
+    }
+    ~Record() { writer().End(nanoseconds_); }
+
+    // Marks the end of the driver call; what is encoded afterwards does not
+    // count towards the call's time.
+    void Called() {
+        nanoseconds_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+    }
+    TraceWriter& writer() { return State().writer; }
+
+  private:
+    std::lock_guard<std::mutex> lock_;
+    std::chrono::steady_clock::time_point start_;
+    uint64_t nanoseconds_;
+};
+
+#define NEXT State().next
+
+// Writes what the app stored through the mapping of |memory| in
+// [offset, offset + size), clipped to the mapped range.
+void RecordMemoryWrite(VkDeviceMemory memory, VkDeviceSize offset,
+                       VkDeviceSize size) {
+    auto it = State().memory.find(TraceHandleBits<VkDeviceMemory>::Get(memory));
+    if (it == State().memory.end() || !it->second.data)
+        return;
+    const Mapping& mapping = it->second;
+    VkDeviceSize end = mapping.offset + mapping.size;
+    if (size == VK_WHOLE_SIZE || offset + size > end)
+        size = end - offset;
+    if (offset < mapping.offset || offset >= end)
+        return;
+
+    TraceWriter& w = State().writer;
+    w.Begin(kTraceMemoryWrite);
+    w.Handle(memory);
+    w.Scalar(offset);
+    w.Scalar(size);
+    const uint8_t* data = mapping.data + (offset - mapping.offset);
+    w.Bytes(data, size);
+    w.End(0);
+}
+
+// Counts of the two-call enumeration idiom: 0 for the size query.
+uint32_t RequestedCount(const uint32_t* pCount, const void* pItems) {
+    return pItems ? *pCount : 0;
+}
+
+}  // namespace
+
+// Recording versions of the entry points, named after them.
+namespace trampoline {
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(
+    VkInstance instance, const char* pName);
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(
+    VkDevice device, const char* pName);
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateInstance(
+    const VkInstanceCreateInfo* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator, VkInstance* pInstance) {
+    Record record(kTraceCreateInstance);
+    VkResult result = NEXT.vkCreateInstance(pCreateInfo, pAllocator,
+                                            pInstance);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Blob(*pCreateInfo);
+    w.Scalar(result);
+    w.NewHandle(result == VK_SUCCESS ? *pInstance : VK_NULL_HANDLE);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyInstance(
+    VkInstance instance, const VkAllocationCallbacks* pAllocator) {
+    Record record(kTraceDestroyInstance);
+    NEXT.vkDestroyInstance(instance, pAllocator);
+    record.Called();
+    record.writer().Handle(instance);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEnumeratePhysicalDevices(
+    VkInstance instance, uint32_t* pPhysicalDeviceCount,
+    VkPhysicalDevice* pPhysicalDevices) {
+    Record record(kTraceEnumeratePhysicalDevices);
+    uint32_t requested = RequestedCount(pPhysicalDeviceCount,
+                                        pPhysicalDevices);
+    VkResult result = NEXT.vkEnumeratePhysicalDevices(
+        instance, pPhysicalDeviceCount, pPhysicalDevices);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(instance);
+    w.Scalar(requested);
+    w.Scalar(result);
+    uint32_t returned = pPhysicalDevices ? *pPhysicalDeviceCount : 0;
+    w.Scalar(returned);
+    for (uint32_t i = 0; i < returned; i++) w.NewHandle(pPhysicalDevices[i]);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceProperties(
+    VkPhysicalDevice physicalDevice, VkPhysicalDeviceProperties* pProperties) {
+    Record record(kTraceGetPhysicalDeviceProperties);
+    NEXT.vkGetPhysicalDeviceProperties(physicalDevice, pProperties);
+    record.Called();
+    record.writer().Handle(physicalDevice);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceMemoryProperties(
+    VkPhysicalDevice physicalDevice,
+    VkPhysicalDeviceMemoryProperties* pMemoryProperties) {
+    Record record(kTraceGetPhysicalDeviceMemoryProperties);
+    NEXT.vkGetPhysicalDeviceMemoryProperties(physicalDevice,
+                                             pMemoryProperties);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(physicalDevice);
+    // The replayer maps captured memory type indices onto its own by flags.
+    w.Raw(*pMemoryProperties);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceQueueFamilyProperties(
+    VkPhysicalDevice physicalDevice, uint32_t* pQueueFamilyPropertyCount,
+    VkQueueFamilyProperties* pQueueFamilyProperties) {
+    Record record(kTraceGetPhysicalDeviceQueueFamilyProperties);
+    uint32_t requested = RequestedCount(pQueueFamilyPropertyCount,
+                                        pQueueFamilyProperties);
+    NEXT.vkGetPhysicalDeviceQueueFamilyProperties(
+        physicalDevice, pQueueFamilyPropertyCount, pQueueFamilyProperties);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(physicalDevice);
+    w.Scalar(requested);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceFormatProperties(
+    VkPhysicalDevice physicalDevice, VkFormat format,
+    VkFormatProperties* pFormatProperties) {
+    Record record(kTraceGetPhysicalDeviceFormatProperties);
+    NEXT.vkGetPhysicalDeviceFormatProperties(physicalDevice, format,
+                                             pFormatProperties);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(physicalDevice);
+    w.Scalar(format);
+}
+
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateAndroidSurfaceKHR(
+    VkInstance instance, const VkAndroidSurfaceCreateInfoKHR* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator, VkSurfaceKHR* pSurface) {
+    Record record(kTraceCreateSurface);
+    VkResult result = NEXT.vkCreateAndroidSurfaceKHR(instance, pCreateInfo,
+                                                     pAllocator, pSurface);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(instance);
+    w.Scalar(result);
+    w.NewHandle(result == VK_SUCCESS ? *pSurface : VK_NULL_HANDLE);
+    return result;
+}
+#endif
+
+VKAPI_ATTR void VKAPI_CALL vkDestroySurfaceKHR(
+    VkInstance instance, VkSurfaceKHR surface,
+    const VkAllocationCallbacks* pAllocator) {
+    Record record(kTraceDestroySurface);
+    NEXT.vkDestroySurfaceKHR(instance, surface, pAllocator);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(instance);
+    w.Handle(surface);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetPhysicalDeviceSurfaceSupportKHR(
+    VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex,
+    VkSurfaceKHR surface, VkBool32* pSupported) {
+    Record record(kTraceGetPhysicalDeviceSurfaceSupport);
+    VkResult result = NEXT.vkGetPhysicalDeviceSurfaceSupportKHR(
+        physicalDevice, queueFamilyIndex, surface, pSupported);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(physicalDevice);
+    w.Scalar(queueFamilyIndex);
+    w.Handle(surface);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetPhysicalDeviceSurfaceCapabilitiesKHR(
+    VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
+    VkSurfaceCapabilitiesKHR* pSurfaceCapabilities) {
+    Record record(kTraceGetPhysicalDeviceSurfaceCapabilities);
+    VkResult result = NEXT.vkGetPhysicalDeviceSurfaceCapabilitiesKHR(
+        physicalDevice, surface, pSurfaceCapabilities);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(physicalDevice);
+    w.Handle(surface);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetPhysicalDeviceSurfaceFormatsKHR(
+    VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
+    uint32_t* pSurfaceFormatCount, VkSurfaceFormatKHR* pSurfaceFormats) {
+    Record record(kTraceGetPhysicalDeviceSurfaceFormats);
+    uint32_t requested = RequestedCount(pSurfaceFormatCount, pSurfaceFormats);
+    VkResult result = NEXT.vkGetPhysicalDeviceSurfaceFormatsKHR(
+        physicalDevice, surface, pSurfaceFormatCount, pSurfaceFormats);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(physicalDevice);
+    w.Handle(surface);
+    w.Scalar(requested);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetPhysicalDeviceSurfacePresentModesKHR(
+    VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
+    uint32_t* pPresentModeCount, VkPresentModeKHR* pPresentModes) {
+    Record record(kTraceGetPhysicalDeviceSurfacePresentModes);
+    uint32_t requested = RequestedCount(pPresentModeCount, pPresentModes);
+    VkResult result = NEXT.vkGetPhysicalDeviceSurfacePresentModesKHR(
+        physicalDevice, surface, pPresentModeCount, pPresentModes);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(physicalDevice);
+    w.Handle(surface);
+    w.Scalar(requested);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateDevice(
+    VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator, VkDevice* pDevice) {
+    Record record(kTraceCreateDevice);
+    VkResult result = NEXT.vkCreateDevice(physicalDevice, pCreateInfo,
+                                          pAllocator, pDevice);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(physicalDevice);
+    w.Blob(*pCreateInfo);
+    w.Scalar(result);
+    w.NewHandle(result == VK_SUCCESS ? *pDevice : VK_NULL_HANDLE);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyDevice(
+    VkDevice device, const VkAllocationCallbacks* pAllocator) {
+    Record record(kTraceDestroyDevice);
+    NEXT.vkDestroyDevice(device, pAllocator);
+    record.Called();
+    record.writer().Handle(device);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetDeviceQueue(VkDevice device,
+                                            uint32_t queueFamilyIndex,
+                                            uint32_t queueIndex,
+                                            VkQueue* pQueue) {
+    Record record(kTraceGetDeviceQueue);
+    NEXT.vkGetDeviceQueue(device, queueFamilyIndex, queueIndex, pQueue);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Scalar(queueFamilyIndex);
+    w.Scalar(queueIndex);
+    w.NewHandle(*pQueue);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkDeviceWaitIdle(VkDevice device) {
+    Record record(kTraceDeviceWaitIdle);
+    VkResult result = NEXT.vkDeviceWaitIdle(device);
+    record.Called();
+    record.writer().Handle(device);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkQueueWaitIdle(VkQueue queue) {
+    Record record(kTraceQueueWaitIdle);
+    VkResult result = NEXT.vkQueueWaitIdle(queue);
+    record.Called();
+    record.writer().Handle(queue);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateSwapchainKHR(
+    VkDevice device, const VkSwapchainCreateInfoKHR* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator, VkSwapchainKHR* pSwapchain) {
+    Record record(kTraceCreateSwapchain);
+    VkResult result = NEXT.vkCreateSwapchainKHR(device, pCreateInfo,
+                                                pAllocator, pSwapchain);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Blob(*pCreateInfo);
+    w.Scalar(result);
+    w.NewHandle(result == VK_SUCCESS ? *pSwapchain : VK_NULL_HANDLE);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroySwapchainKHR(
+    VkDevice device, VkSwapchainKHR swapchain,
+    const VkAllocationCallbacks* pAllocator) {
+    Record record(kTraceDestroySwapchain);
+    NEXT.vkDestroySwapchainKHR(device, swapchain, pAllocator);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(swapchain);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetSwapchainImagesKHR(
+    VkDevice device, VkSwapchainKHR swapchain, uint32_t* pSwapchainImageCount,
+    VkImage* pSwapchainImages) {
+    Record record(kTraceGetSwapchainImages);
+    uint32_t requested = RequestedCount(pSwapchainImageCount,
+                                        pSwapchainImages);
+    VkResult result = NEXT.vkGetSwapchainImagesKHR(
+        device, swapchain, pSwapchainImageCount, pSwapchainImages);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(swapchain);
+    w.Scalar(requested);
+    w.Scalar(result);
+    uint32_t returned = pSwapchainImages ? *pSwapchainImageCount : 0;
+    w.Scalar(returned);
+    for (uint32_t i = 0; i < returned; i++) w.NewHandle(pSwapchainImages[i]);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAcquireNextImageKHR(
+    VkDevice device, VkSwapchainKHR swapchain, uint64_t timeout,
+    VkSemaphore semaphore, VkFence fence, uint32_t* pImageIndex) {
+    Record record(kTraceAcquireNextImage);
+    VkResult result = NEXT.vkAcquireNextImageKHR(device, swapchain, timeout,
+                                                 semaphore, fence,
+                                                 pImageIndex);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(swapchain);
+    w.Scalar(timeout);
+    w.Handle(semaphore);
+    w.Handle(fence);
+    w.Scalar(result);
+    w.Scalar(*pImageIndex);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkQueuePresentKHR(
+    VkQueue queue, const VkPresentInfoKHR* pPresentInfo) {
+    Record record(kTraceQueuePresent);
+    VkResult result = NEXT.vkQueuePresentKHR(queue, pPresentInfo);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(queue);
+    w.Blob(*pPresentInfo);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkQueueSubmit(VkQueue queue,
+                                             uint32_t submitCount,
+                                             const VkSubmitInfo* pSubmits,
+                                             VkFence fence) {
+    Record record(kTraceQueueSubmit);
+    VkResult result = NEXT.vkQueueSubmit(queue, submitCount, pSubmits, fence);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(queue);
+    w.Scalar(submitCount);
+    for (uint32_t i = 0; i < submitCount; i++) w.Blob(pSubmits[i]);
+    w.Handle(fence);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(
+    VkDevice device, const VkMemoryAllocateInfo* pAllocateInfo,
+    const VkAllocationCallbacks* pAllocator, VkDeviceMemory* pMemory) {
+    Record record(kTraceAllocateMemory);
+    VkResult result = NEXT.vkAllocateMemory(device, pAllocateInfo, pAllocator,
+                                            pMemory);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Blob(*pAllocateInfo);
+    w.Scalar(result);
+    w.NewHandle(result == VK_SUCCESS ? *pMemory : VK_NULL_HANDLE);
+    if (result == VK_SUCCESS) {
+        Mapping mapping = {pAllocateInfo->allocationSize, nullptr, 0, 0};
+        State().memory[TraceHandleBits<VkDeviceMemory>::Get(*pMemory)] =
+            mapping;
+    }
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeMemory(
+    VkDevice device, VkDeviceMemory memory,
+    const VkAllocationCallbacks* pAllocator) {
+    Record record(kTraceFreeMemory);
+    NEXT.vkFreeMemory(device, memory, pAllocator);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(memory);
+    State().memory.erase(TraceHandleBits<VkDeviceMemory>::Get(memory));
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkMapMemory(VkDevice device,
+                                           VkDeviceMemory memory,
+                                           VkDeviceSize offset,
+                                           VkDeviceSize size,
+                                           VkMemoryMapFlags flags,
+                                           void** ppData) {
+    Record record(kTraceMapMemory);
+    VkResult result = NEXT.vkMapMemory(device, memory, offset, size, flags,
+                                       ppData);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(memory);
+    w.Scalar(offset);
+    w.Scalar(size);
+    w.Scalar(flags);
+    w.Scalar(result);
+    auto it = State().memory.find(TraceHandleBits<VkDeviceMemory>::Get(memory));
+    if (result == VK_SUCCESS && it != State().memory.end()) {
+        Mapping& mapping = it->second;
+        mapping.data = static_cast<uint8_t*>(*ppData);
+        mapping.offset = offset;
+        mapping.size = size == VK_WHOLE_SIZE
+                           ? mapping.allocationSize - offset
+                           : size;
+    }
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkUnmapMemory(VkDevice device,
+                                         VkDeviceMemory memory) {
+    {
+        // The trace gets everything the app may have written, ahead of
+        // the unmap.
+        std::lock_guard<std::mutex> lock(State().mutex);
+        RecordMemoryWrite(memory, 0, VK_WHOLE_SIZE);
+    }
+    Record record(kTraceUnmapMemory);
+    NEXT.vkUnmapMemory(device, memory);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(memory);
+    auto it = State().memory.find(TraceHandleBits<VkDeviceMemory>::Get(memory));
+    if (it != State().memory.end())
+        it->second.data = nullptr;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkFlushMappedMemoryRanges(
+    VkDevice device, uint32_t memoryRangeCount,
+    const VkMappedMemoryRange* pMemoryRanges) {
+    {
+        std::lock_guard<std::mutex> lock(State().mutex);
+        for (uint32_t i = 0; i < memoryRangeCount; i++)
+            RecordMemoryWrite(pMemoryRanges[i].memory,
+                              pMemoryRanges[i].offset,
+                              pMemoryRanges[i].size);
+    }
+    Record record(kTraceFlushMappedMemoryRanges);
+    VkResult result = NEXT.vkFlushMappedMemoryRanges(device, memoryRangeCount,
+                                                     pMemoryRanges);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Scalar(memoryRangeCount);
+    for (uint32_t i = 0; i < memoryRangeCount; i++) w.Blob(pMemoryRanges[i]);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindBufferMemory(VkDevice device,
+                                                  VkBuffer buffer,
+                                                  VkDeviceMemory memory,
+                                                  VkDeviceSize memoryOffset) {
+    Record record(kTraceBindBufferMemory);
+    VkResult result = NEXT.vkBindBufferMemory(device, buffer, memory,
+                                              memoryOffset);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(buffer);
+    w.Handle(memory);
+    w.Scalar(memoryOffset);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBindImageMemory(VkDevice device,
+                                                 VkImage image,
+                                                 VkDeviceMemory memory,
+                                                 VkDeviceSize memoryOffset) {
+    Record record(kTraceBindImageMemory);
+    VkResult result = NEXT.vkBindImageMemory(device, image, memory,
+                                             memoryOffset);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(image);
+    w.Handle(memory);
+    w.Scalar(memoryOffset);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetBufferMemoryRequirements(
+    VkDevice device, VkBuffer buffer,
+    VkMemoryRequirements* pMemoryRequirements) {
+    Record record(kTraceGetBufferMemoryRequirements);
+    NEXT.vkGetBufferMemoryRequirements(device, buffer, pMemoryRequirements);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(buffer);
+    w.Raw(*pMemoryRequirements);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetImageMemoryRequirements(
+    VkDevice device, VkImage image,
+    VkMemoryRequirements* pMemoryRequirements) {
+    Record record(kTraceGetImageMemoryRequirements);
+    NEXT.vkGetImageMemoryRequirements(device, image, pMemoryRequirements);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(image);
+    w.Raw(*pMemoryRequirements);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetImageSubresourceLayout(
+    VkDevice device, VkImage image, const VkImageSubresource* pSubresource,
+    VkSubresourceLayout* pLayout) {
+    Record record(kTraceGetImageSubresourceLayout);
+    NEXT.vkGetImageSubresourceLayout(device, image, pSubresource, pLayout);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(image);
+    w.Struct(*pSubresource);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateGraphicsPipelines(
+    VkDevice device, VkPipelineCache pipelineCache, uint32_t createInfoCount,
+    const VkGraphicsPipelineCreateInfo* pCreateInfos,
+    const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines) {
+    Record record(kTraceCreateGraphicsPipelines);
+    VkResult result = NEXT.vkCreateGraphicsPipelines(
+        device, pipelineCache, createInfoCount, pCreateInfos, pAllocator,
+        pPipelines);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(pipelineCache);
+    w.Scalar(createInfoCount);
+    for (uint32_t i = 0; i < createInfoCount; i++) w.Blob(pCreateInfos[i]);
+    w.Scalar(result);
+    // Failed creations set their pipelines to VK_NULL_HANDLE.
+    for (uint32_t i = 0; i < createInfoCount; i++) w.NewHandle(pPipelines[i]);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyPipeline(
+    VkDevice device, VkPipeline pipeline,
+    const VkAllocationCallbacks* pAllocator) {
+    Record record(kTraceDestroyPipeline);
+    NEXT.vkDestroyPipeline(device, pipeline, pAllocator);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(pipeline);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateDescriptorSets(
+    VkDevice device, const VkDescriptorSetAllocateInfo* pAllocateInfo,
+    VkDescriptorSet* pDescriptorSets) {
+    Record record(kTraceAllocateDescriptorSets);
+    VkResult result = NEXT.vkAllocateDescriptorSets(device, pAllocateInfo,
+                                                    pDescriptorSets);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Blob(*pAllocateInfo);
+    w.Scalar(result);
+    for (uint32_t i = 0; i < pAllocateInfo->descriptorSetCount; i++)
+        w.NewHandle(result == VK_SUCCESS ? pDescriptorSets[i]
+                                         : VK_NULL_HANDLE);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkFreeDescriptorSets(
+    VkDevice device, VkDescriptorPool descriptorPool,
+    uint32_t descriptorSetCount, const VkDescriptorSet* pDescriptorSets) {
+    Record record(kTraceFreeDescriptorSets);
+    VkResult result = NEXT.vkFreeDescriptorSets(
+        device, descriptorPool, descriptorSetCount, pDescriptorSets);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(descriptorPool);
+    w.Scalar(descriptorSetCount);
+    for (uint32_t i = 0; i < descriptorSetCount; i++)
+        w.Handle(pDescriptorSets[i]);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkUpdateDescriptorSets(
+    VkDevice device, uint32_t descriptorWriteCount,
+    const VkWriteDescriptorSet* pDescriptorWrites,
+    uint32_t descriptorCopyCount,
+    const VkCopyDescriptorSet* pDescriptorCopies) {
+    Record record(kTraceUpdateDescriptorSets);
+    NEXT.vkUpdateDescriptorSets(device, descriptorWriteCount,
+                                pDescriptorWrites, descriptorCopyCount,
+                                pDescriptorCopies);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Scalar(descriptorWriteCount);
+    for (uint32_t i = 0; i < descriptorWriteCount; i++)
+        w.Blob(pDescriptorWrites[i]);
+    w.Scalar(descriptorCopyCount);
+    for (uint32_t i = 0; i < descriptorCopyCount; i++)
+        w.Blob(pDescriptorCopies[i]);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateCommandBuffers(
+    VkDevice device, const VkCommandBufferAllocateInfo* pAllocateInfo,
+    VkCommandBuffer* pCommandBuffers) {
+    Record record(kTraceAllocateCommandBuffers);
+    VkResult result = NEXT.vkAllocateCommandBuffers(device, pAllocateInfo,
+                                                    pCommandBuffers);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Blob(*pAllocateInfo);
+    w.Scalar(result);
+    for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; i++)
+        w.NewHandle(result == VK_SUCCESS ? pCommandBuffers[i]
+                                         : VK_NULL_HANDLE);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeCommandBuffers(
+    VkDevice device, VkCommandPool commandPool, uint32_t commandBufferCount,
+    const VkCommandBuffer* pCommandBuffers) {
+    Record record(kTraceFreeCommandBuffers);
+    NEXT.vkFreeCommandBuffers(device, commandPool, commandBufferCount,
+                              pCommandBuffers);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(commandPool);
+    w.Scalar(commandBufferCount);
+    for (uint32_t i = 0; i < commandBufferCount; i++)
+        w.Handle(pCommandBuffers[i]);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkResetCommandBuffer(
+    VkCommandBuffer commandBuffer, VkCommandBufferResetFlags flags) {
+    Record record(kTraceResetCommandBuffer);
+    VkResult result = NEXT.vkResetCommandBuffer(commandBuffer, flags);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(flags);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkBeginCommandBuffer(
+    VkCommandBuffer commandBuffer, const VkCommandBufferBeginInfo* pBeginInfo) {
+    Record record(kTraceBeginCommandBuffer);
+    VkResult result = NEXT.vkBeginCommandBuffer(commandBuffer, pBeginInfo);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Blob(*pBeginInfo);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkEndCommandBuffer(
+    VkCommandBuffer commandBuffer) {
+    Record record(kTraceEndCommandBuffer);
+    VkResult result = NEXT.vkEndCommandBuffer(commandBuffer);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkResetFences(VkDevice device,
+                                             uint32_t fenceCount,
+                                             const VkFence* pFences) {
+    Record record(kTraceResetFences);
+    VkResult result = NEXT.vkResetFences(device, fenceCount, pFences);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Scalar(fenceCount);
+    for (uint32_t i = 0; i < fenceCount; i++) w.Handle(pFences[i]);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkWaitForFences(VkDevice device,
+                                               uint32_t fenceCount,
+                                               const VkFence* pFences,
+                                               VkBool32 waitAll,
+                                               uint64_t timeout) {
+    Record record(kTraceWaitForFences);
+    VkResult result = NEXT.vkWaitForFences(device, fenceCount, pFences,
+                                           waitAll, timeout);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Scalar(fenceCount);
+    for (uint32_t i = 0; i < fenceCount; i++) w.Handle(pFences[i]);
+    w.Scalar(waitAll);
+    w.Scalar(timeout);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkGetFenceStatus(VkDevice device,
+                                                VkFence fence) {
+    Record record(kTraceGetFenceStatus);
+    VkResult result = NEXT.vkGetFenceStatus(device, fence);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(device);
+    w.Handle(fence);
+    w.Scalar(result);
+    return result;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBeginRenderPass(
+    VkCommandBuffer commandBuffer,
+    const VkRenderPassBeginInfo* pRenderPassBegin,
+    VkSubpassContents contents) {
+    Record record(kTraceCmdBeginRenderPass);
+    NEXT.vkCmdBeginRenderPass(commandBuffer, pRenderPassBegin, contents);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Blob(*pRenderPassBegin);
+    w.Scalar(contents);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderPass(VkCommandBuffer commandBuffer) {
+    Record record(kTraceCmdEndRenderPass);
+    NEXT.vkCmdEndRenderPass(commandBuffer);
+    record.Called();
+    record.writer().Handle(commandBuffer);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBindPipeline(
+    VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint,
+    VkPipeline pipeline) {
+    Record record(kTraceCmdBindPipeline);
+    NEXT.vkCmdBindPipeline(commandBuffer, pipelineBindPoint, pipeline);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(pipelineBindPoint);
+    w.Handle(pipeline);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBindDescriptorSets(
+    VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint,
+    VkPipelineLayout layout, uint32_t firstSet, uint32_t descriptorSetCount,
+    const VkDescriptorSet* pDescriptorSets, uint32_t dynamicOffsetCount,
+    const uint32_t* pDynamicOffsets) {
+    Record record(kTraceCmdBindDescriptorSets);
+    NEXT.vkCmdBindDescriptorSets(commandBuffer, pipelineBindPoint, layout,
+                                 firstSet, descriptorSetCount,
+                                 pDescriptorSets, dynamicOffsetCount,
+                                 pDynamicOffsets);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(pipelineBindPoint);
+    w.Handle(layout);
+    w.Scalar(firstSet);
+    w.Scalar(descriptorSetCount);
+    for (uint32_t i = 0; i < descriptorSetCount; i++)
+        w.Handle(pDescriptorSets[i]);
+    w.Scalar(dynamicOffsetCount);
+    for (uint32_t i = 0; i < dynamicOffsetCount; i++)
+        w.Scalar(pDynamicOffsets[i]);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBindVertexBuffers(
+    VkCommandBuffer commandBuffer, uint32_t firstBinding,
+    uint32_t bindingCount, const VkBuffer* pBuffers,
+    const VkDeviceSize* pOffsets) {
+    Record record(kTraceCmdBindVertexBuffers);
+    NEXT.vkCmdBindVertexBuffers(commandBuffer, firstBinding, bindingCount,
+                                pBuffers, pOffsets);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(firstBinding);
+    w.Scalar(bindingCount);
+    for (uint32_t i = 0; i < bindingCount; i++) {
+        w.Handle(pBuffers[i]);
+        w.Scalar(pOffsets[i]);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBindIndexBuffer(VkCommandBuffer commandBuffer,
+                                                VkBuffer buffer,
+                                                VkDeviceSize offset,
+                                                VkIndexType indexType) {
+    Record record(kTraceCmdBindIndexBuffer);
+    NEXT.vkCmdBindIndexBuffer(commandBuffer, buffer, offset, indexType);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Handle(buffer);
+    w.Scalar(offset);
+    w.Scalar(indexType);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetViewport(VkCommandBuffer commandBuffer,
+                                            uint32_t firstViewport,
+                                            uint32_t viewportCount,
+                                            const VkViewport* pViewports) {
+    Record record(kTraceCmdSetViewport);
+    NEXT.vkCmdSetViewport(commandBuffer, firstViewport, viewportCount,
+                          pViewports);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(firstViewport);
+    w.Scalar(viewportCount);
+    for (uint32_t i = 0; i < viewportCount; i++) w.Struct(pViewports[i]);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetScissor(VkCommandBuffer commandBuffer,
+                                           uint32_t firstScissor,
+                                           uint32_t scissorCount,
+                                           const VkRect2D* pScissors) {
+    Record record(kTraceCmdSetScissor);
+    NEXT.vkCmdSetScissor(commandBuffer, firstScissor, scissorCount,
+                         pScissors);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(firstScissor);
+    w.Scalar(scissorCount);
+    for (uint32_t i = 0; i < scissorCount; i++) w.Struct(pScissors[i]);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdPushConstants(VkCommandBuffer commandBuffer,
+                                              VkPipelineLayout layout,
+                                              VkShaderStageFlags stageFlags,
+                                              uint32_t offset, uint32_t size,
+                                              const void* pValues) {
+    Record record(kTraceCmdPushConstants);
+    NEXT.vkCmdPushConstants(commandBuffer, layout, stageFlags, offset, size,
+                            pValues);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Handle(layout);
+    w.Scalar(stageFlags);
+    w.Scalar(offset);
+    w.Scalar(size);
+    w.Bytes(pValues, size);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdDraw(VkCommandBuffer commandBuffer,
+                                     uint32_t vertexCount,
+                                     uint32_t instanceCount,
+                                     uint32_t firstVertex,
+                                     uint32_t firstInstance) {
+    Record record(kTraceCmdDraw);
+    NEXT.vkCmdDraw(commandBuffer, vertexCount, instanceCount, firstVertex,
+                   firstInstance);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(vertexCount);
+    w.Scalar(instanceCount);
+    w.Scalar(firstVertex);
+    w.Scalar(firstInstance);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdDrawIndexed(VkCommandBuffer commandBuffer,
+                                            uint32_t indexCount,
+                                            uint32_t instanceCount,
+                                            uint32_t firstIndex,
+                                            int32_t vertexOffset,
+                                            uint32_t firstInstance) {
+    Record record(kTraceCmdDrawIndexed);
+    NEXT.vkCmdDrawIndexed(commandBuffer, indexCount, instanceCount,
+                          firstIndex, vertexOffset, firstInstance);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(indexCount);
+    w.Scalar(instanceCount);
+    w.Scalar(firstIndex);
+    w.Scalar(vertexOffset);
+    w.Scalar(firstInstance);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdPipelineBarrier(
+    VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStageMask,
+    VkPipelineStageFlags dstStageMask, VkDependencyFlags dependencyFlags,
+    uint32_t memoryBarrierCount, const VkMemoryBarrier* pMemoryBarriers,
+    uint32_t bufferMemoryBarrierCount,
+    const VkBufferMemoryBarrier* pBufferMemoryBarriers,
+    uint32_t imageMemoryBarrierCount,
+    const VkImageMemoryBarrier* pImageMemoryBarriers) {
+    Record record(kTraceCmdPipelineBarrier);
+    NEXT.vkCmdPipelineBarrier(commandBuffer, srcStageMask, dstStageMask,
+                              dependencyFlags, memoryBarrierCount,
+                              pMemoryBarriers, bufferMemoryBarrierCount,
+                              pBufferMemoryBarriers, imageMemoryBarrierCount,
+                              pImageMemoryBarriers);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Scalar(srcStageMask);
+    w.Scalar(dstStageMask);
+    w.Scalar(dependencyFlags);
+    w.Scalar(memoryBarrierCount);
+    for (uint32_t i = 0; i < memoryBarrierCount; i++)
+        w.Struct(pMemoryBarriers[i]);
+    w.Scalar(bufferMemoryBarrierCount);
+    for (uint32_t i = 0; i < bufferMemoryBarrierCount; i++)
+        w.Struct(pBufferMemoryBarriers[i]);
+    w.Scalar(imageMemoryBarrierCount);
+    for (uint32_t i = 0; i < imageMemoryBarrierCount; i++)
+        w.Struct(pImageMemoryBarriers[i]);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdCopyBuffer(VkCommandBuffer commandBuffer,
+                                           VkBuffer srcBuffer,
+                                           VkBuffer dstBuffer,
+                                           uint32_t regionCount,
+                                           const VkBufferCopy* pRegions) {
+    Record record(kTraceCmdCopyBuffer);
+    NEXT.vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, regionCount,
+                         pRegions);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Handle(srcBuffer);
+    w.Handle(dstBuffer);
+    w.Scalar(regionCount);
+    for (uint32_t i = 0; i < regionCount; i++) w.Struct(pRegions[i]);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdCopyImage(
+    VkCommandBuffer commandBuffer, VkImage srcImage,
+    VkImageLayout srcImageLayout, VkImage dstImage,
+    VkImageLayout dstImageLayout, uint32_t regionCount,
+    const VkImageCopy* pRegions) {
+    Record record(kTraceCmdCopyImage);
+    NEXT.vkCmdCopyImage(commandBuffer, srcImage, srcImageLayout, dstImage,
+                        dstImageLayout, regionCount, pRegions);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Handle(srcImage);
+    w.Scalar(srcImageLayout);
+    w.Handle(dstImage);
+    w.Scalar(dstImageLayout);
+    w.Scalar(regionCount);
+    for (uint32_t i = 0; i < regionCount; i++) w.Struct(pRegions[i]);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdCopyBufferToImage(
+    VkCommandBuffer commandBuffer, VkBuffer srcBuffer, VkImage dstImage,
+    VkImageLayout dstImageLayout, uint32_t regionCount,
+    const VkBufferImageCopy* pRegions) {
+    Record record(kTraceCmdCopyBufferToImage);
+    NEXT.vkCmdCopyBufferToImage(commandBuffer, srcBuffer, dstImage,
+                                dstImageLayout, regionCount, pRegions);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Handle(srcBuffer);
+    w.Handle(dstImage);
+    w.Scalar(dstImageLayout);
+    w.Scalar(regionCount);
+    for (uint32_t i = 0; i < regionCount; i++) w.Struct(pRegions[i]);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBlitImage(
+    VkCommandBuffer commandBuffer, VkImage srcImage,
+    VkImageLayout srcImageLayout, VkImage dstImage,
+    VkImageLayout dstImageLayout, uint32_t regionCount,
+    const VkImageBlit* pRegions, VkFilter filter) {
+    Record record(kTraceCmdBlitImage);
+    NEXT.vkCmdBlitImage(commandBuffer, srcImage, srcImageLayout, dstImage,
+                        dstImageLayout, regionCount, pRegions, filter);
+    record.Called();
+    TraceWriter& w = record.writer();
+    w.Handle(commandBuffer);
+    w.Handle(srcImage);
+    w.Scalar(srcImageLayout);
+    w.Handle(dstImage);
+    w.Scalar(dstImageLayout);
+    w.Scalar(regionCount);
+    for (uint32_t i = 0; i < regionCount; i++) w.Struct(pRegions[i]);
+    w.Scalar(filter);
+}
+
+#define VK_CAPTURE_DEVICE_OBJECT(name)                                      \
+    VKAPI_ATTR VkResult VKAPI_CALL vkCreate##name(                          \
+        VkDevice device, const Vk##name##CreateInfo* pCreateInfo,           \
+        const VkAllocationCallbacks* pAllocator, Vk##name* pObject) {       \
+        Record record(kTraceCreate##name);                                  \
+        VkResult result = NEXT.vkCreate##name(device, pCreateInfo,          \
+                                              pAllocator, pObject);         \
+        record.Called();                                                    \
+        TraceWriter& w = record.writer();                                   \
+        w.Handle(device);                                                   \
+        w.Blob(*pCreateInfo);                                               \
+        w.Scalar(result);                                                   \
+        w.NewHandle(result == VK_SUCCESS ? *pObject : Vk##name());          \
+        return result;                                                      \
+    }                                                                       \
+    VKAPI_ATTR void VKAPI_CALL vkDestroy##name(                             \
+        VkDevice device, Vk##name object,                                   \
+        const VkAllocationCallbacks* pAllocator) {                          \
+        Record record(kTraceDestroy##name);                                 \
+        NEXT.vkDestroy##name(device, object, pAllocator);                   \
+        record.Called();                                                    \
+        TraceWriter& w = record.writer();                                   \
+        w.Handle(device);                                                   \
+        w.Handle(object);                                                   \
+    }
+VK_TRACE_DEVICE_OBJECTS(VK_CAPTURE_DEVICE_OBJECT)
+#undef VK_CAPTURE_DEVICE_OBJECT
+
+// The recording version of |name|, or NULL if capture does not record it.
+PFN_vkVoidFunction Lookup(const char* name) {
+#define VK_CAPTURE_LOOKUP(entry)   \
+    if (!strcmp(name, #entry))     \
+        return reinterpret_cast<PFN_vkVoidFunction>(&trampoline::entry);
+    VK_CAPTURE_ENTRY_POINTS(VK_CAPTURE_LOOKUP)
+#undef VK_CAPTURE_LOOKUP
+    return nullptr;
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetInstanceProcAddr(
+    VkInstance instance, const char* pName) {
+    PFN_vkVoidFunction entryPoint = NEXT.vkGetInstanceProcAddr(instance,
+                                                               pName);
+    PFN_vkVoidFunction recording = Lookup(pName);
+    // Keep NULL for whatever the instance does not expose.
+    return entryPoint && recording ? recording : entryPoint;
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(
+    VkDevice device, const char* pName) {
+    PFN_vkVoidFunction entryPoint = NEXT.vkGetDeviceProcAddr(device, pName);
+    PFN_vkVoidFunction recording = Lookup(pName);
+    return entryPoint && recording ? recording : entryPoint;
+}
+
+}  // namespace trampoline
+
+int StartVulkanCapture(const char* path) {
+    if (!InitVulkan())
+        return 0;
+    CaptureState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.writer.Open(path))
+        return 0;
+#define VK_CAPTURE_INSTALL(name)  \
+    state.next.name = ::name;     \
+    ::name = &trampoline::name;
+    VK_CAPTURE_ENTRY_POINTS(VK_CAPTURE_INSTALL)
+#undef VK_CAPTURE_INSTALL
+    return 1;
+}
+
+void StopVulkanCapture(void) {
+    CaptureState& state = State();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.writer.IsOpen())
+        return;
+#define VK_CAPTURE_RESTORE(name) ::name = state.next.name;
+    VK_CAPTURE_ENTRY_POINTS(VK_CAPTURE_RESTORE)
+#undef VK_CAPTURE_RESTORE
+    state.writer.Close();
+}
@@ -0,0 +1,43 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef VULKAN_CAPTURE_H
+#define VULKAN_CAPTURE_H
+
+#include "vulkan_wrapper.h"
+
+/* Start recording Vulkan calls into the trace file at |path|, in the format
+ * described in vulkan_trace.h; host/vktrace_replay plays it back.
+ * Call it instead of InitVulkan()/InitVulkanLazy(), before vkCreateInstance():
+ * it binds every entry point eagerly, then points the global function
+ * pointers at recording versions. Dispatch tables filled while capturing get
+ * the recording versions too, through vkGetInstanceProcAddr() and
+ * vkGetDeviceProcAddr().
+ * The calls recorded are the ones the tutorials make (instance and device
+ * setup, WSI, resource creation, descriptor updates, command recording,
+ * submission, and data written through vkMapMemory()); others go straight
+ * to the driver and are not in the trace. pNext chains are dropped, so
+ * extension structs, as VkPipelineRenderingCreateInfo and feature chains,
+ * do not replay, and neither do dynamic rendering's vkCmdBeginRendering()
+ * and vkCmdEndRendering(), which are not recorded: draw through a
+ * VkRenderPass while capturing.
+ * Returns 0 if vulkan is not available or |path| cannot be created.
+ */
+int StartVulkanCapture(const char* path);
+
+/* Flush and close the trace, and restore the global function pointers.
+ * Dispatch tables filled while capturing keep working, but stop recording.
+ */
+void StopVulkanCapture(void);
+
+#endif  // VULKAN_CAPTURE_H
@@ -0,0 +1,230 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "vulkan_trace.h"
+
+namespace {
+
+// Records are handed to fwrite() in chunks of about this size.
+const size_t kFlushThreshold = 256 * 1024;
+
+uint64_t HashBytes(const std::vector<uint8_t>& bytes) {
+    uint64_t hash = 14695981039346656037ull;
+    for (uint8_t byte : bytes) {
+        hash ^= byte;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void AppendVarint(std::vector<uint8_t>* out, uint64_t value) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out->push_back(static_cast<uint8_t>(value));
+}
+
+}  // namespace
+
+const char* TraceCommandName(uint32_t command) {
+    switch (command) {
+#define VK_TRACE_NAME(name) \
+    case kTrace##name:      \
+        return #name;
+        VK_TRACE_COMMANDS(VK_TRACE_NAME)
+#undef VK_TRACE_NAME
+#define VK_TRACE_NAME(name)     \
+    case kTraceCreate##name:    \
+        return "Create" #name;  \
+    case kTraceDestroy##name:   \
+        return "Destroy" #name;
+        VK_TRACE_DEVICE_OBJECTS(VK_TRACE_NAME)
+#undef VK_TRACE_NAME
+        default:
+            return nullptr;
+    }
+}
+
+bool TraceWriter::Open(const char* path) {
+    Close();
+    file_ = fopen(path, "wb");
+    if (!file_)
+        return false;
+    buffer_.assign(kTraceMagic, kTraceMagic + sizeof(kTraceMagic));
+    AppendVarint(&buffer_, kTraceVersion);
+    return true;
+}
+
+void TraceWriter::Close() {
+    if (!file_)
+        return;
+    Flush();
+    fclose(file_);
+    file_ = nullptr;
+}
+
+void TraceWriter::Begin(TraceCommand command) {
+    command_ = command;
+    record_.clear();
+    out_ = &record_;
+}
+
+void TraceWriter::End(uint64_t nanoseconds) {
+    if (!file_)
+        return;
+    AppendVarint(&buffer_, command_);
+    std::vector<uint8_t> header;
+    AppendVarint(&header, nanoseconds);
+    AppendVarint(&buffer_, header.size() + record_.size());
+    buffer_.insert(buffer_.end(), header.begin(), header.end());
+    buffer_.insert(buffer_.end(), record_.begin(), record_.end());
+    if (buffer_.size() >= kFlushThreshold)
+        Flush();
+}
+
+void TraceWriter::String(const char* const& string) {
+    if (!string) {
+        Varint(0);
+        return;
+    }
+    size_t length = strlen(string);
+    Varint(length + 1);
+    Append(string, length);
+}
+
+void TraceWriter::Varint(uint64_t value) {
+    AppendVarint(out_, value);
+}
+
+void TraceWriter::Append(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    out_->insert(out_->end(), bytes, bytes + size);
+}
+
+uint32_t TraceWriter::Intern(const std::vector<uint8_t>& encoded) {
+    if (!file_)
+        return 0;
+    uint64_t hash = HashBytes(encoded);
+    auto range = blobIds_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (blobs_[it->second - 1] == encoded)
+            return it->second;
+    }
+    blobs_.push_back(encoded);
+    uint32_t id = static_cast<uint32_t>(blobs_.size());
+    blobIds_.insert(std::make_pair(hash, id));
+
+    // Blob records carry no timing; the payload is the encoding itself.
+    AppendVarint(&buffer_, kTraceBlob);
+    AppendVarint(&buffer_, encoded.size() + 1);
+    AppendVarint(&buffer_, 0);
+    buffer_.insert(buffer_.end(), encoded.begin(), encoded.end());
+    return id;
+}
+
+void TraceWriter::Flush() {
+    if (!buffer_.empty())
+        fwrite(buffer_.data(), 1, buffer_.size(), file_);
+    buffer_.clear();
+    fflush(file_);
+}
+
+bool TraceReader::Open(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+    file_.clear();
+    uint8_t chunk[64 * 1024];
+    size_t size;
+    while ((size = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        file_.insert(file_.end(), chunk, chunk + size);
+    fclose(file);
+
+    if (file_.size() < sizeof(kTraceMagic) ||
+        memcmp(file_.data(), kTraceMagic, sizeof(kTraceMagic)))
+        return false;
+    cursor_ = file_.data() + sizeof(kTraceMagic);
+    end_ = file_.data() + file_.size();
+    if (Varint() != kTraceVersion)
+        return false;
+    recordEnd_ = cursor_;
+    return true;
+}
+
+bool TraceReader::Next() {
+    arena_.clear();
+    for (;;) {
+        cursor_ = recordEnd_;
+        end_ = file_.data() + file_.size();
+        if (cursor_ >= end_)
+            return false;
+        command_ = static_cast<TraceCommand>(Varint());
+        uint64_t size = Varint();
+        if (size > static_cast<uint64_t>(end_ - cursor_))
+            return false;  // truncated, e.g. the app was killed
+        recordEnd_ = cursor_ + size;
+        end_ = recordEnd_;
+        nanoseconds_ = Varint();
+        if (command_ != kTraceBlob)
+            return true;
+        blobs_.push_back(std::make_pair(cursor_, end_));
+    }
+}
+
+void TraceReader::String(const char*& string) {
+    uint64_t size = Varint();
+    string = nullptr;
+    if (!size)
+        return;
+    char* chars = reinterpret_cast<char*>(Allocate(size));
+    Read(chars, size - 1);
+    chars[size - 1] = '\0';
+    string = chars;
+}
+
+uint64_t TraceReader::Varint() {
+    uint64_t value = 0;
+    for (int shift = 0; cursor_ < end_ && shift < 64; shift += 7) {
+        uint8_t byte = *cursor_++;
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            break;
+    }
+    return value;
+}
+
+const uint8_t* TraceReader::Span(uint64_t size) {
+    if (size > static_cast<uint64_t>(end_ - cursor_))
+        size = end_ - cursor_;
+    const uint8_t* span = cursor_;
+    cursor_ += size;
+    return span;
+}
+
+void TraceReader::Read(void* data, uint64_t size) {
+    // A short record leaves the rest zeroed rather than reading past it.
+    uint64_t available = end_ - cursor_;
+    if (size > available) {
+        memset(static_cast<uint8_t*>(data) + available, 0, size - available);
+        size = available;
+    }
+    memcpy(data, cursor_, size);
+    cursor_ += size;
+}
+
+uint8_t* TraceReader::Allocate(uint64_t size) {
+    size_t words = static_cast<size_t>((size + 7) / 8);
+    arena_.emplace_back(new uint64_t[words ? words : 1]());
+    return reinterpret_cast<uint8_t*>(arena_.back().get());
+}
@@ -0,0 +1,1228 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Binary Vulkan call trace, written by vulkan_capture.cpp and read by the
+// host replayer (host/vktrace_replay).
+//
+// File layout: kTraceMagic, then a varint format version, then records.
+// Each record is
+//     varint command, varint payload size, varint nanoseconds, payload
+// where |nanoseconds| is the CPU time the captured call took on the device.
+// Integers are LEB128 varints (signed ones zigzag encoded), floats and
+// opaque structs are raw little-endian bytes.
+//
+// Two things keep traces compact:
+//  - Handles are written as small sequential ids; the replayer maps each id
+//    to the handle its own driver returned. Id 0 is VK_NULL_HANDLE.
+//  - Create-infos are interned: each distinct encoding is written once as a
+//    kTraceBlob record, and calls refer to it by blob id, so re-creating a
+//    swapchain or pipeline with the same parameters costs a few bytes.
+#ifndef VULKAN_TRACE_H
+#define VULKAN_TRACE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "vulkan_wrapper.h"
+
+static const char kTraceMagic[8] = {'V', 'K', 'T', 'R', 'A', 'C', 'E', 0};
+static const uint32_t kTraceVersion = 1;
+
+// Create commands taking (parent, const Vk<Name>CreateInfo*, allocator,
+// Vk<Name>*), and the matching destroy commands.
+#define VK_TRACE_DEVICE_OBJECTS(X) \
+    X(Buffer)                      \
+    X(Image)                       \
+    X(ImageView)                   \
+    X(Sampler)                     \
+    X(ShaderModule)                \
+    X(PipelineCache)               \
+    X(PipelineLayout)              \
+    X(DescriptorSetLayout)         \
+    X(DescriptorPool)              \
+    X(RenderPass)                  \
+    X(Framebuffer)                 \
+    X(CommandPool)                 \
+    X(Fence)                       \
+    X(Semaphore)
+
+// Trace record types, in encoding order; kTrace<Name> in TraceCommand.
+// Blob is an interned create-info, MemoryWrite the bytes the app wrote
+// through a mapping, and CreateSurface any platform surface (the replayer
+// creates a headless one).
+#define VK_TRACE_COMMANDS(X)                  \
+    X(Blob)                                   \
+    X(MemoryWrite)                            \
+    X(CreateInstance)                         \
+    X(DestroyInstance)                        \
+    X(EnumeratePhysicalDevices)               \
+    X(GetPhysicalDeviceProperties)            \
+    X(GetPhysicalDeviceMemoryProperties)      \
+    X(GetPhysicalDeviceQueueFamilyProperties) \
+    X(GetPhysicalDeviceFormatProperties)      \
+    X(CreateSurface)                          \
+    X(DestroySurface)                         \
+    X(GetPhysicalDeviceSurfaceSupport)        \
+    X(GetPhysicalDeviceSurfaceCapabilities)   \
+    X(GetPhysicalDeviceSurfaceFormats)        \
+    X(GetPhysicalDeviceSurfacePresentModes)   \
+    X(CreateDevice)                           \
+    X(DestroyDevice)                          \
+    X(GetDeviceQueue)                         \
+    X(DeviceWaitIdle)                         \
+    X(QueueWaitIdle)                          \
+    X(CreateSwapchain)                        \
+    X(DestroySwapchain)                       \
+    X(GetSwapchainImages)                     \
+    X(AcquireNextImage)                       \
+    X(QueuePresent)                           \
+    X(QueueSubmit)                            \
+    X(AllocateMemory)                         \
+    X(FreeMemory)                             \
+    X(MapMemory)                              \
+    X(UnmapMemory)                            \
+    X(FlushMappedMemoryRanges)                \
+    X(BindBufferMemory)                       \
+    X(BindImageMemory)                        \
+    X(GetBufferMemoryRequirements)            \
+    X(GetImageMemoryRequirements)             \
+    X(GetImageSubresourceLayout)              \
+    X(CreateGraphicsPipelines)                \
+    X(DestroyPipeline)                        \
+    X(AllocateDescriptorSets)                 \
+    X(FreeDescriptorSets)                     \
+    X(UpdateDescriptorSets)                   \
+    X(AllocateCommandBuffers)                 \
+    X(FreeCommandBuffers)                     \
+    X(ResetCommandBuffer)                     \
+    X(BeginCommandBuffer)                     \
+    X(EndCommandBuffer)                       \
+    X(ResetFences)                            \
+    X(WaitForFences)                          \
+    X(GetFenceStatus)                         \
+    X(CmdBeginRenderPass)                     \
+    X(CmdEndRenderPass)                       \
+    X(CmdBindPipeline)                        \
+    X(CmdBindDescriptorSets)                  \
+    X(CmdBindVertexBuffers)                   \
+    X(CmdBindIndexBuffer)                     \
+    X(CmdSetViewport)                         \
+    X(CmdSetScissor)                          \
+    X(CmdPushConstants)                       \
+    X(CmdDraw)                                \
+    X(CmdDrawIndexed)                         \
+    X(CmdPipelineBarrier)                     \
+    X(CmdCopyBuffer)                          \
+    X(CmdCopyImage)                           \
+    X(CmdCopyBufferToImage)                   \
+    X(CmdBlitImage)
+
+enum TraceCommand : uint32_t {
+    kTraceInvalid = 0,
+#define VK_TRACE_ENUM(name) kTrace##name,
+    VK_TRACE_COMMANDS(VK_TRACE_ENUM)
+#undef VK_TRACE_ENUM
+#define VK_TRACE_ENUM(name) kTraceCreate##name, kTraceDestroy##name,
+    VK_TRACE_DEVICE_OBJECTS(VK_TRACE_ENUM)
+#undef VK_TRACE_ENUM
+};
+
+// "CreateInstance" for kTraceCreateInstance, NULL for unknown values.
+const char* TraceCommandName(uint32_t command);
+
+// Handle values as integers: dispatchable handles are pointers everywhere,
+// non-dispatchable ones are pointers on 64-bit ABIs and uint64_t on 32-bit.
+template <typename H, bool IsPointer = std::is_pointer<H>::value>
+struct TraceHandleBits {
+    static uint64_t Get(H handle) {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+    }
+    static H Make(uint64_t bits) {
+        return reinterpret_cast<H>(static_cast<uintptr_t>(bits));
+    }
+};
+
+template <typename H>
+struct TraceHandleBits<H, false> {
+    static uint64_t Get(H handle) { return handle; }
+    static H Make(uint64_t bits) { return bits; }
+};
+
+/*
+ * Structure codec, shared by TraceWriter and TraceReader: TraceIo(stream, v)
+ * writes |v| or reads it back in the same order. Readers get zeroed structs
+ * and arrays, so members the codec skips (pointers the spec says to ignore,
+ * unknown pNext structs) come back NULL.
+ */
+template <typename S, typename T>
+void TraceIoArray(S& s, const T*& items, uint64_t count) {
+    T* array = s.Array(items, count);
+    for (uint64_t i = 0; array && i < count; i++) TraceIo(s, array[i]);
+}
+
+template <typename S, typename T>
+void TraceIoScalars(S& s, const T*& items, uint64_t count) {
+    T* array = s.Array(items, count);
+    for (uint64_t i = 0; array && i < count; i++) s.Scalar(array[i]);
+}
+
+template <typename S, typename H>
+void TraceIoHandles(S& s, const H*& items, uint64_t count) {
+    H* array = s.Array(items, count);
+    for (uint64_t i = 0; array && i < count; i++) s.Handle(array[i]);
+}
+
+template <typename S>
+void TraceIoStrings(S& s, const char* const*& items, uint64_t count) {
+    const char** array = s.Array(items, count);
+    for (uint64_t i = 0; array && i < count; i++) s.String(array[i]);
+}
+
+template <typename S, typename T>
+void TraceIoOptional(S& s, const T*& item) {
+    TraceIoArray(s, item, 1);
+}
+
+// No extension structure is captured yet: the chain is dropped and only its
+// length is kept, so the replayer can report what it is missing. Readers
+// leave |next| NULL.
+template <typename S>
+void TraceIoChain(S& s, const void*& next) {
+    uint32_t dropped = 0;
+    for (const VkBaseInStructure* item =
+             static_cast<const VkBaseInStructure*>(next);
+         item; item = item->pNext)
+        dropped++;
+    s.Scalar(dropped);
+    s.DropExtensions(dropped);
+}
+
+#define VK_TRACE_HEADER(s, v) \
+    s.Scalar(v.sType);        \
+    TraceIoChain(s, v.pNext)
+
+template <typename S>
+void TraceIo(S& s, VkExtent2D& v) {
+    s.Scalar(v.width);
+    s.Scalar(v.height);
+}
+
+template <typename S>
+void TraceIo(S& s, VkExtent3D& v) {
+    s.Scalar(v.width);
+    s.Scalar(v.height);
+    s.Scalar(v.depth);
+}
+
+template <typename S>
+void TraceIo(S& s, VkOffset2D& v) {
+    s.Scalar(v.x);
+    s.Scalar(v.y);
+}
+
+template <typename S>
+void TraceIo(S& s, VkOffset3D& v) {
+    s.Scalar(v.x);
+    s.Scalar(v.y);
+    s.Scalar(v.z);
+}
+
+template <typename S>
+void TraceIo(S& s, VkRect2D& v) {
+    TraceIo(s, v.offset);
+    TraceIo(s, v.extent);
+}
+
+template <typename S>
+void TraceIo(S& s, VkViewport& v) {
+    s.Scalar(v.x);
+    s.Scalar(v.y);
+    s.Scalar(v.width);
+    s.Scalar(v.height);
+    s.Scalar(v.minDepth);
+    s.Scalar(v.maxDepth);
+}
+
+template <typename S>
+void TraceIo(S& s, VkClearValue& v) {
+    s.Raw(v);
+}
+
+template <typename S>
+void TraceIo(S& s, VkApplicationInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.String(v.pApplicationName);
+    s.Scalar(v.applicationVersion);
+    s.String(v.pEngineName);
+    s.Scalar(v.engineVersion);
+    s.Scalar(v.apiVersion);
+}
+
+template <typename S>
+void TraceIo(S& s, VkInstanceCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    TraceIoOptional(s, v.pApplicationInfo);
+    s.Scalar(v.enabledLayerCount);
+    TraceIoStrings(s, v.ppEnabledLayerNames, v.enabledLayerCount);
+    s.Scalar(v.enabledExtensionCount);
+    TraceIoStrings(s, v.ppEnabledExtensionNames, v.enabledExtensionCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPhysicalDeviceFeatures& v) {
+    s.Raw(v);
+}
+
+template <typename S>
+void TraceIo(S& s, VkDeviceQueueCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.queueFamilyIndex);
+    s.Scalar(v.queueCount);
+    TraceIoScalars(s, v.pQueuePriorities, v.queueCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkDeviceCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.queueCreateInfoCount);
+    TraceIoArray(s, v.pQueueCreateInfos, v.queueCreateInfoCount);
+    s.Scalar(v.enabledLayerCount);
+    TraceIoStrings(s, v.ppEnabledLayerNames, v.enabledLayerCount);
+    s.Scalar(v.enabledExtensionCount);
+    TraceIoStrings(s, v.ppEnabledExtensionNames, v.enabledExtensionCount);
+    TraceIoOptional(s, v.pEnabledFeatures);
+}
+
+template <typename S>
+void TraceIo(S& s, VkSwapchainCreateInfoKHR& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Handle(v.surface);
+    s.Scalar(v.minImageCount);
+    s.Scalar(v.imageFormat);
+    s.Scalar(v.imageColorSpace);
+    TraceIo(s, v.imageExtent);
+    s.Scalar(v.imageArrayLayers);
+    s.Scalar(v.imageUsage);
+    s.Scalar(v.imageSharingMode);
+    if (v.imageSharingMode == VK_SHARING_MODE_CONCURRENT) {
+        s.Scalar(v.queueFamilyIndexCount);
+        TraceIoScalars(s, v.pQueueFamilyIndices, v.queueFamilyIndexCount);
+    }
+    s.Scalar(v.preTransform);
+    s.Scalar(v.compositeAlpha);
+    s.Scalar(v.presentMode);
+    s.Scalar(v.clipped);
+    s.Handle(v.oldSwapchain);
+}
+
+template <typename S>
+void TraceIo(S& s, VkBufferCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.size);
+    s.Scalar(v.usage);
+    s.Scalar(v.sharingMode);
+    if (v.sharingMode == VK_SHARING_MODE_CONCURRENT) {
+        s.Scalar(v.queueFamilyIndexCount);
+        TraceIoScalars(s, v.pQueueFamilyIndices, v.queueFamilyIndexCount);
+    }
+}
+
+template <typename S>
+void TraceIo(S& s, VkImageCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.imageType);
+    s.Scalar(v.format);
+    TraceIo(s, v.extent);
+    s.Scalar(v.mipLevels);
+    s.Scalar(v.arrayLayers);
+    s.Scalar(v.samples);
+    s.Scalar(v.tiling);
+    s.Scalar(v.usage);
+    s.Scalar(v.sharingMode);
+    if (v.sharingMode == VK_SHARING_MODE_CONCURRENT) {
+        s.Scalar(v.queueFamilyIndexCount);
+        TraceIoScalars(s, v.pQueueFamilyIndices, v.queueFamilyIndexCount);
+    }
+    s.Scalar(v.initialLayout);
+}
+
+template <typename S>
+void TraceIo(S& s, VkImageSubresourceRange& v) {
+    s.Scalar(v.aspectMask);
+    s.Scalar(v.baseMipLevel);
+    s.Scalar(v.levelCount);
+    s.Scalar(v.baseArrayLayer);
+    s.Scalar(v.layerCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkImageSubresourceLayers& v) {
+    s.Scalar(v.aspectMask);
+    s.Scalar(v.mipLevel);
+    s.Scalar(v.baseArrayLayer);
+    s.Scalar(v.layerCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkImageSubresource& v) {
+    s.Scalar(v.aspectMask);
+    s.Scalar(v.mipLevel);
+    s.Scalar(v.arrayLayer);
+}
+
+template <typename S>
+void TraceIo(S& s, VkImageViewCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Handle(v.image);
+    s.Scalar(v.viewType);
+    s.Scalar(v.format);
+    s.Scalar(v.components.r);
+    s.Scalar(v.components.g);
+    s.Scalar(v.components.b);
+    s.Scalar(v.components.a);
+    TraceIo(s, v.subresourceRange);
+}
+
+template <typename S>
+void TraceIo(S& s, VkSamplerCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.magFilter);
+    s.Scalar(v.minFilter);
+    s.Scalar(v.mipmapMode);
+    s.Scalar(v.addressModeU);
+    s.Scalar(v.addressModeV);
+    s.Scalar(v.addressModeW);
+    s.Scalar(v.mipLodBias);
+    s.Scalar(v.anisotropyEnable);
+    s.Scalar(v.maxAnisotropy);
+    s.Scalar(v.compareEnable);
+    s.Scalar(v.compareOp);
+    s.Scalar(v.minLod);
+    s.Scalar(v.maxLod);
+    s.Scalar(v.borderColor);
+    s.Scalar(v.unnormalizedCoordinates);
+}
+
+template <typename S>
+void TraceIo(S& s, VkShaderModuleCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.codeSize);
+    s.Bytes(v.pCode, v.codeSize);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineCacheCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.initialDataSize);
+    s.Bytes(v.pInitialData, v.initialDataSize);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPushConstantRange& v) {
+    s.Scalar(v.stageFlags);
+    s.Scalar(v.offset);
+    s.Scalar(v.size);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineLayoutCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.setLayoutCount);
+    TraceIoHandles(s, v.pSetLayouts, v.setLayoutCount);
+    s.Scalar(v.pushConstantRangeCount);
+    TraceIoArray(s, v.pPushConstantRanges, v.pushConstantRangeCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkDescriptorSetLayoutBinding& v) {
+    s.Scalar(v.binding);
+    s.Scalar(v.descriptorType);
+    s.Scalar(v.descriptorCount);
+    s.Scalar(v.stageFlags);
+    TraceIoHandles(s, v.pImmutableSamplers, v.descriptorCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkDescriptorSetLayoutCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.bindingCount);
+    TraceIoArray(s, v.pBindings, v.bindingCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkDescriptorPoolSize& v) {
+    s.Scalar(v.type);
+    s.Scalar(v.descriptorCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkDescriptorPoolCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.maxSets);
+    s.Scalar(v.poolSizeCount);
+    TraceIoArray(s, v.pPoolSizes, v.poolSizeCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkDescriptorSetAllocateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Handle(v.descriptorPool);
+    s.Scalar(v.descriptorSetCount);
+    TraceIoHandles(s, v.pSetLayouts, v.descriptorSetCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkDescriptorImageInfo& v) {
+    s.Handle(v.sampler);
+    s.Handle(v.imageView);
+    s.Scalar(v.imageLayout);
+}
+
+template <typename S>
+void TraceIo(S& s, VkDescriptorBufferInfo& v) {
+    s.Handle(v.buffer);
+    s.Scalar(v.offset);
+    s.Scalar(v.range);
+}
+
+template <typename S>
+void TraceIo(S& s, VkWriteDescriptorSet& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Handle(v.dstSet);
+    s.Scalar(v.dstBinding);
+    s.Scalar(v.dstArrayElement);
+    s.Scalar(v.descriptorCount);
+    s.Scalar(v.descriptorType);
+    // Only the array matching the descriptor type is valid.
+    switch (v.descriptorType) {
+        case VK_DESCRIPTOR_TYPE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+            TraceIoArray(s, v.pImageInfo, v.descriptorCount);
+            break;
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+            TraceIoHandles(s, v.pTexelBufferView, v.descriptorCount);
+            break;
+        default:
+            TraceIoArray(s, v.pBufferInfo, v.descriptorCount);
+            break;
+    }
+}
+
+template <typename S>
+void TraceIo(S& s, VkCopyDescriptorSet& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Handle(v.srcSet);
+    s.Scalar(v.srcBinding);
+    s.Scalar(v.srcArrayElement);
+    s.Handle(v.dstSet);
+    s.Scalar(v.dstBinding);
+    s.Scalar(v.dstArrayElement);
+    s.Scalar(v.descriptorCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkAttachmentDescription& v) {
+    s.Scalar(v.flags);
+    s.Scalar(v.format);
+    s.Scalar(v.samples);
+    s.Scalar(v.loadOp);
+    s.Scalar(v.storeOp);
+    s.Scalar(v.stencilLoadOp);
+    s.Scalar(v.stencilStoreOp);
+    s.Scalar(v.initialLayout);
+    s.Scalar(v.finalLayout);
+}
+
+template <typename S>
+void TraceIo(S& s, VkAttachmentReference& v) {
+    s.Scalar(v.attachment);
+    s.Scalar(v.layout);
+}
+
+template <typename S>
+void TraceIo(S& s, VkSubpassDescription& v) {
+    s.Scalar(v.flags);
+    s.Scalar(v.pipelineBindPoint);
+    s.Scalar(v.inputAttachmentCount);
+    TraceIoArray(s, v.pInputAttachments, v.inputAttachmentCount);
+    s.Scalar(v.colorAttachmentCount);
+    TraceIoArray(s, v.pColorAttachments, v.colorAttachmentCount);
+    TraceIoArray(s, v.pResolveAttachments, v.colorAttachmentCount);
+    TraceIoOptional(s, v.pDepthStencilAttachment);
+    s.Scalar(v.preserveAttachmentCount);
+    TraceIoScalars(s, v.pPreserveAttachments, v.preserveAttachmentCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkSubpassDependency& v) {
+    s.Scalar(v.srcSubpass);
+    s.Scalar(v.dstSubpass);
+    s.Scalar(v.srcStageMask);
+    s.Scalar(v.dstStageMask);
+    s.Scalar(v.srcAccessMask);
+    s.Scalar(v.dstAccessMask);
+    s.Scalar(v.dependencyFlags);
+}
+
+template <typename S>
+void TraceIo(S& s, VkRenderPassCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.attachmentCount);
+    TraceIoArray(s, v.pAttachments, v.attachmentCount);
+    s.Scalar(v.subpassCount);
+    TraceIoArray(s, v.pSubpasses, v.subpassCount);
+    s.Scalar(v.dependencyCount);
+    TraceIoArray(s, v.pDependencies, v.dependencyCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkFramebufferCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Handle(v.renderPass);
+    s.Scalar(v.attachmentCount);
+    TraceIoHandles(s, v.pAttachments, v.attachmentCount);
+    s.Scalar(v.width);
+    s.Scalar(v.height);
+    s.Scalar(v.layers);
+}
+
+template <typename S>
+void TraceIo(S& s, VkCommandPoolCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.queueFamilyIndex);
+}
+
+template <typename S>
+void TraceIo(S& s, VkCommandBufferAllocateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Handle(v.commandPool);
+    s.Scalar(v.level);
+    s.Scalar(v.commandBufferCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkCommandBufferInheritanceInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Handle(v.renderPass);
+    s.Scalar(v.subpass);
+    s.Handle(v.framebuffer);
+    s.Scalar(v.occlusionQueryEnable);
+    s.Scalar(v.queryFlags);
+    s.Scalar(v.pipelineStatistics);
+}
+
+template <typename S>
+void TraceIo(S& s, VkCommandBufferBeginInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    TraceIoOptional(s, v.pInheritanceInfo);
+}
+
+template <typename S>
+void TraceIo(S& s, VkFenceCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+}
+
+template <typename S>
+void TraceIo(S& s, VkSemaphoreCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+}
+
+template <typename S>
+void TraceIo(S& s, VkMemoryAllocateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.allocationSize);
+    s.Scalar(v.memoryTypeIndex);
+}
+
+template <typename S>
+void TraceIo(S& s, VkMappedMemoryRange& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Handle(v.memory);
+    s.Scalar(v.offset);
+    s.Scalar(v.size);
+}
+
+template <typename S>
+void TraceIo(S& s, VkSpecializationMapEntry& v) {
+    s.Scalar(v.constantID);
+    s.Scalar(v.offset);
+    s.Scalar(v.size);
+}
+
+template <typename S>
+void TraceIo(S& s, VkSpecializationInfo& v) {
+    s.Scalar(v.mapEntryCount);
+    TraceIoArray(s, v.pMapEntries, v.mapEntryCount);
+    s.Scalar(v.dataSize);
+    s.Bytes(v.pData, v.dataSize);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineShaderStageCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.stage);
+    s.Handle(v.module);
+    s.String(v.pName);
+    TraceIoOptional(s, v.pSpecializationInfo);
+}
+
+template <typename S>
+void TraceIo(S& s, VkVertexInputBindingDescription& v) {
+    s.Scalar(v.binding);
+    s.Scalar(v.stride);
+    s.Scalar(v.inputRate);
+}
+
+template <typename S>
+void TraceIo(S& s, VkVertexInputAttributeDescription& v) {
+    s.Scalar(v.location);
+    s.Scalar(v.binding);
+    s.Scalar(v.format);
+    s.Scalar(v.offset);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineVertexInputStateCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.vertexBindingDescriptionCount);
+    TraceIoArray(s, v.pVertexBindingDescriptions,
+                 v.vertexBindingDescriptionCount);
+    s.Scalar(v.vertexAttributeDescriptionCount);
+    TraceIoArray(s, v.pVertexAttributeDescriptions,
+                 v.vertexAttributeDescriptionCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineInputAssemblyStateCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.topology);
+    s.Scalar(v.primitiveRestartEnable);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineTessellationStateCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.patchControlPoints);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineViewportStateCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.viewportCount);
+    TraceIoArray(s, v.pViewports, v.viewportCount);
+    s.Scalar(v.scissorCount);
+    TraceIoArray(s, v.pScissors, v.scissorCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineRasterizationStateCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.depthClampEnable);
+    s.Scalar(v.rasterizerDiscardEnable);
+    s.Scalar(v.polygonMode);
+    s.Scalar(v.cullMode);
+    s.Scalar(v.frontFace);
+    s.Scalar(v.depthBiasEnable);
+    s.Scalar(v.depthBiasConstantFactor);
+    s.Scalar(v.depthBiasClamp);
+    s.Scalar(v.depthBiasSlopeFactor);
+    s.Scalar(v.lineWidth);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineMultisampleStateCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.rasterizationSamples);
+    s.Scalar(v.sampleShadingEnable);
+    s.Scalar(v.minSampleShading);
+    TraceIoScalars(s, v.pSampleMask, (v.rasterizationSamples + 31) / 32);
+    s.Scalar(v.alphaToCoverageEnable);
+    s.Scalar(v.alphaToOneEnable);
+}
+
+template <typename S>
+void TraceIo(S& s, VkStencilOpState& v) {
+    s.Scalar(v.failOp);
+    s.Scalar(v.passOp);
+    s.Scalar(v.depthFailOp);
+    s.Scalar(v.compareOp);
+    s.Scalar(v.compareMask);
+    s.Scalar(v.writeMask);
+    s.Scalar(v.reference);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineDepthStencilStateCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.depthTestEnable);
+    s.Scalar(v.depthWriteEnable);
+    s.Scalar(v.depthCompareOp);
+    s.Scalar(v.depthBoundsTestEnable);
+    s.Scalar(v.stencilTestEnable);
+    TraceIo(s, v.front);
+    TraceIo(s, v.back);
+    s.Scalar(v.minDepthBounds);
+    s.Scalar(v.maxDepthBounds);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineColorBlendAttachmentState& v) {
+    s.Scalar(v.blendEnable);
+    s.Scalar(v.srcColorBlendFactor);
+    s.Scalar(v.dstColorBlendFactor);
+    s.Scalar(v.colorBlendOp);
+    s.Scalar(v.srcAlphaBlendFactor);
+    s.Scalar(v.dstAlphaBlendFactor);
+    s.Scalar(v.alphaBlendOp);
+    s.Scalar(v.colorWriteMask);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineColorBlendStateCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.logicOpEnable);
+    s.Scalar(v.logicOp);
+    s.Scalar(v.attachmentCount);
+    TraceIoArray(s, v.pAttachments, v.attachmentCount);
+    for (int i = 0; i < 4; i++) s.Scalar(v.blendConstants[i]);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPipelineDynamicStateCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.dynamicStateCount);
+    TraceIoScalars(s, v.pDynamicStates, v.dynamicStateCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkGraphicsPipelineCreateInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.flags);
+    s.Scalar(v.stageCount);
+    TraceIoArray(s, v.pStages, v.stageCount);
+    TraceIoOptional(s, v.pVertexInputState);
+    TraceIoOptional(s, v.pInputAssemblyState);
+    TraceIoOptional(s, v.pTessellationState);
+    TraceIoOptional(s, v.pViewportState);
+    TraceIoOptional(s, v.pRasterizationState);
+    TraceIoOptional(s, v.pMultisampleState);
+    TraceIoOptional(s, v.pDepthStencilState);
+    TraceIoOptional(s, v.pColorBlendState);
+    TraceIoOptional(s, v.pDynamicState);
+    s.Handle(v.layout);
+    s.Handle(v.renderPass);
+    s.Scalar(v.subpass);
+    s.Handle(v.basePipelineHandle);
+    s.Scalar(v.basePipelineIndex);
+}
+
+template <typename S>
+void TraceIo(S& s, VkRenderPassBeginInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Handle(v.renderPass);
+    s.Handle(v.framebuffer);
+    TraceIo(s, v.renderArea);
+    s.Scalar(v.clearValueCount);
+    TraceIoArray(s, v.pClearValues, v.clearValueCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkMemoryBarrier& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.srcAccessMask);
+    s.Scalar(v.dstAccessMask);
+}
+
+template <typename S>
+void TraceIo(S& s, VkBufferMemoryBarrier& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.srcAccessMask);
+    s.Scalar(v.dstAccessMask);
+    s.Scalar(v.srcQueueFamilyIndex);
+    s.Scalar(v.dstQueueFamilyIndex);
+    s.Handle(v.buffer);
+    s.Scalar(v.offset);
+    s.Scalar(v.size);
+}
+
+template <typename S>
+void TraceIo(S& s, VkImageMemoryBarrier& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.srcAccessMask);
+    s.Scalar(v.dstAccessMask);
+    s.Scalar(v.oldLayout);
+    s.Scalar(v.newLayout);
+    s.Scalar(v.srcQueueFamilyIndex);
+    s.Scalar(v.dstQueueFamilyIndex);
+    s.Handle(v.image);
+    TraceIo(s, v.subresourceRange);
+}
+
+template <typename S>
+void TraceIo(S& s, VkBufferCopy& v) {
+    s.Scalar(v.srcOffset);
+    s.Scalar(v.dstOffset);
+    s.Scalar(v.size);
+}
+
+template <typename S>
+void TraceIo(S& s, VkImageCopy& v) {
+    TraceIo(s, v.srcSubresource);
+    TraceIo(s, v.srcOffset);
+    TraceIo(s, v.dstSubresource);
+    TraceIo(s, v.dstOffset);
+    TraceIo(s, v.extent);
+}
+
+template <typename S>
+void TraceIo(S& s, VkBufferImageCopy& v) {
+    s.Scalar(v.bufferOffset);
+    s.Scalar(v.bufferRowLength);
+    s.Scalar(v.bufferImageHeight);
+    TraceIo(s, v.imageSubresource);
+    TraceIo(s, v.imageOffset);
+    TraceIo(s, v.imageExtent);
+}
+
+template <typename S>
+void TraceIo(S& s, VkImageBlit& v) {
+    TraceIo(s, v.srcSubresource);
+    TraceIo(s, v.srcOffsets[0]);
+    TraceIo(s, v.srcOffsets[1]);
+    TraceIo(s, v.dstSubresource);
+    TraceIo(s, v.dstOffsets[0]);
+    TraceIo(s, v.dstOffsets[1]);
+}
+
+template <typename S>
+void TraceIo(S& s, VkSubmitInfo& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.waitSemaphoreCount);
+    TraceIoHandles(s, v.pWaitSemaphores, v.waitSemaphoreCount);
+    TraceIoScalars(s, v.pWaitDstStageMask, v.waitSemaphoreCount);
+    s.Scalar(v.commandBufferCount);
+    TraceIoHandles(s, v.pCommandBuffers, v.commandBufferCount);
+    s.Scalar(v.signalSemaphoreCount);
+    TraceIoHandles(s, v.pSignalSemaphores, v.signalSemaphoreCount);
+}
+
+template <typename S>
+void TraceIo(S& s, VkPresentInfoKHR& v) {
+    VK_TRACE_HEADER(s, v);
+    s.Scalar(v.waitSemaphoreCount);
+    TraceIoHandles(s, v.pWaitSemaphores, v.waitSemaphoreCount);
+    s.Scalar(v.swapchainCount);
+    TraceIoHandles(s, v.pSwapchains, v.swapchainCount);
+    TraceIoScalars(s, v.pImageIndices, v.swapchainCount);
+}
+
+#undef VK_TRACE_HEADER
+
+/*
+ * Encoder side. All calls between Begin() and End() build one record; blobs
+ * interned meanwhile are written out ahead of it.
+ */
+class TraceWriter {
+  public:
+    TraceWriter() : file_(nullptr), out_(&record_), command_(kTraceBlob),
+                    lastHandleId_(0), unknownHandles_(0),
+                    droppedExtensions_(0) {}
+    ~TraceWriter() { Close(); }
+
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return file_ != nullptr; }
+
+    void Begin(TraceCommand command);
+    void End(uint64_t nanoseconds);
+
+    // Fresh id for a handle the driver just returned, 0 if it is null.
+    template <typename H>
+    void NewHandle(H handle) {
+        if (!TraceHandleBits<H>::Get(handle)) {
+            Varint(0);
+            return;
+        }
+        uint32_t id = ++lastHandleId_;
+        handleIds_[TraceHandleBits<H>::Get(handle)] = id;
+        Varint(id);
+    }
+
+    // Interns |info| and writes its blob id.
+    template <typename T>
+    void Blob(const T& info) {
+        std::vector<uint8_t> encoded;
+        out_ = &encoded;
+        TraceIo(*this, const_cast<T&>(info));
+        out_ = &record_;
+        Varint(Intern(encoded));
+    }
+
+    // Writes |value| inline, for small structs not worth interning.
+    template <typename T>
+    void Struct(const T& value) {
+        TraceIo(*this, const_cast<T&>(value));
+    }
+
+    uint64_t UnknownHandles() const { return unknownHandles_; }
+    uint64_t DroppedExtensions() const { return droppedExtensions_; }
+
+    // Codec interface, see TraceIo().
+    template <typename T>
+    void Scalar(const T& value) {
+        Encode(value, std::is_floating_point<T>(), std::is_signed<T>());
+    }
+
+    template <typename T>
+    void Raw(const T& value) {
+        Append(&value, sizeof(value));
+    }
+
+    template <typename H>
+    void Handle(const H& handle) {
+        uint64_t bits = TraceHandleBits<H>::Get(handle);
+        if (!bits) {
+            Varint(0);
+            return;
+        }
+        auto it = handleIds_.find(bits);
+        if (it == handleIds_.end()) {
+            // Created by a call capture does not intercept.
+            unknownHandles_++;
+            Varint(0);
+            return;
+        }
+        Varint(it->second);
+    }
+
+    void String(const char* const& string);
+
+    template <typename P>
+    void Bytes(const P* const& data, uint64_t size) {
+        Varint(data ? 1 : 0);
+        if (data)
+            Append(data, size);
+    }
+
+    template <typename T>
+    T* Array(const T* const& items, uint64_t count) {
+        Varint(items && count ? 1 : 0);
+        return items && count ? const_cast<T*>(items) : nullptr;
+    }
+
+    void DropExtensions(uint32_t count) { droppedExtensions_ += count; }
+
+    void Varint(uint64_t value);
+
+  private:
+    template <typename T>
+    void Encode(const T& value, std::true_type, std::true_type) {
+        Raw(value);
+    }
+    template <typename T>
+    void Encode(const T& value, std::false_type, std::true_type) {
+        int64_t wide = static_cast<int64_t>(value);
+        Varint((static_cast<uint64_t>(wide) << 1) ^
+               static_cast<uint64_t>(wide >> 63));
+    }
+    template <typename T>
+    void Encode(const T& value, std::false_type, std::false_type) {
+        Varint(static_cast<uint64_t>(value));
+    }
+
+    void Append(const void* data, size_t size);
+    uint32_t Intern(const std::vector<uint8_t>& encoded);
+    void Flush();
+
+    FILE* file_;
+    std::vector<uint8_t> buffer_;  // records waiting for fwrite()
+    std::vector<uint8_t> record_;  // payload of the record being built
+    std::vector<uint8_t>* out_;    // where Append() goes: record or blob
+    TraceCommand command_;
+    // Driver handle -> id. A handle value the driver hands out again after
+    // a destroy simply gets a new id.
+    std::unordered_map<uint64_t, uint32_t> handleIds_;
+    uint32_t lastHandleId_;
+    // FNV-1a hash of an encoding -> blob ids with that hash.
+    std::unordered_multimap<uint64_t, uint32_t> blobIds_;
+    std::vector<std::vector<uint8_t>> blobs_;
+    uint64_t unknownHandles_;
+    uint64_t droppedExtensions_;
+};
+
+/*
+ * Decoder side. Next() steps over blob records itself, so callers only see
+ * Vulkan calls and memory writes. Everything a record decodes into lives
+ * until the following Next().
+ */
+class TraceReader {
+  public:
+    TraceReader() : cursor_(nullptr), end_(nullptr), recordEnd_(nullptr),
+                    command_(kTraceBlob), nanoseconds_(0),
+                    droppedExtensions_(0) {}
+
+    bool Open(const char* path);
+    bool Next();
+
+    TraceCommand command() const { return command_; }
+    uint64_t nanoseconds() const { return nanoseconds_; }
+    uint64_t DroppedExtensions() const { return droppedExtensions_; }
+
+    // Reads the id written by TraceWriter::NewHandle(); Bind() then maps it
+    // to the handle the replaying driver returned.
+    uint32_t HandleId() { return static_cast<uint32_t>(Varint()); }
+    template <typename H>
+    void Bind(uint32_t id, H handle) {
+        if (id)
+            handles_[id] = TraceHandleBits<H>::Get(handle);
+    }
+
+    template <typename T>
+    void Blob(T& info) {
+        uint64_t id = Varint();
+        if (id == 0 || id > blobs_.size()) {
+            info = T();
+            return;
+        }
+        const uint8_t* cursor = cursor_;
+        const uint8_t* end = end_;
+        cursor_ = blobs_[id - 1].first;
+        end_ = blobs_[id - 1].second;
+        info = T();
+        TraceIo(*this, info);
+        cursor_ = cursor;
+        end_ = end;
+    }
+
+    template <typename T>
+    void Struct(T& value) {
+        value = T();
+        TraceIo(*this, value);
+    }
+
+    // Codec interface, see TraceIo().
+    template <typename T>
+    void Scalar(T& value) {
+        Decode(value, std::is_floating_point<T>(), std::is_signed<T>());
+    }
+
+    template <typename T>
+    void Raw(T& value) {
+        Read(&value, sizeof(value));
+    }
+
+    template <typename H>
+    void Handle(H& handle) {
+        auto it = handles_.find(static_cast<uint32_t>(Varint()));
+        handle = TraceHandleBits<H>::Make(it == handles_.end() ? 0
+                                                               : it->second);
+    }
+
+    void String(const char*& string);
+
+    template <typename P>
+    void Bytes(const P*& data, uint64_t size) {
+        data = nullptr;
+        if (!Varint())
+            return;
+        uint8_t* bytes = Allocate(size);
+        Read(bytes, size);
+        data = reinterpret_cast<const P*>(bytes);
+    }
+
+    template <typename T>
+    T* Array(const T*& items, uint64_t count) {
+        items = nullptr;
+        if (!Varint())
+            return nullptr;
+        T* array = reinterpret_cast<T*>(Allocate(sizeof(T) * count));
+        items = array;
+        return array;
+    }
+
+    void DropExtensions(uint32_t count) { droppedExtensions_ += count; }
+
+    uint64_t Varint();
+    // Pointer to |size| bytes of the record, for memory writes.
+    const uint8_t* Span(uint64_t size);
+
+  private:
+    template <typename T>
+    void Decode(T& value, std::true_type, std::true_type) {
+        Raw(value);
+    }
+    template <typename T>
+    void Decode(T& value, std::false_type, std::true_type) {
+        uint64_t bits = Varint();
+        value = static_cast<T>(static_cast<int64_t>(bits >> 1) ^
+                               -static_cast<int64_t>(bits & 1));
+    }
+    template <typename T>
+    void Decode(T& value, std::false_type, std::false_type) {
+        value = static_cast<T>(Varint());
+    }
+
+    void Read(void* data, uint64_t size);
+    uint8_t* Allocate(uint64_t size);
+
+    std::vector<uint8_t> file_;
+    const uint8_t* cursor_;
+    const uint8_t* end_;
+    const uint8_t* recordEnd_;
+    TraceCommand command_;
+    uint64_t nanoseconds_;
+    std::unordered_map<uint32_t, uint64_t> handles_;
+    std::vector<std::pair<const uint8_t*, const uint8_t*>> blobs_;
+    std::vector<std::unique_ptr<uint64_t[]>> arena_;
+    uint64_t droppedExtensions_;
+};
+
+#endif  // VULKAN_TRACE_H
@@ -12,7 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-// This file is generated.
+// This file is generated by gen_vulkan_wrapper.py from vk.xml, do not edit.
 #ifndef VULKAN_WRAPPER_H
 #define VULKAN_WRAPPER_H
 
@@ -24,7 +24,26 @@
  */
 int InitVulkan(void);
 
-// VK_core
+/* Lazy-binding variant of InitVulkan(): only opens libvulkan.so and points
+ * every function pointer variable at a resolver thunk, which dlsym()s the
+ * real entry point and replaces itself on its first call. Startup cost then
+ * scales with the entry points the app actually calls. All variables are
+ * non-NULL afterwards, so they cannot be used to probe for a symbol; calling
+ * one libvulkan.so does not export aborts.
+ * Returns 0 if vulkan is not available, non-zero if it is available.
+ */
+int InitVulkanLazy(void);
+
+/* Cold-start counters of the wrapper, cumulative since process start. */
+typedef struct VulkanWrapperStats {
+    uint32_t boundSymbols;     // entry points resolved through dlsym()
+    uint64_t loadNanoseconds;  // time spent in dlopen("libvulkan.so")
+    uint64_t bindNanoseconds;  // time spent in dlsym(), eager and lazy
+} VulkanWrapperStats;
+
+void GetVulkanWrapperStats(VulkanWrapperStats* stats);
+
+// VK_VERSION_1_0
 extern PFN_vkCreateInstance vkCreateInstance;
 extern PFN_vkDestroyInstance vkDestroyInstance;
 extern PFN_vkEnumeratePhysicalDevices vkEnumeratePhysicalDevices;
@@ -176,6 +195,12 @@ extern PFN_vkDestroySwapchainKHR vkDestroySwapchainKHR;
 extern PFN_vkGetSwapchainImagesKHR vkGetSwapchainImagesKHR;
 extern PFN_vkAcquireNextImageKHR vkAcquireNextImageKHR;
 extern PFN_vkQueuePresentKHR vkQueuePresentKHR;
+#ifdef VK_VERSION_1_1
+extern PFN_vkGetDeviceGroupPresentCapabilitiesKHR vkGetDeviceGroupPresentCapabilitiesKHR;
+extern PFN_vkGetDeviceGroupSurfacePresentModesKHR vkGetDeviceGroupSurfacePresentModesKHR;
+extern PFN_vkGetPhysicalDevicePresentRectanglesKHR vkGetPhysicalDevicePresentRectanglesKHR;
+extern PFN_vkAcquireNextImage2KHR vkAcquireNextImage2KHR;
+#endif
 
 // VK_KHR_display
 extern PFN_vkGetPhysicalDeviceDisplayPropertiesKHR vkGetPhysicalDeviceDisplayPropertiesKHR;
@@ -207,12 +232,6 @@ extern PFN_vkCreateWaylandSurfaceKHR vkCreateWaylandSurfaceKHR;
 extern PFN_vkGetPhysicalDeviceWaylandPresentationSupportKHR vkGetPhysicalDeviceWaylandPresentationSupportKHR;
 #endif
 
-#ifdef VK_USE_PLATFORM_MIR_KHR
-// VK_KHR_mir_surface
-extern PFN_vkCreateMirSurfaceKHR vkCreateMirSurfaceKHR;
-extern PFN_vkGetPhysicalDeviceMirPresentationSupportKHR vkGetPhysicalDeviceMirPresentationSupportKHR;
-#endif
-
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 // VK_KHR_android_surface
 extern PFN_vkCreateAndroidSurfaceKHR vkCreateAndroidSurfaceKHR;
@@ -232,5 +251,387 @@ extern PFN_vkDestroyDebugReportCallbackEXT vkDestroyDebugReportCallbackEXT;
 extern PFN_vkDebugReportMessageEXT vkDebugReportMessageEXT;
 #endif
 
+#ifdef VK_VERSION_1_1
+// VK_VERSION_1_1
+extern PFN_vkEnumerateInstanceVersion vkEnumerateInstanceVersion;
+#endif
+
+// Per-instance and per-device dispatch tables.
+// The global function pointers above come from libvulkan.so and are loader
+// trampolines: each call first looks up the real entry point behind the
+// dispatchable handle. Tables filled through vkGetInstanceProcAddr() and
+// vkGetDeviceProcAddr() hold the driver entry points for one instance or
+// device, so calls made through them (vkCmd* in particular) skip that hop.
+// They also carry every Vulkan 1.1-1.3 and extension entry point the wrapper
+// knows about; members the instance or device does not support stay NULL.
+typedef struct VkInstanceDispatchTable {
+  // VK_VERSION_1_0
+  PFN_vkDestroyInstance vkDestroyInstance;
+  PFN_vkEnumeratePhysicalDevices vkEnumeratePhysicalDevices;
+  PFN_vkGetPhysicalDeviceFeatures vkGetPhysicalDeviceFeatures;
+  PFN_vkGetPhysicalDeviceFormatProperties vkGetPhysicalDeviceFormatProperties;
+  PFN_vkGetPhysicalDeviceImageFormatProperties vkGetPhysicalDeviceImageFormatProperties;
+  PFN_vkGetPhysicalDeviceProperties vkGetPhysicalDeviceProperties;
+  PFN_vkGetPhysicalDeviceQueueFamilyProperties vkGetPhysicalDeviceQueueFamilyProperties;
+  PFN_vkGetPhysicalDeviceMemoryProperties vkGetPhysicalDeviceMemoryProperties;
+  PFN_vkGetDeviceProcAddr vkGetDeviceProcAddr;
+  PFN_vkCreateDevice vkCreateDevice;
+  PFN_vkEnumerateDeviceExtensionProperties vkEnumerateDeviceExtensionProperties;
+  PFN_vkEnumerateDeviceLayerProperties vkEnumerateDeviceLayerProperties;
+  PFN_vkGetPhysicalDeviceSparseImageFormatProperties vkGetPhysicalDeviceSparseImageFormatProperties;
+  // VK_KHR_surface
+  PFN_vkDestroySurfaceKHR vkDestroySurfaceKHR;
+  PFN_vkGetPhysicalDeviceSurfaceSupportKHR vkGetPhysicalDeviceSurfaceSupportKHR;
+  PFN_vkGetPhysicalDeviceSurfaceCapabilitiesKHR vkGetPhysicalDeviceSurfaceCapabilitiesKHR;
+  PFN_vkGetPhysicalDeviceSurfaceFormatsKHR vkGetPhysicalDeviceSurfaceFormatsKHR;
+  PFN_vkGetPhysicalDeviceSurfacePresentModesKHR vkGetPhysicalDeviceSurfacePresentModesKHR;
+  // VK_KHR_swapchain
+#ifdef VK_VERSION_1_1
+  PFN_vkGetPhysicalDevicePresentRectanglesKHR vkGetPhysicalDevicePresentRectanglesKHR;
+#endif
+  // VK_KHR_display
+  PFN_vkGetPhysicalDeviceDisplayPropertiesKHR vkGetPhysicalDeviceDisplayPropertiesKHR;
+  PFN_vkGetPhysicalDeviceDisplayPlanePropertiesKHR vkGetPhysicalDeviceDisplayPlanePropertiesKHR;
+  PFN_vkGetDisplayPlaneSupportedDisplaysKHR vkGetDisplayPlaneSupportedDisplaysKHR;
+  PFN_vkGetDisplayModePropertiesKHR vkGetDisplayModePropertiesKHR;
+  PFN_vkCreateDisplayModeKHR vkCreateDisplayModeKHR;
+  PFN_vkGetDisplayPlaneCapabilitiesKHR vkGetDisplayPlaneCapabilitiesKHR;
+  PFN_vkCreateDisplayPlaneSurfaceKHR vkCreateDisplayPlaneSurfaceKHR;
+#ifdef VK_USE_PLATFORM_XLIB_KHR
+  // VK_KHR_xlib_surface
+  PFN_vkCreateXlibSurfaceKHR vkCreateXlibSurfaceKHR;
+  PFN_vkGetPhysicalDeviceXlibPresentationSupportKHR vkGetPhysicalDeviceXlibPresentationSupportKHR;
+#endif
+#ifdef VK_USE_PLATFORM_XCB_KHR
+  // VK_KHR_xcb_surface
+  PFN_vkCreateXcbSurfaceKHR vkCreateXcbSurfaceKHR;
+  PFN_vkGetPhysicalDeviceXcbPresentationSupportKHR vkGetPhysicalDeviceXcbPresentationSupportKHR;
+#endif
+#ifdef VK_USE_PLATFORM_WAYLAND_KHR
+  // VK_KHR_wayland_surface
+  PFN_vkCreateWaylandSurfaceKHR vkCreateWaylandSurfaceKHR;
+  PFN_vkGetPhysicalDeviceWaylandPresentationSupportKHR vkGetPhysicalDeviceWaylandPresentationSupportKHR;
+#endif
+#ifdef VK_USE_PLATFORM_ANDROID_KHR
+  // VK_KHR_android_surface
+  PFN_vkCreateAndroidSurfaceKHR vkCreateAndroidSurfaceKHR;
+#endif
+#ifdef VK_USE_PLATFORM_WIN32_KHR
+  // VK_KHR_win32_surface
+  PFN_vkCreateWin32SurfaceKHR vkCreateWin32SurfaceKHR;
+  PFN_vkGetPhysicalDeviceWin32PresentationSupportKHR vkGetPhysicalDeviceWin32PresentationSupportKHR;
+#endif
+#ifdef USE_DEBUG_EXTENTIONS
+  // VK_EXT_debug_report
+  PFN_vkCreateDebugReportCallbackEXT vkCreateDebugReportCallbackEXT;
+  PFN_vkDestroyDebugReportCallbackEXT vkDestroyDebugReportCallbackEXT;
+  PFN_vkDebugReportMessageEXT vkDebugReportMessageEXT;
+#endif
+#ifdef VK_VERSION_1_1
+  // VK_VERSION_1_1
+  PFN_vkEnumeratePhysicalDeviceGroups vkEnumeratePhysicalDeviceGroups;
+  PFN_vkGetPhysicalDeviceFeatures2 vkGetPhysicalDeviceFeatures2;
+  PFN_vkGetPhysicalDeviceProperties2 vkGetPhysicalDeviceProperties2;
+  PFN_vkGetPhysicalDeviceFormatProperties2 vkGetPhysicalDeviceFormatProperties2;
+  PFN_vkGetPhysicalDeviceImageFormatProperties2 vkGetPhysicalDeviceImageFormatProperties2;
+  PFN_vkGetPhysicalDeviceQueueFamilyProperties2 vkGetPhysicalDeviceQueueFamilyProperties2;
+  PFN_vkGetPhysicalDeviceMemoryProperties2 vkGetPhysicalDeviceMemoryProperties2;
+  PFN_vkGetPhysicalDeviceSparseImageFormatProperties2 vkGetPhysicalDeviceSparseImageFormatProperties2;
+  PFN_vkGetPhysicalDeviceExternalBufferProperties vkGetPhysicalDeviceExternalBufferProperties;
+  PFN_vkGetPhysicalDeviceExternalFenceProperties vkGetPhysicalDeviceExternalFenceProperties;
+  PFN_vkGetPhysicalDeviceExternalSemaphoreProperties vkGetPhysicalDeviceExternalSemaphoreProperties;
+#endif
+#ifdef VK_VERSION_1_3
+  // VK_VERSION_1_3
+  PFN_vkGetPhysicalDeviceToolProperties vkGetPhysicalDeviceToolProperties;
+#endif
+#ifdef VK_KHR_get_physical_device_properties2
+  // VK_KHR_get_physical_device_properties2
+  PFN_vkGetPhysicalDeviceFeatures2KHR vkGetPhysicalDeviceFeatures2KHR;
+  PFN_vkGetPhysicalDeviceProperties2KHR vkGetPhysicalDeviceProperties2KHR;
+  PFN_vkGetPhysicalDeviceFormatProperties2KHR vkGetPhysicalDeviceFormatProperties2KHR;
+  PFN_vkGetPhysicalDeviceImageFormatProperties2KHR vkGetPhysicalDeviceImageFormatProperties2KHR;
+  PFN_vkGetPhysicalDeviceQueueFamilyProperties2KHR vkGetPhysicalDeviceQueueFamilyProperties2KHR;
+  PFN_vkGetPhysicalDeviceMemoryProperties2KHR vkGetPhysicalDeviceMemoryProperties2KHR;
+  PFN_vkGetPhysicalDeviceSparseImageFormatProperties2KHR vkGetPhysicalDeviceSparseImageFormatProperties2KHR;
+#endif
+#ifdef VK_EXT_headless_surface
+  // VK_EXT_headless_surface
+  PFN_vkCreateHeadlessSurfaceEXT vkCreateHeadlessSurfaceEXT;
+#endif
+} VkInstanceDispatchTable;
+
+typedef struct VkDeviceDispatchTable {
+  // VK_VERSION_1_0
+  PFN_vkDestroyDevice vkDestroyDevice;
+  PFN_vkGetDeviceQueue vkGetDeviceQueue;
+  PFN_vkQueueSubmit vkQueueSubmit;
+  PFN_vkQueueWaitIdle vkQueueWaitIdle;
+  PFN_vkDeviceWaitIdle vkDeviceWaitIdle;
+  PFN_vkAllocateMemory vkAllocateMemory;
+  PFN_vkFreeMemory vkFreeMemory;
+  PFN_vkMapMemory vkMapMemory;
+  PFN_vkUnmapMemory vkUnmapMemory;
+  PFN_vkFlushMappedMemoryRanges vkFlushMappedMemoryRanges;
+  PFN_vkInvalidateMappedMemoryRanges vkInvalidateMappedMemoryRanges;
+  PFN_vkGetDeviceMemoryCommitment vkGetDeviceMemoryCommitment;
+  PFN_vkBindBufferMemory vkBindBufferMemory;
+  PFN_vkBindImageMemory vkBindImageMemory;
+  PFN_vkGetBufferMemoryRequirements vkGetBufferMemoryRequirements;
+  PFN_vkGetImageMemoryRequirements vkGetImageMemoryRequirements;
+  PFN_vkGetImageSparseMemoryRequirements vkGetImageSparseMemoryRequirements;
+  PFN_vkQueueBindSparse vkQueueBindSparse;
+  PFN_vkCreateFence vkCreateFence;
+  PFN_vkDestroyFence vkDestroyFence;
+  PFN_vkResetFences vkResetFences;
+  PFN_vkGetFenceStatus vkGetFenceStatus;
+  PFN_vkWaitForFences vkWaitForFences;
+  PFN_vkCreateSemaphore vkCreateSemaphore;
+  PFN_vkDestroySemaphore vkDestroySemaphore;
+  PFN_vkCreateEvent vkCreateEvent;
+  PFN_vkDestroyEvent vkDestroyEvent;
+  PFN_vkGetEventStatus vkGetEventStatus;
+  PFN_vkSetEvent vkSetEvent;
+  PFN_vkResetEvent vkResetEvent;
+  PFN_vkCreateQueryPool vkCreateQueryPool;
+  PFN_vkDestroyQueryPool vkDestroyQueryPool;
+  PFN_vkGetQueryPoolResults vkGetQueryPoolResults;
+  PFN_vkCreateBuffer vkCreateBuffer;
+  PFN_vkDestroyBuffer vkDestroyBuffer;
+  PFN_vkCreateBufferView vkCreateBufferView;
+  PFN_vkDestroyBufferView vkDestroyBufferView;
+  PFN_vkCreateImage vkCreateImage;
+  PFN_vkDestroyImage vkDestroyImage;
+  PFN_vkGetImageSubresourceLayout vkGetImageSubresourceLayout;
+  PFN_vkCreateImageView vkCreateImageView;
+  PFN_vkDestroyImageView vkDestroyImageView;
+  PFN_vkCreateShaderModule vkCreateShaderModule;
+  PFN_vkDestroyShaderModule vkDestroyShaderModule;
+  PFN_vkCreatePipelineCache vkCreatePipelineCache;
+  PFN_vkDestroyPipelineCache vkDestroyPipelineCache;
+  PFN_vkGetPipelineCacheData vkGetPipelineCacheData;
+  PFN_vkMergePipelineCaches vkMergePipelineCaches;
+  PFN_vkCreateGraphicsPipelines vkCreateGraphicsPipelines;
+  PFN_vkCreateComputePipelines vkCreateComputePipelines;
+  PFN_vkDestroyPipeline vkDestroyPipeline;
+  PFN_vkCreatePipelineLayout vkCreatePipelineLayout;
+  PFN_vkDestroyPipelineLayout vkDestroyPipelineLayout;
+  PFN_vkCreateSampler vkCreateSampler;
+  PFN_vkDestroySampler vkDestroySampler;
+  PFN_vkCreateDescriptorSetLayout vkCreateDescriptorSetLayout;
+  PFN_vkDestroyDescriptorSetLayout vkDestroyDescriptorSetLayout;
+  PFN_vkCreateDescriptorPool vkCreateDescriptorPool;
+  PFN_vkDestroyDescriptorPool vkDestroyDescriptorPool;
+  PFN_vkResetDescriptorPool vkResetDescriptorPool;
+  PFN_vkAllocateDescriptorSets vkAllocateDescriptorSets;
+  PFN_vkFreeDescriptorSets vkFreeDescriptorSets;
+  PFN_vkUpdateDescriptorSets vkUpdateDescriptorSets;
+  PFN_vkCreateFramebuffer vkCreateFramebuffer;
+  PFN_vkDestroyFramebuffer vkDestroyFramebuffer;
+  PFN_vkCreateRenderPass vkCreateRenderPass;
+  PFN_vkDestroyRenderPass vkDestroyRenderPass;
+  PFN_vkGetRenderAreaGranularity vkGetRenderAreaGranularity;
+  PFN_vkCreateCommandPool vkCreateCommandPool;
+  PFN_vkDestroyCommandPool vkDestroyCommandPool;
+  PFN_vkResetCommandPool vkResetCommandPool;
+  PFN_vkAllocateCommandBuffers vkAllocateCommandBuffers;
+  PFN_vkFreeCommandBuffers vkFreeCommandBuffers;
+  PFN_vkBeginCommandBuffer vkBeginCommandBuffer;
+  PFN_vkEndCommandBuffer vkEndCommandBuffer;
+  PFN_vkResetCommandBuffer vkResetCommandBuffer;
+  PFN_vkCmdBindPipeline vkCmdBindPipeline;
+  PFN_vkCmdSetViewport vkCmdSetViewport;
+  PFN_vkCmdSetScissor vkCmdSetScissor;
+  PFN_vkCmdSetLineWidth vkCmdSetLineWidth;
+  PFN_vkCmdSetDepthBias vkCmdSetDepthBias;
+  PFN_vkCmdSetBlendConstants vkCmdSetBlendConstants;
+  PFN_vkCmdSetDepthBounds vkCmdSetDepthBounds;
+  PFN_vkCmdSetStencilCompareMask vkCmdSetStencilCompareMask;
+  PFN_vkCmdSetStencilWriteMask vkCmdSetStencilWriteMask;
+  PFN_vkCmdSetStencilReference vkCmdSetStencilReference;
+  PFN_vkCmdBindDescriptorSets vkCmdBindDescriptorSets;
+  PFN_vkCmdBindIndexBuffer vkCmdBindIndexBuffer;
+  PFN_vkCmdBindVertexBuffers vkCmdBindVertexBuffers;
+  PFN_vkCmdDraw vkCmdDraw;
+  PFN_vkCmdDrawIndexed vkCmdDrawIndexed;
+  PFN_vkCmdDrawIndirect vkCmdDrawIndirect;
+  PFN_vkCmdDrawIndexedIndirect vkCmdDrawIndexedIndirect;
+  PFN_vkCmdDispatch vkCmdDispatch;
+  PFN_vkCmdDispatchIndirect vkCmdDispatchIndirect;
+  PFN_vkCmdCopyBuffer vkCmdCopyBuffer;
+  PFN_vkCmdCopyImage vkCmdCopyImage;
+  PFN_vkCmdBlitImage vkCmdBlitImage;
+  PFN_vkCmdCopyBufferToImage vkCmdCopyBufferToImage;
+  PFN_vkCmdCopyImageToBuffer vkCmdCopyImageToBuffer;
+  PFN_vkCmdUpdateBuffer vkCmdUpdateBuffer;
+  PFN_vkCmdFillBuffer vkCmdFillBuffer;
+  PFN_vkCmdClearColorImage vkCmdClearColorImage;
+  PFN_vkCmdClearDepthStencilImage vkCmdClearDepthStencilImage;
+  PFN_vkCmdClearAttachments vkCmdClearAttachments;
+  PFN_vkCmdResolveImage vkCmdResolveImage;
+  PFN_vkCmdSetEvent vkCmdSetEvent;
+  PFN_vkCmdResetEvent vkCmdResetEvent;
+  PFN_vkCmdWaitEvents vkCmdWaitEvents;
+  PFN_vkCmdPipelineBarrier vkCmdPipelineBarrier;
+  PFN_vkCmdBeginQuery vkCmdBeginQuery;
+  PFN_vkCmdEndQuery vkCmdEndQuery;
+  PFN_vkCmdResetQueryPool vkCmdResetQueryPool;
+  PFN_vkCmdWriteTimestamp vkCmdWriteTimestamp;
+  PFN_vkCmdCopyQueryPoolResults vkCmdCopyQueryPoolResults;
+  PFN_vkCmdPushConstants vkCmdPushConstants;
+  PFN_vkCmdBeginRenderPass vkCmdBeginRenderPass;
+  PFN_vkCmdNextSubpass vkCmdNextSubpass;
+  PFN_vkCmdEndRenderPass vkCmdEndRenderPass;
+  PFN_vkCmdExecuteCommands vkCmdExecuteCommands;
+  // VK_KHR_swapchain
+  PFN_vkCreateSwapchainKHR vkCreateSwapchainKHR;
+  PFN_vkDestroySwapchainKHR vkDestroySwapchainKHR;
+  PFN_vkGetSwapchainImagesKHR vkGetSwapchainImagesKHR;
+  PFN_vkAcquireNextImageKHR vkAcquireNextImageKHR;
+  PFN_vkQueuePresentKHR vkQueuePresentKHR;
+#ifdef VK_VERSION_1_1
+  PFN_vkGetDeviceGroupPresentCapabilitiesKHR vkGetDeviceGroupPresentCapabilitiesKHR;
+  PFN_vkGetDeviceGroupSurfacePresentModesKHR vkGetDeviceGroupSurfacePresentModesKHR;
+  PFN_vkAcquireNextImage2KHR vkAcquireNextImage2KHR;
+#endif
+  // VK_KHR_display_swapchain
+  PFN_vkCreateSharedSwapchainsKHR vkCreateSharedSwapchainsKHR;
+#ifdef VK_VERSION_1_1
+  // VK_VERSION_1_1
+  PFN_vkBindBufferMemory2 vkBindBufferMemory2;
+  PFN_vkBindImageMemory2 vkBindImageMemory2;
+  PFN_vkGetDeviceGroupPeerMemoryFeatures vkGetDeviceGroupPeerMemoryFeatures;
+  PFN_vkCmdSetDeviceMask vkCmdSetDeviceMask;
+  PFN_vkCmdDispatchBase vkCmdDispatchBase;
+  PFN_vkGetImageMemoryRequirements2 vkGetImageMemoryRequirements2;
+  PFN_vkGetBufferMemoryRequirements2 vkGetBufferMemoryRequirements2;
+  PFN_vkGetImageSparseMemoryRequirements2 vkGetImageSparseMemoryRequirements2;
+  PFN_vkTrimCommandPool vkTrimCommandPool;
+  PFN_vkGetDeviceQueue2 vkGetDeviceQueue2;
+  PFN_vkCreateSamplerYcbcrConversion vkCreateSamplerYcbcrConversion;
+  PFN_vkDestroySamplerYcbcrConversion vkDestroySamplerYcbcrConversion;
+  PFN_vkCreateDescriptorUpdateTemplate vkCreateDescriptorUpdateTemplate;
+  PFN_vkDestroyDescriptorUpdateTemplate vkDestroyDescriptorUpdateTemplate;
+  PFN_vkUpdateDescriptorSetWithTemplate vkUpdateDescriptorSetWithTemplate;
+  PFN_vkGetDescriptorSetLayoutSupport vkGetDescriptorSetLayoutSupport;
+#endif
+#ifdef VK_VERSION_1_2
+  // VK_VERSION_1_2
+  PFN_vkCmdDrawIndirectCount vkCmdDrawIndirectCount;
+  PFN_vkCmdDrawIndexedIndirectCount vkCmdDrawIndexedIndirectCount;
+  PFN_vkCreateRenderPass2 vkCreateRenderPass2;
+  PFN_vkCmdBeginRenderPass2 vkCmdBeginRenderPass2;
+  PFN_vkCmdNextSubpass2 vkCmdNextSubpass2;
+  PFN_vkCmdEndRenderPass2 vkCmdEndRenderPass2;
+  PFN_vkResetQueryPool vkResetQueryPool;
+  PFN_vkGetSemaphoreCounterValue vkGetSemaphoreCounterValue;
+  PFN_vkWaitSemaphores vkWaitSemaphores;
+  PFN_vkSignalSemaphore vkSignalSemaphore;
+  PFN_vkGetBufferDeviceAddress vkGetBufferDeviceAddress;
+  PFN_vkGetBufferOpaqueCaptureAddress vkGetBufferOpaqueCaptureAddress;
+  PFN_vkGetDeviceMemoryOpaqueCaptureAddress vkGetDeviceMemoryOpaqueCaptureAddress;
+#endif
+#ifdef VK_VERSION_1_3
+  // VK_VERSION_1_3
+  PFN_vkCreatePrivateDataSlot vkCreatePrivateDataSlot;
+  PFN_vkDestroyPrivateDataSlot vkDestroyPrivateDataSlot;
+  PFN_vkSetPrivateData vkSetPrivateData;
+  PFN_vkGetPrivateData vkGetPrivateData;
+  PFN_vkCmdSetEvent2 vkCmdSetEvent2;
+  PFN_vkCmdResetEvent2 vkCmdResetEvent2;
+  PFN_vkCmdWaitEvents2 vkCmdWaitEvents2;
+  PFN_vkCmdPipelineBarrier2 vkCmdPipelineBarrier2;
+  PFN_vkCmdWriteTimestamp2 vkCmdWriteTimestamp2;
+  PFN_vkQueueSubmit2 vkQueueSubmit2;
+  PFN_vkCmdCopyBuffer2 vkCmdCopyBuffer2;
+  PFN_vkCmdCopyImage2 vkCmdCopyImage2;
+  PFN_vkCmdCopyBufferToImage2 vkCmdCopyBufferToImage2;
+  PFN_vkCmdCopyImageToBuffer2 vkCmdCopyImageToBuffer2;
+  PFN_vkCmdBlitImage2 vkCmdBlitImage2;
+  PFN_vkCmdResolveImage2 vkCmdResolveImage2;
+  PFN_vkCmdBeginRendering vkCmdBeginRendering;
+  PFN_vkCmdEndRendering vkCmdEndRendering;
+  PFN_vkCmdSetCullMode vkCmdSetCullMode;
+  PFN_vkCmdSetFrontFace vkCmdSetFrontFace;
+  PFN_vkCmdSetPrimitiveTopology vkCmdSetPrimitiveTopology;
+  PFN_vkCmdSetViewportWithCount vkCmdSetViewportWithCount;
+  PFN_vkCmdSetScissorWithCount vkCmdSetScissorWithCount;
+  PFN_vkCmdBindVertexBuffers2 vkCmdBindVertexBuffers2;
+  PFN_vkCmdSetDepthTestEnable vkCmdSetDepthTestEnable;
+  PFN_vkCmdSetDepthWriteEnable vkCmdSetDepthWriteEnable;
+  PFN_vkCmdSetDepthCompareOp vkCmdSetDepthCompareOp;
+  PFN_vkCmdSetDepthBoundsTestEnable vkCmdSetDepthBoundsTestEnable;
+  PFN_vkCmdSetStencilTestEnable vkCmdSetStencilTestEnable;
+  PFN_vkCmdSetStencilOp vkCmdSetStencilOp;
+  PFN_vkCmdSetRasterizerDiscardEnable vkCmdSetRasterizerDiscardEnable;
+  PFN_vkCmdSetDepthBiasEnable vkCmdSetDepthBiasEnable;
+  PFN_vkCmdSetPrimitiveRestartEnable vkCmdSetPrimitiveRestartEnable;
+  PFN_vkGetDeviceBufferMemoryRequirements vkGetDeviceBufferMemoryRequirements;
+  PFN_vkGetDeviceImageMemoryRequirements vkGetDeviceImageMemoryRequirements;
+  PFN_vkGetDeviceImageSparseMemoryRequirements vkGetDeviceImageSparseMemoryRequirements;
+#endif
+#ifdef VK_KHR_get_memory_requirements2
+  // VK_KHR_get_memory_requirements2
+  PFN_vkGetImageMemoryRequirements2KHR vkGetImageMemoryRequirements2KHR;
+  PFN_vkGetBufferMemoryRequirements2KHR vkGetBufferMemoryRequirements2KHR;
+  PFN_vkGetImageSparseMemoryRequirements2KHR vkGetImageSparseMemoryRequirements2KHR;
+#endif
+#ifdef VK_KHR_timeline_semaphore
+  // VK_KHR_timeline_semaphore
+  PFN_vkGetSemaphoreCounterValueKHR vkGetSemaphoreCounterValueKHR;
+  PFN_vkWaitSemaphoresKHR vkWaitSemaphoresKHR;
+  PFN_vkSignalSemaphoreKHR vkSignalSemaphoreKHR;
+#endif
+#ifdef VK_KHR_synchronization2
+  // VK_KHR_synchronization2
+  PFN_vkCmdSetEvent2KHR vkCmdSetEvent2KHR;
+  PFN_vkCmdResetEvent2KHR vkCmdResetEvent2KHR;
+  PFN_vkCmdWaitEvents2KHR vkCmdWaitEvents2KHR;
+  PFN_vkCmdPipelineBarrier2KHR vkCmdPipelineBarrier2KHR;
+  PFN_vkCmdWriteTimestamp2KHR vkCmdWriteTimestamp2KHR;
+  PFN_vkQueueSubmit2KHR vkQueueSubmit2KHR;
+#endif
+#ifdef VK_KHR_dynamic_rendering
+  // VK_KHR_dynamic_rendering
+  PFN_vkCmdBeginRenderingKHR vkCmdBeginRenderingKHR;
+  PFN_vkCmdEndRenderingKHR vkCmdEndRenderingKHR;
+#endif
+#ifdef VK_KHR_push_descriptor
+  // VK_KHR_push_descriptor
+  PFN_vkCmdPushDescriptorSetKHR vkCmdPushDescriptorSetKHR;
+#if defined(VK_VERSION_1_1) || defined(VK_KHR_descriptor_update_template)
+  PFN_vkCmdPushDescriptorSetWithTemplateKHR vkCmdPushDescriptorSetWithTemplateKHR;
+#endif
+#endif
+#ifdef VK_EXT_host_image_copy
+  // VK_EXT_host_image_copy
+  PFN_vkCopyMemoryToImageEXT vkCopyMemoryToImageEXT;
+  PFN_vkCopyImageToMemoryEXT vkCopyImageToMemoryEXT;
+  PFN_vkCopyImageToImageEXT vkCopyImageToImageEXT;
+  PFN_vkTransitionImageLayoutEXT vkTransitionImageLayoutEXT;
+  PFN_vkGetImageSubresourceLayout2EXT vkGetImageSubresourceLayout2EXT;
+#endif
+#ifdef VK_KHR_present_wait
+  // VK_KHR_present_wait
+  PFN_vkWaitForPresentKHR vkWaitForPresentKHR;
+#endif
+} VkDeviceDispatchTable;
+
+/* Fill |table| with the entry points of |instance|, which must be created
+ * with the global vkCreateInstance(). Entry points the instance does not
+ * expose (extensions not enabled, for example) are left NULL.
+ * Returns 0 if InitVulkan() has not succeeded, non-zero otherwise.
+ */
+int InitVulkanInstanceDispatchTable(VkInstance instance,
+                                    VkInstanceDispatchTable* table);
+
+/* Fill |table| with the entry points of |device|, straight from the driver.
+ * Entry points the device does not expose (a core version above the one the
+ * device supports, extensions not enabled) are left NULL.
+ * Returns 0 if InitVulkan() has not succeeded, non-zero otherwise.
+ */
+int InitVulkanDeviceDispatchTable(VkDevice device,
+                                  VkDeviceDispatchTable* table);
+
 
 #endif // VULKAN_WRAPPER_H
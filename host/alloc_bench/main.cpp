@@ -0,0 +1,186 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Stresses the TlsfHeap that MemoryAllocator places resources in, with
+// buffer and texture sized allocations, and reports its throughput and how
+// fragmented it gets.
+//
+//     alloc_bench [--ops N] [--live N] [--heap-mb N] [--max-kb N]
+//                 [--seed N]
+//
+// It fills the heap with --live allocations, then frees a random one and
+// allocates another --ops times, then frees the rest. Sizes are log-uniform
+// from 256 bytes to --max-kb, at 256 byte to 64 KiB alignments. With F free
+// bytes and L the largest free range, fragmentation is 1 - L / F: 0 when
+// the free space is in one piece. "failed" allocations had enough free
+// bytes, but not in one range.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "TlsfHeap.hpp"
+
+namespace {
+
+struct Request {
+  uint64_t size;
+  uint64_t alignment;
+  uint32_t victim;  // which live allocation to free first, when churning
+};
+
+uint64_t Nanoseconds(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+double Fragmentation(const TlsfHeap& heap) {
+  if (!heap.FreeBytes()) return 0.0;
+  return 1.0 - static_cast<double>(heap.LargestFreeRange()) /
+                   static_cast<double>(heap.FreeBytes());
+}
+
+int Usage(const char* program) {
+  fprintf(stderr,
+          "usage: %s [--ops N] [--live N] [--heap-mb N] [--max-kb N] "
+          "[--seed N]\n",
+          program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint32_t ops = 1000000;
+  uint32_t liveTarget = 1024;
+  uint64_t heapSize = 1024ull << 20;
+  uint64_t maxSize = 4096ull << 10;
+  uint32_t seed = 1;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = (i + 1 < argc);
+    if (!strcmp(argv[i], "--ops") && hasValue) {
+      ops = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--live") && hasValue) {
+      liveTarget = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--heap-mb") && hasValue) {
+      heapSize = strtoull(argv[++i], nullptr, 10) << 20;
+    } else if (!strcmp(argv[i], "--max-kb") && hasValue) {
+      maxSize = strtoull(argv[++i], nullptr, 10) << 10;
+    } else if (!strcmp(argv[i], "--seed") && hasValue) {
+      seed = strtoul(argv[++i], nullptr, 10);
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  if (!liveTarget || !heapSize || maxSize < 256) return Usage(argv[0]);
+
+  // Drawn up front, so the timings are the heap's alone
+  std::mt19937 random(seed);
+  std::uniform_real_distribution<double> logSize(std::log(256.0),
+                                                 std::log(double(maxSize)));
+  const uint64_t kAlignments[] = {256, 256, 1024, 4096, 65536};
+  std::uniform_int_distribution<uint32_t> alignment(0, 4);
+  std::uniform_int_distribution<uint32_t> victim(0, liveTarget - 1);
+  std::vector<Request> requests(liveTarget + ops);
+  for (Request& request : requests) {
+    request.size = static_cast<uint64_t>(std::exp(logSize(random)));
+    request.alignment = kAlignments[alignment(random)];
+    request.victim = victim(random);
+  }
+
+  TlsfHeap heap(heapSize);
+  std::vector<uint32_t> live;  // nodes
+  live.reserve(liveTarget);
+  uint32_t failed = 0;
+  uint32_t exhausted = 0;
+  uint64_t offset;
+
+  uint64_t start = Nanoseconds();
+  for (uint32_t i = 0; i < liveTarget; i++) {
+    const Request& request = requests[i];
+    uint32_t node = heap.Allocate(request.size, request.alignment, &offset);
+    if (node == TlsfHeap::kNoNode) {
+      (heap.FreeBytes() >= request.size ? failed : exhausted)++;
+      continue;
+    }
+    live.push_back(node);
+  }
+  uint64_t fillNanoseconds = Nanoseconds() - start;
+  uint32_t filled = live.size();
+
+  double fragmentationSum = 0.0;
+  uint32_t samples = 0;
+  uint64_t peakUsed = heapSize - heap.FreeBytes();
+  const uint32_t kSampleInterval = 1024;
+  uint64_t churnNanoseconds = 0;
+  start = Nanoseconds();
+  for (uint32_t i = 0; i < ops; i++) {
+    const Request& request = requests[liveTarget + i];
+    if (!live.empty()) {
+      uint32_t index = request.victim % live.size();
+      heap.Free(live[index]);
+      live[index] = live.back();
+      live.pop_back();
+    }
+    uint32_t node = heap.Allocate(request.size, request.alignment, &offset);
+    if (node == TlsfHeap::kNoNode) {
+      (heap.FreeBytes() >= request.size ? failed : exhausted)++;
+    } else {
+      live.push_back(node);
+    }
+    // Sampled off the clock: LargestFreeRange() walks a free list
+    if (i % kSampleInterval == kSampleInterval - 1) {
+      churnNanoseconds += Nanoseconds() - start;
+      fragmentationSum += Fragmentation(heap);
+      samples++;
+      uint64_t used = heapSize - heap.FreeBytes();
+      if (used > peakUsed) peakUsed = used;
+      start = Nanoseconds();
+    }
+  }
+  churnNanoseconds += Nanoseconds() - start;
+  double endFragmentation = Fragmentation(heap);
+  uint64_t used = heapSize - heap.FreeBytes();
+
+  start = Nanoseconds();
+  for (uint32_t node : live) heap.Free(node);
+  uint64_t drainNanoseconds = Nanoseconds() - start;
+  uint32_t drained = live.size();
+
+  printf("heap %llu MiB, sizes 256 B to %llu KiB, %u live\n",
+         static_cast<unsigned long long>(heapSize >> 20),
+         static_cast<unsigned long long>(maxSize >> 10), liveTarget);
+  printf("  fill     %8.1f ns per allocation (%u)\n",
+         filled ? double(fillNanoseconds) / filled : 0.0, filled);
+  printf("  churn    %8.1f ns per free and allocation (%u)\n",
+         ops ? double(churnNanoseconds) / ops : 0.0, ops);
+  printf("  drain    %8.1f ns per free (%u)\n",
+         drained ? double(drainNanoseconds) / drained : 0.0, drained);
+  printf("fragmentation: average %.3f, at the end %.3f\n",
+         samples ? fragmentationSum / samples : endFragmentation,
+         endFragmentation);
+  printf("in use: %.1f MiB at the end, %.1f MiB at peak\n",
+         used / 1048576.0, peakUsed / 1048576.0);
+  printf("failed allocations: %u fragmented, %u out of space\n", failed,
+         exhausted);
+  if (heap.FreeBytes() != heapSize || heap.LargestFreeRange() != heapSize) {
+    fprintf(stderr, "heap not whole after freeing everything\n");
+    return 1;
+  }
+  return 0;
+}
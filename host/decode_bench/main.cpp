@@ -0,0 +1,184 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Times TextureStreamer decoding a set of PNG textures with 1 to N worker
+// threads, as tutorial06 streams its textures in.
+//
+//     decode_bench [--textures N] [--threads N] [--runs N] [--png FILE]
+//
+// Each run requests --textures (64 by default) decodes of --png, tutorial06's
+// sample_tex.png by default, held in memory so that reading it is not timed,
+// and takes them as a renderer would, in the order they finish, until all
+// are decoded. --threads is the most workers tried, the core count by
+// default. Times are the median of --runs runs, from the first request to
+// the last texture taken; "speedup" is against 1 worker, "efficiency" that
+// over the workers, and "reordered" counts the textures taken before one
+// requested earlier, at most over the runs.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include <stb/stb_image.h>
+#include "TextureStreamer.hpp"
+
+namespace {
+
+// Decoding stops being waited for after this long
+const uint64_t kRunTimeout = 60000000000ull;  // 60 s
+// How long the taking thread sleeps when nothing is decoded, leaving the
+// cores to the workers
+const std::chrono::microseconds kPollInterval(50);
+
+uint64_t Nanoseconds(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Decodes the PNG file |context| holds, whatever |name| is
+bool DecodePng(void* context, const char* name, DecodedTexture* texture) {
+  const std::vector<char>& file = *static_cast<std::vector<char>*>(context);
+  int width, height, n;
+  texture->pixels = stbi_load_from_memory(
+      reinterpret_cast<const stbi_uc*>(file.data()),
+      static_cast<int>(file.size()), &width, &height, &n, 0);
+  if (!texture->pixels) return false;
+  texture->width = width;
+  texture->height = height;
+  texture->channels = n;
+  return true;
+}
+
+void ReleasePng(void* context, DecodedTexture* texture) {
+  stbi_image_free(texture->pixels);
+}
+
+bool ReadFile(const char* path, std::vector<char>* content) {
+  FILE* file = fopen(path, "rb");
+  if (!file) return false;
+  char buffer[65536];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    content->insert(content->end(), buffer, buffer + read);
+  }
+  fclose(file);
+  return !content->empty();
+}
+
+// Decodes |textures| with |workers| threads, returning the nanoseconds it
+// took, or 0 if a decode failed or it timed out
+uint64_t Run(std::vector<char>* file, uint32_t textures, uint32_t workers,
+             uint32_t* reordered) {
+  TextureStreamer streamer;
+  streamer.Start(workers, DecodePng, ReleasePng, file);
+  uint64_t start = Nanoseconds();
+  for (uint32_t i = 0; i < textures; i++) {
+    std::string name = std::to_string(i) + ".png";
+    streamer.Request(name.c_str());
+  }
+  uint32_t taken = 0;
+  uint32_t highest = 0;
+  *reordered = 0;
+  while (taken < textures) {
+    uint32_t id;
+    DecodedTexture decoded;
+    if (streamer.TakeDecoded(&id, &decoded)) {
+      streamer.Release(&decoded);
+      *reordered += (id < highest);
+      highest = std::max(highest, id);
+      taken++;
+      continue;
+    }
+    TextureStreamer::Stats stats;
+    streamer.GetStats(&stats);
+    if (stats.failed || Nanoseconds() - start > kRunTimeout) return 0;
+    std::this_thread::sleep_for(kPollInterval);
+  }
+  uint64_t nanoseconds = Nanoseconds() - start;
+  streamer.Stop();
+  return nanoseconds;
+}
+
+int Usage(const char* program) {
+  fprintf(stderr,
+          "usage: %s [--textures N] [--threads N] [--runs N] [--png FILE]\n",
+          program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint32_t textures = 64;
+  uint32_t maxThreads = TextureStreamer::CoreCount();
+  uint32_t runs = 5;
+  const char* png = TUTORIAL06_ASSET_DIR "/sample_tex.png";
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = (i + 1 < argc);
+    if (!strcmp(argv[i], "--textures") && hasValue) {
+      textures = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--threads") && hasValue) {
+      maxThreads = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--runs") && hasValue) {
+      runs = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--png") && hasValue) {
+      png = argv[++i];
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  if (!textures || !maxThreads || !runs) return Usage(argv[0]);
+
+  std::vector<char> file;
+  int width, height, n;
+  if (!ReadFile(png, &file) ||
+      !stbi_info_from_memory(reinterpret_cast<const stbi_uc*>(file.data()),
+                             static_cast<int>(file.size()), &width, &height,
+                             &n)) {
+    fprintf(stderr, "cannot read a PNG from %s\n", png);
+    return 1;
+  }
+  printf("%u decodes of %s, %dx%d, %d channels, on %u cores:\n", textures,
+         png, width, height, n, TextureStreamer::CoreCount());
+  printf("  threads   median ms   textures/s   speedup   efficiency  "
+         "reordered\n");
+  double single = 0.0;
+  for (uint32_t workers = 1; workers <= maxThreads; workers++) {
+    std::vector<uint64_t> samples(runs);
+    uint32_t reordered = 0;
+    for (uint32_t run = 0; run < runs; run++) {
+      uint32_t runReordered;
+      samples[run] = Run(&file, textures, workers, &runReordered);
+      reordered = std::max(reordered, runReordered);
+      if (!samples[run]) {
+        fprintf(stderr, "decoding failed with %u threads\n", workers);
+        return 1;
+      }
+    }
+    std::sort(samples.begin(), samples.end());
+    double median = static_cast<double>(samples[runs / 2]);
+    if (workers == 1) single = median;
+    printf("  %7u %11.3f %12.1f %8.2fx %11.0f%% %10u\n", workers, median / 1e6,
+           textures * 1e9 / median, single / median,
+           100.0 * single / median / workers, reordered);
+  }
+  return 0;
+}
@@ -0,0 +1,237 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Times recording vkCmdDraw() through the libvulkan.so trampoline that
+// vulkan_wrapper's vkCmdDraw points at, against the driver's entry point
+// from a VkDeviceDispatchTable, as the tutorials record their frames.
+//
+//     draw_bench [--draws N] [--runs N] [--system-driver]
+//
+// Each run records --draws (100000 by default) draws into one command
+// buffer each way, taking turns. By default the loader only sees the null
+// driver built next to this executable, whose vkCmdDraw() returns at once,
+// so the difference is the trampoline's own cost; --system-driver records
+// on whatever driver is installed instead. Times are the median of --runs
+// runs (15 by default), in ns per call. The libvulkan.so the trampolines
+// came from is printed first: the loader's own cost is only measured if that
+// is the Khronos loader.
+
+#include <dlfcn.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "vulkan_wrapper.h"
+
+namespace {
+
+uint64_t Nanoseconds(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void UseNullDriver(void) {
+  // As tutorial06_bench does: newer loaders read VK_DRIVER_FILES, and
+  // implicit layers would add their own cost to every call
+  setenv("VK_DRIVER_FILES", NULL_ICD_MANIFEST, 1);
+  setenv("VK_ICD_FILENAMES", NULL_ICD_MANIFEST, 1);
+  setenv("VK_LOADER_LAYERS_DISABLE", "~implicit~", 1);
+}
+
+// The file the trampolines were loaded from, which tells the Khronos loader
+// from a stub libvulkan.so earlier in the library path
+const char* LoaderPath(void) {
+  Dl_info info;
+  if (!dladdr(reinterpret_cast<void*>(vkCmdDraw), &info) || !info.dli_fname) {
+    return "unknown";
+  }
+  return info.dli_fname;
+}
+
+// Records |draws| draws with |draw| into |cmdBuffer|, returning the
+// nanoseconds the draws took
+uint64_t RecordDraws(PFN_vkCmdDraw draw, VkCommandBuffer cmdBuffer,
+                     uint32_t draws) {
+  VkCommandBufferBeginInfo beginInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .pNext = nullptr,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+      .pInheritanceInfo = nullptr,
+  };
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+  uint64_t start = Nanoseconds();
+  for (uint32_t i = 0; i < draws; i++) draw(cmdBuffer, 3, 1, 0, 0);
+  uint64_t nanoseconds = Nanoseconds() - start;
+  vkEndCommandBuffer(cmdBuffer);
+  vkResetCommandBuffer(cmdBuffer, 0);
+  return nanoseconds;
+}
+
+double MedianPerCall(std::vector<uint64_t>* samples, uint32_t draws) {
+  std::sort(samples->begin(), samples->end());
+  return static_cast<double>((*samples)[samples->size() / 2]) / draws;
+}
+
+int Usage(const char* program) {
+  fprintf(stderr, "usage: %s [--draws N] [--runs N] [--system-driver]\n",
+          program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint32_t draws = 100000;
+  uint32_t runs = 15;
+  bool systemDriver = false;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = (i + 1 < argc);
+    if (!strcmp(argv[i], "--draws") && hasValue) {
+      draws = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--runs") && hasValue) {
+      runs = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--system-driver")) {
+      systemDriver = true;
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  if (!draws || !runs) return Usage(argv[0]);
+  if (!systemDriver) UseNullDriver();
+  if (!InitVulkan()) {
+    fprintf(stderr, "cannot load libvulkan.so\n");
+    return 1;
+  }
+
+  VkApplicationInfo appInfo{
+      .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+      .pNext = nullptr,
+      .pApplicationName = "draw_bench",
+      .applicationVersion = 1,
+      .pEngineName = "draw_bench",
+      .engineVersion = 1,
+      .apiVersion = VK_MAKE_VERSION(1, 0, 0),
+  };
+  VkInstanceCreateInfo instanceInfo{
+      .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .pApplicationInfo = &appInfo,
+      .enabledLayerCount = 0,
+      .ppEnabledLayerNames = nullptr,
+      .enabledExtensionCount = 0,
+      .ppEnabledExtensionNames = nullptr,
+  };
+  VkInstance instance;
+  if (vkCreateInstance(&instanceInfo, nullptr, &instance) != VK_SUCCESS) {
+    fprintf(stderr, "vkCreateInstance() failed\n");
+    return 1;
+  }
+  uint32_t gpuCount = 1;
+  VkPhysicalDevice gpu;
+  VkResult result = vkEnumeratePhysicalDevices(instance, &gpuCount, &gpu);
+  if ((result != VK_SUCCESS && result != VK_INCOMPLETE) || !gpuCount) {
+    fprintf(stderr, "no Vulkan device\n");
+    return 1;
+  }
+
+  // Draws are recorded for a graphics queue
+  uint32_t familyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(gpu, &familyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> families(familyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(gpu, &familyCount,
+                                           families.data());
+  uint32_t family = 0;
+  while (family < familyCount &&
+         !(families[family].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+    family++;
+  }
+  if (family == familyCount) {
+    fprintf(stderr, "no graphics queue\n");
+    return 1;
+  }
+  float priority = 1.0f;
+  VkDeviceQueueCreateInfo queueInfo{
+      .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .queueFamilyIndex = family,
+      .queueCount = 1,
+      .pQueuePriorities = &priority,
+  };
+  VkDeviceCreateInfo deviceInfo{
+      .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .queueCreateInfoCount = 1,
+      .pQueueCreateInfos = &queueInfo,
+      .enabledLayerCount = 0,
+      .ppEnabledLayerNames = nullptr,
+      .enabledExtensionCount = 0,
+      .ppEnabledExtensionNames = nullptr,
+      .pEnabledFeatures = nullptr,
+  };
+  VkDevice device;
+  if (vkCreateDevice(gpu, &deviceInfo, nullptr, &device) != VK_SUCCESS) {
+    fprintf(stderr, "vkCreateDevice() failed\n");
+    return 1;
+  }
+  VkDeviceDispatchTable dispatch;
+  InitVulkanDeviceDispatchTable(device, &dispatch);
+
+  VkCommandPoolCreateInfo poolInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = family,
+  };
+  VkCommandPool pool;
+  vkCreateCommandPool(device, &poolInfo, nullptr, &pool);
+  VkCommandBufferAllocateInfo allocateInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .pNext = nullptr,
+      .commandPool = pool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = 1,
+  };
+  VkCommandBuffer cmdBuffer;
+  vkAllocateCommandBuffers(device, &allocateInfo, &cmdBuffer);
+
+  // Outside of a render pass, which only a real driver would mind
+  std::vector<uint64_t> trampoline(runs), table(runs);
+  for (uint32_t run = 0; run < runs; run++) {
+    trampoline[run] = RecordDraws(vkCmdDraw, cmdBuffer, draws);
+    table[run] = RecordDraws(dispatch.vkCmdDraw, cmdBuffer, draws);
+  }
+
+  vkFreeCommandBuffers(device, pool, 1, &cmdBuffer);
+  vkDestroyCommandPool(device, pool, nullptr);
+  vkDestroyDevice(device, nullptr);
+  vkDestroyInstance(instance, nullptr);
+
+  double trampolineNs = MedianPerCall(&trampoline, draws);
+  double tableNs = MedianPerCall(&table, draws);
+  printf("loader: %s\n", LoaderPath());
+  printf("driver: %s\n", systemDriver ? "system" : "null");
+  printf("vkCmdDraw(), %u calls, median of %u runs:\n", draws, runs);
+  printf("  loader trampoline   %8.3f ns per call\n", trampolineNs);
+  printf("  dispatch table      %8.3f ns per call\n", tableNs);
+  printf("  saved               %8.3f ns per call (%.0f%%)\n",
+         trampolineNs - tableNs,
+         100.0 * (trampolineNs - tableNs) / trampolineNs);
+  return 0;
+}
@@ -0,0 +1,938 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A Vulkan driver that does no work: every call succeeds at once, command
+// buffers record nothing and submissions complete immediately. Point the
+// loader at it with
+//
+//     VK_DRIVER_FILES=<build>/null_icd.json   (VK_ICD_FILENAMES before 1.3.234)
+//
+// and what is left of an app's frame time is its own CPU cost, plus the
+// loader's. It reports one physical device with a single all-purpose queue,
+// the memory types of a typical unified-memory mobile GPU, and supports
+// VK_KHR_surface, VK_EXT_headless_surface and VK_KHR_swapchain.
+// Only what mapped memory needs is allocated; other non-dispatchable
+// handles are just unique numbers.
+
+#define VK_NO_PROTOTYPES 1
+#include <vulkan/vk_icd.h>
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+const uint32_t kApiVersion = VK_MAKE_VERSION(1, 1, 0);
+
+// Queue families of a desktop GPU: graphics, async compute and a DMA engine
+const VkQueueFlags kQueueFamilyFlags[] = {
+    VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT,
+    VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT,
+    VK_QUEUE_TRANSFER_BIT,
+};
+const uint32_t kQueueFamilyCount = 3;
+const uint32_t kQueuesPerFamily = 2;
+
+// Dispatchable handles start with a pointer the loader replaces with its
+// dispatch table.
+struct Dispatchable {
+  Dispatchable() { loaderData.loaderMagic = ICD_LOADER_MAGIC; }
+  VK_LOADER_DATA loaderData;
+};
+
+struct NullPhysicalDevice : Dispatchable {};
+struct NullInstance : Dispatchable {
+  NullPhysicalDevice gpu;
+};
+struct NullQueue : Dispatchable {};
+struct NullDevice : Dispatchable {
+  NullQueue queues[kQueueFamilyCount][kQueuesPerFamily];
+};
+struct NullCommandBuffer : Dispatchable {};
+
+struct NullCommandPool {
+  std::unordered_set<NullCommandBuffer*> buffers;
+};
+
+struct NullImage {
+  VkExtent3D extent;
+  uint32_t texelSize;
+  VkDeviceSize size;
+};
+
+struct NullMemory {
+  VkDeviceSize size;
+  std::unique_ptr<uint8_t[]> data;  // allocated on first vkMapMemory()
+};
+
+struct NullSwapchain {
+  std::vector<NullImage> images;
+  uint32_t next;
+};
+
+// Handles of objects without state
+std::atomic<uint64_t> nextHandle(1);
+// What VK_EXT_memory_budget reports as used, across devices
+std::atomic<uint64_t> allocatedBytes(0);
+
+template <typename Handle, typename Object>
+Handle ToHandle(Object* object) {
+  return (Handle)(uintptr_t)object;
+}
+
+template <typename Object, typename Handle>
+Object* FromHandle(Handle handle) {
+  return (Object*)(uintptr_t)handle;
+}
+
+template <typename Handle>
+Handle NewHandle() {
+  return (Handle)(uintptr_t)nextHandle.fetch_add(1);
+}
+
+VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+// Enough to size images and their row pitch; bigger formats than these get
+// the largest size, since nothing ever reads the texels back.
+uint32_t TexelSize(VkFormat format) {
+  switch (format) {
+    case VK_FORMAT_R8_UNORM:
+    case VK_FORMAT_S8_UINT:
+      return 1;
+    case VK_FORMAT_R8G8_UNORM:
+    case VK_FORMAT_R5G6B5_UNORM_PACK16:
+    case VK_FORMAT_D16_UNORM:
+      return 2;
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+    case VK_FORMAT_R32_SFLOAT:
+    case VK_FORMAT_D32_SFLOAT:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_X8_D24_UNORM_PACK32:
+      return 4;
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+    case VK_FORMAT_R32G32_SFLOAT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+      return 8;
+    default:
+      return 16;
+  }
+}
+
+// The usual two-call enumeration
+template <typename T>
+VkResult Enumerate(const T* values, uint32_t count, uint32_t* pCount,
+                   T* pOut) {
+  if (!pOut) {
+    *pCount = count;
+    return VK_SUCCESS;
+  }
+  uint32_t copied = std::min(*pCount, count);
+  std::copy(values, values + copied, pOut);
+  *pCount = copied;
+  return copied < count ? VK_INCOMPLETE : VK_SUCCESS;
+}
+
+VkExtensionProperties Extension(const char* name, uint32_t specVersion) {
+  VkExtensionProperties extension = {};
+  strncpy(extension.extensionName, name, VK_MAX_EXTENSION_NAME_SIZE - 1);
+  extension.specVersion = specVersion;
+  return extension;
+}
+
+// Entry points with nothing to do; they take the signature of the PFN they
+// are converted to.
+template <typename... Args>
+VKAPI_ATTR void VKAPI_CALL Ignore(Args...) {}
+
+template <typename... Args>
+VKAPI_ATTR VkResult VKAPI_CALL Succeed(Args...) {
+  return VK_SUCCESS;
+}
+
+template <typename Parent, typename Info, typename Handle>
+VKAPI_ATTR VkResult VKAPI_CALL Create(Parent, const Info*,
+                                      const VkAllocationCallbacks*,
+                                      Handle* pHandle) {
+  *pHandle = NewHandle<Handle>();
+  return VK_SUCCESS;
+}
+
+PFN_vkVoidFunction Lookup(const char* name);
+
+// Instance and physical device
+
+VKAPI_ATTR VkResult VKAPI_CALL
+EnumerateInstanceExtensionProperties(const char* pLayerName, uint32_t* pCount,
+                                     VkExtensionProperties* pProperties) {
+  const VkExtensionProperties extensions[] = {
+      Extension(VK_KHR_SURFACE_EXTENSION_NAME, 25),
+      Extension("VK_EXT_headless_surface", 1),
+  };
+  return Enumerate(extensions, 2, pCount, pProperties);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL EnumerateInstanceVersion(uint32_t* pVersion) {
+  *pVersion = kApiVersion;
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+CreateInstance(const VkInstanceCreateInfo* pCreateInfo,
+               const VkAllocationCallbacks* pAllocator,
+               VkInstance* pInstance) {
+  *pInstance = reinterpret_cast<VkInstance>(new NullInstance());
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL DestroyInstance(
+    VkInstance instance, const VkAllocationCallbacks* pAllocator) {
+  delete reinterpret_cast<NullInstance*>(instance);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+EnumeratePhysicalDevices(VkInstance instance, uint32_t* pCount,
+                         VkPhysicalDevice* pPhysicalDevices) {
+  VkPhysicalDevice gpu = reinterpret_cast<VkPhysicalDevice>(
+      &reinterpret_cast<NullInstance*>(instance)->gpu);
+  return Enumerate(&gpu, 1, pCount, pPhysicalDevices);
+}
+
+VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFeatures(
+    VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures* pFeatures) {
+  memset(pFeatures, 0, sizeof(*pFeatures));
+  // Every compressed format, so uploads of each can be timed
+  pFeatures->textureCompressionETC2 = VK_TRUE;
+  pFeatures->textureCompressionASTC_LDR = VK_TRUE;
+  pFeatures->textureCompressionBC = VK_TRUE;
+}
+
+// Of the extension features, present id, present wait and dynamic rendering
+// are there
+VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFeatures2(
+    VkPhysicalDevice physicalDevice, VkPhysicalDeviceFeatures2* pFeatures) {
+  GetPhysicalDeviceFeatures(physicalDevice, &pFeatures->features);
+  for (VkBaseOutStructure* next =
+           reinterpret_cast<VkBaseOutStructure*>(pFeatures->pNext);
+       next; next = next->pNext) {
+    switch (next->sType) {
+      case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR:
+        reinterpret_cast<VkPhysicalDevicePresentIdFeaturesKHR*>(next)
+            ->presentId = VK_TRUE;
+        break;
+      case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR:
+        reinterpret_cast<VkPhysicalDevicePresentWaitFeaturesKHR*>(next)
+            ->presentWait = VK_TRUE;
+        break;
+      case VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR:
+        reinterpret_cast<VkPhysicalDeviceDynamicRenderingFeaturesKHR*>(next)
+            ->dynamicRendering = VK_TRUE;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceProperties(
+    VkPhysicalDevice physicalDevice, VkPhysicalDeviceProperties* pProperties) {
+  memset(pProperties, 0, sizeof(*pProperties));
+  pProperties->apiVersion = kApiVersion;
+  pProperties->driverVersion = 1;
+  pProperties->deviceType = VK_PHYSICAL_DEVICE_TYPE_CPU;
+  strncpy(pProperties->deviceName, "Null Vulkan device",
+          VK_MAX_PHYSICAL_DEVICE_NAME_SIZE - 1);
+
+  VkPhysicalDeviceLimits& limits = pProperties->limits;
+  limits.maxImageDimension1D = 16384;
+  limits.maxImageDimension2D = 16384;
+  limits.maxImageDimension3D = 2048;
+  limits.maxImageDimensionCube = 16384;
+  limits.maxImageArrayLayers = 2048;
+  limits.maxMemoryAllocationCount = 4096;
+  limits.maxSamplerAllocationCount = 4000;
+  limits.bufferImageGranularity = 1;
+  limits.maxBoundDescriptorSets = 4;
+  limits.maxPushConstantsSize = 128;
+  limits.maxViewports = 1;
+  limits.maxViewportDimensions[0] = 16384;
+  limits.maxViewportDimensions[1] = 16384;
+  limits.maxFramebufferWidth = 16384;
+  limits.maxFramebufferHeight = 16384;
+  limits.maxFramebufferLayers = 256;
+  limits.maxColorAttachments = 8;
+  limits.minMemoryMapAlignment = 64;
+  limits.minTexelBufferOffsetAlignment = 16;
+  limits.minUniformBufferOffsetAlignment = 16;
+  limits.minStorageBufferOffsetAlignment = 16;
+  limits.optimalBufferCopyOffsetAlignment = 16;
+  limits.optimalBufferCopyRowPitchAlignment = 16;
+  limits.nonCoherentAtomSize = 64;
+  limits.timestampPeriod = 1.0f;
+  limits.framebufferColorSampleCounts = VK_SAMPLE_COUNT_1_BIT;
+  limits.framebufferDepthSampleCounts = VK_SAMPLE_COUNT_1_BIT;
+  limits.sampledImageColorSampleCounts = VK_SAMPLE_COUNT_1_BIT;
+  limits.sampledImageDepthSampleCounts = VK_SAMPLE_COUNT_1_BIT;
+}
+
+VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceQueueFamilyProperties(
+    VkPhysicalDevice physicalDevice, uint32_t* pCount,
+    VkQueueFamilyProperties* pProperties) {
+  VkQueueFamilyProperties families[kQueueFamilyCount] = {};
+  for (uint32_t i = 0; i < kQueueFamilyCount; i++) {
+    families[i].queueFlags = kQueueFamilyFlags[i];
+    families[i].queueCount = kQueuesPerFamily;
+    families[i].timestampValidBits = 64;
+    families[i].minImageTransferGranularity = {1, 1, 1};
+  }
+  Enumerate(families, kQueueFamilyCount, pCount, pProperties);
+}
+
+VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceMemoryProperties(
+    VkPhysicalDevice physicalDevice,
+    VkPhysicalDeviceMemoryProperties* pProperties) {
+  // One heap every type lives in, as on Mali and Adreno
+  memset(pProperties, 0, sizeof(*pProperties));
+  pProperties->memoryHeapCount = 1;
+  pProperties->memoryHeaps[0].size = 4ull << 30;
+  pProperties->memoryHeaps[0].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+  const VkMemoryPropertyFlags types[] = {
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+          VK_MEMORY_PROPERTY_HOST_COHERENT_BIT |
+          VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+          VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+  };
+  pProperties->memoryTypeCount = sizeof(types) / sizeof(types[0]);
+  for (uint32_t i = 0; i < pProperties->memoryTypeCount; i++) {
+    pProperties->memoryTypes[i].propertyFlags = types[i];
+    pProperties->memoryTypes[i].heapIndex = 0;
+  }
+}
+
+// Chained, the memory budget: three quarters of the heap, as if the rest of
+// the system had the other quarter
+VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceMemoryProperties2(
+    VkPhysicalDevice physicalDevice,
+    VkPhysicalDeviceMemoryProperties2* pProperties) {
+  GetPhysicalDeviceMemoryProperties(physicalDevice,
+                                    &pProperties->memoryProperties);
+  for (VkBaseOutStructure* next =
+           reinterpret_cast<VkBaseOutStructure*>(pProperties->pNext);
+       next; next = next->pNext) {
+    if (next->sType !=
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT) {
+      continue;
+    }
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT* budget =
+        reinterpret_cast<VkPhysicalDeviceMemoryBudgetPropertiesEXT*>(next);
+    memset(budget->heapBudget, 0, sizeof(budget->heapBudget));
+    memset(budget->heapUsage, 0, sizeof(budget->heapUsage));
+    budget->heapBudget[0] =
+        pProperties->memoryProperties.memoryHeaps[0].size / 4 * 3;
+    budget->heapUsage[0] = allocatedBytes;
+  }
+}
+
+VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceFormatProperties(
+    VkPhysicalDevice physicalDevice, VkFormat format,
+    VkFormatProperties* pProperties) {
+  // Everything works with everything
+  const VkFormatFeatureFlags kAll =
+      VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+      VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT |
+      VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT |
+      VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BLEND_BIT |
+      VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT |
+      VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+      VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+  pProperties->linearTilingFeatures = kAll;
+  pProperties->optimalTilingFeatures = kAll;
+  pProperties->bufferFeatures = VK_FORMAT_FEATURE_VERTEX_BUFFER_BIT |
+                                VK_FORMAT_FEATURE_UNIFORM_TEXEL_BUFFER_BIT |
+                                VK_FORMAT_FEATURE_STORAGE_TEXEL_BUFFER_BIT;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceImageFormatProperties(
+    VkPhysicalDevice physicalDevice, VkFormat format, VkImageType type,
+    VkImageTiling tiling, VkImageUsageFlags usage, VkImageCreateFlags flags,
+    VkImageFormatProperties* pProperties) {
+  pProperties->maxExtent = {16384, 16384, 2048};
+  pProperties->maxMipLevels = 15;
+  pProperties->maxArrayLayers = 2048;
+  pProperties->sampleCounts = VK_SAMPLE_COUNT_1_BIT;
+  pProperties->maxResourceSize = 1ull << 32;
+  return VK_SUCCESS;
+}
+
+// No sparse residency: the loader still needs the entry point
+VKAPI_ATTR void VKAPI_CALL GetPhysicalDeviceSparseImageFormatProperties(
+    VkPhysicalDevice physicalDevice, VkFormat format, VkImageType type,
+    VkSampleCountFlagBits samples, VkImageUsageFlags usage,
+    VkImageTiling tiling, uint32_t* pCount,
+    VkSparseImageFormatProperties* pProperties) {
+  *pCount = 0;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL EnumerateDeviceExtensionProperties(
+    VkPhysicalDevice physicalDevice, const char* pLayerName, uint32_t* pCount,
+    VkExtensionProperties* pProperties) {
+  const VkExtensionProperties extensions[] = {
+      Extension(VK_KHR_SWAPCHAIN_EXTENSION_NAME, 70),
+      Extension(VK_KHR_PRESENT_ID_EXTENSION_NAME, 1),
+      Extension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME, 1),
+      Extension(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME, 1),
+      Extension(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME, 1),
+      Extension(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME, 1),
+      Extension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, 1),
+  };
+  return Enumerate(extensions, 7, pCount, pProperties);
+}
+
+// WSI: surfaces are numbers, presenting does nothing and is done at once
+
+VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceSupportKHR(
+    VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex,
+    VkSurfaceKHR surface, VkBool32* pSupported) {
+  *pSupported = (kQueueFamilyFlags[queueFamilyIndex] & VK_QUEUE_GRAPHICS_BIT)
+                    ? VK_TRUE
+                    : VK_FALSE;
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceCapabilitiesKHR(
+    VkPhysicalDevice physicalDevice, VkSurfaceKHR surface,
+    VkSurfaceCapabilitiesKHR* pCapabilities) {
+  // Like a real headless surface, the swapchain decides on the extent
+  pCapabilities->minImageCount = 2;
+  pCapabilities->maxImageCount = 8;
+  pCapabilities->currentExtent = {0xFFFFFFFF, 0xFFFFFFFF};
+  pCapabilities->minImageExtent = {1, 1};
+  pCapabilities->maxImageExtent = {16384, 16384};
+  pCapabilities->maxImageArrayLayers = 1;
+  pCapabilities->supportedTransforms = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+  pCapabilities->currentTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+  pCapabilities->supportedCompositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+  pCapabilities->supportedUsageFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                       VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                       VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfaceFormatsKHR(
+    VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t* pCount,
+    VkSurfaceFormatKHR* pFormats) {
+  const VkSurfaceFormatKHR formats[] = {
+      {VK_FORMAT_R8G8B8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+      {VK_FORMAT_R8G8B8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+      {VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR},
+  };
+  return Enumerate(formats, 3, pCount, pFormats);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL GetPhysicalDeviceSurfacePresentModesKHR(
+    VkPhysicalDevice physicalDevice, VkSurfaceKHR surface, uint32_t* pCount,
+    VkPresentModeKHR* pModes) {
+  const VkPresentModeKHR modes[] = {
+      VK_PRESENT_MODE_FIFO_KHR,
+      VK_PRESENT_MODE_FIFO_RELAXED_KHR,
+      VK_PRESENT_MODE_MAILBOX_KHR,
+      VK_PRESENT_MODE_IMMEDIATE_KHR,
+  };
+  return Enumerate(modes, 4, pCount, pModes);
+}
+
+// Device
+
+VKAPI_ATTR VkResult VKAPI_CALL CreateDevice(
+    VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator, VkDevice* pDevice) {
+  *pDevice = reinterpret_cast<VkDevice>(new NullDevice());
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL DestroyDevice(
+    VkDevice device, const VkAllocationCallbacks* pAllocator) {
+  delete reinterpret_cast<NullDevice*>(device);
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL GetDeviceProcAddr(VkDevice device,
+                                                           const char* pName) {
+  return Lookup(pName);
+}
+
+VKAPI_ATTR void VKAPI_CALL GetDeviceQueue(VkDevice device,
+                                          uint32_t queueFamilyIndex,
+                                          uint32_t queueIndex,
+                                          VkQueue* pQueue) {
+  *pQueue = reinterpret_cast<VkQueue>(
+      &reinterpret_cast<NullDevice*>(device)
+           ->queues[queueFamilyIndex][queueIndex]);
+}
+
+// Memory and resources
+
+VKAPI_ATTR VkResult VKAPI_CALL AllocateMemory(
+    VkDevice device, const VkMemoryAllocateInfo* pAllocateInfo,
+    const VkAllocationCallbacks* pAllocator, VkDeviceMemory* pMemory) {
+  NullMemory* memory = new NullMemory();
+  memory->size = pAllocateInfo->allocationSize;
+  allocatedBytes += memory->size;
+  *pMemory = ToHandle<VkDeviceMemory>(memory);
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL FreeMemory(VkDevice device, VkDeviceMemory memory,
+                                      const VkAllocationCallbacks* pAllocator) {
+  NullMemory* nullMemory = FromHandle<NullMemory>(memory);
+  if (!nullMemory) return;
+  allocatedBytes -= nullMemory->size;
+  delete nullMemory;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL MapMemory(VkDevice device,
+                                         VkDeviceMemory memory,
+                                         VkDeviceSize offset,
+                                         VkDeviceSize size,
+                                         VkMemoryMapFlags flags,
+                                         void** ppData) {
+  NullMemory* nullMemory = FromHandle<NullMemory>(memory);
+  if (!nullMemory->data) {
+    nullMemory->data.reset(new uint8_t[nullMemory->size]);
+  }
+  *ppData = nullMemory->data.get() + offset;
+  return VK_SUCCESS;
+}
+
+// Nothing renders, so only memory the host has mapped is ever backed
+VKAPI_ATTR void VKAPI_CALL GetDeviceMemoryCommitment(
+    VkDevice device, VkDeviceMemory memory, VkDeviceSize* pCommitted) {
+  NullMemory* nullMemory = FromHandle<NullMemory>(memory);
+  *pCommitted = nullMemory->data ? nullMemory->size : 0;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+CreateBuffer(VkDevice device, const VkBufferCreateInfo* pCreateInfo,
+             const VkAllocationCallbacks* pAllocator, VkBuffer* pBuffer) {
+  *pBuffer = ToHandle<VkBuffer>(new VkDeviceSize(pCreateInfo->size));
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL DestroyBuffer(
+    VkDevice device, VkBuffer buffer, const VkAllocationCallbacks* pAllocator) {
+  delete FromHandle<VkDeviceSize>(buffer);
+}
+
+VKAPI_ATTR void VKAPI_CALL GetBufferMemoryRequirements(
+    VkDevice device, VkBuffer buffer, VkMemoryRequirements* pRequirements) {
+  pRequirements->size = AlignUp(*FromHandle<VkDeviceSize>(buffer), 64);
+  pRequirements->alignment = 64;
+  pRequirements->memoryTypeBits = 0x7;
+}
+
+NullImage MakeImage(VkFormat format, VkExtent3D extent, uint32_t mipLevels,
+                    uint32_t arrayLayers) {
+  NullImage image;
+  image.extent = extent;
+  image.texelSize = TexelSize(format);
+  // Mip levels add at most a third
+  VkDeviceSize texels = static_cast<VkDeviceSize>(extent.width) *
+                        extent.height * extent.depth * arrayLayers;
+  if (mipLevels > 1) texels += texels / 3;
+  image.size = AlignUp(texels * image.texelSize, 4096);
+  return image;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+CreateImage(VkDevice device, const VkImageCreateInfo* pCreateInfo,
+            const VkAllocationCallbacks* pAllocator, VkImage* pImage) {
+  NullImage* image = new NullImage(
+      MakeImage(pCreateInfo->format, pCreateInfo->extent,
+                pCreateInfo->mipLevels, pCreateInfo->arrayLayers));
+  *pImage = ToHandle<VkImage>(image);
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL DestroyImage(
+    VkDevice device, VkImage image, const VkAllocationCallbacks* pAllocator) {
+  delete FromHandle<NullImage>(image);
+}
+
+VKAPI_ATTR void VKAPI_CALL GetImageMemoryRequirements(
+    VkDevice device, VkImage image, VkMemoryRequirements* pRequirements) {
+  pRequirements->size = FromHandle<NullImage>(image)->size;
+  pRequirements->alignment = 4096;
+  // Lazily allocated memory only backs transient attachments, but nothing
+  // here checks the usage
+  pRequirements->memoryTypeBits = 0xF;
+}
+
+VKAPI_ATTR void VKAPI_CALL GetImageSubresourceLayout(
+    VkDevice device, VkImage image, const VkImageSubresource* pSubresource,
+    VkSubresourceLayout* pLayout) {
+  // Tightly packed rows of the base level
+  const NullImage* nullImage = FromHandle<NullImage>(image);
+  pLayout->offset = 0;
+  pLayout->rowPitch =
+      static_cast<VkDeviceSize>(nullImage->extent.width) * nullImage->texelSize;
+  pLayout->depthPitch = pLayout->rowPitch * nullImage->extent.height;
+  pLayout->arrayPitch = pLayout->depthPitch * nullImage->extent.depth;
+  pLayout->size = pLayout->arrayPitch;
+}
+
+// Pipelines and descriptors
+
+template <typename Info>
+VKAPI_ATTR VkResult VKAPI_CALL CreatePipelines(
+    VkDevice device, VkPipelineCache cache, uint32_t count, const Info*,
+    const VkAllocationCallbacks* pAllocator, VkPipeline* pPipelines) {
+  for (uint32_t i = 0; i < count; i++) {
+    pPipelines[i] = NewHandle<VkPipeline>();
+  }
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL GetPipelineCacheData(VkDevice device,
+                                                    VkPipelineCache cache,
+                                                    size_t* pDataSize,
+                                                    void* pData) {
+  *pDataSize = 0;
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+AllocateDescriptorSets(VkDevice device,
+                       const VkDescriptorSetAllocateInfo* pAllocateInfo,
+                       VkDescriptorSet* pDescriptorSets) {
+  for (uint32_t i = 0; i < pAllocateInfo->descriptorSetCount; i++) {
+    pDescriptorSets[i] = NewHandle<VkDescriptorSet>();
+  }
+  return VK_SUCCESS;
+}
+
+// Command buffers
+
+VKAPI_ATTR VkResult VKAPI_CALL CreateCommandPool(
+    VkDevice device, const VkCommandPoolCreateInfo* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator, VkCommandPool* pCommandPool) {
+  *pCommandPool = ToHandle<VkCommandPool>(new NullCommandPool());
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL DestroyCommandPool(
+    VkDevice device, VkCommandPool commandPool,
+    const VkAllocationCallbacks* pAllocator) {
+  NullCommandPool* pool = FromHandle<NullCommandPool>(commandPool);
+  if (!pool) return;
+  for (NullCommandBuffer* buffer : pool->buffers) delete buffer;
+  delete pool;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL
+AllocateCommandBuffers(VkDevice device,
+                       const VkCommandBufferAllocateInfo* pAllocateInfo,
+                       VkCommandBuffer* pCommandBuffers) {
+  NullCommandPool* pool =
+      FromHandle<NullCommandPool>(pAllocateInfo->commandPool);
+  for (uint32_t i = 0; i < pAllocateInfo->commandBufferCount; i++) {
+    NullCommandBuffer* buffer = new NullCommandBuffer();
+    pool->buffers.insert(buffer);
+    pCommandBuffers[i] = reinterpret_cast<VkCommandBuffer>(buffer);
+  }
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL FreeCommandBuffers(
+    VkDevice device, VkCommandPool commandPool, uint32_t count,
+    const VkCommandBuffer* pCommandBuffers) {
+  NullCommandPool* pool = FromHandle<NullCommandPool>(commandPool);
+  for (uint32_t i = 0; i < count; i++) {
+    NullCommandBuffer* buffer =
+        reinterpret_cast<NullCommandBuffer*>(pCommandBuffers[i]);
+    if (pool->buffers.erase(buffer)) delete buffer;
+  }
+}
+
+// Swapchain
+
+VKAPI_ATTR VkResult VKAPI_CALL CreateSwapchainKHR(
+    VkDevice device, const VkSwapchainCreateInfoKHR* pCreateInfo,
+    const VkAllocationCallbacks* pAllocator, VkSwapchainKHR* pSwapchain) {
+  NullSwapchain* swapchain = new NullSwapchain();
+  VkExtent3D extent = {pCreateInfo->imageExtent.width,
+                       pCreateInfo->imageExtent.height, 1};
+  swapchain->images.resize(
+      std::max(pCreateInfo->minImageCount, 2u),
+      MakeImage(pCreateInfo->imageFormat, extent, 1,
+                pCreateInfo->imageArrayLayers));
+  swapchain->next = 0;
+  *pSwapchain = ToHandle<VkSwapchainKHR>(swapchain);
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL DestroySwapchainKHR(
+    VkDevice device, VkSwapchainKHR swapchain,
+    const VkAllocationCallbacks* pAllocator) {
+  delete FromHandle<NullSwapchain>(swapchain);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL GetSwapchainImagesKHR(VkDevice device,
+                                                     VkSwapchainKHR swapchain,
+                                                     uint32_t* pCount,
+                                                     VkImage* pImages) {
+  NullSwapchain* nullSwapchain = FromHandle<NullSwapchain>(swapchain);
+  std::vector<VkImage> images;
+  for (NullImage& image : nullSwapchain->images) {
+    images.push_back(ToHandle<VkImage>(&image));
+  }
+  return Enumerate(images.data(), static_cast<uint32_t>(images.size()),
+                   pCount, pImages);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL AcquireNextImageKHR(
+    VkDevice device, VkSwapchainKHR swapchain, uint64_t timeout,
+    VkSemaphore semaphore, VkFence fence, uint32_t* pImageIndex) {
+  NullSwapchain* nullSwapchain = FromHandle<NullSwapchain>(swapchain);
+  *pImageIndex = nullSwapchain->next;
+  nullSwapchain->next = (nullSwapchain->next + 1) %
+                        static_cast<uint32_t>(nullSwapchain->images.size());
+  return VK_SUCCESS;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL QueuePresentKHR(
+    VkQueue queue, const VkPresentInfoKHR* pPresentInfo) {
+  if (pPresentInfo->pResults) {
+    for (uint32_t i = 0; i < pPresentInfo->swapchainCount; i++) {
+      pPresentInfo->pResults[i] = VK_SUCCESS;
+    }
+  }
+  return VK_SUCCESS;
+}
+
+#define NULL_ICD_ENTRY_POINT(name, function) \
+  {#name, reinterpret_cast<PFN_vkVoidFunction>(  \
+              static_cast<PFN_##name>(function))},
+
+// clang-format off
+#define NULL_ICD_ENTRY_POINTS(X)                                        \
+  X(vkGetInstanceProcAddr, vk_icdGetInstanceProcAddr)                   \
+  X(vkEnumerateInstanceExtensionProperties,                             \
+    EnumerateInstanceExtensionProperties)                               \
+  X(vkEnumerateInstanceVersion, EnumerateInstanceVersion)               \
+  X(vkCreateInstance, CreateInstance)                                   \
+  X(vkDestroyInstance, DestroyInstance)                                 \
+  X(vkEnumeratePhysicalDevices, EnumeratePhysicalDevices)               \
+  X(vkGetPhysicalDeviceFeatures, GetPhysicalDeviceFeatures)             \
+  X(vkGetPhysicalDeviceFeatures2, GetPhysicalDeviceFeatures2)           \
+  X(vkGetPhysicalDeviceProperties, GetPhysicalDeviceProperties)         \
+  X(vkGetPhysicalDeviceQueueFamilyProperties,                           \
+    GetPhysicalDeviceQueueFamilyProperties)                             \
+  X(vkGetPhysicalDeviceMemoryProperties,                                \
+    GetPhysicalDeviceMemoryProperties)                                  \
+  X(vkGetPhysicalDeviceMemoryProperties2,                               \
+    GetPhysicalDeviceMemoryProperties2)                                 \
+  X(vkGetPhysicalDeviceFormatProperties,                                \
+    GetPhysicalDeviceFormatProperties)                                  \
+  X(vkGetPhysicalDeviceImageFormatProperties,                           \
+    GetPhysicalDeviceImageFormatProperties)                             \
+  X(vkGetPhysicalDeviceSparseImageFormatProperties,                     \
+    GetPhysicalDeviceSparseImageFormatProperties)                       \
+  X(vkEnumerateDeviceExtensionProperties,                               \
+    EnumerateDeviceExtensionProperties)                                 \
+  X(vkCreateHeadlessSurfaceEXT, Create)                                 \
+  X(vkDestroySurfaceKHR, Ignore)                                        \
+  X(vkGetPhysicalDeviceSurfaceSupportKHR,                               \
+    GetPhysicalDeviceSurfaceSupportKHR)                                 \
+  X(vkGetPhysicalDeviceSurfaceCapabilitiesKHR,                          \
+    GetPhysicalDeviceSurfaceCapabilitiesKHR)                            \
+  X(vkGetPhysicalDeviceSurfaceFormatsKHR,                               \
+    GetPhysicalDeviceSurfaceFormatsKHR)                                 \
+  X(vkGetPhysicalDeviceSurfacePresentModesKHR,                          \
+    GetPhysicalDeviceSurfacePresentModesKHR)                            \
+  X(vkCreateDevice, CreateDevice)                                       \
+  X(vkDestroyDevice, DestroyDevice)                                     \
+  X(vkGetDeviceProcAddr, GetDeviceProcAddr)                             \
+  X(vkGetDeviceQueue, GetDeviceQueue)                                   \
+  X(vkDeviceWaitIdle, Succeed)                                          \
+  X(vkQueueWaitIdle, Succeed)                                           \
+  X(vkQueueSubmit, Succeed)                                             \
+  X(vkAllocateMemory, AllocateMemory)                                   \
+  X(vkFreeMemory, FreeMemory)                                           \
+  X(vkMapMemory, MapMemory)                                             \
+  X(vkUnmapMemory, Ignore)                                              \
+  X(vkGetDeviceMemoryCommitment, GetDeviceMemoryCommitment)            \
+  X(vkFlushMappedMemoryRanges, Succeed)                                 \
+  X(vkInvalidateMappedMemoryRanges, Succeed)                            \
+  X(vkCreateBuffer, CreateBuffer)                                       \
+  X(vkDestroyBuffer, DestroyBuffer)                                     \
+  X(vkGetBufferMemoryRequirements, GetBufferMemoryRequirements)         \
+  X(vkBindBufferMemory, Succeed)                                        \
+  X(vkCreateImage, CreateImage)                                         \
+  X(vkDestroyImage, DestroyImage)                                       \
+  X(vkGetImageMemoryRequirements, GetImageMemoryRequirements)           \
+  X(vkGetImageSubresourceLayout, GetImageSubresourceLayout)             \
+  X(vkBindImageMemory, Succeed)                                         \
+  X(vkCreateBufferView, Create)                                         \
+  X(vkDestroyBufferView, Ignore)                                        \
+  X(vkCreateImageView, Create)                                          \
+  X(vkDestroyImageView, Ignore)                                         \
+  X(vkCreateSampler, Create)                                            \
+  X(vkDestroySampler, Ignore)                                           \
+  X(vkCreateShaderModule, Create)                                       \
+  X(vkDestroyShaderModule, Ignore)                                      \
+  X(vkCreatePipelineCache, Create)                                      \
+  X(vkDestroyPipelineCache, Ignore)                                     \
+  X(vkGetPipelineCacheData, GetPipelineCacheData)                       \
+  X(vkCreatePipelineLayout, Create)                                     \
+  X(vkDestroyPipelineLayout, Ignore)                                    \
+  X(vkCreateGraphicsPipelines, CreatePipelines)                         \
+  X(vkCreateComputePipelines, CreatePipelines)                          \
+  X(vkDestroyPipeline, Ignore)                                          \
+  X(vkCreateDescriptorSetLayout, Create)                                \
+  X(vkDestroyDescriptorSetLayout, Ignore)                               \
+  X(vkCreateDescriptorPool, Create)                                     \
+  X(vkDestroyDescriptorPool, Ignore)                                    \
+  X(vkResetDescriptorPool, Succeed)                                     \
+  X(vkAllocateDescriptorSets, AllocateDescriptorSets)                   \
+  X(vkFreeDescriptorSets, Succeed)                                      \
+  X(vkUpdateDescriptorSets, Ignore)                                     \
+  X(vkCreateRenderPass, Create)                                         \
+  X(vkDestroyRenderPass, Ignore)                                        \
+  X(vkCreateFramebuffer, Create)                                        \
+  X(vkDestroyFramebuffer, Ignore)                                       \
+  X(vkCreateFence, Create)                                              \
+  X(vkDestroyFence, Ignore)                                             \
+  X(vkResetFences, Succeed)                                             \
+  X(vkGetFenceStatus, Succeed)                                          \
+  X(vkWaitForFences, Succeed)                                           \
+  X(vkCreateSemaphore, Create)                                          \
+  X(vkDestroySemaphore, Ignore)                                         \
+  X(vkCreateEvent, Create)                                              \
+  X(vkDestroyEvent, Ignore)                                             \
+  X(vkCreateQueryPool, Create)                                          \
+  X(vkDestroyQueryPool, Ignore)                                         \
+  X(vkCreateCommandPool, CreateCommandPool)                             \
+  X(vkDestroyCommandPool, DestroyCommandPool)                           \
+  X(vkResetCommandPool, Succeed)                                        \
+  X(vkAllocateCommandBuffers, AllocateCommandBuffers)                   \
+  X(vkFreeCommandBuffers, FreeCommandBuffers)                           \
+  X(vkBeginCommandBuffer, Succeed)                                      \
+  X(vkEndCommandBuffer, Succeed)                                        \
+  X(vkResetCommandBuffer, Succeed)                                      \
+  X(vkCmdBindPipeline, Ignore)                                          \
+  X(vkCmdSetViewport, Ignore)                                           \
+  X(vkCmdSetScissor, Ignore)                                            \
+  X(vkCmdSetLineWidth, Ignore)                                          \
+  X(vkCmdSetDepthBias, Ignore)                                          \
+  X(vkCmdSetBlendConstants, Ignore)                                     \
+  X(vkCmdSetDepthBounds, Ignore)                                        \
+  X(vkCmdSetStencilCompareMask, Ignore)                                 \
+  X(vkCmdSetStencilWriteMask, Ignore)                                   \
+  X(vkCmdSetStencilReference, Ignore)                                   \
+  X(vkCmdBindDescriptorSets, Ignore)                                    \
+  X(vkCmdBindIndexBuffer, Ignore)                                       \
+  X(vkCmdBindVertexBuffers, Ignore)                                     \
+  X(vkCmdDraw, Ignore)                                                  \
+  X(vkCmdDrawIndexed, Ignore)                                           \
+  X(vkCmdDrawIndirect, Ignore)                                          \
+  X(vkCmdDrawIndexedIndirect, Ignore)                                   \
+  X(vkCmdDispatch, Ignore)                                              \
+  X(vkCmdDispatchIndirect, Ignore)                                      \
+  X(vkCmdCopyBuffer, Ignore)                                            \
+  X(vkCmdCopyImage, Ignore)                                             \
+  X(vkCmdBlitImage, Ignore)                                             \
+  X(vkCmdCopyBufferToImage, Ignore)                                     \
+  X(vkCmdCopyImageToBuffer, Ignore)                                     \
+  X(vkCmdUpdateBuffer, Ignore)                                          \
+  X(vkCmdFillBuffer, Ignore)                                            \
+  X(vkCmdClearColorImage, Ignore)                                       \
+  X(vkCmdClearDepthStencilImage, Ignore)                                \
+  X(vkCmdClearAttachments, Ignore)                                      \
+  X(vkCmdResolveImage, Ignore)                                          \
+  X(vkCmdSetEvent, Ignore)                                              \
+  X(vkCmdResetEvent, Ignore)                                            \
+  X(vkCmdWaitEvents, Ignore)                                            \
+  X(vkCmdPipelineBarrier, Ignore)                                       \
+  X(vkCmdBeginQuery, Ignore)                                            \
+  X(vkCmdEndQuery, Ignore)                                              \
+  X(vkCmdResetQueryPool, Ignore)                                        \
+  X(vkCmdWriteTimestamp, Ignore)                                        \
+  X(vkCmdPushConstants, Ignore)                                         \
+  X(vkCmdBeginRenderPass, Ignore)                                       \
+  X(vkCmdNextSubpass, Ignore)                                           \
+  X(vkCmdEndRenderPass, Ignore)                                         \
+  X(vkCmdBeginRenderingKHR, Ignore)                                     \
+  X(vkCmdEndRenderingKHR, Ignore)                                       \
+  X(vkCmdExecuteCommands, Ignore)                                       \
+  X(vkCreateSwapchainKHR, CreateSwapchainKHR)                           \
+  X(vkDestroySwapchainKHR, DestroySwapchainKHR)                         \
+  X(vkGetSwapchainImagesKHR, GetSwapchainImagesKHR)                     \
+  X(vkAcquireNextImageKHR, AcquireNextImageKHR)                         \
+  X(vkQueuePresentKHR, QueuePresentKHR)                                 \
+  X(vkWaitForPresentKHR, Succeed)
+// clang-format on
+
+}  // namespace
+
+extern "C" {
+
+VKAPI_ATTR VkResult VKAPI_CALL
+vk_icdNegotiateLoaderICDInterfaceVersion(uint32_t* pVersion);
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL
+vk_icdGetInstanceProcAddr(VkInstance instance, const char* pName);
+
+// Version 3 lets the driver create surfaces itself; later versions add
+// nothing this driver needs.
+__attribute__((visibility("default"))) VKAPI_ATTR VkResult VKAPI_CALL
+vk_icdNegotiateLoaderICDInterfaceVersion(uint32_t* pVersion) {
+  if (*pVersion < 3) return VK_ERROR_INCOMPATIBLE_DRIVER;
+  *pVersion = 3;
+  return VK_SUCCESS;
+}
+
+// Every entry point is reachable through here, whatever |instance| is
+__attribute__((visibility("default"))) VKAPI_ATTR PFN_vkVoidFunction
+    VKAPI_CALL vk_icdGetInstanceProcAddr(VkInstance instance,
+                                         const char* pName) {
+  return Lookup(pName);
+}
+
+}  // extern "C"
+
+namespace {
+
+PFN_vkVoidFunction Lookup(const char* name) {
+  static const std::unordered_map<std::string, PFN_vkVoidFunction> kEntries{
+      NULL_ICD_ENTRY_POINTS(NULL_ICD_ENTRY_POINT)};
+  auto entry = kEntries.find(name);
+  return entry == kEntries.end() ? nullptr : entry->second;
+}
+
+}  // namespace
@@ -0,0 +1,185 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Times CopyPixelsToRgba(), the texture upload's copy into a mapped image,
+// against the per-byte loop it replaced, for square textures.
+//
+//     pixel_bench [--size N] [--runs N] [--pitch-align N]
+//
+// Without --size it runs 512, 2048 and 4096. Each instruction set the CPU
+// has copies RGBA as is, expands RGB, and premultiplies RGBA, into rows
+// padded to --pitch-align bytes (256 by default, as drivers lay out linear
+// images); its output is checked against the scalar rows'. Then each
+// averages the RGBA down a mip level with DownsampleRgba(), from N and from
+// N - 1, whose odd last row and column are left out. Times are the median
+// of --runs calls, and GB/s counts bytes written.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "PixelCopy.hpp"
+
+namespace {
+
+struct Case {
+  const char* name;
+  uint32_t channels;
+  uint32_t flags;
+};
+
+const Case kCases[] = {
+    {"rgba", 4, 0},
+    {"rgb", 3, 0},
+    {"rgba premultiply", 4, kPixelCopyPremultiply},
+    {"rgb flip", 3, kPixelCopyFlipY},
+};
+
+uint64_t Nanoseconds(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// The loop tutorial06 copied textures with
+void CopyPerByte(const uint8_t* imageData, uint32_t imgWidth,
+                 uint32_t imgHeight, uint8_t* data, uint64_t rowPitch) {
+  for (uint32_t y = 0; y < imgHeight; y++) {
+    unsigned char* row = data + rowPitch * y;
+    for (uint32_t x = 0; x < imgWidth; x++) {
+      row[x * 4] = imageData[(x + y * imgWidth) * 4];
+      row[x * 4 + 1] = imageData[(x + y * imgWidth) * 4 + 1];
+      row[x * 4 + 2] = imageData[(x + y * imgWidth) * 4 + 2];
+      row[x * 4 + 3] = imageData[(x + y * imgWidth) * 4 + 3];
+    }
+  }
+}
+
+double Median(std::vector<uint64_t>* samples) {
+  std::sort(samples->begin(), samples->end());
+  return static_cast<double>((*samples)[samples->size() / 2]);
+}
+
+void Report(const char* isa, const char* name, double nanoseconds,
+            uint64_t bytes) {
+  printf("  %-8s %-18s %9.3f ms  %6.2f GB/s\n", isa, name,
+         nanoseconds / 1e6, bytes / nanoseconds);
+}
+
+int Usage(const char* program) {
+  fprintf(stderr, "usage: %s [--size N] [--runs N] [--pitch-align N]\n",
+          program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<uint32_t> sizes;
+  uint32_t runs = 15;
+  uint64_t pitchAlign = 256;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = (i + 1 < argc);
+    if (!strcmp(argv[i], "--size") && hasValue) {
+      sizes.push_back(strtoul(argv[++i], nullptr, 10));
+    } else if (!strcmp(argv[i], "--runs") && hasValue) {
+      runs = strtoul(argv[++i], nullptr, 10);
+    } else if (!strcmp(argv[i], "--pitch-align") && hasValue) {
+      pitchAlign = strtoull(argv[++i], nullptr, 10);
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  if (!runs || !pitchAlign) return Usage(argv[0]);
+  if (sizes.empty()) sizes = {512, 2048, 4096};
+
+  printf("best instruction set: %s\n", PixelCopyIsaName(BestPixelCopyIsa()));
+  bool mismatch = false;
+  std::mt19937 random(1);
+  for (uint32_t size : sizes) {
+    if (!size) return Usage(argv[0]);
+    uint64_t rowPitch = (size * 4ull + pitchAlign - 1) / pitchAlign *
+                        pitchAlign;
+    uint64_t written = size * 4ull * size;
+    std::vector<uint8_t> src(size * 4ull * size);
+    for (uint8_t& byte : src) byte = static_cast<uint8_t>(random());
+    std::vector<uint8_t> dst(rowPitch * size);
+    std::vector<uint8_t> expected(rowPitch * size);
+    std::vector<uint64_t> samples(runs);
+
+    printf("%ux%u, row pitch %llu:\n", size, size,
+           static_cast<unsigned long long>(rowPitch));
+    for (uint32_t run = 0; run < runs; run++) {
+      uint64_t start = Nanoseconds();
+      CopyPerByte(src.data(), size, size, dst.data(), rowPitch);
+      samples[run] = Nanoseconds() - start;
+    }
+    Report("per-byte", "rgba", Median(&samples), written);
+
+    for (const Case& test : kCases) {
+      SetPixelCopyIsa(kPixelCopyScalar);
+      CopyPixelsToRgba(src.data(), test.channels, size, size,
+                       expected.data(), rowPitch, test.flags);
+      for (uint32_t isa = 0; isa < kPixelCopyIsaCount; isa++) {
+        if (!SetPixelCopyIsa(static_cast<PixelCopyIsa>(isa))) continue;
+        memset(dst.data(), 0, dst.size());
+        for (uint32_t run = 0; run < runs; run++) {
+          uint64_t start = Nanoseconds();
+          CopyPixelsToRgba(src.data(), test.channels, size, size, dst.data(),
+                           rowPitch, test.flags);
+          samples[run] = Nanoseconds() - start;
+        }
+        const char* name = PixelCopyIsaName(static_cast<PixelCopyIsa>(isa));
+        Report(name, test.name, Median(&samples), written);
+        if (dst != expected) {
+          printf("  %s %s: output differs from scalar\n", name, test.name);
+          mismatch = true;
+        }
+      }
+    }
+
+    // The next level down, in the rows of the destination
+    for (uint32_t srcSize : {size, size - 1}) {
+      if (!srcSize) continue;
+      uint32_t levelSize = srcSize > 1 ? srcSize / 2 : 1;
+      uint64_t levelBytes = levelSize * 4ull * levelSize;
+      char name[32];
+      snprintf(name, sizeof(name), "downsample %u", srcSize);
+      SetPixelCopyIsa(kPixelCopyScalar);
+      memset(expected.data(), 0, expected.size());
+      DownsampleRgba(src.data(), srcSize, srcSize, size * 4ull,
+                     expected.data(), rowPitch);
+      for (uint32_t isa = 0; isa < kPixelCopyIsaCount; isa++) {
+        if (!SetPixelCopyIsa(static_cast<PixelCopyIsa>(isa))) continue;
+        memset(dst.data(), 0, dst.size());
+        for (uint32_t run = 0; run < runs; run++) {
+          uint64_t start = Nanoseconds();
+          DownsampleRgba(src.data(), srcSize, srcSize, size * 4ull,
+                         dst.data(), rowPitch);
+          samples[run] = Nanoseconds() - start;
+        }
+        const char* isaName = PixelCopyIsaName(static_cast<PixelCopyIsa>(isa));
+        Report(isaName, name, Median(&samples), levelBytes);
+        if (dst != expected) {
+          printf("  %s %s: output differs from scalar\n", isaName, name);
+          mismatch = true;
+        }
+      }
+    }
+  }
+  return mismatch ? 1 : 0;
+}
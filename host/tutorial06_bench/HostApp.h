@@ -0,0 +1,44 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef HOST_TUTORIAL06_BENCH_HOSTAPP_H
+#define HOST_TUTORIAL06_BENCH_HOSTAPP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Platform.h"
+
+// What Platform.h's PlatformApp is on the host: a window-less app reading
+// its assets from a directory.
+struct HostApp {
+  std::string assetDir;
+  std::string dataDir;
+  VkExtent2D windowSize;
+
+  // PlatformMarkPhase() calls, in order, with a steady_clock timestamp
+  struct Phase {
+    const char* name;
+    uint64_t nanoseconds;
+  };
+  std::vector<Phase> phases;
+};
+
+// PlatformLog() drops kLogInfo messages unless this is set: the tutorial
+// logs every frame, which would be most of what a benchmark measures.
+void SetHostLogVerbose(bool verbose);
+
+uint64_t HostNanoseconds(void);
+
+#endif  // HOST_TUTORIAL06_BENCH_HOSTAPP_H
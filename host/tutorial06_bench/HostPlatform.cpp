@@ -0,0 +1,88 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Platform.h for Linux: assets come from the filesystem, and the renderer
+// presents to a VK_EXT_headless_surface.
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include "HostApp.h"
+
+namespace {
+
+bool verboseLog = false;
+
+}  // namespace
+
+void SetHostLogVerbose(bool verbose) { verboseLog = verbose; }
+
+uint64_t HostNanoseconds(void) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void PlatformLog(PlatformLogPriority priority, const char* tag,
+                 const char* format, ...) {
+  static const char kPriorityName[] = {'I', 'W', 'E'};
+  if (priority == kLogInfo && !verboseLog) return;
+  fprintf(stderr, "%c/%s: ", kPriorityName[priority], tag);
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fputc('\n', stderr);
+}
+
+bool ReadAsset(PlatformApp* app, const char* path, std::vector<char>* data) {
+  std::string fullPath = app->assetDir + "/" + path;
+  FILE* file = fopen(fullPath.c_str(), "rb");
+  if (!file) return false;
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  data->resize(size > 0 ? size : 0);
+  size_t read = fread(data->data(), 1, data->size(), file);
+  fclose(file);
+  return size >= 0 && read == data->size();
+}
+
+const char* PlatformDataDir(PlatformApp* app) { return app->dataDir.c_str(); }
+
+const char* PlatformSurfaceExtension(void) { return "VK_EXT_headless_surface"; }
+
+VkResult CreatePlatformSurface(PlatformApp* app, VkInstance instance,
+                               VkSurfaceKHR* surface) {
+  // vkCreateHeadlessSurfaceEXT is not exported by the loader, only reachable
+  // through vkGetInstanceProcAddr
+  VkInstanceDispatchTable table;
+  InitVulkanInstanceDispatchTable(instance, &table);
+  if (!table.vkCreateHeadlessSurfaceEXT) {
+    return VK_ERROR_EXTENSION_NOT_PRESENT;
+  }
+  VkHeadlessSurfaceCreateInfoEXT createInfo{
+      .sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT,
+      .pNext = nullptr,
+      .flags = 0,
+  };
+  return table.vkCreateHeadlessSurfaceEXT(instance, &createInfo, nullptr,
+                                          surface);
+}
+
+VkExtent2D PlatformWindowSize(PlatformApp* app) { return app->windowSize; }
+
+void PlatformMarkPhase(PlatformApp* app, const char* name) {
+  app->phases.push_back(HostApp::Phase{name, HostNanoseconds()});
+}
@@ -0,0 +1,384 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Runs tutorial06's VulkanMain.cpp on Linux and reports the CPU time of
+// InitVulkan(), phase by phase, and of each VulkanDrawFrame().
+//
+//     tutorial06_bench [--frames N] [--warmup N] [--frames-in-flight N]
+//                      [--profile low-latency|high-throughput] [--images N]
+//                      [--resume N] [--render-pass] [--staging-upload]
+//                      [--mipmaps none|auto|cpu] [--texture NAME] [--size WxH]
+//                      [--textures N] [--workers N] [--stream N]
+//                      [--assets DIR] [--system-driver]
+//                      [--memory-json FILE] [--verbose]
+//
+// By default the Vulkan loader only sees the null driver built next to this
+// executable, whose entry points return at once, so the numbers are the
+// tutorial's own cost plus the loader's. --system-driver runs on whatever
+// driver is installed instead. "blocked" is the part of each frame spent
+// waiting on the GPU, which more frames in flight should bring down.
+// "latency" runs from acquiring a frame's image to the display when the
+// driver has VK_KHR_present_wait, else to vkQueuePresentKHR() returning;
+// --profile and --images pick the swapchain it depends on. --resume times N
+// rounds of DeleteVulkanSurface() and InitVulkan(), what the app goes
+// through each time its window goes away and comes back. --render-pass
+// draws through a VkRenderPass and framebuffers even where the driver has
+// dynamic rendering. --staging-upload copies textures through the staging
+// ring into optimally tiled images even where the driver samples linear
+// ones, as on devices that cannot. Textures stream in over the first
+// frames, decoded on worker threads: the "texture" phase only uploads the
+// placeholder drawn meanwhile, and "textures" shows when they were resident.
+// --mipmaps picks how their mip chains are made, see SetTextureMipmaps();
+// "texture reads" estimates the bytes a frame fetches from the first one,
+// with and without them, as the null driver draws nothing to measure, at 4
+// bytes a texel: "drawn" over half the window, which --size sets, and
+// "minified" at 4 texels a pixel each way. --texture loads another asset than
+// sample_tex.png; a KTX2 file, such as checker_bc1.ktx2, keeps its
+// compressed format and levels. --textures streams N of them, drawing the
+// first, and --workers decodes them on N threads, a thread per core by
+// default. --stream N skips all of the above, timing instead InitVulkan()
+// and frames until N textures are resident, with 1 to --workers threads:
+// "textures/s" and "speedup", against 1 thread, are the median of 3 runs.
+// --memory-json writes GetVulkanMemoryJson() after the
+// timed frames to FILE.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "HostApp.h"
+#include "TextureStreamer.hpp"
+#include "VulkanMain.hpp"
+
+namespace {
+
+const uint64_t kStreamTimeout = 10000000000ull;  // 10 s
+const uint32_t kStreamRuns = 3;
+const uint32_t kCacheLineBytes = 64;
+// The minification "texture reads" is also estimated at, in texels a pixel
+// along each side, as when the texture is drawn far away
+const double kMinifiedTexelsPerPixel = 4.0;
+
+uint64_t LevelBytes(uint32_t width, uint32_t height, uint32_t level) {
+  return std::max(width >> level, 1u) * 4ull * std::max(height >> level, 1u);
+}
+
+// Bytes fetched from a |width| x |height| texture drawn over |pixels|
+// pixels |texelsPerPixel| texels apart. Without mips, minified fragments
+// land on a cache line each, until all of level 0 has been read; with them,
+// trilinear filtering reads the two levels nearest one texel per pixel.
+void PrintTextureReads(const char* label, uint32_t width, uint32_t height,
+                       uint64_t pixels, double texelsPerPixel) {
+  uint32_t mipLevels = 0;
+  while (std::max(width, height) >> mipLevels) mipLevels++;
+  uint64_t flat = LevelBytes(width, height, 0);
+  if (texelsPerPixel > 1.0) flat = std::min(flat, pixels * kCacheLineBytes);
+  uint32_t level = 0;
+  while (level + 1 < mipLevels && texelsPerPixel >= double(2u << level)) {
+    level++;
+  }
+  uint64_t mipped = LevelBytes(width, height, level);
+  // Magnified, level 0 is the only one sampled
+  if (texelsPerPixel > 1.0 && level + 1 < mipLevels) {
+    mipped += LevelBytes(width, height, level + 1);
+  }
+  printf("  %-10s %6.2f texels a pixel: ~%.1f KiB a frame with %u mip "
+         "levels, ~%.1f KiB with 1\n",
+         label, texelsPerPixel, mipped / 1024.0, mipLevels, flat / 1024.0);
+}
+
+void PrintPercentiles(const char* label, std::vector<uint64_t> values) {
+  if (values.empty()) return;
+  std::sort(values.begin(), values.end());
+  uint64_t sum = 0;
+  for (uint64_t value : values) sum += value;
+  printf("  %-8s avg %8.3f us  median %8.3f us  p95 %8.3f us  max %8.3f us\n",
+         label, sum / 1e3 / values.size(), values[values.size() / 2] / 1e3,
+         values[values.size() * 95 / 100] / 1e3, values.back() / 1e3);
+}
+
+void PrintPhases(const HostApp& app) {
+  for (size_t i = 0; i + 1 < app.phases.size(); i++) {
+    const HostApp::Phase& phase = app.phases[i];
+    if (!phase.name) continue;
+    printf("  %-12s %10.3f ms\n", phase.name,
+           (app.phases[i + 1].nanoseconds - phase.nanoseconds) / 1e6);
+  }
+}
+
+void UseNullDriver(void) {
+  // VK_DRIVER_FILES replaced VK_ICD_FILENAMES in newer loaders; implicit
+  // layers (overlays, capture tools) would add their own overhead.
+  setenv("VK_DRIVER_FILES", NULL_ICD_MANIFEST, 1);
+  setenv("VK_ICD_FILENAMES", NULL_ICD_MANIFEST, 1);
+  setenv("VK_LOADER_LAYERS_DISABLE", "~implicit~", 1);
+}
+
+// Draws from InitVulkan() until the textures are resident, returning the
+// nanoseconds from their request to the last one resident, or 0 if one
+// failed or they took too long
+uint64_t StreamTextures(HostApp* app, VulkanTextureStats* stats) {
+  app->phases.clear();
+  if (!InitVulkan(app) || !IsVulkanReady()) return 0;
+  uint64_t start = HostNanoseconds();
+  do {
+    VulkanDrawFrame();
+    GetVulkanTextureStats(stats);
+  } while (stats->inFlight && HostNanoseconds() - start < kStreamTimeout);
+  DeleteVulkan();
+  return stats->inFlight || stats->failed ? 0 : stats->nanoseconds;
+}
+
+// Streams |textures| textures with 1 to |maxWorkers| decode threads
+int PrintStreamScaling(HostApp* app, uint32_t textures, uint32_t maxWorkers) {
+  SetTextureCount(textures);
+  printf("%u textures streamed in, on %u cores:\n", textures,
+         TextureStreamer::CoreCount());
+  printf("  threads   median ms   textures/s      MiB/s   speedup\n");
+  double single = 0.0;
+  for (uint32_t workers = 1; workers <= maxWorkers; workers++) {
+    SetTextureWorkers(workers);
+    std::vector<uint64_t> samples(kStreamRuns);
+    VulkanTextureStats stats;
+    for (uint64_t& sample : samples) {
+      sample = StreamTextures(app, &stats);
+      if (!sample) {
+        fprintf(stderr, "streaming failed with %u threads\n", workers);
+        return 1;
+      }
+    }
+    std::sort(samples.begin(), samples.end());
+    double median = static_cast<double>(samples[kStreamRuns / 2]);
+    if (workers == 1) single = median;
+    printf("  %7u %11.3f %12.1f %10.1f %8.2fx\n", workers, median / 1e6,
+           textures * 1e9 / median, stats.bytes * 1e9 / median / 1048576.0,
+           single / median);
+  }
+  return 0;
+}
+
+int Usage(const char* program) {
+  fprintf(stderr,
+          "usage: %s [--frames N] [--warmup N] [--frames-in-flight N] "
+          "[--profile low-latency|high-throughput] [--images N] "
+          "[--resume N] [--render-pass] [--staging-upload] "
+          "[--mipmaps none|auto|cpu] [--texture NAME] [--size WxH] "
+          "[--textures N] [--workers N] [--stream N] [--assets DIR] "
+          "[--system-driver] [--memory-json FILE] [--verbose]\n",
+          program);
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  HostApp app;
+  app.assetDir = TUTORIAL06_ASSET_DIR;
+  app.dataDir = ".";
+  app.windowSize = VkExtent2D{.width = 1920, .height = 1080};
+  int frames = 1000;
+  int warmup = 10;
+  int resumes = 0;
+  bool systemDriver = false;
+  const char* memoryJsonPath = nullptr;
+  SwapchainProfile profile = kSwapchainHighThroughput;
+  uint32_t images = 0;
+  uint32_t workers = 0;
+  uint32_t streamTextures = 0;
+  for (int i = 1; i < argc; i++) {
+    bool hasValue = (i + 1 < argc);
+    if (!strcmp(argv[i], "--frames") && hasValue) {
+      frames = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--warmup") && hasValue) {
+      warmup = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--frames-in-flight") && hasValue) {
+      SetFramesInFlight(atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--profile") && hasValue) {
+      const char* name = argv[++i];
+      if (!strcmp(name, "low-latency")) {
+        profile = kSwapchainLowLatency;
+      } else if (!strcmp(name, "high-throughput")) {
+        profile = kSwapchainHighThroughput;
+      } else {
+        return Usage(argv[0]);
+      }
+    } else if (!strcmp(argv[i], "--images") && hasValue) {
+      images = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--resume") && hasValue) {
+      resumes = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--render-pass")) {
+      SetDynamicRendering(false);
+    } else if (!strcmp(argv[i], "--staging-upload")) {
+      SetStagingUpload(true);
+    } else if (!strcmp(argv[i], "--mipmaps") && hasValue) {
+      const char* name = argv[++i];
+      if (!strcmp(name, "none")) {
+        SetTextureMipmaps(kTextureMipmapsNone);
+      } else if (!strcmp(name, "auto")) {
+        SetTextureMipmaps(kTextureMipmapsAuto);
+      } else if (!strcmp(name, "cpu")) {
+        SetTextureMipmaps(kTextureMipmapsCpu);
+      } else {
+        return Usage(argv[0]);
+      }
+    } else if (!strcmp(argv[i], "--texture") && hasValue) {
+      SetTextureFile(argv[++i]);
+    } else if (!strcmp(argv[i], "--size") && hasValue) {
+      if (sscanf(argv[++i], "%ux%u", &app.windowSize.width,
+                 &app.windowSize.height) != 2) {
+        return Usage(argv[0]);
+      }
+    } else if (!strcmp(argv[i], "--textures") && hasValue) {
+      SetTextureCount(atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "--workers") && hasValue) {
+      workers = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--stream") && hasValue) {
+      streamTextures = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--assets") && hasValue) {
+      app.assetDir = argv[++i];
+    } else if (!strcmp(argv[i], "--system-driver")) {
+      systemDriver = true;
+    } else if (!strcmp(argv[i], "--memory-json") && hasValue) {
+      memoryJsonPath = argv[++i];
+    } else if (!strcmp(argv[i], "--verbose")) {
+      SetHostLogVerbose(true);
+    } else {
+      return Usage(argv[0]);
+    }
+  }
+  if (!systemDriver) UseNullDriver();
+  SetSwapchainProfile(profile, images);
+  if (streamTextures) {
+    return PrintStreamScaling(
+        &app, streamTextures, workers ? workers : TextureStreamer::CoreCount());
+  }
+  SetTextureWorkers(workers);
+
+  uint64_t start = HostNanoseconds();
+  if (!InitVulkan(&app) || !IsVulkanReady()) {
+    fprintf(stderr, "InitVulkan() failed\n");
+    return 1;
+  }
+  uint64_t initNanoseconds = HostNanoseconds() - start;
+
+  std::vector<uint64_t> frameTimes, blockedTimes, latencies;
+  frameTimes.reserve(frames);
+  blockedTimes.reserve(frames);
+  latencies.reserve(frames);
+  bool toDisplay = false;
+  for (int i = 0; i < warmup + frames; i++) {
+    start = HostNanoseconds();
+    VulkanDrawFrame();
+    if (i < warmup) continue;
+    frameTimes.push_back(HostNanoseconds() - start);
+    VulkanFrameStats stats;
+    GetVulkanFrameStats(&stats);
+    blockedTimes.push_back(stats.fenceWaitNanoseconds +
+                           stats.acquireWaitNanoseconds);
+    if (stats.presentLatencyNanoseconds) {
+      latencies.push_back(stats.presentLatencyNanoseconds);
+    }
+    toDisplay = stats.presentLatencyToDisplay;
+  }
+  // Draw on, untimed, until the textures have streamed in, to see when
+  VulkanTextureStats textureStats;
+  GetVulkanTextureStats(&textureStats);
+  start = HostNanoseconds();
+  while (textureStats.inFlight && HostNanoseconds() - start < kStreamTimeout) {
+    VulkanDrawFrame();
+    GetVulkanTextureStats(&textureStats);
+  }
+  VulkanDepthStats depthStats;
+  GetVulkanDepthStats(&depthStats);
+  if (memoryJsonPath) {
+    FILE* file = fopen(memoryJsonPath, "w");
+    if (!file) {
+      fprintf(stderr, "cannot write %s\n", memoryJsonPath);
+      return 1;
+    }
+    fprintf(file, "%s\n", GetVulkanMemoryJson().c_str());
+    fclose(file);
+  }
+
+  HostApp initApp = app;
+  std::vector<uint64_t> resumeTimes;
+  for (int i = 0; i < resumes; i++) {
+    DeleteVulkanSurface();
+    app.phases.clear();
+    start = HostNanoseconds();
+    if (!InitVulkan(&app) || !IsVulkanReady()) {
+      fprintf(stderr, "InitVulkan() failed on resume\n");
+      return 1;
+    }
+    resumeTimes.push_back(HostNanoseconds() - start);
+    VulkanDrawFrame();
+  }
+
+  start = HostNanoseconds();
+  DeleteVulkan();
+  uint64_t deleteNanoseconds = HostNanoseconds() - start;
+
+  printf("driver: %s\n", systemDriver ? "system" : "null");
+  printf("InitVulkan():  %10.3f ms\n", initNanoseconds / 1e6);
+  PrintPhases(initApp);
+  printf("VulkanDrawFrame(), %zu frames after %d warmup:\n", frameTimes.size(),
+         warmup);
+  PrintPercentiles("cpu", frameTimes);
+  PrintPercentiles("blocked", blockedTimes);
+  PrintPercentiles("latency", latencies);
+  printf("  (latency: acquire to %s)\n",
+         toDisplay ? "display, VK_KHR_present_wait" : "vkQueuePresentKHR()");
+  printf("depth buffer: format %d, %s, %llu of %llu bytes committed\n",
+         depthStats.format,
+         depthStats.lazilyAllocated ? "lazily allocated" : "device local",
+         static_cast<unsigned long long>(depthStats.committedBytes),
+         static_cast<unsigned long long>(depthStats.allocatedBytes));
+  printf("textures: %u resident, %u in flight, %u failed, %u threads; %.1f "
+         "KiB resident %.3f ms after their request, %.1f MiB/s; %u mip "
+         "levels\n",
+         textureStats.completed, textureStats.inFlight, textureStats.failed,
+         textureStats.workers, textureStats.bytes / 1024.0,
+         textureStats.nanoseconds / 1e6,
+         textureStats.bytesPerSecond / 1048576.0, textureStats.mipLevels);
+  if (textureStats.width) {
+    // Half the window, at the texture's aspect
+    uint64_t pixels =
+        uint64_t(app.windowSize.width) * app.windowSize.height / 2;
+    double texelsPerPixel =
+        std::sqrt(double(textureStats.width) * textureStats.height / pixels);
+    printf("texture reads, %ux%u (estimated):\n", textureStats.width,
+           textureStats.height);
+    PrintTextureReads("drawn", textureStats.width, textureStats.height,
+                      pixels, texelsPerPixel);
+    // Far enough away for the mip levels to matter, which a large window
+    // never has the texture
+    double minified = kMinifiedTexelsPerPixel;
+    uint64_t minifiedPixels = std::max<uint64_t>(
+        uint64_t(textureStats.width / minified) *
+            uint64_t(textureStats.height / minified),
+        1);
+    PrintTextureReads("minified", textureStats.width, textureStats.height,
+                      minifiedPixels, minified);
+  }
+  if (!resumeTimes.empty()) {
+    printf("InitVulkan() after DeleteVulkanSurface(), %zu times:\n",
+           resumeTimes.size());
+    PrintPercentiles("resume", resumeTimes);
+    PrintPhases(app);
+  }
+  printf("DeleteVulkan(): %9.3f ms\n", deleteNanoseconds / 1e6);
+  return 0;
+}
@@ -0,0 +1,1415 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Plays a trace written by StartVulkanCapture() against the host's Vulkan
+// driver (lavapipe, SwiftShader, a desktop GPU) and reports how long the
+// driver took for each call, next to the time the same call took on the
+// device it was captured on.
+//
+//     vktrace_replay <trace> [--verbose]
+//
+// The Android surface is replaced by a VK_EXT_headless_surface one, and
+// whatever the host driver differs on is patched up as calls are replayed:
+// memory type indices, allocation sizes, the swapchain format and the
+// surface transform. Everything runs on one instance and one device, which
+// is all the tutorials create.
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "vulkan_trace.h"
+#include "vulkan_wrapper.h"
+
+namespace {
+
+// Time spent in each kind of call, captured on the device and replayed here.
+struct CommandStats {
+  uint64_t count;
+  uint64_t capturedNanoseconds;
+  uint64_t replayNanoseconds;
+};
+
+// CPU time of the calls between two presents, i.e. one VulkanDrawFrame().
+struct FrameTime {
+  uint64_t captured;
+  uint64_t replay;
+};
+
+class Replayer {
+ public:
+  explicit Replayer(bool verbose)
+      : verbose_(verbose),
+        instance_(VK_NULL_HANDLE),
+        device_(VK_NULL_HANDLE),
+        swapchainFormat_(VK_FORMAT_UNDEFINED),
+        replaySwapchainFormat_(VK_FORMAT_UNDEFINED),
+        framesStarted_(false),
+        replayNanoseconds_(0),
+        failedCalls_(0) {
+    memset(&instanceTable_, 0, sizeof(instanceTable_));
+    memset(&deviceTable_, 0, sizeof(deviceTable_));
+    memset(&capturedMemory_, 0, sizeof(capturedMemory_));
+    memset(&replayMemory_, 0, sizeof(replayMemory_));
+    memset(&stats_, 0, sizeof(stats_));
+  }
+
+  bool Run(const char* path);
+  void Report() const;
+
+ private:
+  void Replay();
+
+  // Times the driver call |call| and checks its VkResult against the one
+  // the device returned, if any.
+  template <typename Call>
+  void Timed(Call call) {
+    auto start = std::chrono::steady_clock::now();
+    call();
+    replayNanoseconds_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  }
+  void Check(VkResult captured, VkResult replayed);
+
+  void CreateInstance();
+  void EnumeratePhysicalDevices();
+  void CreateSurface();
+  void CreateDevice();
+  void CreateSwapchain();
+  void GetSwapchainImages();
+  void AcquireNextImage();
+  void QueuePresent();
+  void QueueSubmit();
+  void AllocateMemory();
+  void MapMemory();
+  void MemoryWrite();
+  void FlushMappedMemoryRanges();
+  void GetMemoryRequirements(bool image);
+  void CreateGraphicsPipelines();
+  void Fixup(VkImageViewCreateInfo& info);
+  void Fixup(VkRenderPassCreateInfo& info);
+  template <typename T>
+  void Fixup(T&) {}
+  uint32_t MemoryTypeIndex(uint32_t capturedIndex, uint32_t typeBits) const;
+
+  bool verbose_;
+  TraceReader reader_;
+  VkInstance instance_;
+  VkInstanceDispatchTable instanceTable_;
+  VkDevice device_;
+  VkDeviceDispatchTable deviceTable_;
+  VkPhysicalDeviceMemoryProperties capturedMemory_;
+  VkPhysicalDeviceMemoryProperties replayMemory_;
+
+  // The last vkGet*MemoryRequirements(), used by the vkAllocateMemory() that
+  // follows it: the host driver may want more memory, or other types.
+  struct PendingRequirements {
+    VkMemoryRequirements captured;
+    VkMemoryRequirements replay;
+  };
+  std::vector<PendingRequirements> pending_;
+
+  struct Mapping {
+    uint8_t* data;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    VkDeviceSize allocationSize;
+  };
+  std::unordered_map<uint64_t, Mapping> mappings_;
+
+  // Swapchain images keep the captured format in the trace's image views
+  // and render passes; they are given the one the headless surface has.
+  std::unordered_set<uint64_t> swapchainImages_;
+  VkFormat swapchainFormat_;
+  VkFormat replaySwapchainFormat_;
+  std::unordered_map<uint64_t, uint32_t> acquiredImages_;
+
+  bool framesStarted_;
+  FrameTime init_;
+  FrameTime frame_;
+  std::vector<FrameTime> frames_;
+  CommandStats stats_[256];
+  uint64_t replayNanoseconds_;
+  uint64_t failedCalls_;
+};
+
+bool Replayer::Run(const char* path) {
+  if (!reader_.Open(path)) {
+    fprintf(stderr, "%s: not a readable trace\n", path);
+    return false;
+  }
+  init_ = FrameTime{0, 0};
+  frame_ = FrameTime{0, 0};
+  while (reader_.Next()) {
+    uint32_t command = reader_.command();
+    replayNanoseconds_ = 0;
+    Replay();
+    if (verbose_) {
+      const char* name = TraceCommandName(command);
+      printf("%-40s %10llu %10llu\n", name ? name : "?",
+             static_cast<unsigned long long>(reader_.nanoseconds()),
+             static_cast<unsigned long long>(replayNanoseconds_));
+    }
+    if (command < sizeof(stats_) / sizeof(stats_[0])) {
+      stats_[command].count++;
+      stats_[command].capturedNanoseconds += reader_.nanoseconds();
+      stats_[command].replayNanoseconds += replayNanoseconds_;
+    }
+    // Everything up to the first acquire is InitVulkan(); from there on,
+    // each present closes a frame.
+    if (command == kTraceAcquireNextImage) framesStarted_ = true;
+    FrameTime& time = framesStarted_ ? frame_ : init_;
+    time.captured += reader_.nanoseconds();
+    time.replay += replayNanoseconds_;
+    if (command == kTraceQueuePresent) {
+      frames_.push_back(frame_);
+      frame_ = FrameTime{0, 0};
+    }
+  }
+  return true;
+}
+
+void Replayer::Check(VkResult captured, VkResult replayed) {
+  // Timeouts and out-of-date swapchains depend on the device's timing.
+  if (replayed == captured || replayed >= 0) return;
+  failedCalls_++;
+  const char* name = TraceCommandName(reader_.command());
+  fprintf(stderr, "%s returned %d, captured %d\n", name ? name : "?",
+          replayed, captured);
+}
+
+void Replayer::Replay() {
+  TraceReader& r = reader_;
+  VkResult captured;
+  VkResult result = VK_SUCCESS;
+  switch (r.command()) {
+    case kTraceMemoryWrite:
+      MemoryWrite();
+      break;
+    case kTraceCreateInstance:
+      CreateInstance();
+      break;
+    case kTraceDestroyInstance: {
+      VkInstance instance;
+      r.Handle(instance);
+      Timed([&] { vkDestroyInstance(instance, nullptr); });
+      instance_ = VK_NULL_HANDLE;
+      break;
+    }
+    case kTraceEnumeratePhysicalDevices:
+      EnumeratePhysicalDevices();
+      break;
+    case kTraceGetPhysicalDeviceProperties: {
+      VkPhysicalDevice gpu;
+      r.Handle(gpu);
+      VkPhysicalDeviceProperties properties;
+      Timed([&] { vkGetPhysicalDeviceProperties(gpu, &properties); });
+      break;
+    }
+    case kTraceGetPhysicalDeviceMemoryProperties: {
+      VkPhysicalDevice gpu;
+      r.Handle(gpu);
+      r.Raw(capturedMemory_);
+      Timed([&] { vkGetPhysicalDeviceMemoryProperties(gpu, &replayMemory_); });
+      break;
+    }
+    case kTraceGetPhysicalDeviceQueueFamilyProperties: {
+      VkPhysicalDevice gpu;
+      uint32_t count;
+      r.Handle(gpu);
+      r.Scalar(count);
+      std::vector<VkQueueFamilyProperties> properties(count);
+      Timed([&] {
+        vkGetPhysicalDeviceQueueFamilyProperties(
+            gpu, &count, count ? properties.data() : nullptr);
+      });
+      break;
+    }
+    case kTraceGetPhysicalDeviceFormatProperties: {
+      VkPhysicalDevice gpu;
+      VkFormat format;
+      r.Handle(gpu);
+      r.Scalar(format);
+      VkFormatProperties properties;
+      Timed([&] {
+        vkGetPhysicalDeviceFormatProperties(gpu, format, &properties);
+      });
+      break;
+    }
+    case kTraceCreateSurface:
+      CreateSurface();
+      break;
+    case kTraceDestroySurface: {
+      VkInstance instance;
+      VkSurfaceKHR surface;
+      r.Handle(instance);
+      r.Handle(surface);
+      Timed([&] { vkDestroySurfaceKHR(instance, surface, nullptr); });
+      break;
+    }
+    case kTraceGetPhysicalDeviceSurfaceSupport: {
+      VkPhysicalDevice gpu;
+      uint32_t family;
+      VkSurfaceKHR surface;
+      r.Handle(gpu);
+      r.Scalar(family);
+      r.Handle(surface);
+      VkBool32 supported;
+      Timed([&] {
+        result = vkGetPhysicalDeviceSurfaceSupportKHR(gpu, family, surface,
+                                                      &supported);
+      });
+      break;
+    }
+    case kTraceGetPhysicalDeviceSurfaceCapabilities: {
+      VkPhysicalDevice gpu;
+      VkSurfaceKHR surface;
+      r.Handle(gpu);
+      r.Handle(surface);
+      VkSurfaceCapabilitiesKHR capabilities;
+      Timed([&] {
+        result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(gpu, surface,
+                                                           &capabilities);
+      });
+      break;
+    }
+    case kTraceGetPhysicalDeviceSurfaceFormats: {
+      VkPhysicalDevice gpu;
+      VkSurfaceKHR surface;
+      uint32_t count;
+      r.Handle(gpu);
+      r.Handle(surface);
+      r.Scalar(count);
+      std::vector<VkSurfaceFormatKHR> formats(count);
+      Timed([&] {
+        result = vkGetPhysicalDeviceSurfaceFormatsKHR(
+            gpu, surface, &count, count ? formats.data() : nullptr);
+      });
+      break;
+    }
+    case kTraceGetPhysicalDeviceSurfacePresentModes: {
+      VkPhysicalDevice gpu;
+      VkSurfaceKHR surface;
+      uint32_t count;
+      r.Handle(gpu);
+      r.Handle(surface);
+      r.Scalar(count);
+      std::vector<VkPresentModeKHR> modes(count);
+      Timed([&] {
+        result = vkGetPhysicalDeviceSurfacePresentModesKHR(
+            gpu, surface, &count, count ? modes.data() : nullptr);
+      });
+      break;
+    }
+    case kTraceCreateDevice:
+      CreateDevice();
+      break;
+    case kTraceDestroyDevice: {
+      VkDevice device;
+      r.Handle(device);
+      Timed([&] { deviceTable_.vkDestroyDevice(device, nullptr); });
+      device_ = VK_NULL_HANDLE;
+      break;
+    }
+    case kTraceGetDeviceQueue: {
+      VkDevice device;
+      uint32_t family, index;
+      r.Handle(device);
+      r.Scalar(family);
+      r.Scalar(index);
+      uint32_t id = r.HandleId();
+      VkQueue queue;
+      Timed([&] {
+        deviceTable_.vkGetDeviceQueue(device, family, index, &queue);
+      });
+      r.Bind(id, queue);
+      break;
+    }
+    case kTraceDeviceWaitIdle: {
+      VkDevice device;
+      r.Handle(device);
+      Timed([&] { result = deviceTable_.vkDeviceWaitIdle(device); });
+      break;
+    }
+    case kTraceQueueWaitIdle: {
+      VkQueue queue;
+      r.Handle(queue);
+      Timed([&] { result = deviceTable_.vkQueueWaitIdle(queue); });
+      break;
+    }
+    case kTraceCreateSwapchain:
+      CreateSwapchain();
+      break;
+    case kTraceDestroySwapchain: {
+      VkDevice device;
+      VkSwapchainKHR swapchain;
+      r.Handle(device);
+      r.Handle(swapchain);
+      Timed([&] {
+        deviceTable_.vkDestroySwapchainKHR(device, swapchain, nullptr);
+      });
+      break;
+    }
+    case kTraceGetSwapchainImages:
+      GetSwapchainImages();
+      break;
+    case kTraceAcquireNextImage:
+      AcquireNextImage();
+      break;
+    case kTraceQueuePresent:
+      QueuePresent();
+      break;
+    case kTraceQueueSubmit:
+      QueueSubmit();
+      break;
+    case kTraceAllocateMemory:
+      AllocateMemory();
+      break;
+    case kTraceFreeMemory: {
+      VkDevice device;
+      VkDeviceMemory memory;
+      r.Handle(device);
+      r.Handle(memory);
+      Timed([&] { deviceTable_.vkFreeMemory(device, memory, nullptr); });
+      mappings_.erase(TraceHandleBits<VkDeviceMemory>::Get(memory));
+      break;
+    }
+    case kTraceMapMemory:
+      MapMemory();
+      break;
+    case kTraceUnmapMemory: {
+      VkDevice device;
+      VkDeviceMemory memory;
+      r.Handle(device);
+      r.Handle(memory);
+      Timed([&] { deviceTable_.vkUnmapMemory(device, memory); });
+      auto it = mappings_.find(TraceHandleBits<VkDeviceMemory>::Get(memory));
+      if (it != mappings_.end()) it->second.data = nullptr;
+      break;
+    }
+    case kTraceFlushMappedMemoryRanges:
+      FlushMappedMemoryRanges();
+      break;
+    case kTraceBindBufferMemory: {
+      VkDevice device;
+      VkBuffer buffer;
+      VkDeviceMemory memory;
+      VkDeviceSize offset;
+      r.Handle(device);
+      r.Handle(buffer);
+      r.Handle(memory);
+      r.Scalar(offset);
+      r.Scalar(captured);
+      Timed([&] {
+        result = deviceTable_.vkBindBufferMemory(device, buffer, memory,
+                                                 offset);
+      });
+      Check(captured, result);
+      break;
+    }
+    case kTraceBindImageMemory: {
+      VkDevice device;
+      VkImage image;
+      VkDeviceMemory memory;
+      VkDeviceSize offset;
+      r.Handle(device);
+      r.Handle(image);
+      r.Handle(memory);
+      r.Scalar(offset);
+      r.Scalar(captured);
+      Timed([&] {
+        result = deviceTable_.vkBindImageMemory(device, image, memory,
+                                                offset);
+      });
+      Check(captured, result);
+      break;
+    }
+    case kTraceGetBufferMemoryRequirements:
+      GetMemoryRequirements(false);
+      break;
+    case kTraceGetImageMemoryRequirements:
+      GetMemoryRequirements(true);
+      break;
+    case kTraceGetImageSubresourceLayout: {
+      VkDevice device;
+      VkImage image;
+      VkImageSubresource subresource;
+      r.Handle(device);
+      r.Handle(image);
+      r.Struct(subresource);
+      VkSubresourceLayout layout;
+      Timed([&] {
+        deviceTable_.vkGetImageSubresourceLayout(device, image, &subresource,
+                                                 &layout);
+      });
+      break;
+    }
+    case kTraceCreateGraphicsPipelines:
+      CreateGraphicsPipelines();
+      break;
+    case kTraceDestroyPipeline: {
+      VkDevice device;
+      VkPipeline pipeline;
+      r.Handle(device);
+      r.Handle(pipeline);
+      Timed([&] {
+        deviceTable_.vkDestroyPipeline(device, pipeline, nullptr);
+      });
+      break;
+    }
+    case kTraceAllocateDescriptorSets: {
+      VkDevice device;
+      VkDescriptorSetAllocateInfo info;
+      r.Handle(device);
+      r.Blob(info);
+      r.Scalar(captured);
+      std::vector<VkDescriptorSet> sets(info.descriptorSetCount);
+      Timed([&] {
+        result = deviceTable_.vkAllocateDescriptorSets(device, &info,
+                                                       sets.data());
+      });
+      Check(captured, result);
+      for (VkDescriptorSet set : sets) r.Bind(r.HandleId(), set);
+      break;
+    }
+    case kTraceFreeDescriptorSets: {
+      VkDevice device;
+      VkDescriptorPool pool;
+      uint32_t count;
+      r.Handle(device);
+      r.Handle(pool);
+      r.Scalar(count);
+      std::vector<VkDescriptorSet> sets(count);
+      for (VkDescriptorSet& set : sets) r.Handle(set);
+      Timed([&] {
+        result = deviceTable_.vkFreeDescriptorSets(device, pool, count,
+                                                   sets.data());
+      });
+      break;
+    }
+    case kTraceUpdateDescriptorSets: {
+      VkDevice device;
+      uint32_t writeCount, copyCount;
+      r.Handle(device);
+      r.Scalar(writeCount);
+      std::vector<VkWriteDescriptorSet> writes(writeCount);
+      for (VkWriteDescriptorSet& write : writes) r.Blob(write);
+      r.Scalar(copyCount);
+      std::vector<VkCopyDescriptorSet> copies(copyCount);
+      for (VkCopyDescriptorSet& copy : copies) r.Blob(copy);
+      Timed([&] {
+        deviceTable_.vkUpdateDescriptorSets(device, writeCount, writes.data(),
+                                            copyCount, copies.data());
+      });
+      break;
+    }
+    case kTraceAllocateCommandBuffers: {
+      VkDevice device;
+      VkCommandBufferAllocateInfo info;
+      r.Handle(device);
+      r.Blob(info);
+      r.Scalar(captured);
+      std::vector<VkCommandBuffer> buffers(info.commandBufferCount);
+      Timed([&] {
+        result = deviceTable_.vkAllocateCommandBuffers(device, &info,
+                                                       buffers.data());
+      });
+      Check(captured, result);
+      for (VkCommandBuffer buffer : buffers) r.Bind(r.HandleId(), buffer);
+      break;
+    }
+    case kTraceFreeCommandBuffers: {
+      VkDevice device;
+      VkCommandPool pool;
+      uint32_t count;
+      r.Handle(device);
+      r.Handle(pool);
+      r.Scalar(count);
+      std::vector<VkCommandBuffer> buffers(count);
+      for (VkCommandBuffer& buffer : buffers) r.Handle(buffer);
+      Timed([&] {
+        deviceTable_.vkFreeCommandBuffers(device, pool, count,
+                                          buffers.data());
+      });
+      break;
+    }
+    case kTraceResetCommandBuffer: {
+      VkCommandBuffer buffer;
+      VkCommandBufferResetFlags flags;
+      r.Handle(buffer);
+      r.Scalar(flags);
+      r.Scalar(captured);
+      Timed([&] {
+        result = deviceTable_.vkResetCommandBuffer(buffer, flags);
+      });
+      Check(captured, result);
+      break;
+    }
+    case kTraceBeginCommandBuffer: {
+      VkCommandBuffer buffer;
+      VkCommandBufferBeginInfo info;
+      r.Handle(buffer);
+      r.Blob(info);
+      r.Scalar(captured);
+      Timed([&] {
+        result = deviceTable_.vkBeginCommandBuffer(buffer, &info);
+      });
+      Check(captured, result);
+      break;
+    }
+    case kTraceEndCommandBuffer: {
+      VkCommandBuffer buffer;
+      r.Handle(buffer);
+      r.Scalar(captured);
+      Timed([&] { result = deviceTable_.vkEndCommandBuffer(buffer); });
+      Check(captured, result);
+      break;
+    }
+    case kTraceResetFences: {
+      VkDevice device;
+      uint32_t count;
+      r.Handle(device);
+      r.Scalar(count);
+      std::vector<VkFence> fences(count);
+      for (VkFence& fence : fences) r.Handle(fence);
+      Timed([&] {
+        result = deviceTable_.vkResetFences(device, count, fences.data());
+      });
+      break;
+    }
+    case kTraceWaitForFences: {
+      VkDevice device;
+      uint32_t count;
+      VkBool32 waitAll;
+      uint64_t timeout;
+      r.Handle(device);
+      r.Scalar(count);
+      std::vector<VkFence> fences(count);
+      for (VkFence& fence : fences) r.Handle(fence);
+      r.Scalar(waitAll);
+      r.Scalar(timeout);
+      Timed([&] {
+        result = deviceTable_.vkWaitForFences(device, count, fences.data(),
+                                              waitAll, timeout);
+      });
+      break;
+    }
+    case kTraceGetFenceStatus: {
+      VkDevice device;
+      VkFence fence;
+      r.Handle(device);
+      r.Handle(fence);
+      Timed([&] { result = deviceTable_.vkGetFenceStatus(device, fence); });
+      break;
+    }
+    case kTraceCmdBeginRenderPass: {
+      VkCommandBuffer buffer;
+      VkRenderPassBeginInfo info;
+      VkSubpassContents contents;
+      r.Handle(buffer);
+      r.Blob(info);
+      r.Scalar(contents);
+      Timed([&] {
+        deviceTable_.vkCmdBeginRenderPass(buffer, &info, contents);
+      });
+      break;
+    }
+    case kTraceCmdEndRenderPass: {
+      VkCommandBuffer buffer;
+      r.Handle(buffer);
+      Timed([&] { deviceTable_.vkCmdEndRenderPass(buffer); });
+      break;
+    }
+    case kTraceCmdBindPipeline: {
+      VkCommandBuffer buffer;
+      VkPipelineBindPoint bindPoint;
+      VkPipeline pipeline;
+      r.Handle(buffer);
+      r.Scalar(bindPoint);
+      r.Handle(pipeline);
+      Timed([&] {
+        deviceTable_.vkCmdBindPipeline(buffer, bindPoint, pipeline);
+      });
+      break;
+    }
+    case kTraceCmdBindDescriptorSets: {
+      VkCommandBuffer buffer;
+      VkPipelineBindPoint bindPoint;
+      VkPipelineLayout layout;
+      uint32_t firstSet, setCount, offsetCount;
+      r.Handle(buffer);
+      r.Scalar(bindPoint);
+      r.Handle(layout);
+      r.Scalar(firstSet);
+      r.Scalar(setCount);
+      std::vector<VkDescriptorSet> sets(setCount);
+      for (VkDescriptorSet& set : sets) r.Handle(set);
+      r.Scalar(offsetCount);
+      std::vector<uint32_t> offsets(offsetCount);
+      for (uint32_t& offset : offsets) r.Scalar(offset);
+      Timed([&] {
+        deviceTable_.vkCmdBindDescriptorSets(buffer, bindPoint, layout,
+                                             firstSet, setCount, sets.data(),
+                                             offsetCount, offsets.data());
+      });
+      break;
+    }
+    case kTraceCmdBindVertexBuffers: {
+      VkCommandBuffer buffer;
+      uint32_t first, count;
+      r.Handle(buffer);
+      r.Scalar(first);
+      r.Scalar(count);
+      std::vector<VkBuffer> buffers(count);
+      std::vector<VkDeviceSize> offsets(count);
+      for (uint32_t i = 0; i < count; i++) {
+        r.Handle(buffers[i]);
+        r.Scalar(offsets[i]);
+      }
+      Timed([&] {
+        deviceTable_.vkCmdBindVertexBuffers(buffer, first, count,
+                                            buffers.data(), offsets.data());
+      });
+      break;
+    }
+    case kTraceCmdBindIndexBuffer: {
+      VkCommandBuffer commandBuffer;
+      VkBuffer buffer;
+      VkDeviceSize offset;
+      VkIndexType type;
+      r.Handle(commandBuffer);
+      r.Handle(buffer);
+      r.Scalar(offset);
+      r.Scalar(type);
+      Timed([&] {
+        deviceTable_.vkCmdBindIndexBuffer(commandBuffer, buffer, offset,
+                                          type);
+      });
+      break;
+    }
+    case kTraceCmdSetViewport: {
+      VkCommandBuffer buffer;
+      uint32_t first, count;
+      r.Handle(buffer);
+      r.Scalar(first);
+      r.Scalar(count);
+      std::vector<VkViewport> viewports(count);
+      for (VkViewport& viewport : viewports) r.Struct(viewport);
+      Timed([&] {
+        deviceTable_.vkCmdSetViewport(buffer, first, count, viewports.data());
+      });
+      break;
+    }
+    case kTraceCmdSetScissor: {
+      VkCommandBuffer buffer;
+      uint32_t first, count;
+      r.Handle(buffer);
+      r.Scalar(first);
+      r.Scalar(count);
+      std::vector<VkRect2D> scissors(count);
+      for (VkRect2D& scissor : scissors) r.Struct(scissor);
+      Timed([&] {
+        deviceTable_.vkCmdSetScissor(buffer, first, count, scissors.data());
+      });
+      break;
+    }
+    case kTraceCmdPushConstants: {
+      VkCommandBuffer buffer;
+      VkPipelineLayout layout;
+      VkShaderStageFlags stages;
+      uint32_t offset, size;
+      const void* values;
+      r.Handle(buffer);
+      r.Handle(layout);
+      r.Scalar(stages);
+      r.Scalar(offset);
+      r.Scalar(size);
+      r.Bytes(values, size);
+      Timed([&] {
+        deviceTable_.vkCmdPushConstants(buffer, layout, stages, offset, size,
+                                        values);
+      });
+      break;
+    }
+    case kTraceCmdDraw: {
+      VkCommandBuffer buffer;
+      uint32_t vertexCount, instanceCount, firstVertex, firstInstance;
+      r.Handle(buffer);
+      r.Scalar(vertexCount);
+      r.Scalar(instanceCount);
+      r.Scalar(firstVertex);
+      r.Scalar(firstInstance);
+      Timed([&] {
+        deviceTable_.vkCmdDraw(buffer, vertexCount, instanceCount,
+                               firstVertex, firstInstance);
+      });
+      break;
+    }
+    case kTraceCmdDrawIndexed: {
+      VkCommandBuffer buffer;
+      uint32_t indexCount, instanceCount, firstIndex, firstInstance;
+      int32_t vertexOffset;
+      r.Handle(buffer);
+      r.Scalar(indexCount);
+      r.Scalar(instanceCount);
+      r.Scalar(firstIndex);
+      r.Scalar(vertexOffset);
+      r.Scalar(firstInstance);
+      Timed([&] {
+        deviceTable_.vkCmdDrawIndexed(buffer, indexCount, instanceCount,
+                                      firstIndex, vertexOffset,
+                                      firstInstance);
+      });
+      break;
+    }
+    case kTraceCmdPipelineBarrier: {
+      VkCommandBuffer buffer;
+      VkPipelineStageFlags srcStages, dstStages;
+      VkDependencyFlags dependencies;
+      uint32_t count;
+      r.Handle(buffer);
+      r.Scalar(srcStages);
+      r.Scalar(dstStages);
+      r.Scalar(dependencies);
+      r.Scalar(count);
+      std::vector<VkMemoryBarrier> memory(count);
+      for (VkMemoryBarrier& barrier : memory) r.Struct(barrier);
+      r.Scalar(count);
+      std::vector<VkBufferMemoryBarrier> buffers(count);
+      for (VkBufferMemoryBarrier& barrier : buffers) r.Struct(barrier);
+      r.Scalar(count);
+      std::vector<VkImageMemoryBarrier> images(count);
+      for (VkImageMemoryBarrier& barrier : images) r.Struct(barrier);
+      Timed([&] {
+        deviceTable_.vkCmdPipelineBarrier(
+            buffer, srcStages, dstStages, dependencies,
+            static_cast<uint32_t>(memory.size()), memory.data(),
+            static_cast<uint32_t>(buffers.size()), buffers.data(),
+            static_cast<uint32_t>(images.size()), images.data());
+      });
+      break;
+    }
+    case kTraceCmdCopyBuffer: {
+      VkCommandBuffer buffer;
+      VkBuffer src, dst;
+      uint32_t count;
+      r.Handle(buffer);
+      r.Handle(src);
+      r.Handle(dst);
+      r.Scalar(count);
+      std::vector<VkBufferCopy> regions(count);
+      for (VkBufferCopy& region : regions) r.Struct(region);
+      Timed([&] {
+        deviceTable_.vkCmdCopyBuffer(buffer, src, dst, count, regions.data());
+      });
+      break;
+    }
+    case kTraceCmdCopyImage: {
+      VkCommandBuffer buffer;
+      VkImage src, dst;
+      VkImageLayout srcLayout, dstLayout;
+      uint32_t count;
+      r.Handle(buffer);
+      r.Handle(src);
+      r.Scalar(srcLayout);
+      r.Handle(dst);
+      r.Scalar(dstLayout);
+      r.Scalar(count);
+      std::vector<VkImageCopy> regions(count);
+      for (VkImageCopy& region : regions) r.Struct(region);
+      Timed([&] {
+        deviceTable_.vkCmdCopyImage(buffer, src, srcLayout, dst, dstLayout,
+                                    count, regions.data());
+      });
+      break;
+    }
+    case kTraceCmdCopyBufferToImage: {
+      VkCommandBuffer buffer;
+      VkBuffer src;
+      VkImage dst;
+      VkImageLayout dstLayout;
+      uint32_t count;
+      r.Handle(buffer);
+      r.Handle(src);
+      r.Handle(dst);
+      r.Scalar(dstLayout);
+      r.Scalar(count);
+      std::vector<VkBufferImageCopy> regions(count);
+      for (VkBufferImageCopy& region : regions) r.Struct(region);
+      Timed([&] {
+        deviceTable_.vkCmdCopyBufferToImage(buffer, src, dst, dstLayout,
+                                            count, regions.data());
+      });
+      break;
+    }
+    case kTraceCmdBlitImage: {
+      VkCommandBuffer buffer;
+      VkImage src, dst;
+      VkImageLayout srcLayout, dstLayout;
+      uint32_t count;
+      VkFilter filter;
+      r.Handle(buffer);
+      r.Handle(src);
+      r.Scalar(srcLayout);
+      r.Handle(dst);
+      r.Scalar(dstLayout);
+      r.Scalar(count);
+      std::vector<VkImageBlit> regions(count);
+      for (VkImageBlit& region : regions) r.Struct(region);
+      r.Scalar(filter);
+      Timed([&] {
+        deviceTable_.vkCmdBlitImage(buffer, src, srcLayout, dst, dstLayout,
+                                    count, regions.data(), filter);
+      });
+      break;
+    }
+#define VK_REPLAY_DEVICE_OBJECT(name)                                     \
+  case kTraceCreate##name: {                                              \
+    VkDevice device;                                                      \
+    Vk##name##CreateInfo info;                                            \
+    r.Handle(device);                                                     \
+    r.Blob(info);                                                         \
+    r.Scalar(captured);                                                   \
+    uint32_t id = r.HandleId();                                           \
+    Fixup(info);                                                          \
+    Vk##name object = Vk##name();                                         \
+    Timed([&] {                                                           \
+      result = deviceTable_.vkCreate##name(device, &info, nullptr,        \
+                                           &object);                      \
+    });                                                                   \
+    Check(captured, result);                                              \
+    r.Bind(id, object);                                                   \
+    break;                                                                \
+  }                                                                       \
+  case kTraceDestroy##name: {                                             \
+    VkDevice device;                                                      \
+    Vk##name object;                                                      \
+    r.Handle(device);                                                     \
+    r.Handle(object);                                                     \
+    Timed([&] { deviceTable_.vkDestroy##name(device, object, nullptr); }); \
+    break;                                                                \
+  }
+      VK_TRACE_DEVICE_OBJECTS(VK_REPLAY_DEVICE_OBJECT)
+#undef VK_REPLAY_DEVICE_OBJECT
+    default:
+      // A newer capture; the record is skipped as a whole.
+      fprintf(stderr, "skipping unknown record %u\n", r.command());
+      break;
+  }
+}
+
+void Replayer::CreateInstance() {
+  VkInstanceCreateInfo info;
+  VkResult captured;
+  reader_.Blob(info);
+  reader_.Scalar(captured);
+  uint32_t id = reader_.HandleId();
+
+  // Platform surfaces become headless ones; the device's layers are
+  // unlikely to be installed here and would only skew the timing.
+  std::vector<const char*> extensions;
+  for (uint32_t i = 0; i < info.enabledExtensionCount; i++) {
+    const char* name = info.ppEnabledExtensionNames[i];
+    if (strcmp(name, VK_KHR_SURFACE_EXTENSION_NAME) &&
+        strstr(name, "_surface"))
+      continue;
+    extensions.push_back(name);
+  }
+  extensions.push_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+  info.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+  info.ppEnabledExtensionNames = extensions.data();
+  info.enabledLayerCount = 0;
+  info.ppEnabledLayerNames = nullptr;
+
+  VkResult result;
+  Timed([&] { result = vkCreateInstance(&info, nullptr, &instance_); });
+  if (result != VK_SUCCESS) {
+    fprintf(stderr, "vkCreateInstance() failed (%d); does the driver "
+            "support VK_EXT_headless_surface?\n", result);
+    instance_ = VK_NULL_HANDLE;
+  } else {
+    InitVulkanInstanceDispatchTable(instance_, &instanceTable_);
+  }
+  reader_.Bind(id, instance_);
+}
+
+void Replayer::EnumeratePhysicalDevices() {
+  VkInstance instance;
+  uint32_t requested, returned;
+  VkResult captured, result;
+  reader_.Handle(instance);
+  reader_.Scalar(requested);
+  reader_.Scalar(captured);
+  reader_.Scalar(returned);
+
+  uint32_t count = requested;
+  std::vector<VkPhysicalDevice> gpus(count);
+  Timed([&] {
+    result = vkEnumeratePhysicalDevices(instance, &count,
+                                        count ? gpus.data() : nullptr);
+  });
+  // The device's GPUs map onto the host's by index, all extra ones onto the
+  // last host GPU.
+  gpus.resize(count);
+  for (uint32_t i = 0; i < returned; i++) {
+    uint32_t id = reader_.HandleId();
+    if (!gpus.empty()) reader_.Bind(id, gpus[std::min(i, count - 1)]);
+  }
+}
+
+void Replayer::CreateSurface() {
+  VkInstance instance;
+  VkResult captured;
+  reader_.Handle(instance);
+  reader_.Scalar(captured);
+  uint32_t id = reader_.HandleId();
+
+  VkHeadlessSurfaceCreateInfoEXT info = {
+      .sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT,
+      .pNext = nullptr,
+      .flags = 0,
+  };
+  VkSurfaceKHR surface = VK_NULL_HANDLE;
+  VkResult result = VK_ERROR_EXTENSION_NOT_PRESENT;
+  if (instanceTable_.vkCreateHeadlessSurfaceEXT) {
+    Timed([&] {
+      result = instanceTable_.vkCreateHeadlessSurfaceEXT(instance, &info,
+                                                         nullptr, &surface);
+    });
+  }
+  Check(captured, result);
+  reader_.Bind(id, surface);
+}
+
+void Replayer::CreateDevice() {
+  VkPhysicalDevice gpu;
+  VkDeviceCreateInfo info;
+  VkResult captured, result;
+  reader_.Handle(gpu);
+  reader_.Blob(info);
+  reader_.Scalar(captured);
+  uint32_t id = reader_.HandleId();
+
+  info.enabledLayerCount = 0;
+  info.ppEnabledLayerNames = nullptr;
+  Timed([&] { result = vkCreateDevice(gpu, &info, nullptr, &device_); });
+  Check(captured, result);
+  if (result == VK_SUCCESS)
+    InitVulkanDeviceDispatchTable(device_, &deviceTable_);
+  else
+    device_ = VK_NULL_HANDLE;
+  reader_.Bind(id, device_);
+}
+
+void Replayer::CreateSwapchain() {
+  VkDevice device;
+  VkSwapchainCreateInfoKHR info;
+  VkResult captured, result;
+  reader_.Handle(device);
+  reader_.Blob(info);
+  reader_.Scalar(captured);
+  uint32_t id = reader_.HandleId();
+
+  // Keep what the headless surface supports. The physical device is the
+  // one the device was created from; the tutorials only have one.
+  uint32_t gpuCount = 1;
+  VkPhysicalDevice gpu = VK_NULL_HANDLE;
+  vkEnumeratePhysicalDevices(instance_, &gpuCount, &gpu);
+  VkSurfaceCapabilitiesKHR capabilities;
+  vkGetPhysicalDeviceSurfaceCapabilitiesKHR(gpu, info.surface,
+                                            &capabilities);
+  uint32_t formatCount = 0;
+  vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, info.surface, &formatCount,
+                                       nullptr);
+  std::vector<VkSurfaceFormatKHR> formats(formatCount);
+  vkGetPhysicalDeviceSurfaceFormatsKHR(gpu, info.surface, &formatCount,
+                                       formats.data());
+
+  swapchainFormat_ = info.imageFormat;
+  replaySwapchainFormat_ = info.imageFormat;
+  bool supported = false;
+  for (const VkSurfaceFormatKHR& format : formats)
+    supported |= format.format == info.imageFormat &&
+                 format.colorSpace == info.imageColorSpace;
+  if (!supported && !formats.empty()) {
+    replaySwapchainFormat_ = formats[0].format;
+    info.imageFormat = formats[0].format;
+    info.imageColorSpace = formats[0].colorSpace;
+  }
+  if (!(info.preTransform & capabilities.supportedTransforms))
+    info.preTransform = capabilities.currentTransform;
+  if (!(info.compositeAlpha & capabilities.supportedCompositeAlpha)) {
+    uint32_t alpha = capabilities.supportedCompositeAlpha;
+    info.compositeAlpha =
+        static_cast<VkCompositeAlphaFlagBitsKHR>(alpha & (~alpha + 1));
+  }
+  info.minImageCount = std::max(info.minImageCount,
+                                capabilities.minImageCount);
+  if (capabilities.maxImageCount)
+    info.minImageCount = std::min(info.minImageCount,
+                                  capabilities.maxImageCount);
+  info.imageUsage &= capabilities.supportedUsageFlags;
+  info.presentMode = VK_PRESENT_MODE_FIFO_KHR;
+
+  VkSwapchainKHR swapchain = VK_NULL_HANDLE;
+  Timed([&] {
+    result = deviceTable_.vkCreateSwapchainKHR(device, &info, nullptr,
+                                               &swapchain);
+  });
+  Check(captured, result);
+  reader_.Bind(id, swapchain);
+}
+
+void Replayer::GetSwapchainImages() {
+  VkDevice device;
+  VkSwapchainKHR swapchain;
+  uint32_t requested, returned;
+  VkResult captured, result;
+  reader_.Handle(device);
+  reader_.Handle(swapchain);
+  reader_.Scalar(requested);
+  reader_.Scalar(captured);
+  reader_.Scalar(returned);
+
+  uint32_t count = requested;
+  std::vector<VkImage> images(count);
+  Timed([&] {
+    result = deviceTable_.vkGetSwapchainImagesKHR(
+        device, swapchain, &count, count ? images.data() : nullptr);
+  });
+  // Images the host swapchain does not have (it may have fewer) alias the
+  // last one it does.
+  images.resize(count);
+  for (uint32_t i = 0; i < returned; i++) {
+    uint32_t id = reader_.HandleId();
+    if (images.empty()) continue;
+    VkImage image = images[std::min(i, count - 1)];
+    swapchainImages_.insert(TraceHandleBits<VkImage>::Get(image));
+    reader_.Bind(id, image);
+  }
+}
+
+void Replayer::AcquireNextImage() {
+  VkDevice device;
+  VkSwapchainKHR swapchain;
+  uint64_t timeout;
+  VkSemaphore semaphore;
+  VkFence fence;
+  VkResult captured, result;
+  uint32_t capturedIndex, index = 0;
+  reader_.Handle(device);
+  reader_.Handle(swapchain);
+  reader_.Scalar(timeout);
+  reader_.Handle(semaphore);
+  reader_.Handle(fence);
+  reader_.Scalar(captured);
+  reader_.Scalar(capturedIndex);
+  Timed([&] {
+    result = deviceTable_.vkAcquireNextImageKHR(device, swapchain, timeout,
+                                                semaphore, fence, &index);
+  });
+  Check(captured, result);
+  // The trace goes on recording into the captured image's framebuffer,
+  // which is fine for timing; the present has to name the acquired one.
+  acquiredImages_[TraceHandleBits<VkSwapchainKHR>::Get(swapchain)] = index;
+}
+
+void Replayer::QueuePresent() {
+  VkQueue queue;
+  VkPresentInfoKHR info;
+  VkResult captured, result;
+  reader_.Handle(queue);
+  reader_.Blob(info);
+  reader_.Scalar(captured);
+
+  std::vector<uint32_t> indices(info.pImageIndices,
+                                info.pImageIndices + info.swapchainCount);
+  for (uint32_t i = 0; i < info.swapchainCount; i++) {
+    auto it = acquiredImages_.find(
+        TraceHandleBits<VkSwapchainKHR>::Get(info.pSwapchains[i]));
+    if (it != acquiredImages_.end()) indices[i] = it->second;
+  }
+  info.pImageIndices = indices.data();
+  Timed([&] { result = deviceTable_.vkQueuePresentKHR(queue, &info); });
+  Check(captured, result);
+}
+
+void Replayer::QueueSubmit() {
+  VkQueue queue;
+  uint32_t count;
+  VkFence fence;
+  VkResult captured, result;
+  reader_.Handle(queue);
+  reader_.Scalar(count);
+  std::vector<VkSubmitInfo> submits(count);
+  for (VkSubmitInfo& submit : submits) reader_.Blob(submit);
+  reader_.Handle(fence);
+  reader_.Scalar(captured);
+  Timed([&] {
+    result = deviceTable_.vkQueueSubmit(queue, count, submits.data(), fence);
+  });
+  Check(captured, result);
+}
+
+// The host memory type that has at least the property flags the captured
+// one had, among |typeBits|.
+uint32_t Replayer::MemoryTypeIndex(uint32_t capturedIndex,
+                                   uint32_t typeBits) const {
+  VkMemoryPropertyFlags flags = 0;
+  if (capturedIndex < capturedMemory_.memoryTypeCount)
+    flags = capturedMemory_.memoryTypes[capturedIndex].propertyFlags;
+  uint32_t fallback = UINT32_MAX;
+  for (uint32_t i = 0; i < replayMemory_.memoryTypeCount; i++) {
+    if (!(typeBits & (1u << i))) continue;
+    if ((replayMemory_.memoryTypes[i].propertyFlags & flags) == flags)
+      return i;
+    if (fallback == UINT32_MAX) fallback = i;
+  }
+  return fallback == UINT32_MAX ? 0 : fallback;
+}
+
+void Replayer::AllocateMemory() {
+  VkDevice device;
+  VkMemoryAllocateInfo info;
+  VkResult captured, result;
+  reader_.Handle(device);
+  reader_.Blob(info);
+  reader_.Scalar(captured);
+  uint32_t id = reader_.HandleId();
+
+  uint32_t typeBits = UINT32_MAX;
+  if (!pending_.empty()) {
+    const PendingRequirements& pending = pending_.back();
+    // Grows with the host's requirements, keeping any extra the app asked
+    // for on top of the device's.
+    if (info.allocationSize >= pending.captured.size)
+      info.allocationSize += pending.replay.size > pending.captured.size
+                                 ? pending.replay.size - pending.captured.size
+                                 : 0;
+    typeBits = pending.replay.memoryTypeBits;
+    pending_.clear();
+  }
+  info.memoryTypeIndex = MemoryTypeIndex(info.memoryTypeIndex, typeBits);
+
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  Timed([&] {
+    result = deviceTable_.vkAllocateMemory(device, &info, nullptr, &memory);
+  });
+  Check(captured, result);
+  reader_.Bind(id, memory);
+  if (result == VK_SUCCESS)
+    mappings_[TraceHandleBits<VkDeviceMemory>::Get(memory)] =
+        Mapping{nullptr, 0, 0, info.allocationSize};
+}
+
+void Replayer::MapMemory() {
+  VkDevice device;
+  VkDeviceMemory memory;
+  VkDeviceSize offset, size;
+  VkMemoryMapFlags flags;
+  VkResult captured, result;
+  reader_.Handle(device);
+  reader_.Handle(memory);
+  reader_.Scalar(offset);
+  reader_.Scalar(size);
+  reader_.Scalar(flags);
+  reader_.Scalar(captured);
+
+  void* data = nullptr;
+  Timed([&] {
+    result = deviceTable_.vkMapMemory(device, memory, offset, size, flags,
+                                      &data);
+  });
+  Check(captured, result);
+  auto it = mappings_.find(TraceHandleBits<VkDeviceMemory>::Get(memory));
+  if (result != VK_SUCCESS || it == mappings_.end()) return;
+  Mapping& mapping = it->second;
+  mapping.data = static_cast<uint8_t*>(data);
+  mapping.offset = offset;
+  mapping.size =
+      size == VK_WHOLE_SIZE ? mapping.allocationSize - offset : size;
+}
+
+void Replayer::MemoryWrite() {
+  VkDeviceMemory memory;
+  VkDeviceSize offset, size;
+  reader_.Handle(memory);
+  reader_.Scalar(offset);
+  reader_.Scalar(size);
+  const uint8_t* bytes = reader_.Varint() ? reader_.Span(size) : nullptr;
+
+  auto it = mappings_.find(TraceHandleBits<VkDeviceMemory>::Get(memory));
+  if (!bytes || it == mappings_.end() || !it->second.data) return;
+  const Mapping& mapping = it->second;
+  if (offset < mapping.offset || offset >= mapping.offset + mapping.size)
+    return;
+  size = std::min(size, mapping.offset + mapping.size - offset);
+  memcpy(mapping.data + (offset - mapping.offset), bytes, size);
+}
+
+void Replayer::FlushMappedMemoryRanges() {
+  VkDevice device;
+  uint32_t count;
+  VkResult captured, result;
+  reader_.Handle(device);
+  reader_.Scalar(count);
+  std::vector<VkMappedMemoryRange> ranges(count);
+  for (VkMappedMemoryRange& range : ranges) {
+    reader_.Blob(range);
+    // The device's nonCoherentAtomSize alignment may not be the host's.
+    auto it =
+        mappings_.find(TraceHandleBits<VkDeviceMemory>::Get(range.memory));
+    if (it != mappings_.end()) range.offset = it->second.offset;
+    range.size = VK_WHOLE_SIZE;
+  }
+  reader_.Scalar(captured);
+  Timed([&] {
+    result = deviceTable_.vkFlushMappedMemoryRanges(device, count,
+                                                    ranges.data());
+  });
+  Check(captured, result);
+}
+
+void Replayer::GetMemoryRequirements(bool image) {
+  VkDevice device;
+  PendingRequirements pending;
+  reader_.Handle(device);
+  if (image) {
+    VkImage object;
+    reader_.Handle(object);
+    reader_.Raw(pending.captured);
+    Timed([&] {
+      deviceTable_.vkGetImageMemoryRequirements(device, object,
+                                                &pending.replay);
+    });
+  } else {
+    VkBuffer object;
+    reader_.Handle(object);
+    reader_.Raw(pending.captured);
+    Timed([&] {
+      deviceTable_.vkGetBufferMemoryRequirements(device, object,
+                                                 &pending.replay);
+    });
+  }
+  pending_.clear();
+  pending_.push_back(pending);
+}
+
+void Replayer::CreateGraphicsPipelines() {
+  VkDevice device;
+  VkPipelineCache cache;
+  uint32_t count;
+  VkResult captured, result;
+  reader_.Handle(device);
+  reader_.Handle(cache);
+  reader_.Scalar(count);
+  std::vector<VkGraphicsPipelineCreateInfo> infos(count);
+  for (VkGraphicsPipelineCreateInfo& info : infos) reader_.Blob(info);
+  reader_.Scalar(captured);
+  std::vector<VkPipeline> pipelines(count);
+  Timed([&] {
+    result = deviceTable_.vkCreateGraphicsPipelines(
+        device, cache, count, infos.data(), nullptr, pipelines.data());
+  });
+  Check(captured, result);
+  for (VkPipeline pipeline : pipelines) reader_.Bind(reader_.HandleId(),
+                                                     pipeline);
+}
+
+void Replayer::Fixup(VkImageViewCreateInfo& info) {
+  if (swapchainImages_.count(TraceHandleBits<VkImage>::Get(info.image)))
+    info.format = replaySwapchainFormat_;
+}
+
+void Replayer::Fixup(VkRenderPassCreateInfo& info) {
+  if (swapchainFormat_ == replaySwapchainFormat_) return;
+  // Decoded structs live in the reader's arena and may be patched in place.
+  VkAttachmentDescription* attachments =
+      const_cast<VkAttachmentDescription*>(info.pAttachments);
+  for (uint32_t i = 0; attachments && i < info.attachmentCount; i++) {
+    if (attachments[i].format == swapchainFormat_)
+      attachments[i].format = replaySwapchainFormat_;
+  }
+}
+
+void PrintPercentiles(const char* label, std::vector<uint64_t> values) {
+  if (values.empty()) return;
+  std::sort(values.begin(), values.end());
+  uint64_t sum = 0;
+  for (uint64_t value : values) sum += value;
+  printf("  %-8s avg %8.3f ms  median %8.3f ms  p95 %8.3f ms\n", label,
+         sum / 1e6 / values.size(), values[values.size() / 2] / 1e6,
+         values[values.size() * 95 / 100] / 1e6);
+}
+
+void Replayer::Report() const {
+  printf("InitVulkan():   captured %8.3f ms  replay %8.3f ms\n",
+         init_.captured / 1e6, init_.replay / 1e6);
+  printf("%zu frames:\n", frames_.size());
+  std::vector<uint64_t> captured, replay;
+  for (const FrameTime& frame : frames_) {
+    captured.push_back(frame.captured);
+    replay.push_back(frame.replay);
+  }
+  PrintPercentiles("captured", captured);
+  PrintPercentiles("replay", replay);
+
+  printf("\n%-40s %8s %12s %12s\n", "command", "calls", "captured ms",
+         "replay ms");
+  for (uint32_t i = 0; i < sizeof(stats_) / sizeof(stats_[0]); i++) {
+    const CommandStats& stats = stats_[i];
+    if (!stats.count) continue;
+    const char* name = TraceCommandName(i);
+    printf("%-40s %8llu %12.3f %12.3f\n", name ? name : "?",
+           static_cast<unsigned long long>(stats.count),
+           stats.capturedNanoseconds / 1e6, stats.replayNanoseconds / 1e6);
+  }
+  if (reader_.DroppedExtensions())
+    printf("\n%llu extension structs were not captured\n",
+           static_cast<unsigned long long>(reader_.DroppedExtensions()));
+  if (failedCalls_)
+    printf("%llu calls failed on replay\n",
+           static_cast<unsigned long long>(failedCalls_));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  bool verbose = false;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--verbose"))
+      verbose = true;
+    else
+      path = argv[i];
+  }
+  if (!path) {
+    fprintf(stderr, "usage: %s <trace> [--verbose]\n", argv[0]);
+    return 2;
+  }
+  if (!InitVulkan()) {
+    fprintf(stderr, "no Vulkan loader found\n");
+    return 1;
+  }
+  Replayer replayer(verbose);
+  if (!replayer.Run(path)) return 1;
+  replayer.Report();
+  return 0;
+}
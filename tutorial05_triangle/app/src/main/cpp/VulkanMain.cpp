@@ -18,8 +18,10 @@
 #include <android/log.h>
 
 #include <cassert>
+#include <chrono>
 #include <cstring>
 #include <vector>
+#include "MemoryTypeSelector.hpp"
 
 // Android log function wrappers
 static const char* kTAG = "Vulkan-Tutorial05";
@@ -50,6 +52,13 @@ struct VulkanDeviceInfo {
 
   VkSurfaceKHR surface_;
   VkQueue queue_;
+
+  // Driver entry points for device_: command recording and the per-frame
+  // calls go through here instead of the libvulkan.so trampolines
+  VkDeviceDispatchTable dispatch_;
+
+  // Picks the memory type for each kind of allocation
+  MemoryTypeSelector memoryTypes_;
 };
 VulkanDeviceInfo device;
 
@@ -84,11 +93,25 @@ struct VulkanRenderInfo {
   VkCommandPool cmdPool_;
   VkCommandBuffer* cmdBuffer_;
   uint32_t cmdBufferLen_;
-  VkSemaphore semaphore_;
-  VkFence fence_;
+
+  // Up to framesInFlight_ frames are queued before VulkanDrawFrame() waits
+  // on the GPU; frameIndex_ cycles through their sync objects.
+  uint32_t framesInFlight_;
+  uint32_t frameIndex_;
+  std::vector<VkFence> frameFence_;            // the frame's submit retired
+  std::vector<VkSemaphore> acquireSemaphore_;  // the frame's image is ready
+  // Per swapchain image: rendering to it is done, and the frame fence of the
+  // last submit using its command buffer.
+  std::vector<VkSemaphore> renderSemaphore_;
+  std::vector<VkFence> imageFence_;
 };
 VulkanRenderInfo render;
 
+// Settings and stats for VulkanDrawFrame()
+uint32_t framesInFlight = 2;
+VulkanFrameStats frameStats;
+const uint32_t kFrameStatsInterval = 300;  // frames between stats logs
+
 // Android Native App pointer...
 android_app* androidAppCtx = nullptr;
 
@@ -190,7 +213,12 @@ void CreateVulkanDevice(ANativeWindow* platformWindow,
 
   CALL_VK(vkCreateDevice(device.gpuDevice_, &deviceCreateInfo, nullptr,
                          &device.device_));
+  InitVulkanDeviceDispatchTable(device.device_, &device.dispatch_);
   vkGetDeviceQueue(device.device_, device.queueFamilyIndex_, 0, &device.queue_);
+
+  VkPhysicalDeviceMemoryProperties memoryProperties;
+  vkGetPhysicalDeviceMemoryProperties(device.gpuDevice_, &memoryProperties);
+  device.memoryTypes_ = MemoryTypeSelector(memoryProperties);
 }
 
 void CreateSwapChain(void) {
@@ -331,26 +359,6 @@ void CreateFrameBuffers(VkRenderPass& renderPass,
   }
 }
 
-// A helper function
-bool MapMemoryTypeToIndex(uint32_t typeBits, VkFlags requirements_mask,
-                          uint32_t* typeIndex) {
-  VkPhysicalDeviceMemoryProperties memoryProperties;
-  vkGetPhysicalDeviceMemoryProperties(device.gpuDevice_, &memoryProperties);
-  // Search memtypes to find first index with those properties
-  for (uint32_t i = 0; i < 32; i++) {
-    if ((typeBits & 1) == 1) {
-      // Type is available, does it match user properties?
-      if ((memoryProperties.memoryTypes[i].propertyFlags & requirements_mask) ==
-          requirements_mask) {
-        *typeIndex = i;
-        return true;
-      }
-    }
-    typeBits >>= 1;
-  }
-  return false;
-}
-
 // Create our vertex buffer
 bool CreateBuffers(void) {
   // -----------------------------------------------
@@ -386,11 +394,11 @@ bool CreateBuffers(void) {
       .memoryTypeIndex = 0,  // Memory type assigned in the next step
   };
 
-  // Assign the proper memory type for that buffer
-  MapMemoryTypeToIndex(memReq.memoryTypeBits,
-                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                       &allocInfo.memoryTypeIndex);
+  // Assign the proper memory type for that buffer: written by the CPU, and
+  // read by the vertex shader
+  allocInfo.memoryTypeIndex = device.memoryTypes_.Select(
+      kMemoryUsageDynamic, memReq.memoryTypeBits);
+  assert(allocInfo.memoryTypeIndex != MemoryTypeSelector::kNoType);
 
   // Allocate memory for the buffer
   VkDeviceMemory deviceMemory;
@@ -400,6 +408,19 @@ bool CreateBuffers(void) {
   CALL_VK(vkMapMemory(device.device_, deviceMemory, 0, allocInfo.allocationSize,
                       0, &data));
   memcpy(data, vertexData, sizeof(vertexData));
+  // Dynamic memory need not be coherent: the whole mapping is flushed, as
+  // ranges must be whole nonCoherentAtomSize atoms or reach its end
+  if (!(device.memoryTypes_.Flags(allocInfo.memoryTypeIndex) &
+        VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+    VkMappedMemoryRange range{
+        .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .pNext = nullptr,
+        .memory = deviceMemory,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+    CALL_VK(vkFlushMappedMemoryRanges(device.device_, 1, &range));
+  }
   vkUnmapMemory(device.device_, deviceMemory);
 
   CALL_VK(
@@ -633,7 +654,9 @@ void DeleteGraphicsPipeline(void) {
 bool InitVulkan(android_app* app) {
   androidAppCtx = app;
 
-  if (!InitVulkan()) {
+  // Bind libvulkan.so entry points on first use: most of them are never
+  // called by this sample
+  if (!InitVulkanLazy()) {
     LOGW("Vulkan is unavailable, install vulkan and re-start");
     return false;
   }
@@ -738,8 +761,8 @@ bool InitVulkan(android_app* app) {
         .flags = 0,
         .pInheritanceInfo = nullptr,
     };
-    CALL_VK(vkBeginCommandBuffer(render.cmdBuffer_[bufferIndex],
-                                 &cmdBufferBeginInfo));
+    CALL_VK(device.dispatch_.vkBeginCommandBuffer(
+        render.cmdBuffer_[bufferIndex], &cmdBufferBeginInfo));
     // transition the display image to color attachment layout
     setImageLayout(render.cmdBuffer_[bufferIndex],
                    swapchain.displayImages_[bufferIndex],
@@ -760,42 +783,66 @@ bool InitVulkan(android_app* app) {
                        .extent = swapchain.displaySize_},
         .clearValueCount = 1,
         .pClearValues = &clearVals};
-    vkCmdBeginRenderPass(render.cmdBuffer_[bufferIndex], &renderPassBeginInfo,
-                         VK_SUBPASS_CONTENTS_INLINE);
+    device.dispatch_.vkCmdBeginRenderPass(render.cmdBuffer_[bufferIndex],
+                                          &renderPassBeginInfo,
+                                          VK_SUBPASS_CONTENTS_INLINE);
     // Bind what is necessary to the command buffer
-    vkCmdBindPipeline(render.cmdBuffer_[bufferIndex],
-                      VK_PIPELINE_BIND_POINT_GRAPHICS, gfxPipeline.pipeline_);
+    device.dispatch_.vkCmdBindPipeline(render.cmdBuffer_[bufferIndex],
+                                       VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                       gfxPipeline.pipeline_);
     VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(render.cmdBuffer_[bufferIndex], 0, 1,
-                           &buffers.vertexBuf_, &offset);
+    device.dispatch_.vkCmdBindVertexBuffers(render.cmdBuffer_[bufferIndex], 0,
+                                            1, &buffers.vertexBuf_, &offset);
 
     // Draw Triangle
-    vkCmdDraw(render.cmdBuffer_[bufferIndex], 3, 1, 0, 0);
+    device.dispatch_.vkCmdDraw(render.cmdBuffer_[bufferIndex], 3, 1, 0, 0);
 
-    vkCmdEndRenderPass(render.cmdBuffer_[bufferIndex]);
+    device.dispatch_.vkCmdEndRenderPass(render.cmdBuffer_[bufferIndex]);
 
-    CALL_VK(vkEndCommandBuffer(render.cmdBuffer_[bufferIndex]));
+    CALL_VK(
+        device.dispatch_.vkEndCommandBuffer(render.cmdBuffer_[bufferIndex]));
   }
 
-  // We need to create a fence to be able, in the main loop, to wait for our
-  // draw command(s) to finish before swapping the framebuffers
+  // Each frame in flight gets a fence, to wait in the main loop for the GPU
+  // to finish with it before reusing its objects, and a semaphore for the
+  // swapchain to signal once its image can be drawn to.
+  // The semaphores presents wait on are per image instead: nothing tells
+  // when a present is done with one, except that its image is acquired
+  // again.
+  render.framesInFlight_ = framesInFlight;
+  render.frameIndex_ = 0;
+  render.frameFence_.resize(render.framesInFlight_);
+  render.acquireSemaphore_.resize(render.framesInFlight_);
+  render.renderSemaphore_.resize(swapchain.swapchainLength_);
+  render.imageFence_.assign(swapchain.swapchainLength_, VK_NULL_HANDLE);
+
+  // Signaled, so waiting for a frame that was never submitted returns
   VkFenceCreateInfo fenceCreateInfo{
       .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
       .pNext = nullptr,
-      .flags = 0,
+      .flags = VK_FENCE_CREATE_SIGNALED_BIT,
   };
-  CALL_VK(
-      vkCreateFence(device.device_, &fenceCreateInfo, nullptr, &render.fence_));
-
-  // We need to create a semaphore to be able to wait, in the main loop, for our
-  // framebuffer to be available for us before drawing.
   VkSemaphoreCreateInfo semaphoreCreateInfo{
       .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
       .pNext = nullptr,
       .flags = 0,
   };
-  CALL_VK(vkCreateSemaphore(device.device_, &semaphoreCreateInfo, nullptr,
-                            &render.semaphore_));
+  for (uint32_t i = 0; i < render.framesInFlight_; i++) {
+    CALL_VK(vkCreateFence(device.device_, &fenceCreateInfo, nullptr,
+                          &render.frameFence_[i]));
+    CALL_VK(vkCreateSemaphore(device.device_, &semaphoreCreateInfo, nullptr,
+                              &render.acquireSemaphore_[i]));
+  }
+  for (uint32_t i = 0; i < swapchain.swapchainLength_; i++) {
+    CALL_VK(vkCreateSemaphore(device.device_, &semaphoreCreateInfo, nullptr,
+                              &render.renderSemaphore_[i]));
+  }
+
+  VulkanWrapperStats wrapperStats;
+  GetVulkanWrapperStats(&wrapperStats);
+  LOGI("vulkan_wrapper: %u entry points bound, dlopen %.1f us, dlsym %.1f us",
+       wrapperStats.boundSymbols, wrapperStats.loadNanoseconds / 1000.0,
+       wrapperStats.bindNanoseconds / 1000.0);
 
   device.initialized_ = true;
   return true;
@@ -806,6 +853,20 @@ bool InitVulkan(android_app* app) {
 bool IsVulkanReady(void) { return device.initialized_; }
 
 void DeleteVulkan(void) {
+  // Frames in flight may still be using everything below
+  vkDeviceWaitIdle(device.device_);
+  for (uint32_t i = 0; i < render.framesInFlight_; i++) {
+    vkDestroyFence(device.device_, render.frameFence_[i], nullptr);
+    vkDestroySemaphore(device.device_, render.acquireSemaphore_[i], nullptr);
+  }
+  for (VkSemaphore semaphore : render.renderSemaphore_) {
+    vkDestroySemaphore(device.device_, semaphore, nullptr);
+  }
+  render.frameFence_.clear();
+  render.acquireSemaphore_.clear();
+  render.renderSemaphore_.clear();
+  render.imageFence_.clear();
+
   vkFreeCommandBuffers(device.device_, render.cmdPool_, render.cmdBufferLen_,
                        render.cmdBuffer_);
   delete[] render.cmdBuffer_;
@@ -822,29 +883,68 @@ void DeleteVulkan(void) {
   device.initialized_ = false;
 }
 
+void SetFramesInFlight(uint32_t count) {
+  framesInFlight = (count ? count : 1);
+}
+
+void GetVulkanFrameStats(VulkanFrameStats* stats) { *stats = frameStats; }
+
+uint64_t NanosecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Wait for |fence|, adding the time blocked to the frame's stats
+void WaitForFrameFence(VkFence fence) {
+  auto start = std::chrono::steady_clock::now();
+  CALL_VK(device.dispatch_.vkWaitForFences(device.device_, 1, &fence, VK_TRUE,
+                                           UINT64_MAX));
+  frameStats.fenceWaitNanoseconds += NanosecondsSince(start);
+}
+
 // Draw one frame
 bool VulkanDrawFrame(void) {
+  uint32_t frame = render.frameIndex_;
+  render.frameIndex_ = (frame + 1) % render.framesInFlight_;
+  frameStats.fenceWaitNanoseconds = 0;
+
+  // This frame's objects were last used framesInFlight_ frames ago: only
+  // block if the GPU is still that far behind.
+  WaitForFrameFence(render.frameFence_[frame]);
+
   uint32_t nextIndex;
   // Get the framebuffer index we should draw in
-  CALL_VK(vkAcquireNextImageKHR(device.device_, swapchain.swapchain_,
-                                UINT64_MAX, render.semaphore_, VK_NULL_HANDLE,
-                                &nextIndex));
-  CALL_VK(vkResetFences(device.device_, 1, &render.fence_));
+  auto acquireStart = std::chrono::steady_clock::now();
+  CALL_VK(device.dispatch_.vkAcquireNextImageKHR(
+      device.device_, swapchain.swapchain_, UINT64_MAX,
+      render.acquireSemaphore_[frame], VK_NULL_HANDLE, &nextIndex));
+  frameStats.acquireWaitNanoseconds = NanosecondsSince(acquireStart);
+
+  // The image's command buffer is recorded once, and cannot be submitted
+  // again until the frame that last used it retires
+  if (render.imageFence_[nextIndex] != VK_NULL_HANDLE &&
+      render.imageFence_[nextIndex] != render.frameFence_[frame]) {
+    WaitForFrameFence(render.imageFence_[nextIndex]);
+  }
+  render.imageFence_[nextIndex] = render.frameFence_[frame];
+  CALL_VK(device.dispatch_.vkResetFences(device.device_, 1,
+                                         &render.frameFence_[frame]));
 
   VkPipelineStageFlags waitStageMask =
       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  VkSubmitInfo submit_info = {.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                              .pNext = nullptr,
-                              .waitSemaphoreCount = 1,
-                              .pWaitSemaphores = &render.semaphore_,
-                              .pWaitDstStageMask = &waitStageMask,
-                              .commandBufferCount = 1,
-                              .pCommandBuffers = &render.cmdBuffer_[nextIndex],
-                              .signalSemaphoreCount = 0,
-                              .pSignalSemaphores = nullptr};
-  CALL_VK(vkQueueSubmit(device.queue_, 1, &submit_info, render.fence_));
-  CALL_VK(
-      vkWaitForFences(device.device_, 1, &render.fence_, VK_TRUE, 100000000));
+  VkSubmitInfo submit_info = {
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .pNext = nullptr,
+      .waitSemaphoreCount = 1,
+      .pWaitSemaphores = &render.acquireSemaphore_[frame],
+      .pWaitDstStageMask = &waitStageMask,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &render.cmdBuffer_[nextIndex],
+      .signalSemaphoreCount = 1,
+      .pSignalSemaphores = &render.renderSemaphore_[nextIndex]};
+  CALL_VK(device.dispatch_.vkQueueSubmit(device.queue_, 1, &submit_info,
+                                         render.frameFence_[frame]));
 
   LOGI("Drawing frames......");
 
@@ -852,14 +952,27 @@ bool VulkanDrawFrame(void) {
   VkPresentInfoKHR presentInfo{
       .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
       .pNext = nullptr,
-      .waitSemaphoreCount = 0,
-      .pWaitSemaphores = nullptr,
+      .waitSemaphoreCount = 1,
+      .pWaitSemaphores = &render.renderSemaphore_[nextIndex],
       .swapchainCount = 1,
       .pSwapchains = &swapchain.swapchain_,
       .pImageIndices = &nextIndex,
       .pResults = &result,
   };
-  vkQueuePresentKHR(device.queue_, &presentInfo);
+  device.dispatch_.vkQueuePresentKHR(device.queue_, &presentInfo);
+
+  // Blocked time close to the frame time means the CPU is not running
+  // ahead of the GPU
+  static uint64_t blockedNanoseconds = 0;
+  static uint32_t frameCount = 0;
+  blockedNanoseconds +=
+      frameStats.fenceWaitNanoseconds + frameStats.acquireWaitNanoseconds;
+  if (++frameCount == kFrameStatsInterval) {
+    LOGI("%u frames in flight: CPU blocked %.3f ms per frame",
+         render.framesInFlight_, blockedNanoseconds / 1e6 / frameCount);
+    blockedNanoseconds = 0;
+    frameCount = 0;
+  }
   return true;
 }
 
@@ -937,6 +1050,6 @@ void setImageLayout(VkCommandBuffer cmdBuffer, VkImage image,
       break;
   }
 
-  vkCmdPipelineBarrier(cmdBuffer, srcStages, destStages, 0, 0, NULL, 0, NULL, 1,
-                       &imageMemoryBarrier);
+  device.dispatch_.vkCmdPipelineBarrier(cmdBuffer, srcStages, destStages, 0, 0,
+                                        NULL, 0, NULL, 1, &imageMemoryBarrier);
 }
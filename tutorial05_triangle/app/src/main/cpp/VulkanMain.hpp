@@ -14,6 +14,7 @@
 #ifndef __VULKANMAIN_HPP__
 #define __VULKANMAIN_HPP__
 
+#include <cstdint>
 #include <game-activity/native_app_glue/android_native_app_glue.h>
 
 // Initialize vulkan device context
@@ -29,6 +30,18 @@ bool IsVulkanReady(void);
 // Ask Vulkan to Render a frame
 bool VulkanDrawFrame(void);
 
+// Number of frames VulkanDrawFrame() queues before it waits for the GPU to
+// finish the oldest one; with 1, each frame waits for the previous one.
+// Takes effect at the next InitVulkan(), the default is 2.
+void SetFramesInFlight(uint32_t count);
+
+// CPU time the last VulkanDrawFrame() spent blocked on the GPU
+struct VulkanFrameStats {
+  uint64_t fenceWaitNanoseconds;    // for an earlier frame to retire
+  uint64_t acquireWaitNanoseconds;  // in vkAcquireNextImageKHR()
+};
+void GetVulkanFrameStats(VulkanFrameStats* stats);
+
 #endif // __VULKANMAIN_HPP__
 
 
@@ -20,7 +20,18 @@
 layout (location = 0) in vec4 pos;
 layout (location = 1) in vec2 attr;
 layout (location = 0) out vec2 texcoord;
+// Turns the scene to the orientation of the swapchain (pre-rotation):
+// columns of a 2x2 matrix
+layout (push_constant) uniform PreRotation {
+   vec4 rotation;
+} preRotation;
+// Written every frame: the spin of the triangle, columns of a 2x2 matrix
+layout (binding = 1) uniform FrameData {
+   vec4 spin;
+} frameData;
 void main() {
    texcoord = attr;
-   gl_Position = pos;
+   mat2 rotation = mat2(preRotation.rotation.xy, preRotation.rotation.zw);
+   mat2 spin = mat2(frameData.spin.xy, frameData.spin.zw);
+   gl_Position = vec4(rotation * (spin * pos.xy), pos.zw);
 }
@@ -22,8 +22,9 @@ void handle_cmd(android_app* app, int32_t cmd) {
       InitVulkan(app);
       break;
     case APP_CMD_TERM_WINDOW:
-      // The window is being hidden or closed, clean it up.
-      DeleteVulkan();
+      // The window is being hidden or closed, let go of it. The rest stays
+      // for when it comes back.
+      DeleteVulkanSurface();
       break;
     default:
       __android_log_print(ANDROID_LOG_INFO, "Vulkan Tutorials",
@@ -52,4 +53,5 @@ void android_main(struct android_app* app) {
       VulkanDrawFrame();
     }
   } while (app->destroyRequested == 0);
+  DeleteVulkan();
 }
@@ -0,0 +1,70 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <android/log.h>
+#include <android/native_window.h>
+#include <android/trace.h>
+#include <cstdarg>
+#include "Platform.h"
+
+void PlatformLog(PlatformLogPriority priority, const char* tag,
+                 const char* format, ...) {
+  static const int kAndroidPriority[] = {
+      ANDROID_LOG_INFO, ANDROID_LOG_WARN, ANDROID_LOG_ERROR,
+  };
+  va_list args;
+  va_start(args, format);
+  __android_log_vprint(kAndroidPriority[priority], tag, format, args);
+  va_end(args);
+}
+
+bool ReadAsset(PlatformApp* app, const char* path, std::vector<char>* data) {
+  AAsset* file = AAssetManager_open(app->activity->assetManager, path,
+                                    AASSET_MODE_BUFFER);
+  if (!file) return false;
+  data->resize(AAsset_getLength(file));
+  int read = AAsset_read(file, data->data(), data->size());
+  AAsset_close(file);
+  return read == static_cast<int>(data->size());
+}
+
+const char* PlatformDataDir(PlatformApp* app) {
+  return app->activity->internalDataPath;
+}
+
+const char* PlatformSurfaceExtension(void) { return "VK_KHR_android_surface"; }
+
+VkResult CreatePlatformSurface(PlatformApp* app, VkInstance instance,
+                               VkSurfaceKHR* surface) {
+  VkAndroidSurfaceCreateInfoKHR createInfo{
+      .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
+      .pNext = nullptr,
+      .flags = 0,
+      .window = app->window};
+  return vkCreateAndroidSurfaceKHR(instance, &createInfo, nullptr, surface);
+}
+
+VkExtent2D PlatformWindowSize(PlatformApp* app) {
+  return VkExtent2D{
+      .width = static_cast<uint32_t>(ANativeWindow_getWidth(app->window)),
+      .height = static_cast<uint32_t>(ANativeWindow_getHeight(app->window)),
+  };
+}
+
+void PlatformMarkPhase(PlatformApp* app, const char* name) {
+  static bool inPhase = false;
+  if (inPhase) ATrace_endSection();
+  inPhase = (name != nullptr);
+  if (inPhase) ATrace_beginSection(name);
+}
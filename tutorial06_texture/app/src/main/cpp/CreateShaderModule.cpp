@@ -16,7 +16,7 @@
  */
 
 #include "CreateShaderModule.h"
-#include <android/log.h>
+#include <cstdlib>
 #include <shaderc/shaderc.hpp>
 
 // Translate Vulkan Shader Type to shaderc shader type
@@ -35,28 +35,24 @@ shaderc_shader_kind getShadercShaderType(VkShaderStageFlagBits type) {
     case VK_SHADER_STAGE_COMPUTE_BIT:
       return shaderc_glsl_compute_shader;
     default:
-      __android_log_assert("invalid VKShaderStageFlagBits",
-                           "tutorial06_texture", "type = %08x", type);
+      PlatformLog(kLogError, "tutorial06_texture",
+                  "invalid VKShaderStageFlagBits, type = %08x", type);
+      abort();
   }
   return static_cast<shaderc_shader_kind>(-1);
 }
 
 // Create VK shader module from given glsl shader file
 // filePath: glsl shader file (including path ) in APK's asset folder
-VkResult buildShaderFromFile(android_app* appInfo, const char* filePath,
+VkResult buildShaderFromFile(PlatformApp* appInfo, const char* filePath,
                              VkShaderStageFlagBits type, VkDevice vkDevice,
                              VkShaderModule* shaderOut) {
   // read file from Assets
-  AAsset* file = AAssetManager_open(appInfo->activity->assetManager, filePath,
-                                    AASSET_MODE_BUFFER);
-  size_t glslShaderLen = AAsset_getLength(file);
   std::vector<char> glslShader;
-  glslShader.resize(glslShaderLen);
-
-  AAsset_read(file, static_cast<void*>(glslShader.data()), glslShaderLen);
-  AAsset_close(file);
-
-  int shaderCount = glslShaderLen;
+  if (!ReadAsset(appInfo, filePath, &glslShader)) {
+    return VK_ERROR_INITIALIZATION_FAILED;
+  }
+  size_t glslShaderLen = glslShader.size();
 
   // compile into spir-V shader
   shaderc_compiler_t compiler = shaderc_compiler_initialize();
@@ -65,6 +61,8 @@ VkResult buildShaderFromFile(android_app* appInfo, const char* filePath,
       "shaderc_error", "main", nullptr);
   if (shaderc_result_get_compilation_status(spvShader) !=
       shaderc_compilation_status_success) {
+    shaderc_result_release(spvShader);
+    shaderc_compiler_release(compiler);
     return static_cast<VkResult>(-1);
   }
 
@@ -82,8 +80,5 @@ VkResult buildShaderFromFile(android_app* appInfo, const char* filePath,
   shaderc_result_release(spvShader);
   shaderc_compiler_release(compiler);
 
-  static shaderSum = 0;
-  shaderSum += shaderCount;
-  return shaderSum;
-  // return result;
+  return result;
 }
@@ -19,7 +19,7 @@
 #define TUTORIAL06_TEXTURE_CREATESHADERMODULE_H
 
 #include <vulkan_wrapper.h>
-#include <game-activity/native_app_glue/android_native_app_glue.h>
+#include "Platform.h"
 /*
  * buildShaderFromFile()
  *   Create a Vulkan shader module from the given glsl shader file
@@ -32,7 +32,7 @@
  *
  *   feedback for CDep is very welcome to the https://github.com/google/cdep
  * Input:
- *     appInfo:   android_app, from which get AAssertManager*
+ *     appInfo:   PlatformApp, to read the asset from
  *     filePaht:  shader file full name with path inside APK/assets
  *     type:      borrowed VK's shader type to indicate which glsl shader it is
  *     vkDevice:  Vulkan logical device
@@ -44,7 +44,7 @@
  */
 
 VkResult buildShaderFromFile(
-    android_app* appInfo,
+    PlatformApp* appInfo,
     const char* filePath,
     VkShaderStageFlagBits type,
     VkDevice vkDevice,
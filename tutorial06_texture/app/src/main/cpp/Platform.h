@@ -0,0 +1,68 @@
+// Copyright 2016 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TUTORIAL06_TEXTURE_PLATFORM_H
+#define TUTORIAL06_TEXTURE_PLATFORM_H
+
+// The few things the renderer needs from the OS. AndroidPlatform.cpp backs
+// them with the NativeActivity glue; host/tutorial06_bench backs them with
+// the filesystem and a VK_EXT_headless_surface, so the same VulkanMain.cpp
+// runs as a Linux executable.
+#include <vector>
+#include <vulkan_wrapper.h>
+
+#ifdef __ANDROID__
+#include <game-activity/native_app_glue/android_native_app_glue.h>
+typedef android_app PlatformApp;
+#else
+struct HostApp;
+typedef HostApp PlatformApp;
+#endif
+
+enum PlatformLogPriority {
+  kLogInfo,
+  kLogWarn,
+  kLogError,
+};
+
+// printf-style logging, to logcat on Android
+void PlatformLog(PlatformLogPriority priority, const char* tag,
+                 const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// Read the whole asset at |path| (relative to the asset root) into |data|.
+// Returns false if it could not be read.
+bool ReadAsset(PlatformApp* app, const char* path, std::vector<char>* data);
+
+// Writable directory for files the app creates, such as traces
+const char* PlatformDataDir(PlatformApp* app);
+
+// Name of the instance extension CreatePlatformSurface() needs, on top of
+// VK_KHR_surface
+const char* PlatformSurfaceExtension(void);
+
+// Create the surface to present to, for an instance with
+// PlatformSurfaceExtension() enabled
+VkResult CreatePlatformSurface(PlatformApp* app, VkInstance instance,
+                               VkSurfaceKHR* surface);
+
+// Size to use when the surface leaves the swapchain extent to the app
+VkExtent2D PlatformWindowSize(PlatformApp* app);
+
+// Start the named phase of initialization and end the previous one; nullptr
+// ends the last phase. Shows as a trace section on Android, and is timed by
+// the host benchmark.
+void PlatformMarkPhase(PlatformApp* app, const char* name);
+
+#endif  // TUTORIAL06_TEXTURE_PLATFORM_H
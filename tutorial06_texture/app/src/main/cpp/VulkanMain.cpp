@@ -12,32 +12,48 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <android/log.h>
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
 #include <vector>
 #include "vulkan_wrapper.h"
+#ifdef ENABLE_VULKAN_CAPTURE
+#include "vulkan_capture.h"
+#endif
 #define STB_IMAGE_IMPLEMENTATION
 #define STBI_ONLY_PNG
 #include <stb/stb_image.h>
 #include "CreateShaderModule.h"
+#include "DeletionQueue.hpp"
+#include "DepthBuffer.hpp"
+#include "DynamicRendering.hpp"
+#include "FrameRing.hpp"
+#include "Ktx2Texture.hpp"
+#include "MemoryAllocator.hpp"
+#include "PixelCopy.hpp"
+#include "Platform.h"
+#include "QueueTopology.hpp"
+#include "StagingRing.hpp"
+#include "SwapchainPolicy.hpp"
+#include "TextureStreamer.hpp"
+#include "TextureUploadBatch.hpp"
 #include "VulkanMain.hpp"
 
-// Android log function wrappers
+// Log function wrappers
 static const char* kTAG = "Vulkan-Tutorial06";
-#define LOGI(...) \
-  ((void)__android_log_print(ANDROID_LOG_INFO, kTAG, __VA_ARGS__))
-#define LOGW(...) \
-  ((void)__android_log_print(ANDROID_LOG_WARN, kTAG, __VA_ARGS__))
-#define LOGE(...) \
-  ((void)__android_log_print(ANDROID_LOG_ERROR, kTAG, __VA_ARGS__))
+#define LOGI(...) ((void)PlatformLog(kLogInfo, kTAG, __VA_ARGS__))
+#define LOGW(...) ((void)PlatformLog(kLogWarn, kTAG, __VA_ARGS__))
+#define LOGE(...) ((void)PlatformLog(kLogError, kTAG, __VA_ARGS__))
 
 // Vulkan call wrapper
-#define CALL_VK(func)                                                 \
-  if (VK_SUCCESS != (func)) {                                         \
-    __android_log_print(ANDROID_LOG_ERROR, "Tutorial ",               \
-                        "Vulkan error. File[%s], line[%d]", __FILE__, \
-                        __LINE__);                                    \
-    assert(false);                                                    \
+#define CALL_VK(func)                                                        \
+  if (VK_SUCCESS != (func)) {                                                \
+    PlatformLog(kLogError, "Tutorial ", "Vulkan error. File[%s], line[%d]", \
+                __FILE__, __LINE__);                                         \
+    assert(false);                                                           \
   }
 
 // A macro to check value is VK_SUCCESS
@@ -50,26 +66,55 @@ struct VulkanDeviceInfo {
 
   VkInstance instance_;
   VkPhysicalDevice gpuDevice_;
-  VkPhysicalDeviceMemoryProperties gpuMemoryProperties_;
   VkDevice device_;
   uint32_t queueFamilyIndex_;
 
   VkSurfaceKHR surface_;
-  VkQueue queue_;
+  VkQueue queue_;  // graphics, queueFamilyIndex_'s
+
+  // Transfer and compute queues, next to graphics where the GPU has them
+  QueueTopology queues_;
+
+  // Driver entry points for device_: command recording and the per-frame
+  // calls go through here instead of the libvulkan.so trampolines
+  VkDeviceDispatchTable dispatch_;
+
+  // Enabled when the device has it, to time presents up to the display
+  PresentWaitFeatures presentWait_;
+  // Queried when dynamic rendering is asked for
+  DynamicRenderingSupport dynamicRendering_;
+  // VK_EXT_memory_budget, enabled when the device has it
+  MemoryBudgetSupport memoryBudget_;
+  // Enabled: the texture compression formats the device has
+  VkPhysicalDeviceFeatures features_;
+
+  // Where buffer and image memory comes from
+  MemoryAllocator* allocator_;
+  // Objects the GPU may still use, keyed by the frame serial retiring them
+  DeletionQueue deletionQueue_;
+  // Where uploads are copied from, retired by frame serial too
+  StagingRing staging_;
 };
 VulkanDeviceInfo device;
 
 struct VulkanSwapchainInfo {
+  bool initialized_;  // there is a window to draw to
+
   VkSwapchainKHR swapchain_;
   uint32_t swapchainLength_;
 
   VkExtent2D displaySize_;
   VkFormat displayFormat_;
+  PreRotation preRotation_;  // pushed to the vertex shader
 
   // array of frame buffers and views
   VkFramebuffer* framebuffers_;
   VkImage* displayImages_;
   VkImageView* displayViews_;
+
+  // Shared by every framebuffer: it is cleared on load and dropped on
+  // store, so no frame sees another's depth
+  DepthBuffer depth_;
 };
 VulkanSwapchainInfo swapchain;
 
@@ -77,27 +122,51 @@ typedef struct texture_object {
   VkSampler sampler;
   VkImage image;
   VkImageLayout imageLayout;
-  VkDeviceMemory mem;
+  MemoryAllocation mem;
   VkImageView view;
   int32_t tex_width;
   int32_t tex_height;
+  VkFormat format;
+  uint32_t mipLevels;
+  VkDeviceSize bytes;  // of every level
+  bool resident;  // its upload retired, so frames sample it
 } texture_object;
 static const VkFormat kTexFmt = VK_FORMAT_R8G8B8A8_UNORM;
+// The textures drawn
 #define TUTORIAL_TEXTURE_COUNT 1
 const char* texFiles[TUTORIAL_TEXTURE_COUNT] = {
     "sample_tex.png",
 };
-struct texture_object textures[TUTORIAL_TEXTURE_COUNT];
+// The drawn textures first, then any more SetTextureCount() asked for,
+// loaded from texFiles in turn
+std::vector<texture_object> textures;
+uint32_t textureCount = TUTORIAL_TEXTURE_COUNT;
+uint32_t textureWorkers = 0;  // 0: a worker per core
+// Bound in place of the textures until they are resident
+struct texture_object placeholderTexture;
+// Decodes textures[i] as request i, in the background, on a worker per
+// core. They are uploaded in the order they finish.
+TextureStreamer textureStreamer;
+// Counts the textures made resident, for frames to see their descriptors
+// are out of date
+uint32_t textureGeneration = 0;
 
 struct VulkanBufferInfo {
   VkBuffer vertexBuf_;
+  MemoryAllocation vertexMem_;
+
+  // What tri.vert's FrameData is written to each frame
+  FrameRing frameData_;
 };
 VulkanBufferInfo buffers;
 
 struct VulkanGfxPipelineInfo {
   VkDescriptorSetLayout dscLayout_;
   VkDescriptorPool descPool_;
-  VkDescriptorSet descSet_;
+  // Per frame in flight, as the textures it binds change while the others
+  // are drawn; with the textureGeneration they were written at
+  std::vector<VkDescriptorSet> descSets_;
+  std::vector<uint32_t> descGeneration_;
   VkPipelineLayout layout_;
   VkPipelineCache cache_;
   VkPipeline pipeline_;
@@ -105,30 +174,71 @@ struct VulkanGfxPipelineInfo {
 VulkanGfxPipelineInfo gfxPipeline;
 
 struct VulkanRenderInfo {
+  // With dynamic rendering, there is no render pass nor framebuffers; the
+  // command buffers begin rendering to the swapchain's views instead.
+  bool dynamicRendering_;
+  PFN_vkCmdBeginRenderingKHR beginRendering_;
+  PFN_vkCmdEndRenderingKHR endRendering_;
   VkRenderPass renderPass_;
+  VkFormat depthFormat_;
   VkCommandPool cmdPool_;
   VkCommandBuffer* cmdBuffer_;
   uint32_t cmdBufferLen_;
-  VkSemaphore semaphore_;
-  VkFence fence_;
+
+  // Up to framesInFlight_ frames are queued before VulkanDrawFrame() waits
+  // on the GPU; frameIndex_ cycles through their sync objects.
+  uint32_t framesInFlight_;
+  uint32_t frameIndex_;
+  std::vector<VkFence> frameFence_;            // the frame's submit retired
+  std::vector<uint64_t> frameSerial_;          // of the frame's last submit
+  uint64_t submitSerial_;                      // frames submitted so far
+  std::vector<VkSemaphore> acquireSemaphore_;  // the frame's image is ready
+  // Per swapchain image: rendering to it is done, and the frame fence of the
+  // last submit using its command buffer.
+  std::vector<VkSemaphore> renderSemaphore_;
+  std::vector<VkFence> imageFence_;
 };
 VulkanRenderInfo render;
 
-// Android Native App pointer...
-android_app* androidAppCtx = nullptr;
+// Settings and stats for VulkanDrawFrame()
+uint32_t framesInFlight = 2;
+SwapchainProfile swapchainProfile = kSwapchainHighThroughput;
+bool useDynamicRendering = true;
+bool forceStagingUpload = false;
+TextureMipmaps textureMipmaps = kTextureMipmapsAuto;
+uint32_t swapchainImageCount = 0;  // 0: what swapchainProfile asks for
+VulkanFrameStats frameStats;
+PresentLatencyTracker presentLatency;
+const uint32_t kFrameStatsInterval = 300;  // frames between stats logs
+
+// tri.vert's FrameData
+struct FrameData {
+  float spin[4];
+};
+const VkDeviceSize kFrameRingBytesPerFrame = 4096;
+// A 1024x1024 RGBA texture
+const VkDeviceSize kStagingRingBytes = 4 << 20;
+// Uploaded by a frame, past the first texture; half of the staging ring,
+// so a frame's uploads fit in it while the previous frame's retire
+const VkDeviceSize kStreamBytesPerFrame = kStagingRingBytes / 2;
+const double kSpinRadiansPerSecond = 0.5;
+const double kTwoPi = 6.283185307179586;
+std::chrono::steady_clock::time_point animationStart;
+
+// Native App pointer...
+PlatformApp* appCtx = nullptr;
 void setImageLayout(VkCommandBuffer cmdBuffer, VkImage image,
                     VkImageLayout oldImageLayout, VkImageLayout newImageLayout,
                     VkPipelineStageFlags srcStages,
                     VkPipelineStageFlags destStages);
 
 // Create vulkan device
-void CreateVulkanDevice(ANativeWindow* platformWindow,
-                        VkApplicationInfo* appInfo) {
+void CreateVulkanDevice(PlatformApp* app, VkApplicationInfo* appInfo) {
   std::vector<const char*> instance_extensions;
   std::vector<const char*> device_extensions;
 
   instance_extensions.push_back("VK_KHR_surface");
-  instance_extensions.push_back("VK_KHR_android_surface");
+  instance_extensions.push_back(PlatformSurfaceExtension());
 
   device_extensions.push_back("VK_KHR_swapchain");
 
@@ -145,14 +255,7 @@ void CreateVulkanDevice(ANativeWindow* platformWindow,
       .ppEnabledExtensionNames = instance_extensions.data(),
   };
   CALL_VK(vkCreateInstance(&instanceCreateInfo, nullptr, &device.instance_));
-  VkAndroidSurfaceCreateInfoKHR createInfo{
-      .sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR,
-      .pNext = nullptr,
-      .flags = 0,
-      .window = platformWindow};
-
-  CALL_VK(vkCreateAndroidSurfaceKHR(device.instance_, &createInfo, nullptr,
-                                    &device.surface_));
+  CALL_VK(CreatePlatformSurface(app, device.instance_, &device.surface_));
   // Find one GPU to use:
   // On Android, every GPU device is equal -- supporting
   // graphics/compute/present
@@ -163,59 +266,99 @@ void CreateVulkanDevice(ANativeWindow* platformWindow,
   CALL_VK(vkEnumeratePhysicalDevices(device.instance_, &gpuCount, tmpGpus));
   device.gpuDevice_ = tmpGpus[0];  // Pick up the first GPU Device
 
-  vkGetPhysicalDeviceMemoryProperties(device.gpuDevice_,
-                                      &device.gpuMemoryProperties_);
-
-  // Find a GFX queue family
-  uint32_t queueFamilyCount;
-  vkGetPhysicalDeviceQueueFamilyProperties(device.gpuDevice_, &queueFamilyCount,
-                                           nullptr);
-  assert(queueFamilyCount);
-  std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
-  vkGetPhysicalDeviceQueueFamilyProperties(device.gpuDevice_, &queueFamilyCount,
-                                           queueFamilyProperties.data());
-
-  uint32_t queueFamilyIndex;
-  for (queueFamilyIndex = 0; queueFamilyIndex < queueFamilyCount;
-       queueFamilyIndex++) {
-    if (queueFamilyProperties[queueFamilyIndex].queueFlags &
-        VK_QUEUE_GRAPHICS_BIT) {
-      break;
-    }
+  QueryPresentWait(device.instance_, device.gpuDevice_, appInfo->apiVersion,
+                   &device_extensions, &device.presentWait_);
+  memset(&device.dynamicRendering_, 0, sizeof(device.dynamicRendering_));
+#ifdef ENABLE_VULKAN_CAPTURE
+  // Capture drops pNext chains, VkPipelineRenderingCreateInfo among them,
+  // and does not record vkCmdBeginRendering(): for the trace to replay,
+  // draw through a VkRenderPass
+  bool wantDynamicRendering = false;
+#else
+  bool wantDynamicRendering = useDynamicRendering;
+#endif
+  if (wantDynamicRendering) {
+    QueryDynamicRendering(device.instance_, device.gpuDevice_,
+                          appInfo->apiVersion, &device_extensions,
+                          &device.dynamicRendering_);
   }
-  assert(queueFamilyIndex < queueFamilyCount);
-  device.queueFamilyIndex_ = queueFamilyIndex;
-  // Create a logical device (vulkan device)
-  float priorities[] = {
-      1.0f,
-  };
-  VkDeviceQueueCreateInfo queueCreateInfo{
-      .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-      .pNext = nullptr,
-      .flags = 0,
-      .queueFamilyIndex = device.queueFamilyIndex_,
-      .queueCount = 1,
-      .pQueuePriorities = priorities,
-  };
+  QueryMemoryBudget(device.instance_, device.gpuDevice_, appInfo->apiVersion,
+                    &device_extensions, &device.memoryBudget_);
+  memset(&device.features_, 0, sizeof(device.features_));
+  QueryTextureCompression(device.gpuDevice_, &device.features_);
+  // Chain the features to enable
+  void* features = nullptr;
+  if (device.dynamicRendering_.supported) {
+    device.dynamicRendering_.features.pNext = features;
+    features = &device.dynamicRendering_.features;
+  }
+  if (device.presentWait_.supported) {
+    device.presentWait_.presentWait.pNext = features;
+    features = &device.presentWait_.presentId;
+  }
+
+  // Graphics, plus transfer and compute queues where the GPU has them
+  bool hasGraphics = DiscoverQueueTopology(device.gpuDevice_, device.surface_,
+                                           &device.queues_);
+  assert(hasGraphics);
+  device.queueFamilyIndex_ = device.queues_.family[kQueueGraphics];
+  std::vector<VkDeviceQueueCreateInfo> queueCreateInfos =
+      QueueCreateInfos(device.queues_);
 
   VkDeviceCreateInfo deviceCreateInfo{
       .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-      .pNext = nullptr,
-      .queueCreateInfoCount = 1,
-      .pQueueCreateInfos = &queueCreateInfo,
+      .pNext = features,
+      .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
+      .pQueueCreateInfos = queueCreateInfos.data(),
       .enabledLayerCount = 0,
       .ppEnabledLayerNames = nullptr,
       .enabledExtensionCount = static_cast<uint32_t>(device_extensions.size()),
       .ppEnabledExtensionNames = device_extensions.data(),
-      .pEnabledFeatures = nullptr,
+      .pEnabledFeatures = &device.features_,
   };
 
   CALL_VK(vkCreateDevice(device.gpuDevice_, &deviceCreateInfo, nullptr,
                          &device.device_));
-  vkGetDeviceQueue(device.device_, 0, 0, &device.queue_);
+  InitVulkanDeviceDispatchTable(device.device_, &device.dispatch_);
+  GetTopologyQueues(device.device_, &device.queues_);
+  device.queue_ = device.queues_.queue[kQueueGraphics];
+  device.allocator_ = new MemoryAllocator(device.gpuDevice_, device.device_,
+                                          &device.memoryBudget_);
+  device.deletionQueue_.Create(device.device_, device.allocator_);
+  if (!device.staging_.Create(device.gpuDevice_, device.device_,
+                              device.allocator_, kStagingRingBytes)) {
+    LOGW("No staging ring: uploads stage in buffers of their own");
+  }
+  const MemoryTypeSelector& memoryTypes = device.allocator_->Selector();
+  LOGI("Memory types: gpu only %d, upload %d, dynamic %d, readback %d, "
+       "transient %d",
+       memoryTypes.Select(kMemoryUsageGpuOnly, ~0u),
+       memoryTypes.Select(kMemoryUsageUpload, ~0u),
+       memoryTypes.Select(kMemoryUsageDynamic, ~0u),
+       memoryTypes.Select(kMemoryUsageReadback, ~0u),
+       memoryTypes.Select(kMemoryUsageTransient, ~0u));
+  const QueueTopology& queues = device.queues_;
+  LOGI("Queues (family/index): graphics %u/%u, transfer %u/%u, compute %u/%u",
+       queues.family[kQueueGraphics], queues.index[kQueueGraphics],
+       queues.family[kQueueTransfer], queues.index[kQueueTransfer],
+       queues.family[kQueueCompute], queues.index[kQueueCompute]);
+
+  const DynamicRenderingSupport& dynamicRendering = device.dynamicRendering_;
+  render.dynamicRendering_ = dynamicRendering.supported;
+  render.beginRendering_ = dynamicRendering.core
+                               ? device.dispatch_.vkCmdBeginRendering
+                               : device.dispatch_.vkCmdBeginRenderingKHR;
+  render.endRendering_ = dynamicRendering.core
+                             ? device.dispatch_.vkCmdEndRendering
+                             : device.dispatch_.vkCmdEndRenderingKHR;
+  LOGI("Rendering with %s", render.dynamicRendering_
+                                ? "dynamic rendering"
+                                : "a render pass and framebuffers");
 }
 
-void CreateSwapChain(void) {
+// |oldSwapchain|, if any, is retired by the new swapchain but left for the
+// caller to destroy.
+void CreateSwapChain(VkSwapchainKHR oldSwapchain) {
   LOGI("->createSwapChain");
   memset(&swapchain, 0, sizeof(swapchain));
 
@@ -242,30 +385,45 @@ void CreateSwapChain(void) {
   }
   assert(chosenFormat < formatCount);
 
-  swapchain.displaySize_ = surfaceCapabilities.currentExtent;
+  // A surface without a size of its own, such as a headless one, lets the
+  // swapchain decide
+  if (surfaceCapabilities.currentExtent.width == 0xFFFFFFFF) {
+    surfaceCapabilities.currentExtent = PlatformWindowSize(appCtx);
+  }
+  // Render in the display's orientation rather than the app's, the
+  // compositor would otherwise rotate every frame
+  swapchain.preRotation_ = ChoosePreRotation(
+      surfaceCapabilities, surfaceCapabilities.currentExtent);
+  swapchain.displaySize_ = swapchain.preRotation_.extent;
   swapchain.displayFormat_ = formats[chosenFormat].format;
 
+  SwapchainPolicy policy =
+      ChooseSwapchainPolicy(device.gpuDevice_, device.surface_,
+                            surfaceCapabilities, swapchainProfile,
+                            swapchainImageCount);
+  LOGI("Swapchain: %s, %u images", PresentModeName(policy.presentMode),
+       policy.minImageCount);
+
   // **********************************************************
-  // Create a swap chain (here we choose the minimum available number of surface
-  // in the chain)
+  // Create a swap chain with the present mode and length of the policy
   VkSwapchainCreateInfoKHR swapchainCreateInfo{
       .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
       .pNext = nullptr,
       .surface = device.surface_,
-      .minImageCount = surfaceCapabilities.minImageCount,
+      .minImageCount = policy.minImageCount,
       .imageFormat = formats[chosenFormat].format,
       .imageColorSpace = formats[chosenFormat].colorSpace,
-      .imageExtent = surfaceCapabilities.currentExtent,
+      .imageExtent = swapchain.displaySize_,
       .imageArrayLayers = 1,
       .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
       .imageSharingMode = VK_SHARING_MODE_EXCLUSIVE,
       .queueFamilyIndexCount = 1,
       .pQueueFamilyIndices = &device.queueFamilyIndex_,
-      .preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
+      .preTransform = swapchain.preRotation_.transform,
       .compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
-      .presentMode = VK_PRESENT_MODE_FIFO_KHR,
+      .presentMode = policy.presentMode,
       .clipped = VK_FALSE,
-      .oldSwapchain = VK_NULL_HANDLE,
+      .oldSwapchain = oldSwapchain,
   };
   CALL_VK(vkCreateSwapchainKHR(device.device_, &swapchainCreateInfo, nullptr,
                                &swapchain.swapchain_));
@@ -274,23 +432,41 @@ void CreateSwapChain(void) {
   CALL_VK(vkGetSwapchainImagesKHR(device.device_, swapchain.swapchain_,
                                   &swapchain.swapchainLength_, nullptr));
   delete[] formats;
+
+  presentLatency.Reset(device.device_, swapchain.swapchain_,
+                       device.presentWait_.supported
+                           ? device.dispatch_.vkWaitForPresentKHR
+                           : nullptr);
   LOGI("<-createSwapChain");
 }
 
-void DeleteSwapChain(void) {
+void DeleteFrameBuffers(void) {
   for (int i = 0; i < swapchain.swapchainLength_; i++) {
-    vkDestroyFramebuffer(device.device_, swapchain.framebuffers_[i], nullptr);
+    if (swapchain.framebuffers_) {
+      vkDestroyFramebuffer(device.device_, swapchain.framebuffers_[i],
+                           nullptr);
+    }
     vkDestroyImageView(device.device_, swapchain.displayViews_[i], nullptr);
   }
   delete[] swapchain.framebuffers_;
+  swapchain.framebuffers_ = nullptr;
   delete[] swapchain.displayViews_;
   delete[] swapchain.displayImages_;
-
-  vkDestroySwapchainKHR(device.device_, swapchain.swapchain_, nullptr);
+  DestroyDepthBuffer(device.device_, &swapchain.depth_);
 }
 
-void CreateFrameBuffers(VkRenderPass& renderPass,
-                        VkImageView depthView = VK_NULL_HANDLE) {
+void CreateFrameBuffers(VkRenderPass& renderPass) {
+  // Depth comes first: it is attached however the frame is rendered
+  bool hasDepth = CreateDepthBuffer(
+      device.gpuDevice_, device.device_, device.allocator_->Selector(),
+      swapchain.displaySize_, false, &swapchain.depth_,
+      &device.allocator_->Budget());
+  assert(hasDepth && swapchain.depth_.format == render.depthFormat_);
+  LOGI("depth buffer: format %d, %llu bytes, %s", swapchain.depth_.format,
+       static_cast<unsigned long long>(swapchain.depth_.allocationSize),
+       swapchain.depth_.lazilyAllocated ? "lazily allocated"
+                                        : "committed up front");
+
   // query display attachment to swapchain
   uint32_t SwapchainImagesCount = 0;
   CALL_VK(vkGetSwapchainImagesKHR(device.device_, swapchain.swapchain_,
@@ -330,347 +506,501 @@ void CreateFrameBuffers(VkRenderPass& renderPass,
                               &swapchain.displayViews_[i]));
   }
 
-  // create a framebuffer from each swapchain image
+  // create a framebuffer from each swapchain image, unless dynamic rendering
+  // draws to the views themselves
+  if (renderPass == VK_NULL_HANDLE) return;
   swapchain.framebuffers_ = new VkFramebuffer[swapchain.swapchainLength_];
   for (uint32_t i = 0; i < swapchain.swapchainLength_; i++) {
     VkImageView attachments[2] = {
-        swapchain.displayViews_[i], depthView,
+        swapchain.displayViews_[i], swapchain.depth_.view,
     };
     VkFramebufferCreateInfo fbCreateInfo{
         .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
         .pNext = nullptr,
         .renderPass = renderPass,
-        .attachmentCount = 1,  // 2 if using depth
+        .attachmentCount = 2,
         .pAttachments = attachments,
         .width = static_cast<uint32_t>(swapchain.displaySize_.width),
         .height = static_cast<uint32_t>(swapchain.displaySize_.height),
         .layers = 1,
     };
-    fbCreateInfo.attachmentCount = (depthView == VK_NULL_HANDLE ? 1 : 2);
 
     CALL_VK(vkCreateFramebuffer(device.device_, &fbCreateInfo, nullptr,
                                 &swapchain.framebuffers_[i]));
   }
 }
 
-// A help function to map required memory property into a VK memory type
-// memory type is an index into the array of 32 entries; or the bit index
-// for the memory type ( each BIT of an 32 bit integer is a type ).
-VkResult AllocateMemoryTypeFromProperties(uint32_t typeBits,
-                                          VkFlags requirements_mask,
-                                          uint32_t* typeIndex) {
-  // Search memtypes to find first index with those properties
-  for (uint32_t i = 0; i < 32; i++) {
-    if ((typeBits & 1) == 1) {
-      // Type is available, does it match user properties?
-      if ((device.gpuMemoryProperties_.memoryTypes[i].propertyFlags &
-           requirements_mask) == requirements_mask) {
-        *typeIndex = i;
-        return VK_SUCCESS;
-      }
+// Takes the levels of the KTX2 |file| as they are, when the device samples
+// their format. Supercompressed files, and Basis Universal ones, are not
+// loaded.
+bool DecodeKtx2(const char* name, const std::vector<char>& file,
+                DecodedTexture* texture) {
+  Ktx2Texture ktx;
+  if (!ParseKtx2(file.data(), file.size(), &ktx)) {
+    LOGE("Cannot parse KTX2 texture %s", name);
+    return false;
+  }
+  if (ktx.supercompression != Ktx2Texture::kSupercompressionNone) {
+    LOGE("%s has supercompression scheme %u, which is not supported", name,
+         ktx.supercompression);
+    return false;
+  }
+  BlockFormat block;
+  if (!GetBlockFormat(ktx.format, &block) ||
+      !IsFormatSampled(device.gpuDevice_, device.features_, ktx.format)) {
+    LOGE("%s is in format %d, which the device does not sample", name,
+         ktx.format);
+    return false;
+  }
+  uint32_t mipLevels =
+      (textureMipmaps == kTextureMipmapsNone) ? 1 : ktx.mipLevels;
+  uint64_t size = 0;
+  for (uint32_t level = 0; level < mipLevels; level++) {
+    size += ktx.levels[level].size;
+  }
+  texture->pixels = static_cast<unsigned char*>(malloc(size));
+  if (!texture->pixels) return false;
+  uint64_t offset = 0;
+  for (uint32_t level = 0; level < mipLevels; level++) {
+    memcpy(texture->pixels + offset, file.data() + ktx.levels[level].offset,
+           ktx.levels[level].size);
+    offset += ktx.levels[level].size;
+  }
+  texture->width = ktx.width;
+  texture->height = ktx.height;
+  texture->channels = 0;
+  texture->format = ktx.format;
+  texture->mipLevels = mipLevels;
+  texture->size = size;
+  return true;
+}
+
+// Reads and decodes |name|, on a textureStreamer worker. RGB and RGBA are
+// decoded as they are, and made RGBA as they are copied to the texture;
+// grey is expanded by stb_image. KTX2 files keep their compressed blocks.
+bool DecodeTexture(void* context, const char* name, DecodedTexture* texture) {
+  std::vector<char> fileContent;
+  if (!ReadAsset(static_cast<PlatformApp*>(context), name, &fileContent)) {
+    LOGE("Cannot read texture %s", name);
+    return false;
+  }
+  if (IsKtx2(fileContent.data(), fileContent.size())) {
+    return DecodeKtx2(name, fileContent, texture);
+  }
+  const stbi_uc* fileBytes =
+      reinterpret_cast<const stbi_uc*>(fileContent.data());
+  int fileSize = static_cast<int>(fileContent.size());
+  int width, height, n;
+  if (!stbi_info_from_memory(fileBytes, fileSize, &width, &height, &n)) {
+    LOGE("Cannot decode texture %s", name);
+    return false;
+  }
+  int channels = (n == 3 || n == 4) ? 0 : 4;
+  texture->pixels = stbi_load_from_memory(fileBytes, fileSize, &width,
+                                          &height, &n, channels);
+  if (!texture->pixels) {
+    LOGE("Cannot decode texture %s", name);
+    return false;
+  }
+  texture->width = width;
+  texture->height = height;
+  texture->channels = channels ? channels : n;
+  return true;
+}
+
+void ReleaseTexture(void* context, DecodedTexture* texture) {
+  if (texture->channels) {
+    stbi_image_free(texture->pixels);
+  } else {
+    free(texture->pixels);
+  }
+}
+
+// Averages the levels after the first of |regions| from |texels|, on the
+// CPU, writing them at their offsets from |staged|. Each is made from the
+// one above in cached memory: staging memory may be write combined, and
+// slow to read back.
+void StageMipLevels(const DecodedTexture& texels,
+                    const std::vector<VkBufferImageCopy>& regions,
+                    uint8_t* staged) {
+  if (regions.size() < 2) return;
+  uint32_t width = texels.width, height = texels.height;
+  std::vector<uint8_t> above, level;
+  const uint8_t* src = texels.pixels;
+  if (texels.channels != 4) {
+    above.resize(width * 4ull * height);
+    CopyPixelsToRgba(texels.pixels, texels.channels, width, height,
+                     above.data(), width * 4ull, 0);
+    src = above.data();
+  }
+  for (size_t i = 1; i < regions.size(); i++) {
+    const VkExtent3D& extent = regions[i].imageExtent;
+    uint64_t rowBytes = extent.width * 4ull;
+    level.resize(rowBytes * extent.height);
+    DownsampleRgba(src, width, height, width * 4ull, level.data(), rowBytes);
+    uint8_t* dst = staged + regions[i].bufferOffset;
+    for (uint32_t y = 0; y < extent.height; y++) {
+      memcpy(dst + y * regions[i].bufferRowLength * 4ull,
+             level.data() + y * rowBytes, rowBytes);
+    }
+    above.swap(level);
+    src = above.data();
+    width = extent.width;
+    height = extent.height;
+  }
+}
+
+// Copies the levels of compressed |texels| to |regions|' offsets in |staged|,
+// a row of blocks at a time
+void StageBlocks(const DecodedTexture& texels, const BlockFormat& block,
+                 const std::vector<VkBufferImageCopy>& regions,
+                 uint8_t* staged) {
+  const uint8_t* src = texels.pixels;
+  for (const VkBufferImageCopy& region : regions) {
+    uint32_t blocksWide =
+        (region.imageExtent.width + block.blockWidth - 1) / block.blockWidth;
+    uint32_t rows =
+        (region.imageExtent.height + block.blockHeight - 1) / block.blockHeight;
+    uint64_t rowBytes = uint64_t(blocksWide) * block.blockBytes;
+    uint64_t rowPitch =
+        uint64_t(region.bufferRowLength / block.blockWidth) * block.blockBytes;
+    uint8_t* dst = staged + region.bufferOffset;
+    for (uint32_t y = 0; y < rows; y++) {
+      memcpy(dst + y * rowPitch, src + y * rowBytes, rowBytes);
     }
-    typeBits >>= 1;
+    src += rowBytes * rows;
   }
-  // No memory types matched, return failure
-  return VK_ERROR_MEMORY_MAP_FAILED;
 }
 
-VkResult LoadTextureFromFile(const char* filePath,
-                             struct texture_object* tex_obj,
-                             VkImageUsageFlags usage, VkFlags required_props) {
+// Undoes an UploadTexture() that failed before recording any commands, so
+// that a texture marked failed holds nothing until DeleteVulkan()
+void DestroyUnusedImage(struct texture_object* tex_obj) {
+  vkDestroyImage(device.device_, tex_obj->image, nullptr);
+  tex_obj->image = VK_NULL_HANDLE;
+  device.allocator_->Free(&tex_obj->mem);
+}
+
+// Creates |tex_obj| from |texels|, with the commands finishing the upload
+// added to |batch|
+VkResult UploadTexture(const DecodedTexture& texels,
+                       struct texture_object* tex_obj,
+                       VkImageUsageFlags usage, VkFlags required_props,
+                       TextureUploadBatch* batch) {
   if (!(usage | required_props)) {
-    __android_log_print(ANDROID_LOG_ERROR, "tutorial texture",
-                        "No usage and required_pros");
+    PlatformLog(kLogError, "tutorial texture", "No usage and required_pros");
     return VK_ERROR_FORMAT_NOT_SUPPORTED;
   }
 
+  // Blocks are uploaded in their own format, decoded texels as kTexFmt
+  bool blocks = !texels.channels;
+  VkFormat format = blocks ? static_cast<VkFormat>(texels.format) : kTexFmt;
+  BlockFormat block;
+  if (!GetBlockFormat(format, &block)) return VK_ERROR_FORMAT_NOT_SUPPORTED;
+
   // Check for linear supportability
   VkFormatProperties props;
   bool needBlit = true;
-  vkGetPhysicalDeviceFormatProperties(device.gpuDevice_, kTexFmt, &props);
+  vkGetPhysicalDeviceFormatProperties(device.gpuDevice_, format, &props);
   assert((props.linearTilingFeatures | props.optimalTilingFeatures) &
          VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
 
-  if (props.linearTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-    // linear format supporting the required texture
-    needBlit = false;
-  }
-
-  // Read the file:
-  AAsset* file = AAssetManager_open(androidAppCtx->activity->assetManager,
-                                    filePath, AASSET_MODE_BUFFER);
-  size_t fileLength = AAsset_getLength(file);
-  stbi_uc* fileContent = new unsigned char[fileLength];
-  AAsset_read(file, fileContent, fileLength);
-  AAsset_close(file);
-
-  uint32_t imgWidth, imgHeight, n;
-  unsigned char* imageData = stbi_load_from_memory(
-      fileContent, fileLength, reinterpret_cast<int*>(&imgWidth),
-      reinterpret_cast<int*>(&imgHeight), reinterpret_cast<int*>(&n), 4);
-  assert(n == 4);
-
+  uint32_t imgWidth = texels.width, imgHeight = texels.height;
   tex_obj->tex_width = imgWidth;
   tex_obj->tex_height = imgHeight;
+  tex_obj->format = format;
+  // Blocks come with what levels they have
+  tex_obj->mipLevels = blocks ? texels.mipLevels : 1;
+  if (!blocks && textureMipmaps != kTextureMipmapsNone) {
+    while (std::max(imgWidth, imgHeight) >> tex_obj->mipLevels) {
+      tex_obj->mipLevels++;
+    }
+  }
+  tex_obj->bytes = 0;
+  for (uint32_t level = 0; level < tex_obj->mipLevels; level++) {
+    tex_obj->bytes += BlockLevelBytes(block, std::max(imgWidth >> level, 1u),
+                                      std::max(imgHeight >> level, 1u));
+  }
 
-  // Allocate the linear texture so texture could be copied over
+  // A linear image holds one level, written by CopyPixelsToRgba()
+  if (!forceStagingUpload && !blocks && tex_obj->mipLevels == 1 &&
+      (props.linearTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT)) {
+    // linear format supporting the required texture
+    needBlit = false;
+  }
+  // Levels past the first are blitted on the GPU where the format can be,
+  // else averaged on the CPU and copied with the first
+  const VkFormatFeatureFlags kBlitFeatures =
+      VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+      VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+  bool gpuMipmaps =
+      !blocks && tex_obj->mipLevels > 1 &&
+      textureMipmaps == kTextureMipmapsAuto &&
+      (props.optimalTilingFeatures & kBlitFeatures) == kBlitFeatures;
+
+  // Sampled as it is in a linear image where the device can, else copied
+  // from a staging buffer into an optimally tiled one
   VkImageCreateInfo image_create_info = {
       .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
       .pNext = nullptr,
       .flags = 0,
       .imageType = VK_IMAGE_TYPE_2D,
-      .format = kTexFmt,
+      .format = format,
       .extent = {static_cast<uint32_t>(imgWidth),
                  static_cast<uint32_t>(imgHeight), 1},
-      .mipLevels = 1,
+      .mipLevels = tex_obj->mipLevels,
       .arrayLayers = 1,
       .samples = VK_SAMPLE_COUNT_1_BIT,
-      .tiling = VK_IMAGE_TILING_LINEAR,
-      .usage = (needBlit ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT
-                         : VK_IMAGE_USAGE_SAMPLED_BIT),
+      .tiling = needBlit ? VK_IMAGE_TILING_OPTIMAL : VK_IMAGE_TILING_LINEAR,
+      .usage = (needBlit ? VK_IMAGE_USAGE_TRANSFER_DST_BIT : 0u) |
+               (gpuMipmaps ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0u) |
+               VK_IMAGE_USAGE_SAMPLED_BIT,
       .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
       .queueFamilyIndexCount = 1,
       .pQueueFamilyIndices = &device.queueFamilyIndex_,
-      .initialLayout = VK_IMAGE_LAYOUT_PREINITIALIZED,
-  };
-  VkMemoryAllocateInfo mem_alloc = {
-      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-      .pNext = nullptr,
-      .allocationSize = 0,
-      .memoryTypeIndex = 0,
+      .initialLayout = needBlit ? VK_IMAGE_LAYOUT_UNDEFINED
+                                : VK_IMAGE_LAYOUT_PREINITIALIZED,
   };
-
-  VkMemoryRequirements mem_reqs;
   CALL_VK(vkCreateImage(device.device_, &image_create_info, nullptr,
                         &tex_obj->image));
-  vkGetImageMemoryRequirements(device.device_, tex_obj->image, &mem_reqs);
-  mem_alloc.allocationSize = mem_reqs.size;
-  VK_CHECK(AllocateMemoryTypeFromProperties(mem_reqs.memoryTypeBits,
-                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
-                                            &mem_alloc.memoryTypeIndex));
-  CALL_VK(vkAllocateMemory(device.device_, &mem_alloc, nullptr, &tex_obj->mem));
-  CALL_VK(vkBindImageMemory(device.device_, tex_obj->image, tex_obj->mem, 0));
-
-  if (required_props & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
-    const VkImageSubresource subres = {
-        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = 0, .arrayLayer = 0,
-    };
-    VkSubresourceLayout layout;
-    void* data;
-
-    vkGetImageSubresourceLayout(device.device_, tex_obj->image, &subres,
-                                &layout);
-    CALL_VK(vkMapMemory(device.device_, tex_obj->mem, 0,
-                        mem_alloc.allocationSize, 0, &data));
-
-    for (int32_t y = 0; y < imgHeight; y++) {
-      unsigned char* row = (unsigned char*)((char*)data + layout.rowPitch * y);
-      for (int32_t x = 0; x < imgWidth; x++) {
-        row[x * 4] = imageData[(x + y * imgWidth) * 4];
-        row[x * 4 + 1] = imageData[(x + y * imgWidth) * 4 + 1];
-        row[x * 4 + 2] = imageData[(x + y * imgWidth) * 4 + 2];
-        row[x * 4 + 3] = imageData[(x + y * imgWidth) * 4 + 3];
+  if (!device.allocator_->AllocateForImage(
+          tex_obj->image, image_create_info.tiling,
+          needBlit ? kMemoryUsageGpuOnly : kMemoryUsageDynamic,
+          &tex_obj->mem)) {
+    LOGE("No memory for a %ux%u texture", imgWidth, imgHeight);
+    DestroyUnusedImage(tex_obj);
+    return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+  }
+
+  // Staging comes from the ring, or, when the ring has too little free, a
+  // buffer of its own
+  VkBuffer stageBuffer = VK_NULL_HANDLE;
+  MemoryAllocation stageMem = {};
+  if (!needBlit) {
+    if (required_props & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+      const VkImageSubresource subres = {
+          .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+          .mipLevel = 0,
+          .arrayLayer = 0,
+      };
+      VkSubresourceLayout layout;
+      // The allocator keeps host visible memory mapped
+      void* data = tex_obj->mem.mapped;
+
+      vkGetImageSubresourceLayout(device.device_, tex_obj->image, &subres,
+                                  &layout);
+
+      CopyPixelsToRgba(texels.pixels, texels.channels, imgWidth, imgHeight,
+                       static_cast<uint8_t*>(data) + layout.offset,
+                       layout.rowPitch, 0);
+      device.allocator_->Flush(tex_obj->mem, 0, tex_obj->mem.size);
+    }
+    batch->AddLinear(tex_obj->image);
+  } else {
+    // The levels staged one after another, each at an offset and row pitch
+    // the device copies fastest, in whole blocks
+    StagingRing& staging = device.staging_;
+    VkDeviceSize alignment = std::max<VkDeviceSize>(
+        staging.CopyOffsetAlignment(), block.blockBytes);
+    std::vector<VkBufferImageCopy> regions(gpuMipmaps ? 1
+                                                      : tex_obj->mipLevels);
+    VkDeviceSize stageSize = 0;
+    for (uint32_t level = 0; level < regions.size(); level++) {
+      uint32_t width = std::max(imgWidth >> level, 1u);
+      uint32_t height = std::max(imgHeight >> level, 1u);
+      uint32_t blocksWide = (width + block.blockWidth - 1) / block.blockWidth;
+      uint32_t blocksHigh =
+          (height + block.blockHeight - 1) / block.blockHeight;
+      VkDeviceSize rowPitch = staging.RowPitch(blocksWide, block.blockBytes);
+      stageSize = (stageSize + alignment - 1) & ~(alignment - 1);
+      regions[level] = VkBufferImageCopy{
+          .bufferOffset = stageSize,
+          // In texels
+          .bufferRowLength = static_cast<uint32_t>(
+              rowPitch / block.blockBytes * block.blockWidth),
+          .bufferImageHeight = 0,
+          .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1},
+          .imageOffset = {0, 0, 0},
+          .imageExtent = {width, height, 1},
+      };
+      stageSize += rowPitch * blocksHigh;
+    }
+    VkDeviceSize stageOffset = 0;
+    // Aligned as the regions are, for their offsets to stay whole blocks
+    void* data = staging.Allocate(stageSize, alignment, &stageOffset);
+    VkBuffer copySource = staging.Buffer();
+    if (!data) {
+      VkBufferCreateInfo bufferInfo{
+          .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+          .pNext = nullptr,
+          .flags = 0,
+          .size = stageSize,
+          .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+          .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+          .queueFamilyIndexCount = 0,
+          .pQueueFamilyIndices = nullptr,
+      };
+      CALL_VK(vkCreateBuffer(device.device_, &bufferInfo, nullptr,
+                             &stageBuffer));
+      if (!device.allocator_->AllocateForBuffer(
+              stageBuffer, kMemoryUsageUpload, &stageMem)) {
+        LOGE("No host visible memory to stage a %ux%u texture", imgWidth,
+             imgHeight);
+        vkDestroyBuffer(device.device_, stageBuffer, nullptr);
+        DestroyUnusedImage(tex_obj);
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
       }
+      data = stageMem.mapped;
+      copySource = stageBuffer;
+    }
+    if (blocks) {
+      StageBlocks(texels, block, regions, static_cast<uint8_t*>(data));
+    } else {
+      CopyPixelsToRgba(texels.pixels, texels.channels, imgWidth, imgHeight,
+                       static_cast<uint8_t*>(data),
+                       regions[0].bufferRowLength * 4ull, 0);
+      StageMipLevels(texels, regions, static_cast<uint8_t*>(data));
+    }
+    if (stageBuffer != VK_NULL_HANDLE) {
+      device.allocator_->Flush(stageMem, 0, stageSize);
+    } else {
+      staging.Flush();
     }
 
-    vkUnmapMemory(device.device_, tex_obj->mem);
-    stbi_image_free(imageData);
+    for (VkBufferImageCopy& region : regions) {
+      region.bufferOffset += stageOffset;
+    }
+    batch->AddCopy(tex_obj->image, tex_obj->mipLevels, copySource,
+                   regions.data(), static_cast<uint32_t>(regions.size()));
+    // The batch is submitted ahead of the next frame, whose fence retires
+    // the staging
+    uint64_t retireValue = render.submitSerial_ + 1;
+    device.deletionQueue_.DeferBuffer(stageBuffer, retireValue);
+    device.deletionQueue_.DeferMemory(&stageMem, retireValue);
   }
-  delete[] fileContent;
-
   tex_obj->imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
-  VkCommandPoolCreateInfo cmdPoolCreateInfo{
-      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-      .pNext = nullptr,
-      .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-      .queueFamilyIndex = device.queueFamilyIndex_,
-  };
-
-  VkCommandPool cmdPool;
-  CALL_VK(vkCreateCommandPool(device.device_, &cmdPoolCreateInfo, nullptr,
-                              &cmdPool));
-
-  VkCommandBuffer gfxCmd;
-  const VkCommandBufferAllocateInfo cmd = {
-      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+  const VkSamplerCreateInfo sampler = {
+      .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
       .pNext = nullptr,
-      .commandPool = cmdPool,
-      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-      .commandBufferCount = 1,
+      .magFilter = VK_FILTER_NEAREST,
+      // Trilinear where there are levels to filter between
+      .minFilter =
+          tex_obj->mipLevels > 1 ? VK_FILTER_LINEAR : VK_FILTER_NEAREST,
+      .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+      .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+      .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+      .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+      .mipLodBias = 0.0f,
+      .maxAnisotropy = 1,
+      .compareOp = VK_COMPARE_OP_NEVER,
+      .minLod = 0.0f,
+      .maxLod = static_cast<float>(tex_obj->mipLevels - 1),
+      .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
+      .unnormalizedCoordinates = VK_FALSE,
   };
-
-  CALL_VK(vkAllocateCommandBuffers(device.device_, &cmd, &gfxCmd));
-  VkCommandBufferBeginInfo cmd_buf_info = {
-      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-      .pNext = nullptr,
-      .flags = 0,
-      .pInheritanceInfo = nullptr};
-  CALL_VK(vkBeginCommandBuffer(gfxCmd, &cmd_buf_info));
-
-  // If linear is supported, we are done
-  VkImage stageImage = VK_NULL_HANDLE;
-  VkDeviceMemory stageMem = VK_NULL_HANDLE;
-  if (!needBlit) {
-    setImageLayout(gfxCmd, tex_obj->image, VK_IMAGE_LAYOUT_PREINITIALIZED,
-                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                   VK_PIPELINE_STAGE_HOST_BIT,
-                   VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-  } else {
-    // save current image and mem as staging image and memory
-    stageImage = tex_obj->image;
-    stageMem = tex_obj->mem;
-    tex_obj->image = VK_NULL_HANDLE;
-    tex_obj->mem = VK_NULL_HANDLE;
-
-    // Create a tile texture to blit into
-    image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
-    image_create_info.usage =
-        VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-    image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    CALL_VK(vkCreateImage(device.device_, &image_create_info, nullptr,
-                          &tex_obj->image));
-    vkGetImageMemoryRequirements(device.device_, tex_obj->image, &mem_reqs);
-
-    mem_alloc.allocationSize = mem_reqs.size;
-    VK_CHECK(AllocateMemoryTypeFromProperties(
-        mem_reqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-        &mem_alloc.memoryTypeIndex));
-    CALL_VK(
-        vkAllocateMemory(device.device_, &mem_alloc, nullptr, &tex_obj->mem));
-    CALL_VK(vkBindImageMemory(device.device_, tex_obj->image, tex_obj->mem, 0));
-
-    // transitions image out of UNDEFINED type
-    setImageLayout(gfxCmd, stageImage, VK_IMAGE_LAYOUT_PREINITIALIZED,
-                   VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                   VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
-    setImageLayout(gfxCmd, tex_obj->image, VK_IMAGE_LAYOUT_UNDEFINED,
-                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                   VK_PIPELINE_STAGE_HOST_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
-    VkImageCopy bltInfo{
-        .srcSubresource {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .mipLevel = 0,
-            .baseArrayLayer = 0,
-            .layerCount = 1,
-         },
-        .srcOffset { .x = 0, .y = 0, .z = 0 },
-        .dstSubresource {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .mipLevel = 0,
-            .baseArrayLayer = 0,
-            .layerCount = 1,
-         },
-        .dstOffset { .x = 0, .y = 0, .z = 0},
-        .extent { .width = imgWidth, .height = imgHeight, .depth = 1,},
-    };
-    vkCmdCopyImage(gfxCmd, stageImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                   tex_obj->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1,
-                   &bltInfo);
-
-    setImageLayout(gfxCmd, tex_obj->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                   VK_PIPELINE_STAGE_TRANSFER_BIT,
-                   VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-  }
-
-  CALL_VK(vkEndCommandBuffer(gfxCmd));
-  VkFenceCreateInfo fenceInfo = {
-      .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+  VkImageViewCreateInfo view = {
+      .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
       .pNext = nullptr,
       .flags = 0,
+      .image = tex_obj->image,
+      .viewType = VK_IMAGE_VIEW_TYPE_2D,
+      .format = format,
+      .components =
+          {
+              VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G,
+              VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A,
+          },
+      .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, tex_obj->mipLevels, 0,
+                           1},
   };
-  VkFence fence;
-  CALL_VK(vkCreateFence(device.device_, &fenceInfo, nullptr, &fence));
-
-  VkSubmitInfo submitInfo = {
-      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-      .pNext = nullptr,
-      .waitSemaphoreCount = 0,
-      .pWaitSemaphores = nullptr,
-      .pWaitDstStageMask = nullptr,
-      .commandBufferCount = 1,
-      .pCommandBuffers = &gfxCmd,
-      .signalSemaphoreCount = 0,
-      .pSignalSemaphores = nullptr,
-  };
-  CALL_VK(vkQueueSubmit(device.queue_, 1, &submitInfo, fence) != VK_SUCCESS);
-  CALL_VK(vkWaitForFences(device.device_, 1, &fence, VK_TRUE, 100000000) !=
-          VK_SUCCESS);
-  vkDestroyFence(device.device_, fence, nullptr);
-
-  vkFreeCommandBuffers(device.device_, cmdPool, 1, &gfxCmd);
-  vkDestroyCommandPool(device.device_, cmdPool, nullptr);
-  if (stageImage != VK_NULL_HANDLE) {
-    vkDestroyImage(device.device_, stageImage, nullptr);
-    vkFreeMemory(device.device_, stageMem, nullptr);
-  }
+  CALL_VK(
+      vkCreateSampler(device.device_, &sampler, nullptr, &tex_obj->sampler));
+  CALL_VK(vkCreateImageView(device.device_, &view, nullptr, &tex_obj->view));
   return VK_SUCCESS;
 }
 
+// Draws with the placeholder until the textures stream in, and starts
+// streaming them
 void CreateTexture(void) {
-  for (uint32_t i = 0; i < TUTORIAL_TEXTURE_COUNT; i++) {
-    LoadTextureFromFile(texFiles[i], &textures[i], VK_IMAGE_USAGE_SAMPLED_BIT,
-                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
-
-    const VkSamplerCreateInfo sampler = {
-        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-        .pNext = nullptr,
-        .magFilter = VK_FILTER_NEAREST,
-        .minFilter = VK_FILTER_NEAREST,
-        .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
-        .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-        .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-        .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-        .mipLodBias = 0.0f,
-        .maxAnisotropy = 1,
-        .compareOp = VK_COMPARE_OP_NEVER,
-        .minLod = 0.0f,
-        .maxLod = 0.0f,
-        .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
-        .unnormalizedCoordinates = VK_FALSE,
-    };
-    VkImageViewCreateInfo view = {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-        .pNext = nullptr,
-        .flags = 0,
-        .image = VK_NULL_HANDLE,
-        .viewType = VK_IMAGE_VIEW_TYPE_2D,
-        .format = kTexFmt,
-        .components =
-            {
-                VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G,
-                VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A,
-            },
-        .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1},
-    };
-
-    CALL_VK(vkCreateSampler(device.device_, &sampler, nullptr,
-                            &textures[i].sampler));
-    view.image = textures[i].image;
-    CALL_VK(
-        vkCreateImageView(device.device_, &view, nullptr, &textures[i].view));
+  // A grey checkerboard, uploaded as the streamed textures are
+  static unsigned char placeholderTexels[] = {
+      0x60, 0x60, 0x60, 0xff, 0xa0, 0xa0, 0xa0, 0xff,
+      0xa0, 0xa0, 0xa0, 0xff, 0x60, 0x60, 0x60, 0xff,
+  };
+  const DecodedTexture placeholder = {
+      .width = 2,
+      .height = 2,
+      .channels = 4,
+      .pixels = placeholderTexels,
+  };
+  memset(&placeholderTexture, 0, sizeof(placeholderTexture));
+  TextureUploadBatch batch;
+  batch.Begin(device.device_, device.queues_);
+  CALL_VK(UploadTexture(placeholder, &placeholderTexture,
+                        VK_IMAGE_USAGE_SAMPLED_BIT,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &batch));
+  // The first frame's fence retires the batch and the staging
+  uint64_t retireValue = render.submitSerial_ + 1;
+  CALL_VK(batch.Submit(&device.deletionQueue_, retireValue));
+  device.staging_.Retire(retireValue);
+
+  textures.assign(textureCount, texture_object());
+  textureGeneration = 0;
+  uint32_t workers =
+      textureWorkers ? textureWorkers : TextureStreamer::CoreCount();
+  textureStreamer.Start(workers, DecodeTexture, ReleaseTexture, appCtx);
+  for (uint32_t i = 0; i < textureCount; i++) {
+    textureStreamer.Request(texFiles[i % TUTORIAL_TEXTURE_COUNT]);
   }
 }
 
-// A helper function
-bool MapMemoryTypeToIndex(uint32_t typeBits, VkFlags requirements_mask,
-                          uint32_t* typeIndex) {
-  VkPhysicalDeviceMemoryProperties memoryProperties;
-  vkGetPhysicalDeviceMemoryProperties(device.gpuDevice_, &memoryProperties);
-  // Search memtypes to find first index with those properties
-  for (uint32_t i = 0; i < 32; i++) {
-    if ((typeBits & 1) == 1) {
-      // Type is available, does it match user properties?
-      if ((memoryProperties.memoryTypes[i].propertyFlags & requirements_mask) ==
-          requirements_mask) {
-        *typeIndex = i;
-        return true;
-      }
+// At the start of a frame, with |completedSerial| retired: the textures it
+// made resident are drawn from now on, and what the workers decoded since
+// is uploaded, up to kStreamBytesPerFrame, for later frames
+void StreamTextures(uint64_t completedSerial) {
+  static std::vector<uint32_t> resident;
+  resident.clear();
+  textureStreamer.Collect(completedSerial, &resident);
+  for (uint32_t id : resident) textures[id].resident = true;
+  if (!resident.empty()) textureGeneration++;
+
+  TextureUploadBatch batch;
+  batch.Begin(device.device_, device.queues_);
+  // Ahead of the frame's own submit, so its fence retires the uploads
+  uint64_t retireValue = render.submitSerial_ + 1;
+  VkDeviceSize bytes = 0;
+  uint32_t id;
+  DecodedTexture decoded;
+  while (bytes < kStreamBytesPerFrame &&
+         textureStreamer.TakeDecoded(&id, &decoded)) {
+    VkResult result =
+        UploadTexture(decoded, &textures[id], VK_IMAGE_USAGE_SAMPLED_BIT,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, &batch);
+    textureStreamer.Release(&decoded);
+    if (result != VK_SUCCESS) {
+      textureStreamer.Failed(id);
+      continue;
     }
-    typeBits >>= 1;
+    textureStreamer.Uploading(id, textures[id].bytes, retireValue);
+    bytes += textures[id].bytes;
   }
-  return false;
+  if (!batch.TextureCount()) return;
+  CALL_VK(batch.Submit(&device.deletionQueue_, retireValue));
+  device.staging_.Retire(retireValue);
+}
+
+void DeleteTextureObject(struct texture_object* tex_obj) {
+  vkDestroyImageView(device.device_, tex_obj->view, nullptr);
+  vkDestroySampler(device.device_, tex_obj->sampler, nullptr);
+  vkDestroyImage(device.device_, tex_obj->image, nullptr);
+  device.allocator_->Free(&tex_obj->mem);
+}
+
+void DeleteTexture(void) {
+  // Those that never streamed in have null handles
+  for (texture_object& texture : textures) DeleteTextureObject(&texture);
+  textures.clear();
+  DeleteTextureObject(&placeholderTexture);
 }
 
 // Create our vertex buffer
@@ -696,84 +1026,93 @@ bool CreateBuffers(void) {
   CALL_VK(vkCreateBuffer(device.device_, &createBufferInfo, nullptr,
                          &buffers.vertexBuf_));
 
-  VkMemoryRequirements memReq;
-  vkGetBufferMemoryRequirements(device.device_, buffers.vertexBuf_, &memReq);
-
-  VkMemoryAllocateInfo allocInfo{
-      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-      .pNext = nullptr,
-      .allocationSize = memReq.size,
-      .memoryTypeIndex = 0,  // Memory type assigned in the next step
-  };
-
-  // Assign the proper memory type for that buffer
-  MapMemoryTypeToIndex(memReq.memoryTypeBits,
-                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-                       VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                       &allocInfo.memoryTypeIndex);
-
-  // Allocate memory for the buffer
-  VkDeviceMemory deviceMemory;
-  CALL_VK(vkAllocateMemory(device.device_, &allocInfo, nullptr, &deviceMemory));
-
-  void* data;
-  CALL_VK(vkMapMemory(device.device_, deviceMemory, 0, allocInfo.allocationSize,
-                      0, &data));
-  memcpy(data, vertexData, sizeof(vertexData));
-  vkUnmapMemory(device.device_, deviceMemory);
-
-  CALL_VK(
-      vkBindBufferMemory(device.device_, buffers.vertexBuf_, deviceMemory, 0));
-  return true;
+  // Allocate memory for the buffer, and bind it
+  if (!device.allocator_->AllocateForBuffer(
+          buffers.vertexBuf_, kMemoryUsageDynamic, &buffers.vertexMem_)) {
+    return false;
+  }
+  // Dynamic memory need not be coherent
+  memcpy(buffers.vertexMem_.mapped, vertexData, sizeof(vertexData));
+  device.allocator_->Flush(buffers.vertexMem_, 0, sizeof(vertexData));
+
+  // Room for each frame in flight's FrameData, and per-frame data to come
+  return buffers.frameData_.Create(
+      device.gpuDevice_, device.device_, device.allocator_,
+      framesInFlight * kFrameRingBytesPerFrame,
+      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+      framesInFlight);
 }
 
 void DeleteBuffers(void) {
   vkDestroyBuffer(device.device_, buffers.vertexBuf_, nullptr);
+  device.allocator_->Free(&buffers.vertexMem_);
+  buffers.frameData_.Destroy();
 }
 
 // Create Graphics Pipeline
 VkResult CreateGraphicsPipeline(void) {
-  memset(&gfxPipeline, 0, sizeof(gfxPipeline));
+  gfxPipeline = VulkanGfxPipelineInfo();
 
-  const VkDescriptorSetLayoutBinding descriptorSetLayoutBinding{
-      .binding = 0,
-      .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-      .descriptorCount = TUTORIAL_TEXTURE_COUNT,
-      .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
-      .pImmutableSamplers = nullptr,
+  // The texture, and FrameData at the offset the frame binds
+  const VkDescriptorSetLayoutBinding descriptorSetLayoutBindings[2]{
+      {
+          .binding = 0,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .descriptorCount = TUTORIAL_TEXTURE_COUNT,
+          .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+          .pImmutableSamplers = nullptr,
+      },
+      {
+          .binding = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+          .pImmutableSamplers = nullptr,
+      },
   };
   const VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
       .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
       .pNext = nullptr,
-      .bindingCount = 1,
-      .pBindings = &descriptorSetLayoutBinding,
+      .bindingCount = 2,
+      .pBindings = descriptorSetLayoutBindings,
   };
   CALL_VK(vkCreateDescriptorSetLayout(device.device_,
                                       &descriptorSetLayoutCreateInfo, nullptr,
                                       &gfxPipeline.dscLayout_));
+  // The pre-rotation matrix of tri.vert
+  VkPushConstantRange pushConstantRange{
+      .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+      .offset = 0,
+      .size = sizeof(swapchain.preRotation_.rotation),
+  };
   VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{
       .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
       .pNext = nullptr,
       .setLayoutCount = 1,
       .pSetLayouts = &gfxPipeline.dscLayout_,
-      .pushConstantRangeCount = 0,
-      .pPushConstantRanges = nullptr,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &pushConstantRange,
   };
   CALL_VK(vkCreatePipelineLayout(device.device_, &pipelineLayoutCreateInfo,
                                  nullptr, &gfxPipeline.layout_));
 
-  // No dynamic state in that tutorial
+  // Viewport and scissor are set in the command buffers, so the pipeline
+  // outlives swapchains of other sizes
+  VkDynamicState dynamicStates[] = {
+      VK_DYNAMIC_STATE_VIEWPORT,
+      VK_DYNAMIC_STATE_SCISSOR,
+  };
   VkPipelineDynamicStateCreateInfo dynamicStateInfo{
       .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
       .pNext = nullptr,
-      .dynamicStateCount = 0,
-      .pDynamicStates = nullptr};
+      .dynamicStateCount = 2,
+      .pDynamicStates = dynamicStates};
 
   VkShaderModule vertexShader, fragmentShader;
-  buildShaderFromFile(androidAppCtx, "shaders/tri.vert",
+  buildShaderFromFile(appCtx, "shaders/tri.vert",
                       VK_SHADER_STAGE_VERTEX_BIT, device.device_,
                       &vertexShader);
-  buildShaderFromFile(androidAppCtx, "shaders/tri.frag",
+  buildShaderFromFile(appCtx, "shaders/tri.frag",
                       VK_SHADER_STAGE_FRAGMENT_BIT, device.device_,
                       &fragmentShader);
   // Specify vertex and fragment shader stages
@@ -797,27 +1136,14 @@ VkResult CreateGraphicsPipeline(void) {
           .pSpecializationInfo = nullptr,
       }};
 
-  VkViewport viewports {
-      .x = 0,
-      .y = 0,
-      .width = (float)swapchain.displaySize_.width,
-      .height = (float)swapchain.displaySize_.height,
-      .minDepth = 0.0f,
-      .maxDepth = 1.0f,
-  };
-
-  VkRect2D scissor = {
-          .offset = {.x = 0, .y = 0,},
-          .extent = swapchain.displaySize_,
-   };
   // Specify viewport info
   VkPipelineViewportStateCreateInfo viewportInfo{
       .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
       .pNext = nullptr,
       .viewportCount = 1,
-      .pViewports = &viewports,
+      .pViewports = nullptr,
       .scissorCount = 1,
-      .pScissors = &scissor,
+      .pScissors = nullptr,
   };
 
   // Specify multisample info
@@ -862,6 +1188,20 @@ VkResult CreateGraphicsPipeline(void) {
       .lineWidth = 1,
   };
 
+  // Specify depth test: nearest fragment wins
+  VkPipelineDepthStencilStateCreateInfo depthStencilInfo{
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .depthTestEnable = VK_TRUE,
+      .depthWriteEnable = VK_TRUE,
+      .depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL,
+      .depthBoundsTestEnable = VK_FALSE,
+      .stencilTestEnable = VK_FALSE,
+      .minDepthBounds = 0.0f,
+      .maxDepthBounds = 1.0f,
+  };
+
   // Specify input assembler state
   VkPipelineInputAssemblyStateCreateInfo inputAssemblyInfo{
       .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
@@ -910,10 +1250,21 @@ VkResult CreateGraphicsPipeline(void) {
   CALL_VK(vkCreatePipelineCache(device.device_, &pipelineCacheInfo, nullptr,
                                 &gfxPipeline.cache_));
 
+  // Without a render pass, the pipeline takes the attachment formats
+  VkPipelineRenderingCreateInfoKHR renderingInfo{
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR,
+      .pNext = nullptr,
+      .viewMask = 0,
+      .colorAttachmentCount = 1,
+      .pColorAttachmentFormats = &swapchain.displayFormat_,
+      .depthAttachmentFormat = render.depthFormat_,
+      .stencilAttachmentFormat = VK_FORMAT_UNDEFINED,
+  };
+
   // Create the pipeline
   VkGraphicsPipelineCreateInfo pipelineCreateInfo{
       .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-      .pNext = nullptr,
+      .pNext = render.dynamicRendering_ ? &renderingInfo : nullptr,
       .flags = 0,
       .stageCount = 2,
       .pStages = shaderStages,
@@ -923,7 +1274,7 @@ VkResult CreateGraphicsPipeline(void) {
       .pViewportState = &viewportInfo,
       .pRasterizationState = &rasterInfo,
       .pMultisampleState = &multisampleInfo,
-      .pDepthStencilState = nullptr,
+      .pDepthStencilState = &depthStencilInfo,
       .pColorBlendState = &colorBlendInfo,
       .pDynamicState = &dynamicStateInfo,
       .layout = gfxPipeline.layout_,
@@ -948,69 +1299,342 @@ void DeleteGraphicsPipeline(void) {
   if (gfxPipeline.pipeline_ == VK_NULL_HANDLE) return;
   vkDestroyPipeline(device.device_, gfxPipeline.pipeline_, nullptr);
   vkDestroyPipelineCache(device.device_, gfxPipeline.cache_, nullptr);
-  vkFreeDescriptorSets(device.device_, gfxPipeline.descPool_, 1,
-                       &gfxPipeline.descSet_);
+  // Frees the descriptor sets with it
   vkDestroyDescriptorPool(device.device_, gfxPipeline.descPool_, nullptr);
+  gfxPipeline.descSets_.clear();
+  gfxPipeline.descGeneration_.clear();
   vkDestroyPipelineLayout(device.device_, gfxPipeline.layout_, nullptr);
 }
 
+// Point frame |frame|'s descriptor set at the resident textures, and at the
+// placeholder for the others; the frame's last submit has to be retired
+void WriteTextureDescriptors(uint32_t frame) {
+  VkDescriptorImageInfo texDsts[TUTORIAL_TEXTURE_COUNT];
+  memset(texDsts, 0, sizeof(texDsts));
+  for (int32_t idx = 0; idx < TUTORIAL_TEXTURE_COUNT; idx++) {
+    const texture_object& tex =
+        textures[idx].resident ? textures[idx] : placeholderTexture;
+    texDsts[idx].sampler = tex.sampler;
+    texDsts[idx].imageView = tex.view;
+    texDsts[idx].imageLayout = tex.imageLayout;
+  }
+  VkWriteDescriptorSet writeDst{
+      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+      .pNext = nullptr,
+      .dstSet = gfxPipeline.descSets_[frame],
+      .dstBinding = 0,
+      .dstArrayElement = 0,
+      .descriptorCount = TUTORIAL_TEXTURE_COUNT,
+      .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+      .pImageInfo = texDsts,
+      .pBufferInfo = nullptr,
+      .pTexelBufferView = nullptr,
+  };
+  device.dispatch_.vkUpdateDescriptorSets(device.device_, 1, &writeDst, 0,
+                                          nullptr);
+  gfxPipeline.descGeneration_[frame] = textureGeneration;
+}
+
 // initialize descriptor set
 VkResult CreateDescriptorSet(void) {
-  const VkDescriptorPoolSize type_count = {
-      .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-      .descriptorCount = TUTORIAL_TEXTURE_COUNT,
+  uint32_t setCount = render.framesInFlight_;
+  const VkDescriptorPoolSize type_count[2] = {
+      {
+          .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .descriptorCount = TUTORIAL_TEXTURE_COUNT * setCount,
+      },
+      {
+          .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+          .descriptorCount = setCount,
+      },
   };
   const VkDescriptorPoolCreateInfo descriptor_pool = {
       .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
       .pNext = nullptr,
-      .maxSets = 1,
-      .poolSizeCount = 1,
-      .pPoolSizes = &type_count,
+      .maxSets = setCount,
+      .poolSizeCount = 2,
+      .pPoolSizes = type_count,
   };
 
   CALL_VK(vkCreateDescriptorPool(device.device_, &descriptor_pool, nullptr,
                                  &gfxPipeline.descPool_));
 
+  std::vector<VkDescriptorSetLayout> layouts(setCount,
+                                             gfxPipeline.dscLayout_);
   VkDescriptorSetAllocateInfo alloc_info{
       .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
       .pNext = nullptr,
       .descriptorPool = gfxPipeline.descPool_,
-      .descriptorSetCount = 1,
-      .pSetLayouts = &gfxPipeline.dscLayout_};
+      .descriptorSetCount = setCount,
+      .pSetLayouts = layouts.data()};
+  gfxPipeline.descSets_.resize(setCount);
+  gfxPipeline.descGeneration_.resize(setCount);
   CALL_VK(vkAllocateDescriptorSets(device.device_, &alloc_info,
-                                   &gfxPipeline.descSet_));
+                                   gfxPipeline.descSets_.data()));
 
-  VkDescriptorImageInfo texDsts[TUTORIAL_TEXTURE_COUNT];
-  memset(texDsts, 0, sizeof(texDsts));
-  for (int32_t idx = 0; idx < TUTORIAL_TEXTURE_COUNT; idx++) {
-    texDsts[idx].sampler = textures[idx].sampler;
-    texDsts[idx].imageView = textures[idx].view;
-    texDsts[idx].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+  // Each frame adds its dynamic offset to the ring's start
+  VkDescriptorBufferInfo frameDataDst{
+      .buffer = buffers.frameData_.Buffer(),
+      .offset = 0,
+      .range = sizeof(FrameData),
+  };
+  for (uint32_t i = 0; i < setCount; i++) {
+    VkWriteDescriptorSet writeDst{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext = nullptr,
+        .dstSet = gfxPipeline.descSets_[i],
+        .dstBinding = 1,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+        .pImageInfo = nullptr,
+        .pBufferInfo = &frameDataDst,
+        .pTexelBufferView = nullptr,
+    };
+    vkUpdateDescriptorSets(device.device_, 1, &writeDst, 0, nullptr);
+    WriteTextureDescriptors(i);
   }
+  return VK_SUCCESS;
+}
 
-  VkWriteDescriptorSet writeDst{
-      .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+// Allocate a command buffer per swapchain image, which RecordCommandBuffer()
+// records each time the image is drawn to, and create the semaphores
+// presents of the images wait on: nothing tells when a present is done with
+// one, except that its image is acquired again.
+void CreateCommandBuffers(void) {
+  render.cmdBufferLen_ = swapchain.swapchainLength_;
+  render.cmdBuffer_ = new VkCommandBuffer[swapchain.swapchainLength_];
+  VkCommandBufferAllocateInfo cmdBufferCreateInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
       .pNext = nullptr,
-      .dstSet = gfxPipeline.descSet_,
-      .dstBinding = 0,
-      .dstArrayElement = 0,
-      .descriptorCount = TUTORIAL_TEXTURE_COUNT,
-      .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-      .pImageInfo = texDsts,
-      .pBufferInfo = nullptr,
-      .pTexelBufferView = nullptr};
-  vkUpdateDescriptorSets(device.device_, 1, &writeDst, 0, nullptr);
-  return VK_SUCCESS;
+      .commandPool = render.cmdPool_,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = render.cmdBufferLen_,
+  };
+  CALL_VK(vkAllocateCommandBuffers(device.device_, &cmdBufferCreateInfo,
+                                   render.cmdBuffer_));
+
+  render.renderSemaphore_.resize(swapchain.swapchainLength_);
+  render.imageFence_.assign(swapchain.swapchainLength_, VK_NULL_HANDLE);
+  VkSemaphoreCreateInfo semaphoreCreateInfo{
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+  };
+  for (uint32_t i = 0; i < swapchain.swapchainLength_; i++) {
+    CALL_VK(vkCreateSemaphore(device.device_, &semaphoreCreateInfo, nullptr,
+                              &render.renderSemaphore_[i]));
+  }
+}
+
+// Record the draw to swapchain image |bufferIndex|, with the frame's
+// |descSet|, reading its FrameData at |frameDataOffset| in buffers.frameData_
+void RecordCommandBuffer(uint32_t bufferIndex, VkDescriptorSet descSet,
+                         uint32_t frameDataOffset) {
+  // We start by creating and declare the "beginning" our command buffer
+  VkCommandBufferBeginInfo cmdBufferBeginInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .pNext = nullptr,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+      .pInheritanceInfo = nullptr,
+  };
+  CALL_VK(device.dispatch_.vkBeginCommandBuffer(
+      render.cmdBuffer_[bufferIndex], &cmdBufferBeginInfo));
+
+  // transition the buffer into color attachment; it is cleared, so its
+  // contents need not survive
+  setImageLayout(render.cmdBuffer_[bufferIndex],
+                 swapchain.displayImages_[bufferIndex],
+                 VK_IMAGE_LAYOUT_UNDEFINED,
+                 VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                 VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+  // Now we start a renderpass, or dynamic rendering. Any draw command has
+  // to be recorded in one
+  VkClearValue clearVals[2]{
+      {.color { .float32 { 0.0f, 0.34f, 0.90f, 1.0f,}}},
+      {.depthStencil {.depth = 1.0f, .stencil = 0}},
+  };
+  VkRect2D renderArea{
+      .offset = {.x = 0, .y = 0},
+      .extent = swapchain.displaySize_,
+  };
+
+  if (render.dynamicRendering_) {
+    // The render pass does this for its attachments: wait for the frame
+    // before to be done with the depth buffer, whose contents go
+    VkImageMemoryBarrier depthBarrier{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                         VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = swapchain.depth_.image,
+        .subresourceRange =
+            {
+                .aspectMask = swapchain.depth_.aspect,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+    };
+    device.dispatch_.vkCmdPipelineBarrier(
+        render.cmdBuffer_[bufferIndex],
+        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT, 0, 0, nullptr, 0,
+        nullptr, 1, &depthBarrier);
+
+    VkRenderingAttachmentInfoKHR colorAttachment{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+        .pNext = nullptr,
+        .imageView = swapchain.displayViews_[bufferIndex],
+        .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .resolveMode = VK_RESOLVE_MODE_NONE,
+        .resolveImageView = VK_NULL_HANDLE,
+        .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+        .clearValue = clearVals[0],
+    };
+    // Not kept past the draw, so a tiler never writes it out
+    VkRenderingAttachmentInfoKHR depthAttachment{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+        .pNext = nullptr,
+        .imageView = swapchain.depth_.view,
+        .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        .resolveMode = VK_RESOLVE_MODE_NONE,
+        .resolveImageView = VK_NULL_HANDLE,
+        .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .clearValue = clearVals[1],
+    };
+    VkRenderingInfoKHR renderingInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+        .pNext = nullptr,
+        .flags = 0,
+        .renderArea = renderArea,
+        .layerCount = 1,
+        .viewMask = 0,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &colorAttachment,
+        .pDepthAttachment = &depthAttachment,
+        .pStencilAttachment = nullptr,
+    };
+    render.beginRendering_(render.cmdBuffer_[bufferIndex], &renderingInfo);
+  } else {
+    VkRenderPassBeginInfo renderPassBeginInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+        .pNext = nullptr,
+        .renderPass = render.renderPass_,
+        .framebuffer = swapchain.framebuffers_[bufferIndex],
+        .renderArea = renderArea,
+        .clearValueCount = 2,
+        .pClearValues = clearVals};
+    device.dispatch_.vkCmdBeginRenderPass(render.cmdBuffer_[bufferIndex],
+                                          &renderPassBeginInfo,
+                                          VK_SUBPASS_CONTENTS_INLINE);
+  }
+  // Bind what is necessary to the command buffer
+  device.dispatch_.vkCmdBindPipeline(render.cmdBuffer_[bufferIndex],
+                                     VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                     gfxPipeline.pipeline_);
+  VkViewport viewport{
+      .x = 0,
+      .y = 0,
+      .width = (float)swapchain.displaySize_.width,
+      .height = (float)swapchain.displaySize_.height,
+      .minDepth = 0.0f,
+      .maxDepth = 1.0f,
+  };
+  VkRect2D scissor{
+      .offset = {.x = 0, .y = 0},
+      .extent = swapchain.displaySize_,
+  };
+  device.dispatch_.vkCmdSetViewport(render.cmdBuffer_[bufferIndex], 0, 1,
+                                    &viewport);
+  device.dispatch_.vkCmdSetScissor(render.cmdBuffer_[bufferIndex], 0, 1,
+                                   &scissor);
+  device.dispatch_.vkCmdPushConstants(
+      render.cmdBuffer_[bufferIndex], gfxPipeline.layout_,
+      VK_SHADER_STAGE_VERTEX_BIT, 0,
+      sizeof(swapchain.preRotation_.rotation),
+      swapchain.preRotation_.rotation);
+  device.dispatch_.vkCmdBindDescriptorSets(
+      render.cmdBuffer_[bufferIndex], VK_PIPELINE_BIND_POINT_GRAPHICS,
+      gfxPipeline.layout_, 0, 1, &descSet, 1, &frameDataOffset);
+  VkDeviceSize offset = 0;
+  device.dispatch_.vkCmdBindVertexBuffers(render.cmdBuffer_[bufferIndex], 0,
+                                          1, &buffers.vertexBuf_, &offset);
+
+  // Draw Triangle
+  device.dispatch_.vkCmdDraw(render.cmdBuffer_[bufferIndex], 3, 1, 0, 0);
+
+  if (render.dynamicRendering_) {
+    render.endRendering_(render.cmdBuffer_[bufferIndex]);
+  } else {
+    device.dispatch_.vkCmdEndRenderPass(render.cmdBuffer_[bufferIndex]);
+  }
+  setImageLayout(render.cmdBuffer_[bufferIndex],
+                 swapchain.displayImages_[bufferIndex],
+                 VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                 VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                 VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                 VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+  CALL_VK(device.dispatch_.vkEndCommandBuffer(render.cmdBuffer_[bufferIndex]));
+}
+
+void DeleteCommandBuffers(void) {
+  vkFreeCommandBuffers(device.device_, render.cmdPool_, render.cmdBufferLen_,
+                       render.cmdBuffer_);
+  delete[] render.cmdBuffer_;
+  for (VkSemaphore semaphore : render.renderSemaphore_) {
+    vkDestroySemaphore(device.device_, semaphore, nullptr);
+  }
+  render.renderSemaphore_.clear();
+  render.imageFence_.clear();
 }
 
 // InitVulkan:
 //   Initialize Vulkan Context when android application window is created
 //   upon return, vulkan is ready to draw frames
-bool InitVulkan(android_app* app) {
-  androidAppCtx = app;
-
-  if (!InitVulkan()) {
+bool InitVulkan(PlatformApp* app) {
+  appCtx = app;
+  if (device.initialized_) {
+    // Back from DeleteVulkanSurface(): everything but the window survived
+    PlatformMarkPhase(app, "swapchain");
+    CALL_VK(CreatePlatformSurface(app, device.instance_, &device.surface_));
+    CreateSwapChain(VK_NULL_HANDLE);
+    CreateFrameBuffers(render.renderPass_);
+    PlatformMarkPhase(app, "commands");
+    CreateCommandBuffers();
+    PlatformMarkPhase(app, nullptr);
+    swapchain.initialized_ = true;
+    return true;
+  }
+  PlatformMarkPhase(app, "loader");
+
+#ifdef ENABLE_VULKAN_CAPTURE
+  // Record every Vulkan call for host/vktrace_replay; fetch the trace with
+  //   adb exec-out run-as com.android.example.vulkan.tutorials.six
+  //       cat files/tutorial06.vktrace > tutorial06.vktrace
+  // (one command line)
+  std::string tracePath =
+      std::string(PlatformDataDir(app)) + "/tutorial06.vktrace";
+  if (!StartVulkanCapture(tracePath.c_str())) {
+#else
+  // Bind libvulkan.so entry points on first use: most of them are never
+  // called by this sample
+  if (!InitVulkanLazy()) {
+#endif
     LOGW("Vulkan is unavailable, install vulkan and re-start");
+    PlatformMarkPhase(app, nullptr);
     return false;
   }
 
@@ -1021,221 +1645,382 @@ bool InitVulkan(android_app* app) {
       .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
       .pEngineName = "tutorial",
       .engineVersion = VK_MAKE_VERSION(1, 0, 0),
-      .apiVersion = VK_MAKE_VERSION(1, 0, 0),
+      // Up to 1.3, which has dynamic rendering in core
+      .apiVersion = ChooseInstanceApiVersion(VK_API_VERSION_1_3),
   };
 
   // create a device
-  CreateVulkanDevice(app->window, &appInfo);
+  PlatformMarkPhase(app, "device");
+  CreateVulkanDevice(app, &appInfo);
+
+  PlatformMarkPhase(app, "swapchain");
+  CreateSwapChain(VK_NULL_HANDLE);
 
-  CreateSwapChain();
+  // Every device has a depth-only format it renders to, D16 at least
+  render.depthFormat_ = ChooseDepthFormat(device.gpuDevice_, false);
+  assert(render.depthFormat_ != VK_FORMAT_UNDEFINED);
 
   // -----------------------------------------------------------------
-  // Create render pass
-  VkAttachmentDescription attachmentDescriptions{
-      .format = swapchain.displayFormat_,
-      .samples = VK_SAMPLE_COUNT_1_BIT,
-      .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-      .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-      .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-      .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-      .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-  };
+  // Create render pass, unless dynamic rendering does without
+  if (!render.dynamicRendering_) {
+    VkAttachmentDescription attachmentDescriptions[2]{
+        {
+            .format = swapchain.displayFormat_,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        },
+        // Depth lives and dies in the render pass: on a tiler it stays in
+        // tile memory, and its lazily allocated backing is never committed
+        {
+            .format = render.depthFormat_,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        },
+    };
 
-  VkAttachmentReference colourReference = {
-      .attachment = 0, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference colourReference = {
+        .attachment = 0, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkAttachmentReference depthReference = {
+        .attachment = 1,
+        .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL};
 
-  VkSubpassDescription subpassDescription{
-      .flags = 0,
-      .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
-      .inputAttachmentCount = 0,
-      .pInputAttachments = nullptr,
-      .colorAttachmentCount = 1,
-      .pColorAttachments = &colourReference,
-      .pResolveAttachments = nullptr,
-      .pDepthStencilAttachment = nullptr,
-      .preserveAttachmentCount = 0,
-      .pPreserveAttachments = nullptr,
-  };
-  VkRenderPassCreateInfo renderPassCreateInfo{
-      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-      .pNext = nullptr,
-      .attachmentCount = 1,
-      .pAttachments = &attachmentDescriptions,
-      .subpassCount = 1,
-      .pSubpasses = &subpassDescription,
-      .dependencyCount = 0,
-      .pDependencies = nullptr,
-  };
-  CALL_VK(vkCreateRenderPass(device.device_, &renderPassCreateInfo, nullptr,
-                             &render.renderPass_));
+    VkSubpassDescription subpassDescription{
+        .flags = 0,
+        .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+        .inputAttachmentCount = 0,
+        .pInputAttachments = nullptr,
+        .colorAttachmentCount = 1,
+        .pColorAttachments = &colourReference,
+        .pResolveAttachments = nullptr,
+        .pDepthStencilAttachment = &depthReference,
+        .preserveAttachmentCount = 0,
+        .pPreserveAttachments = nullptr,
+    };
+    // The frames in flight share the depth buffer: the one before has to
+    // be done with it before the clear
+    VkSubpassDependency depthDependency{
+        .srcSubpass = VK_SUBPASS_EXTERNAL,
+        .dstSubpass = 0,
+        .srcStageMask = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+        .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                         VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        .dependencyFlags = 0,
+    };
+    VkRenderPassCreateInfo renderPassCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .pNext = nullptr,
+        .attachmentCount = 2,
+        .pAttachments = attachmentDescriptions,
+        .subpassCount = 1,
+        .pSubpasses = &subpassDescription,
+        .dependencyCount = 1,
+        .pDependencies = &depthDependency,
+    };
+    CALL_VK(vkCreateRenderPass(device.device_, &renderPassCreateInfo, nullptr,
+                               &render.renderPass_));
+  }
 
   CreateFrameBuffers(render.renderPass_);
+  // Each has a descriptor set
+  render.framesInFlight_ = framesInFlight;
+  PlatformMarkPhase(app, "texture");
   CreateTexture();
   CreateBuffers();
 
   // Create graphics pipeline
+  PlatformMarkPhase(app, "pipeline");
   CreateGraphicsPipeline();
 
   CreateDescriptorSet();
 
+  PlatformMarkPhase(app, "commands");
+
   // -----------------------------------------------
   // Create a pool of command buffers to allocate command buffer from
   VkCommandPoolCreateInfo cmdPoolCreateInfo{
       .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
       .pNext = nullptr,
       .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-      .queueFamilyIndex = 0,
+      .queueFamilyIndex = device.queueFamilyIndex_,
   };
   CALL_VK(vkCreateCommandPool(device.device_, &cmdPoolCreateInfo, nullptr,
                               &render.cmdPool_));
-
-  // Record a command buffer that just clear the screen
-  // 1 command buffer draw in 1 framebuffer
-  // In our case we need 2 command as we have 2 framebuffer
-  render.cmdBufferLen_ = swapchain.swapchainLength_;
-  render.cmdBuffer_ = new VkCommandBuffer[swapchain.swapchainLength_];
-  VkCommandBufferAllocateInfo cmdBufferCreateInfo{
-      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-      .pNext = nullptr,
-      .commandPool = render.cmdPool_,
-      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-      .commandBufferCount = render.cmdBufferLen_,
-  };
-  CALL_VK(vkAllocateCommandBuffers(device.device_, &cmdBufferCreateInfo,
-                                   render.cmdBuffer_));
-
-  for (int bufferIndex = 0; bufferIndex < swapchain.swapchainLength_;
-       bufferIndex++) {
-    // We start by creating and declare the "beginning" our command buffer
-    VkCommandBufferBeginInfo cmdBufferBeginInfo{
-        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .pNext = nullptr,
-        .flags = 0,
-        .pInheritanceInfo = nullptr,
-    };
-    CALL_VK(vkBeginCommandBuffer(render.cmdBuffer_[bufferIndex],
-                                 &cmdBufferBeginInfo));
-
-    // transition the buffer into color attachment
-    setImageLayout(render.cmdBuffer_[bufferIndex],
-                   swapchain.displayImages_[bufferIndex],
-                   VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-                   VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                   VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
-                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
-
-    // Now we start a renderpass. Any draw command has to be recorded in a
-    // renderpass
-    VkClearValue clearVals{
-        .color { .float32 { 0.0f, 0.34f, 0.90f, 1.0f,}},
-    };
-
-    VkRenderPassBeginInfo renderPassBeginInfo{
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-        .pNext = nullptr,
-        .renderPass = render.renderPass_,
-        .framebuffer = swapchain.framebuffers_[bufferIndex],
-        .renderArea = {.offset =
-                           {
-                               .x = 0, .y = 0,
-                           },
-                       .extent = swapchain.displaySize_},
-        .clearValueCount = 1,
-        .pClearValues = &clearVals};
-    vkCmdBeginRenderPass(render.cmdBuffer_[bufferIndex], &renderPassBeginInfo,
-                         VK_SUBPASS_CONTENTS_INLINE);
-    // Bind what is necessary to the command buffer
-    vkCmdBindPipeline(render.cmdBuffer_[bufferIndex],
-                      VK_PIPELINE_BIND_POINT_GRAPHICS, gfxPipeline.pipeline_);
-    vkCmdBindDescriptorSets(
-        render.cmdBuffer_[bufferIndex], VK_PIPELINE_BIND_POINT_GRAPHICS,
-        gfxPipeline.layout_, 0, 1, &gfxPipeline.descSet_, 0, nullptr);
-    VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(render.cmdBuffer_[bufferIndex], 0, 1,
-                           &buffers.vertexBuf_, &offset);
-
-    // Draw Triangle
-    vkCmdDraw(render.cmdBuffer_[bufferIndex], 3, 1, 0, 0);
-
-    vkCmdEndRenderPass(render.cmdBuffer_[bufferIndex]);
-    setImageLayout(render.cmdBuffer_[bufferIndex],
-                   swapchain.displayImages_[bufferIndex],
-                   VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                   VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                   VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
-    CALL_VK(vkEndCommandBuffer(render.cmdBuffer_[bufferIndex]));
-  }
-
-  // We need to create a fence to be able, in the main loop, to wait for our
-  // draw command(s) to finish before swapping the framebuffers
+  CreateCommandBuffers();
+
+  // Each frame in flight gets a fence, to wait in the main loop for the GPU
+  // to finish with it before reusing its objects, and a semaphore for the
+  // swapchain to signal once its image can be drawn to. They do not depend
+  // on the swapchain, so they outlive the window.
+  render.frameIndex_ = 0;
+  animationStart = std::chrono::steady_clock::now();
+  render.frameFence_.resize(render.framesInFlight_);
+  render.frameSerial_.assign(render.framesInFlight_, 0);
+  render.acquireSemaphore_.resize(render.framesInFlight_);
+
+  // Signaled, so waiting for a frame that was never submitted returns
   VkFenceCreateInfo fenceCreateInfo{
       .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
       .pNext = nullptr,
-      .flags = 0,
+      .flags = VK_FENCE_CREATE_SIGNALED_BIT,
   };
-  CALL_VK(
-      vkCreateFence(device.device_, &fenceCreateInfo, nullptr, &render.fence_));
-
-  // We need to create a semaphore to be able to wait, in the main loop, for our
-  // framebuffer to be available for us before drawing.
   VkSemaphoreCreateInfo semaphoreCreateInfo{
       .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
       .pNext = nullptr,
       .flags = 0,
   };
-  CALL_VK(vkCreateSemaphore(device.device_, &semaphoreCreateInfo, nullptr,
-                            &render.semaphore_));
+  for (uint32_t i = 0; i < render.framesInFlight_; i++) {
+    CALL_VK(vkCreateFence(device.device_, &fenceCreateInfo, nullptr,
+                          &render.frameFence_[i]));
+    CALL_VK(vkCreateSemaphore(device.device_, &semaphoreCreateInfo, nullptr,
+                              &render.acquireSemaphore_[i]));
+  }
 
+  VulkanWrapperStats wrapperStats;
+  GetVulkanWrapperStats(&wrapperStats);
+  LOGI("vulkan_wrapper: %u entry points bound, dlopen %.1f us, dlsym %.1f us",
+       wrapperStats.boundSymbols, wrapperStats.loadNanoseconds / 1000.0,
+       wrapperStats.bindNanoseconds / 1000.0);
+  MemoryAllocator::Stats memoryStats;
+  device.allocator_->GetStats(&memoryStats);
+  LOGI("memory: %u allocations in %u blocks and %u dedicated allocations, "
+       "budget %s",
+       memoryStats.allocationCount, memoryStats.blockCount,
+       memoryStats.dedicatedCount,
+       device.memoryBudget_.supported ? "from VK_EXT_memory_budget"
+                                      : "estimated from heap sizes");
+
+  PlatformMarkPhase(app, nullptr);
   device.initialized_ = true;
+  swapchain.initialized_ = true;
   return true;
 }
 
 // IsVulkanReady():
 //    native app poll to see if we are ready to draw...
-bool IsVulkanReady(void) { return device.initialized_; }
+bool IsVulkanReady(void) {
+  return device.initialized_ && swapchain.initialized_;
+}
+
+void DeleteVulkanSurface(void) {
+  if (!swapchain.initialized_) return;
+  // Frames in flight may still be using the swapchain images
+  vkDeviceWaitIdle(device.device_);
+  DeleteCommandBuffers();
+  DeleteFrameBuffers();
+  vkDestroySwapchainKHR(device.device_, swapchain.swapchain_, nullptr);
+  vkDestroySurfaceKHR(device.instance_, device.surface_, nullptr);
+  swapchain.initialized_ = false;
+}
 
 void DeleteVulkan() {
-  vkFreeCommandBuffers(device.device_, render.cmdPool_, render.cmdBufferLen_,
-                       render.cmdBuffer_);
-  delete[] render.cmdBuffer_;
+  if (!device.initialized_) return;
+  textureStreamer.Stop();
+  LOGI("memory: %s", GetVulkanMemoryJson().c_str());
+  DeleteVulkanSurface();
+  for (uint32_t i = 0; i < render.framesInFlight_; i++) {
+    vkDestroyFence(device.device_, render.frameFence_[i], nullptr);
+    vkDestroySemaphore(device.device_, render.acquireSemaphore_[i], nullptr);
+  }
+  render.frameFence_.clear();
+  render.frameSerial_.clear();
+  render.acquireSemaphore_.clear();
 
   vkDestroyCommandPool(device.device_, render.cmdPool_, nullptr);
   vkDestroyRenderPass(device.device_, render.renderPass_, nullptr);
-  DeleteSwapChain();
+  render.renderPass_ = VK_NULL_HANDLE;
   DeleteGraphicsPipeline();
   DeleteBuffers();
+  DeleteTexture();
+  // Idle since DeleteVulkanSurface()
+  device.deletionQueue_.Destroy();
+  device.staging_.Destroy();
+  delete device.allocator_;
+  device.allocator_ = nullptr;
 
   vkDestroyDevice(device.device_, nullptr);
   vkDestroyInstance(device.instance_, nullptr);
 
   device.initialized_ = false;
+#ifdef ENABLE_VULKAN_CAPTURE
+  StopVulkanCapture();
+#endif
+}
+
+// The surface changed size or no longer matches the swapchain: build a new
+// swapchain from the old one, which lets the driver hand over its images.
+void RecreateSwapChain(void) {
+  vkDeviceWaitIdle(device.device_);
+  DeleteCommandBuffers();
+  DeleteFrameBuffers();
+  VkSwapchainKHR oldSwapchain = swapchain.swapchain_;
+  CreateSwapChain(oldSwapchain);
+  vkDestroySwapchainKHR(device.device_, oldSwapchain, nullptr);
+  CreateFrameBuffers(render.renderPass_);
+  CreateCommandBuffers();
+  swapchain.initialized_ = true;
+}
+
+void SetFramesInFlight(uint32_t count) {
+  framesInFlight = (count ? count : 1);
+}
+
+void SetSwapchainProfile(SwapchainProfile profile, uint32_t imageCount) {
+  swapchainProfile = profile;
+  swapchainImageCount = imageCount;
+}
+
+void SetDynamicRendering(bool enable) { useDynamicRendering = enable; }
+
+void SetStagingUpload(bool force) { forceStagingUpload = force; }
+
+void SetTextureMipmaps(TextureMipmaps mipmaps) { textureMipmaps = mipmaps; }
+
+void SetTextureFile(const char* name) { texFiles[0] = name; }
+
+void SetTextureCount(uint32_t count) {
+  textureCount = std::max<uint32_t>(count, TUTORIAL_TEXTURE_COUNT);
+}
+
+void SetTextureWorkers(uint32_t count) { textureWorkers = count; }
+
+void GetVulkanFrameStats(VulkanFrameStats* stats) { *stats = frameStats; }
+
+void GetVulkanDepthStats(VulkanDepthStats* stats) {
+  stats->format = swapchain.depth_.format;
+  stats->lazilyAllocated = swapchain.depth_.lazilyAllocated;
+  stats->allocatedBytes = swapchain.depth_.allocationSize;
+  stats->committedBytes =
+      swapchain.initialized_
+          ? DepthBufferCommitment(device.device_, swapchain.depth_)
+          : 0;
+}
+
+void GetVulkanTextureStats(VulkanTextureStats* stats) {
+  TextureStreamer::Stats streamStats;
+  textureStreamer.GetStats(&streamStats);
+  stats->workers = streamStats.workers;
+  stats->inFlight = streamStats.inFlight;
+  stats->completed = streamStats.completed;
+  stats->failed = streamStats.failed;
+  stats->bytes = streamStats.bytes;
+  stats->nanoseconds = streamStats.nanoseconds;
+  stats->bytesPerSecond = streamStats.bytesPerSecond;
+  bool resident = !textures.empty() && textures[0].resident;
+  stats->width = resident ? textures[0].tex_width : 0;
+  stats->height = resident ? textures[0].tex_height : 0;
+  stats->mipLevels = resident ? textures[0].mipLevels : 0;
+}
+
+std::string GetVulkanMemoryJson(void) {
+  if (!device.allocator_) return "{}";
+  MemoryBudget& budget = device.allocator_->Budget();
+  budget.Update();
+  return budget.Json();
+}
+
+uint64_t NanosecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// Wait for |fence|, adding the time blocked to the frame's stats
+void WaitForFrameFence(VkFence fence) {
+  auto start = std::chrono::steady_clock::now();
+  CALL_VK(device.dispatch_.vkWaitForFences(device.device_, 1, &fence, VK_TRUE,
+                                           UINT64_MAX));
+  frameStats.fenceWaitNanoseconds += NanosecondsSince(start);
 }
 
 // Draw one frame
 bool VulkanDrawFrame(void) {
+  uint32_t frame = render.frameIndex_;
+  render.frameIndex_ = (frame + 1) % render.framesInFlight_;
+  frameStats.fenceWaitNanoseconds = 0;
+
+  // This frame's objects were last used framesInFlight_ frames ago: only
+  // block if the GPU is still that far behind.
+  WaitForFrameFence(render.frameFence_[frame]);
+  buffers.frameData_.BeginFrame(frame);
+  // The queue retires submits in order: everything deferred up to this
+  // frame's last submit is done with
+  device.deletionQueue_.Collect(render.frameSerial_[frame]);
+  device.staging_.Collect(render.frameSerial_[frame]);
+  StreamTextures(render.frameSerial_[frame]);
+  if (gfxPipeline.descGeneration_[frame] != textureGeneration) {
+    WriteTextureDescriptors(frame);
+  }
+
   uint32_t nextIndex;
   // Get the framebuffer index we should draw in
-  CALL_VK(vkAcquireNextImageKHR(device.device_, swapchain.swapchain_,
-                                UINT64_MAX, render.semaphore_, VK_NULL_HANDLE,
-                                &nextIndex));
-  CALL_VK(vkResetFences(device.device_, 1, &render.fence_));
+  presentLatency.BeginFrame();
+  auto acquireStart = std::chrono::steady_clock::now();
+  VkResult acquireResult = device.dispatch_.vkAcquireNextImageKHR(
+      device.device_, swapchain.swapchain_, UINT64_MAX,
+      render.acquireSemaphore_[frame], VK_NULL_HANDLE, &nextIndex);
+  frameStats.acquireWaitNanoseconds = NanosecondsSince(acquireStart);
+  if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
+    // Nothing was acquired, and the frame fence is still signaled
+    RecreateSwapChain();
+    return true;
+  }
+  CALL_VK(acquireResult == VK_SUBOPTIMAL_KHR ? VK_SUCCESS : acquireResult);
+
+  // The image's command buffer cannot be recorded again until the frame
+  // that last used it retires
+  if (render.imageFence_[nextIndex] != VK_NULL_HANDLE &&
+      render.imageFence_[nextIndex] != render.frameFence_[frame]) {
+    WaitForFrameFence(render.imageFence_[nextIndex]);
+  }
+  render.imageFence_[nextIndex] = render.frameFence_[frame];
+
+  // Stream this frame's FrameData, and draw with it
+  VkDeviceSize frameDataOffset;
+  FrameData* frameData = static_cast<FrameData*>(
+      buffers.frameData_.Allocate(sizeof(FrameData), 0, &frameDataOffset));
+  assert(frameData);
+  // Within a turn, where a float angle keeps its precision
+  float angle = static_cast<float>(
+      fmod(kSpinRadiansPerSecond * NanosecondsSince(animationStart) / 1e9,
+           kTwoPi));
+  float sine = sinf(angle), cosine = cosf(angle);
+  frameData->spin[0] = cosine;
+  frameData->spin[1] = sine;
+  frameData->spin[2] = -sine;
+  frameData->spin[3] = cosine;
+  buffers.frameData_.Flush();
+  RecordCommandBuffer(nextIndex, gfxPipeline.descSets_[frame],
+                      static_cast<uint32_t>(frameDataOffset));
+  CALL_VK(device.dispatch_.vkResetFences(device.device_, 1,
+                                         &render.frameFence_[frame]));
 
   VkPipelineStageFlags waitStageMask =
       VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  VkSubmitInfo submit_info = {.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                              .pNext = nullptr,
-                              .waitSemaphoreCount = 1,
-                              .pWaitSemaphores = &render.semaphore_,
-                              .pWaitDstStageMask = &waitStageMask,
-                              .commandBufferCount = 1,
-                              .pCommandBuffers = &render.cmdBuffer_[nextIndex],
-                              .signalSemaphoreCount = 0,
-                              .pSignalSemaphores = nullptr};
-  CALL_VK(vkQueueSubmit(device.queue_, 1, &submit_info, render.fence_));
-  CALL_VK(
-      vkWaitForFences(device.device_, 1, &render.fence_, VK_TRUE, 100000000));
+  VkSubmitInfo submit_info = {
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .pNext = nullptr,
+      .waitSemaphoreCount = 1,
+      .pWaitSemaphores = &render.acquireSemaphore_[frame],
+      .pWaitDstStageMask = &waitStageMask,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &render.cmdBuffer_[nextIndex],
+      .signalSemaphoreCount = 1,
+      .pSignalSemaphores = &render.renderSemaphore_[nextIndex]};
+  CALL_VK(device.dispatch_.vkQueueSubmit(device.queue_, 1, &submit_info,
+                                         render.frameFence_[frame]));
+  render.frameSerial_[frame] = ++render.submitSerial_;
 
   LOGI("Drawing frames......");
 
@@ -1243,14 +2028,74 @@ bool VulkanDrawFrame(void) {
   VkPresentInfoKHR presentInfo{
       .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
       .pNext = nullptr,
-      .waitSemaphoreCount = 0,
-      .pWaitSemaphores = nullptr,
+      .waitSemaphoreCount = 1,
+      .pWaitSemaphores = &render.renderSemaphore_[nextIndex],
       .swapchainCount = 1,
       .pSwapchains = &swapchain.swapchain_,
       .pImageIndices = &nextIndex,
       .pResults = &result,
   };
-  vkQueuePresentKHR(device.queue_, &presentInfo);
+  presentLatency.AddPresentId(&presentInfo);
+  VkResult presentResult =
+      device.dispatch_.vkQueuePresentKHR(device.queue_, &presentInfo);
+  presentLatency.EndFrame();
+  // Suboptimal is how a rotation of the display shows up, since it keeps
+  // the size of the surface
+  if (acquireResult == VK_SUBOPTIMAL_KHR ||
+      presentResult == VK_SUBOPTIMAL_KHR ||
+      presentResult == VK_ERROR_OUT_OF_DATE_KHR) {
+    RecreateSwapChain();
+  }
+
+  static std::vector<uint64_t> latencies;
+  presentLatency.TakeLatencies(&latencies);
+  frameStats.presentLatencyNanoseconds =
+      latencies.empty() ? 0 : latencies.back();
+  frameStats.presentLatencyToDisplay = presentLatency.UsesPresentWait();
+
+  // Blocked time close to the frame time means the CPU is not running
+  // ahead of the GPU
+  static uint64_t blockedNanoseconds = 0;
+  static uint64_t latencyNanoseconds = 0;
+  static uint32_t frameCount = 0;
+  static uint32_t latencyCount = 0;
+  blockedNanoseconds +=
+      frameStats.fenceWaitNanoseconds + frameStats.acquireWaitNanoseconds;
+  for (uint64_t latency : latencies) latencyNanoseconds += latency;
+  latencyCount += latencies.size();
+  if (++frameCount == kFrameStatsInterval) {
+    LOGI("%u frames in flight: CPU blocked %.3f ms per frame",
+         render.framesInFlight_, blockedNanoseconds / 1e6 / frameCount);
+    LOGI("acquire to %s: %.3f ms per frame",
+         frameStats.presentLatencyToDisplay ? "display" : "present",
+         latencyCount ? latencyNanoseconds / 1e6 / latencyCount : 0.0);
+    LOGI("depth buffer: %llu of %llu bytes committed",
+         static_cast<unsigned long long>(
+             DepthBufferCommitment(device.device_, swapchain.depth_)),
+         static_cast<unsigned long long>(swapchain.depth_.allocationSize));
+    MemoryBudget& budget = device.allocator_->Budget();
+    budget.Update();
+    for (uint32_t i = 0; i < budget.HeapCount(); i++) {
+      HeapBudget heap;
+      budget.GetHeap(i, &heap);
+      LOGI("heap %u: %.1f of %.1f MiB budget used, %.1f MiB at peak", i,
+           heap.usage / 1048576.0, heap.budget / 1048576.0,
+           heap.peakBytes / 1048576.0);
+    }
+    LOGI("deletion queue: %u objects pending, %llu destroyed",
+         device.deletionQueue_.PendingCount(),
+         static_cast<unsigned long long>(
+             device.deletionQueue_.DestroyedCount()));
+    TextureStreamer::Stats streamStats;
+    textureStreamer.GetStats(&streamStats);
+    LOGI("textures: %u resident, %u in flight, %u failed, %.1f MiB/s",
+         streamStats.completed, streamStats.inFlight, streamStats.failed,
+         streamStats.bytesPerSecond / 1048576.0);
+    blockedNanoseconds = 0;
+    latencyNanoseconds = 0;
+    frameCount = 0;
+    latencyCount = 0;
+  }
   return true;
 }
 
@@ -1321,6 +2166,6 @@ void setImageLayout(VkCommandBuffer cmdBuffer, VkImage image,
       break;
   }
 
-  vkCmdPipelineBarrier(cmdBuffer, srcStages, destStages, 0, 0, NULL, 0, NULL, 1,
-                       &imageMemoryBarrier);
+  device.dispatch_.vkCmdPipelineBarrier(cmdBuffer, srcStages, destStages, 0, 0,
+                                        NULL, 0, NULL, 1, &imageMemoryBarrier);
 }
@@ -15,9 +15,16 @@
 #define __VULKANMAIN_HPP__
 
 // Initialize vulkan device context
-// after return, vulkan is ready to draw
-#include <game-activity/native_app_glue/android_native_app_glue.h>
-bool InitVulkan(android_app* app);
+// after return, vulkan is ready to draw. After DeleteVulkanSurface(), only
+// the surface, swapchain and what depends on them are created again.
+#include <string>
+#include "Platform.h"
+#include "SwapchainPolicy.hpp"
+bool InitVulkan(PlatformApp* app);
+
+// release the window, keeping the device, textures and pipeline for the
+// next InitVulkan()
+void DeleteVulkanSurface(void);
 
 // delete vulkan device context when application goes away
 void DeleteVulkan(void);
@@ -28,6 +35,105 @@ bool IsVulkanReady(void);
 // Ask Vulkan to Render a frame
 bool VulkanDrawFrame(void);
 
+// Number of frames VulkanDrawFrame() queues before it waits for the GPU to
+// finish the oldest one; with 1, each frame waits for the previous one.
+// Takes effect at the next InitVulkan() after DeleteVulkan(), the default
+// is 2.
+void SetFramesInFlight(uint32_t count);
+
+// Present mode and swapchain length to ask for, see ChooseSwapchainPolicy().
+// Takes effect with the next swapchain, the default is
+// kSwapchainHighThroughput.
+void SetSwapchainProfile(SwapchainProfile profile, uint32_t imageCount = 0);
+
+// Draw with dynamic rendering, straight to the swapchain's image views, when
+// the device has it; else, or with false, through a VkRenderPass and a
+// VkFramebuffer per image. Takes effect at the next InitVulkan() after
+// DeleteVulkan(), the default is true. Builds with ENABLE_VULKAN_CAPTURE
+// always use the render pass, which is what a trace can replay.
+void SetDynamicRendering(bool enable);
+
+// Copy textures from a staging buffer into optimally tiled images even
+// where the device samples linear images, which it then does faster. Takes
+// effect at the next InitVulkan() after DeleteVulkan(), the default is
+// false: linear images are sampled as they are where the device can.
+void SetStagingUpload(bool force);
+
+// How textures get their mip levels, down to 1x1. With them, textures are
+// copied to optimally tiled images, whatever SetStagingUpload() says, and
+// minified with trilinear filtering.
+enum TextureMipmaps {
+  kTextureMipmapsNone,  // the one level, sampled with nearest filtering
+  // Blitted on the GPU, with linear filtering, where the texture format
+  // allows it; else as kTextureMipmapsCpu
+  kTextureMipmapsAuto,
+  // Each 2x2 texels averaged by DownsampleRgba(), and uploaded with the
+  // first level
+  kTextureMipmapsCpu,
+};
+// Takes effect for textures uploaded after it, the default is
+// kTextureMipmapsAuto.
+void SetTextureMipmaps(TextureMipmaps mipmaps);
+
+// The asset the texture is loaded from, a PNG or a KTX2 file, which has to
+// outlive its loading. Takes effect at the next InitVulkan() after
+// DeleteVulkan(), the default is "sample_tex.png"; checker_bc1.ktx2 is a
+// BC1 one with its mip levels.
+void SetTextureFile(const char* name);
+
+// Stream |count| textures, the drawn one and more loaded from the same
+// file, kept resident without being drawn, as a scene with more textures
+// would have: work for the decode workers to share. Takes effect at the
+// next InitVulkan() after DeleteVulkan(), the default is 1.
+void SetTextureCount(uint32_t count);
+// Decode textures on |count| worker threads; the default, 0, starts one
+// per core. Takes effect at the next InitVulkan() after DeleteVulkan().
+void SetTextureWorkers(uint32_t count);
+
+// CPU time the last VulkanDrawFrame() spent blocked on the GPU, and the
+// latency of the newest frame PresentLatencyTracker saw end during it (0 if
+// none did): up to the display with present wait, else up to
+// vkQueuePresentKHR() returning.
+struct VulkanFrameStats {
+  uint64_t fenceWaitNanoseconds;    // for an earlier frame to retire
+  uint64_t acquireWaitNanoseconds;  // in vkAcquireNextImageKHR()
+  uint64_t presentLatencyNanoseconds;
+  bool presentLatencyToDisplay;
+};
+void GetVulkanFrameStats(VulkanFrameStats* stats);
+
+// The swapchain's depth buffer, and how much of it the device has committed
+// to memory: on a tiler with lazily allocated memory, none of it.
+struct VulkanDepthStats {
+  VkFormat format;
+  bool lazilyAllocated;
+  uint64_t allocatedBytes;
+  uint64_t committedBytes;  // from vkGetDeviceMemoryCommitment()
+};
+void GetVulkanDepthStats(VulkanDepthStats* stats);
+
+// The textures InitVulkan() streams in the background, drawn with a
+// placeholder until they are resident, as TextureStreamer counts them
+struct VulkanTextureStats {
+  uint32_t workers;   // decoding them
+  uint32_t inFlight;  // being decoded or uploaded
+  uint32_t completed;
+  uint32_t failed;
+  uint64_t bytes;        // of every level of the completed ones, as stored
+  uint64_t nanoseconds;  // from their request to the last one resident
+  double bytesPerSecond;
+  // The first texture, once resident; else 0
+  uint32_t width;
+  uint32_t height;
+  uint32_t mipLevels;
+};
+void GetVulkanTextureStats(VulkanTextureStats* stats);
+
+// Device memory per heap: budget, usage and peak, and how many allocations
+// and bytes the tutorial has in it, as MemoryBudget::Json() has them.
+// DeleteVulkan() logs it too.
+std::string GetVulkanMemoryJson(void);
+
 #endif // __VULKANMAIN_HPP__
 
 